@@ -42,8 +42,13 @@ class StackConfig : public ocpp::config::IChargePointConfig
 
     /** @brief Path to the database to store persistent data */
     std::string databasePath() const override { return getString("DatabasePath"); }
+    /** @brief Durability profile of the database : safe (WAL + full sync), balanced (WAL + normal sync) or fast (WAL + no sync) */
+    std::string databaseDurability() const override { return getString("DatabaseDurability"); }
     /** @brief Path to the JSON schemas to validate the messages */
     std::string jsonSchemasPath() const override { return getString("JsonSchemasPath"); }
+    /** @brief Validation policy of the sent requests and of their responses : off, sampled or full,
+     *         optionally followed by per action policies (ex: sampled,Authorize=full,MeterValues=off) */
+    std::string messagesValidationPolicy() const override { return getString("MessagesValidationPolicy"); }
 
     // Communication parameters
 
@@ -57,6 +62,21 @@ class StackConfig : public ocpp::config::IChargePointConfig
     std::chrono::milliseconds retryInterval() const override { return get<std::chrono::milliseconds>("RetryInterval"); }
     /** @brief Call request timeout */
     std::chrono::milliseconds callRequestTimeout() const override { return get<std::chrono::milliseconds>("CallRequestTimeout"); }
+    /** @brief Maximum number of call requests waiting for their response at the same time (1 = no pipelining) */
+    unsigned int maxPendingCallRequests() const override { return get<unsigned int>("MaxPendingCallRequests"); }
+    /** @brief Maximum size in bytes of a message received on the websocket connection */
+    unsigned int websocketMaxMessageSize() const override { return get<unsigned int>("WebsocketMaxMessageSize"); }
+    /** @brief Maximum number of Normal priority messages (requests) waiting to be sent on the websocket connection */
+    unsigned int websocketSendQueueSize() const override { return get<unsigned int>("WebsocketSendQueueSize"); }
+    /** @brief Offer the permessage-deflate extension to compress the websocket messages
+     *         (the connection fails if the stack has been built without OCPP_WITH_PERMESSAGE_DEFLATE) */
+    bool websocketCompression() const override { return getBool("WebsocketCompression"); }
+    /** @brief Compression level of the websocket messages (1 = fastest to 9 = best compression) */
+    unsigned int websocketCompressionLevel() const override { return get<unsigned int>("WebsocketCompressionLevel"); }
+    /** @brief Base 2 logarithm of the compression window size of the websocket messages (9 to 15, 0 = default) */
+    unsigned int websocketCompressionWindowBits() const override { return get<unsigned int>("WebsocketCompressionWindowBits"); }
+    /** @brief Number of worker threads for the asynchronous operations (timer callbacks, asynchronous responses), 0 = default */
+    unsigned int workerThreadCount() const override { return get<unsigned int>("WorkerThreadCount"); }
     /** @brief Cipher list to use for TLSv1.2 connections */
     std::string tlsv12CipherList() const override { return getString("Tlsv12CipherList"); }
     /** @brief Cipher list to use for TLSv1.3 connections */
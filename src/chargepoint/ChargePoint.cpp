@@ -27,6 +27,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "MessageDispatcher.h"
 #include "MeterValuesManager.h"
 #include "ReservationManager.h"
+#include "SendLocalList.h"
 #include "SmartChargingManager.h"
 #include "StatusManager.h"
 #include "TransactionManager.h"
@@ -61,13 +62,14 @@ ChargePoint::ChargePoint(const ocpp::config::IChargePointConfig& stack_config,
       m_ocpp_config(ocpp_config),
       m_events_handler(events_handler),
       m_timer_pool(),
-      m_worker_pool(2u), // 1 asynchronous timer operations + 1 for asynchronous responses
+      m_worker_pool(stack_config.workerThreadCount() != 0 ? stack_config.workerThreadCount() : DEFAULT_WORKER_THREAD_COUNT, &m_timer_pool),
       m_database(),
       m_internal_config(m_database),
       m_messages_converter(),
       m_ws_client(),
       m_rpc_client(),
       m_msg_dispatcher(),
+      m_msg_validator(),
       m_msg_sender(),
       m_connectors(ocpp_config, m_database, m_timer_pool),
       m_config_manager(),
@@ -87,7 +89,8 @@ ChargePoint::ChargePoint(const ocpp::config::IChargePointConfig& stack_config,
       m_total_disconnected_time(0)
 {
     // Open database
-    if (m_database.open(m_stack_config.databasePath()))
+    auto durability = ocpp::database::Database::durabilityFromString(m_stack_config.databaseDurability());
+    if (m_database.open(m_stack_config.databasePath(), durability))
     {
         // Register logger
         if (m_stack_config.logMaxEntriesCount() != 0)
@@ -114,6 +117,12 @@ ChargePoint::ChargePoint(const ocpp::config::IChargePointConfig& stack_config,
 ChargePoint::~ChargePoint()
 {
     stop();
+
+    // Unregister logger before the database is closed
+    if (m_stack_config.logMaxEntriesCount() != 0)
+    {
+        ocpp::log::Logger::unregisterDefaultLogger();
+    }
 }
 
 /** @copydoc bool IChargePoint::resetData() */
@@ -139,7 +148,8 @@ bool ChargePoint::resetData()
         if (std::filesystem::remove(m_stack_config.databasePath()))
         {
             // Open database
-            if (m_database.open(m_stack_config.databasePath()))
+            auto durability = ocpp::database::Database::durabilityFromString(m_stack_config.databaseDurability());
+            if (m_database.open(m_stack_config.databasePath(), durability))
             {
                 // Register logger
                 if (m_stack_config.logMaxEntriesCount() != 0)
@@ -201,14 +211,21 @@ bool ChargePoint::start()
         m_uptime_timer.start(std::chrono::seconds(1u));
 
         // Allocate resources
-        m_ws_client  = std::unique_ptr<ocpp::websockets::IWebsocketClient>(ocpp::websockets::WebsocketFactory::newClient());
+        m_ws_client  = std::unique_ptr<ocpp::websockets::IWebsocketClient>(ocpp::websockets::WebsocketFactory::newClient(
+            m_stack_config.websocketMaxMessageSize(), m_stack_config.websocketSendQueueSize()));
         m_rpc_client = std::make_unique<ocpp::rpc::RpcClient>(*m_ws_client, "ocpp1.6");
         m_rpc_client->registerListener(*this);
         m_rpc_client->registerClientListener(*this);
         m_rpc_client->registerSpy(*this);
+        m_rpc_client->setMaxPendingCalls(m_stack_config.maxPendingCallRequests());
         m_msg_dispatcher = std::make_unique<ocpp::messages::MessageDispatcher>(m_stack_config.jsonSchemasPath());
-        m_msg_sender     = std::make_unique<ocpp::messages::GenericMessageSender>(
-            *m_rpc_client, m_messages_converter, m_stack_config.callRequestTimeout());
+        m_msg_validator  = std::make_unique<ocpp::messages::MessagesValidator>(m_stack_config.jsonSchemasPath());
+        if (!m_msg_validator->configure(m_stack_config.messagesValidationPolicy()))
+        {
+            LOG_ERROR << "Invalid messages validation policy : " << m_stack_config.messagesValidationPolicy();
+        }
+        m_msg_sender = std::make_unique<ocpp::messages::GenericMessageSender>(
+            *m_rpc_client, m_messages_converter, m_stack_config.callRequestTimeout(), m_msg_validator.get());
 
         m_config_manager  = std::make_unique<ConfigManager>(m_ocpp_config, m_messages_converter, *m_msg_dispatcher);
         m_trigger_manager = std::make_unique<TriggerMessageManager>(m_connectors, m_messages_converter, *m_msg_dispatcher);
@@ -273,6 +290,9 @@ bool ChargePoint::start()
             "SecurityProfile", std::bind(&ChargePoint::checkSecurityProfileParameter, this, std::placeholders::_1, std::placeholders::_2));
         m_config_manager->registerConfigChangedListener("AuthorizationKey", *this);
 
+        // Decode the potentially large local lists without loading them entirely in memory
+        m_rpc_client->registerStreamHandler(ocpp::messages::SEND_LOCAL_LIST_ACTION, *this);
+
         // Start connection
         ret = doConnect();
     }
@@ -298,6 +318,10 @@ bool ChargePoint::stop()
         m_uptime_timer.stop();
         saveUptime();
 
+        // Stop connection first, the completions of the pending asynchronous
+        // requests are notified and may still use the managers
+        ret = m_rpc_client->stop();
+
         // Stop managers
         m_config_manager.reset();
         m_authent_manager.reset();
@@ -310,14 +334,12 @@ bool ChargePoint::stop()
         m_smart_charging_manager.reset();
         m_maintenance_manager.reset();
 
-        // Stop connection
-        ret = m_rpc_client->stop();
-
         // Free resources
         m_ws_client.reset();
         m_rpc_client.reset();
         m_msg_dispatcher.reset();
         m_msg_sender.reset();
+        m_msg_validator.reset();
 
         // Close database
         m_database.close();
@@ -634,6 +656,22 @@ bool ChargePoint::rpcCallReceived(const std::string&      action,
     return m_msg_dispatcher->dispatchMessage(action, payload, response, error_code, error_message);
 }
 
+/** @copydoc bool IRpc::IStreamHandler::rpcStreamedCallReceived(const std::string&,
+                                                                const char*,
+                                                                size_t,
+                                                                rapidjson::Document&,
+                                                                const char*&,
+                                                                std::string&) */
+bool ChargePoint::rpcStreamedCallReceived(const std::string&   action,
+                                          const char*          frame,
+                                          size_t               size,
+                                          rapidjson::Document& response,
+                                          const char*&         error_code,
+                                          std::string&         error_message)
+{
+    return m_msg_dispatcher->dispatchStreamedMessage(action, frame, size, response, error_code, error_message);
+}
+
 /** @copydoc void IRpc::ISpy::rcpMessageReceived(const std::string&) */
 void ChargePoint::rcpMessageReceived(const std::string& msg)
 {
@@ -657,12 +695,7 @@ void ChargePoint::configurationValueChanged(const std::string& key)
         if (m_ocpp_config.securityProfile() != 3)
         {
             LOG_INFO << "AuthorizationKey modified, reconnect with new credentials";
-            m_worker_pool.run<void>(
-                [this]
-                {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(500u));
-                    doConnect();
-                });
+            m_worker_pool.runAfter(std::chrono::milliseconds(500u), [this] { doConnect(); });
         }
     }
 }
@@ -810,6 +843,9 @@ bool ChargePoint::doConnect()
     credentials.allow_expired_certificates    = m_stack_config.tlsAllowExpiredCertificates();
     credentials.accept_untrusted_certificates = m_stack_config.tlsAcceptNonTrustedCertificates();
     credentials.skip_server_name_check        = m_stack_config.tlsSkipServerNameCheck();
+    credentials.permessage_deflate            = m_stack_config.websocketCompression();
+    credentials.compression_level             = m_stack_config.websocketCompressionLevel();
+    credentials.compression_window_bits       = m_stack_config.websocketCompressionWindowBits();
 
     // Start connection process
     return m_rpc_client->start(connection_url,
@@ -39,6 +39,7 @@ namespace messages
 {
 class MessageDispatcher;
 class GenericMessageSender;
+class MessagesValidator;
 } // namespace messages
 namespace websockets
 {
@@ -63,11 +64,15 @@ class MaintenanceManager;
 /** @brief Charge point implementation */
 class ChargePoint : public IChargePoint,
                     public ocpp::rpc::IRpc::IListener,
+                    public ocpp::rpc::IRpc::IStreamHandler,
                     public ocpp::rpc::IRpc::ISpy,
                     public ocpp::rpc::RpcClient::IListener,
                     public IConfigManager::IConfigChangedListener
 {
   public:
+    /** @brief Default number of worker threads : 2 for timer callbacks and asynchronous timer operations + 1 for asynchronous responses */
+    static constexpr unsigned int DEFAULT_WORKER_THREAD_COUNT = 3u;
+
     /** @brief Constructor */
     ChargePoint(const ocpp::config::IChargePointConfig& stack_config,
                 ocpp::config::IOcppConfig&              ocpp_config,
@@ -174,6 +179,21 @@ class ChargePoint : public IChargePoint,
                          const char*&            error_code,
                          std::string&            error_message) override;
 
+    // IRpc::IStreamHandler interface
+
+    /** @copydoc bool IRpc::IStreamHandler::rpcStreamedCallReceived(const std::string&,
+                                                                    const char*,
+                                                                    size_t,
+                                                                    rapidjson::Document&,
+                                                                    const char*&,
+                                                                    std::string&) */
+    bool rpcStreamedCallReceived(const std::string&   action,
+                                 const char*          frame,
+                                 size_t               size,
+                                 rapidjson::Document& response,
+                                 const char*&         error_code,
+                                 std::string&         error_message) override;
+
     /// IRpc::ISpy interface
 
     /** @copydoc void IRpc::ISpy::rcpMessageReceived(const std::string&) */
@@ -214,6 +234,8 @@ class ChargePoint : public IChargePoint,
     std::unique_ptr<ocpp::rpc::RpcClient> m_rpc_client;
     /** @brief Message dispatcher */
     std::unique_ptr<ocpp::messages::MessageDispatcher> m_msg_dispatcher;
+    /** @brief Validator of the sent messages */
+    std::unique_ptr<ocpp::messages::MessagesValidator> m_msg_validator;
     /** @brief Message sender */
     std::unique_ptr<ocpp::messages::GenericMessageSender> m_msg_sender;
 
@@ -123,6 +123,9 @@ bool AuthentCache::check(const std::string& id_tag, ocpp::types::IdTagInfo& tag_
                 }
             }
         }
+
+        // Release the result
+        m_find_query->reset();
     }
     return ret;
 }
@@ -218,6 +221,9 @@ void AuthentCache::update(const std::string& id_tag, const ocpp::types::IdTagInf
                 }
             }
         }
+
+        // Release the result
+        m_find_query->reset();
     }
 }
 
@@ -249,20 +255,67 @@ void AuthentCache::initDatabaseTable()
             LOG_ERROR << "Could not create authent cache table : " << query->lastError();
         }
     }
-    std::stringstream trigger_query;
-    trigger_query << "CREATE TRIGGER delete_oldest_AuthentCache AFTER INSERT ON AuthentCache WHEN "
-                     " ((SELECT count() FROM AuthentCache) > ";
-    trigger_query << m_stack_config.authentCacheMaxEntriesCount();
-    trigger_query << ") BEGIN DELETE FROM AuthentCache WHERE ROWID IN "
-                     "(SELECT ROWID FROM AuthentCache LIMIT 1);END;";
-    query = m_database.query(trigger_query.str());
+
+    // Keep the number of entries in a separate table so that the eviction doesn't count the entries on each insertion,
+    // it is resynchronized at startup in case the database has been written by a previous version
+    query = m_database.query("CREATE TABLE IF NOT EXISTS AuthentCacheCount ([count] INTEGER);");
     if (query)
     {
         if (!query->exec())
         {
-            LOG_ERROR << "Could not create authent cache trigger  : " << query->lastError();
+            LOG_ERROR << "Could not create authent cache count table : " << query->lastError();
         }
     }
+    query = m_database.query("DELETE FROM AuthentCacheCount WHERE TRUE;");
+    if (query)
+    {
+        query->exec();
+    }
+    query = m_database.query("INSERT INTO AuthentCacheCount VALUES ((SELECT count() FROM AuthentCache));");
+    if (query)
+    {
+        query->exec();
+    }
+
+    // Evict the oldest entries when there are more than max entries count entries
+    unsigned int      max_entries = m_stack_config.authentCacheMaxEntriesCount();
+    std::stringstream evict_query;
+    evict_query << "DELETE FROM AuthentCache WHERE id IN (SELECT id FROM AuthentCache ORDER BY id LIMIT "
+                   "max(0, (SELECT count FROM AuthentCacheCount) - "
+                << max_entries << "));";
+    const char* triggers_names[] = {"delete_oldest_AuthentCache", "count_delete_AuthentCache"};
+    for (const char* trigger_name : triggers_names)
+    {
+        query = m_database.query(std::string("DROP TRIGGER IF EXISTS ") + trigger_name + ";");
+        if (query)
+        {
+            query->exec();
+        }
+    }
+    std::string triggers_queries[] = {
+        "CREATE TRIGGER count_delete_AuthentCache AFTER DELETE ON AuthentCache BEGIN "
+        "UPDATE AuthentCacheCount SET count = count - 1;END;",
+        "CREATE TRIGGER delete_oldest_AuthentCache AFTER INSERT ON AuthentCache BEGIN "
+        "UPDATE AuthentCacheCount SET count = count + 1;" +
+            evict_query.str() + "END;"};
+    for (const std::string& trigger_query : triggers_queries)
+    {
+        query = m_database.query(trigger_query);
+        if (query)
+        {
+            if (!query->exec())
+            {
+                LOG_ERROR << "Could not create authent cache trigger  : " << query->lastError();
+            }
+        }
+    }
+
+    // Apply a maximum entries count reduction
+    query = m_database.query(evict_query.str());
+    if (query)
+    {
+        query->exec();
+    }
 
     // Create parametrized queries
     m_find_query   = m_database.query("SELECT * FROM AuthentCache WHERE tag=?;");
@@ -19,7 +19,6 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "AuthentLocalList.h"
 #include "IChargePointConfig.h"
 #include "IInternalConfigManager.h"
-#include "IMessageDispatcher.h"
 #include "IOcppConfig.h"
 #include "InternalConfigKeys.h"
 #include "Logger.h"
@@ -46,6 +45,7 @@ AuthentLocalList::AuthentLocalList(ocpp::config::IOcppConfig&
       m_ocpp_config(ocpp_config),
       m_database(database),
       m_internal_config(internal_config),
+      m_send_local_list_conf_converter(*messages_converter.getResponseConverter<SendLocalListConf>(SEND_LOCAL_LIST_ACTION)),
       m_local_list_version(0),
       m_find_query(),
       m_delete_query(),
@@ -57,6 +57,7 @@ AuthentLocalList::AuthentLocalList(ocpp::config::IOcppConfig&
                                    *dynamic_cast<GenericMessageHandler<GetLocalListVersionReq, GetLocalListVersionConf>*>(this));
     msg_dispatcher.registerHandler(SEND_LOCAL_LIST_ACTION,
                                    *dynamic_cast<GenericMessageHandler<SendLocalListReq, SendLocalListConf>*>(this));
+    msg_dispatcher.registerStreamHandler(SEND_LOCAL_LIST_ACTION, *this);
 
     // Get current local list version
     std::string local_list_version;
@@ -104,11 +105,63 @@ bool AuthentLocalList::handleMessage(const ocpp::messages::SendLocalListReq& req
                                      const char*&                            error_code,
                                      std::string&                            error_message)
 {
-    (void)request;
-    (void)response;
     (void)error_code;
     (void)error_message;
 
+    // Entries have already been decoded
+    response.status = updateLocalList(request,
+                                      [&request](const SendLocalListStreamDecoder::ChunkHandler& handler)
+                                      { return handler(request.localAuthorizationList); });
+
+    return true;
+}
+
+/** @copydoc bool IStreamHandler::handleStream(const std::string&,
+                                               const char*,
+                                               size_t,
+                                               const rapidjson::SchemaDocument&,
+                                               rapidjson::Document&,
+                                               const char*&,
+                                               std::string&) */
+bool AuthentLocalList::handleStream(const std::string&               action,
+                                    const char*                      frame,
+                                    size_t                           size,
+                                    const rapidjson::SchemaDocument& schema,
+                                    rapidjson::Document&             response,
+                                    const char*&                     error_code,
+                                    std::string&                     error_message)
+{
+    bool ret = false;
+    (void)action;
+
+    // Validate the whole payload before modifying the local list
+    SendLocalListStreamDecoder decoder(schema, frame, size);
+    SendLocalListReq           request;
+    size_t                     entries_count = 0;
+    if (decoder.decodeHeader(request, entries_count, error_code, error_message))
+    {
+        LOG_DEBUG << "Local list update streamed : " << entries_count << " entries";
+
+        // Decode and store the entries by chunks
+        SendLocalListConf conf;
+        conf.status = updateLocalList(request,
+                                      [&decoder](const SendLocalListStreamDecoder::ChunkHandler& handler)
+                                      { return decoder.decodeEntries(CHUNK_SIZE, handler); });
+
+        // Convert response
+        m_send_local_list_conf_converter.setAllocator(&response.GetAllocator());
+        ret = m_send_local_list_conf_converter.toJson(conf, response);
+    }
+
+    return ret;
+}
+
+/** @brief Update the local list with the entries of a SendLocalList request */
+ocpp::types::UpdateStatus AuthentLocalList::updateLocalList(const ocpp::messages::SendLocalListReq& request,
+                                                           const EntriesReader&                    read_entries)
+{
+    UpdateStatus status;
+
     LOG_INFO << "Local list update requested : listVersion = " << request.listVersion
              << " - updateType = " << UpdateTypeHelper.toString(request.updateType);
 
@@ -122,19 +175,19 @@ bool AuthentLocalList::handleMessage(const ocpp::messages::SendLocalListReq& req
             bool success;
             if (request.updateType == UpdateType::Full)
             {
-                success = performFullUpdate(request.localAuthorizationList);
+                success = performFullUpdate(read_entries);
             }
             else
             {
-                success = performPartialUpdate(request.localAuthorizationList);
+                success = performPartialUpdate(read_entries);
             }
             if (success)
             {
-                response.status = UpdateStatus::Accepted;
+                status = UpdateStatus::Accepted;
             }
             else
             {
-                response.status = UpdateStatus::Failed;
+                status = UpdateStatus::Failed;
             }
 
             // Update local list version
@@ -146,17 +199,17 @@ bool AuthentLocalList::handleMessage(const ocpp::messages::SendLocalListReq& req
         }
         else
         {
-            response.status = UpdateStatus::VersionMismatch;
+            status = UpdateStatus::VersionMismatch;
         }
     }
     else
     {
-        response.status = UpdateStatus::NotSupported;
+        status = UpdateStatus::NotSupported;
     }
 
-    LOG_INFO << "Local list update status : " << UpdateStatusHelper.toString(response.status);
+    LOG_INFO << "Local list update status : " << UpdateStatusHelper.toString(status);
 
-    return true;
+    return status;
 }
 
 /** @brief Look for a tag id in the local list */
@@ -190,6 +243,9 @@ bool AuthentLocalList::check(const std::string& id_tag, ocpp::types::IdTagInfo&
                 }
             }
         }
+
+        // Release the result
+        m_find_query->reset();
     }
     return ret;
 }
@@ -227,10 +283,13 @@ void AuthentLocalList::initDatabaseTable()
 }
 
 /** @brief Perform the full update of the local list */
-bool AuthentLocalList::performFullUpdate(const std::vector<ocpp::types::AuthorizationData>& authorization_datas)
+bool AuthentLocalList::performFullUpdate(const EntriesReader& read_entries)
 {
     bool ret = true;
 
+    // Replace the whole list at once
+    Database::Transaction transaction(m_database);
+
     // Clear local list
     auto query = m_database.query("DELETE FROM AuthentLocalList WHERE TRUE;");
     if (query)
@@ -244,126 +303,173 @@ bool AuthentLocalList::performFullUpdate(const std::vector<ocpp::types::Authoriz
     if (ret)
     {
         // Insert new list
-        if (m_insert_query)
-        {
-            for (const AuthorizationData& authorization_data : authorization_datas)
-            {
-                m_insert_query->reset();
-                m_insert_query->bind(0, authorization_data.idTag);
-                m_insert_query->bind(1, authorization_data.idTagInfo.value().parentIdTag.value());
-                if (authorization_data.idTagInfo.value().expiryDate.isSet())
-                {
-                    m_insert_query->bind(2, authorization_data.idTagInfo.value().expiryDate.value().timestamp());
-                }
-                else
-                {
-                    m_insert_query->bind(2);
-                }
-                m_insert_query->bind(3, static_cast<int>(authorization_data.idTagInfo.value().status));
-                if (!m_insert_query->exec())
-                {
-                    LOG_ERROR << "Could not insert idTag [" << authorization_data.idTag.str() << "]";
-                    ret = false;
-                }
-                else
-                {
-                    LOG_DEBUG << "IdTag [" << authorization_data.idTag.str() << "] inserted";
-                }
-            }
-        }
+        ret = read_entries([this](const std::vector<AuthorizationData>& authorization_datas)
+                           { return insertEntries(authorization_datas); });
+    }
+    if (ret)
+    {
+        ret = transaction.commit();
     }
 
     return ret;
 }
+
 /** @brief Perform the partial update of the local list */
-bool AuthentLocalList::performPartialUpdate(const std::vector<ocpp::types::AuthorizationData>& authorization_datas)
+bool AuthentLocalList::performPartialUpdate(const EntriesReader& read_entries)
 {
     bool ret = true;
 
     if (m_delete_query && m_find_query && m_update_query && m_insert_query)
     {
-        // Far all idTags
-        for (const AuthorizationData& authorization_data : authorization_datas)
+        // Apply all the changes at once
+        Database::Transaction transaction(m_database);
+
+        // Go on with the next entries even if some of them could not be applied
+        bool read = read_entries(
+            [this, &ret](const std::vector<AuthorizationData>& authorization_datas)
+            {
+                ret = updateEntries(authorization_datas) && ret;
+                return true;
+            });
+        ret = read && ret;
+
+        // Commit the successful changes
+        if (!transaction.commit())
+        {
+            LOG_ERROR << "Could not commit the local list changes";
+            ret = false;
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Insert new entries in the local list */
+bool AuthentLocalList::insertEntries(const std::vector<ocpp::types::AuthorizationData>& authorization_datas)
+{
+    bool ret = true;
+
+    if (m_insert_query)
+    {
+        ret = m_database.execBatch(*m_insert_query,
+                                   authorization_datas.size(),
+                                   [&authorization_datas](Database::Query& insert_query, size_t index)
+                                   {
+                                       const AuthorizationData& authorization_data = authorization_datas[index];
+                                       insert_query.bind(0, authorization_data.idTag);
+                                       insert_query.bind(1, authorization_data.idTagInfo.value().parentIdTag.value());
+                                       if (authorization_data.idTagInfo.value().expiryDate.isSet())
+                                       {
+                                           insert_query.bind(2, authorization_data.idTagInfo.value().expiryDate.value().timestamp());
+                                       }
+                                       else
+                                       {
+                                           insert_query.bind(2);
+                                       }
+                                       insert_query.bind(3, static_cast<int>(authorization_data.idTagInfo.value().status));
+                                   });
+        if (ret)
         {
-            // Check if the idTag must be deleted
-            if (!authorization_data.idTagInfo.isSet())
+            LOG_DEBUG << authorization_datas.size() << " idTag(s) inserted";
+        }
+        else
+        {
+            LOG_ERROR << "Could not insert idTags : " << m_insert_query->lastError();
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Update or delete existing entries of the local list */
+bool AuthentLocalList::updateEntries(const std::vector<ocpp::types::AuthorizationData>& authorization_datas)
+{
+    bool ret = true;
+
+    // Far all idTags
+    for (const AuthorizationData& authorization_data : authorization_datas)
+    {
+        // Check if the idTag must be deleted
+        if (!authorization_data.idTagInfo.isSet())
+        {
+            // Delete entry
+            m_delete_query->reset();
+            m_delete_query->bind(0, authorization_data.idTag);
+            if (!m_delete_query->exec())
             {
-                // Delete entry
-                m_delete_query->reset();
-                m_delete_query->bind(0, authorization_data.idTag);
-                if (!m_delete_query->exec())
-                {
-                    LOG_ERROR << "Could not delete idTag [" << authorization_data.idTag.str() << "]";
-                    ret = false;
-                }
-                else
-                {
-                    LOG_DEBUG << "IdTag [" << authorization_data.idTag.str() << "] deleted";
-                }
+                LOG_ERROR << "Could not delete idTag [" << authorization_data.idTag.str() << "]";
+                ret = false;
             }
             else
             {
-                // Create or update, check if the entry exists
-                m_find_query->reset();
-                m_find_query->bind(0, authorization_data.idTag);
-                if (m_find_query->exec())
+                LOG_DEBUG << "IdTag [" << authorization_data.idTag.str() << "] deleted";
+            }
+        }
+        else
+        {
+            // Create or update, check if the entry exists
+            m_find_query->reset();
+            m_find_query->bind(0, authorization_data.idTag);
+            if (m_find_query->exec())
+            {
+                if (m_find_query->hasRows())
                 {
-                    if (m_find_query->hasRows())
+                    // Update
+                    int entry = m_find_query->getInt32(0);
+                    m_update_query->reset();
+                    m_update_query->bind(0, authorization_data.idTagInfo.value().parentIdTag.value());
+                    if (authorization_data.idTagInfo.value().expiryDate.isSet())
                     {
-                        // Update
-                        int entry = m_find_query->getInt32(0);
-                        m_update_query->reset();
-                        m_update_query->bind(0, authorization_data.idTagInfo.value().parentIdTag.value());
-                        if (authorization_data.idTagInfo.value().expiryDate.isSet())
-                        {
-                            m_update_query->bind(1, authorization_data.idTagInfo.value().expiryDate.value().timestamp());
-                        }
-                        else
-                        {
-                            m_update_query->bind(1);
-                        }
-                        m_update_query->bind(2, static_cast<int>(authorization_data.idTagInfo.value().status));
-                        m_update_query->bind(3, entry);
-                        if (!m_update_query->exec())
-                        {
-                            LOG_ERROR << "Could not update idTag [" << authorization_data.idTag.str() << "]";
-                        }
-                        else
-                        {
-                            LOG_DEBUG << "IdTag [" << authorization_data.idTag.str() << "] updated";
-                        }
+                        m_update_query->bind(1, authorization_data.idTagInfo.value().expiryDate.value().timestamp());
                     }
                     else
                     {
-                        // Insert
-                        m_insert_query->reset();
-                        m_insert_query->bind(0, authorization_data.idTag);
-                        m_insert_query->bind(1, authorization_data.idTagInfo.value().parentIdTag.value());
-                        if (authorization_data.idTagInfo.value().expiryDate.isSet())
-                        {
-                            m_insert_query->bind(2, authorization_data.idTagInfo.value().expiryDate.value().timestamp());
-                        }
-                        else
-                        {
-                            m_insert_query->bind(2);
-                        }
-                        m_insert_query->bind(3, static_cast<int>(authorization_data.idTagInfo.value().status));
-                        if (!m_insert_query->exec())
-                        {
-                            LOG_ERROR << "Could not insert idTag [" << authorization_data.idTag.str() << "]";
-                            ret = false;
-                        }
-                        else
-                        {
-                            LOG_DEBUG << "IdTag [" << authorization_data.idTag.str() << "] inserted";
-                        }
+                        m_update_query->bind(1);
+                    }
+                    m_update_query->bind(2, static_cast<int>(authorization_data.idTagInfo.value().status));
+                    m_update_query->bind(3, entry);
+                    if (!m_update_query->exec())
+                    {
+                        LOG_ERROR << "Could not update idTag [" << authorization_data.idTag.str() << "]";
+                    }
+                    else
+                    {
+                        LOG_DEBUG << "IdTag [" << authorization_data.idTag.str() << "] updated";
                     }
                 }
                 else
                 {
-                    ret = false;
+                    // Insert
+                    m_insert_query->reset();
+                    m_insert_query->bind(0, authorization_data.idTag);
+                    m_insert_query->bind(1, authorization_data.idTagInfo.value().parentIdTag.value());
+                    if (authorization_data.idTagInfo.value().expiryDate.isSet())
+                    {
+                        m_insert_query->bind(2, authorization_data.idTagInfo.value().expiryDate.value().timestamp());
+                    }
+                    else
+                    {
+                        m_insert_query->bind(2);
+                    }
+                    m_insert_query->bind(3, static_cast<int>(authorization_data.idTagInfo.value().status));
+                    if (!m_insert_query->exec())
+                    {
+                        LOG_ERROR << "Could not insert idTag [" << authorization_data.idTag.str() << "]";
+                        ret = false;
+                    }
+                    else
+                    {
+                        LOG_DEBUG << "IdTag [" << authorization_data.idTag.str() << "] inserted";
+                    }
                 }
             }
+            else
+            {
+                ret = false;
+            }
+
+            // Release the result
+            m_find_query->reset();
         }
     }
 
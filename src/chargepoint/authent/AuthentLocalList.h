@@ -23,7 +23,11 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "Enums.h"
 #include "GenericMessageHandler.h"
 #include "GetLocalListVersion.h"
+#include "IMessageDispatcher.h"
 #include "SendLocalList.h"
+#include "SendLocalListStreamDecoder.h"
+
+#include <functional>
 
 namespace ocpp
 {
@@ -33,10 +37,6 @@ namespace config
 class IChargePointConfig;
 class IOcppConfig;
 } // namespace config
-namespace messages
-{
-class IMessageDispatcher;
-} // namespace messages
 
 // Main namespace
 namespace chargepoint
@@ -47,9 +47,13 @@ class IInternalConfigManager;
 /** @brief Handle charge point authentication local list */
 class AuthentLocalList
     : public ocpp::messages::GenericMessageHandler<ocpp::messages::GetLocalListVersionReq, ocpp::messages::GetLocalListVersionConf>,
-      public ocpp::messages::GenericMessageHandler<ocpp::messages::SendLocalListReq, ocpp::messages::SendLocalListConf>
+      public ocpp::messages::GenericMessageHandler<ocpp::messages::SendLocalListReq, ocpp::messages::SendLocalListConf>,
+      public ocpp::messages::IMessageDispatcher::IStreamHandler
 {
   public:
+    /** @brief Maximum number of local list entries decoded and written to the database at once */
+    static constexpr size_t CHUNK_SIZE = 64u;
+
     /** @brief Constructor */
     AuthentLocalList(ocpp::config::IOcppConfig&                      ocpp_config,
                      ocpp::database::Database&                       database,
@@ -82,6 +86,23 @@ class AuthentLocalList
                        const char*&                            error_code,
                        std::string&                            error_message) override;
 
+    // IStreamHandler interface
+
+    /** @copydoc bool IStreamHandler::handleStream(const std::string&,
+                                                   const char*,
+                                                   size_t,
+                                                   const rapidjson::SchemaDocument&,
+                                                   rapidjson::Document&,
+                                                   const char*&,
+                                                   std::string&) */
+    bool handleStream(const std::string&               action,
+                      const char*                      frame,
+                      size_t                           size,
+                      const rapidjson::SchemaDocument& schema,
+                      rapidjson::Document&             response,
+                      const char*&                     error_code,
+                      std::string&                     error_message) override;
+
     // AuthentLocalList interface
 
     /**
@@ -93,12 +114,17 @@ class AuthentLocalList
     bool check(const std::string& id_tag, ocpp::types::IdTagInfo& tag_info);
 
   private:
+    /** @brief Function reading the entries of the local list by chunks, returns false if all the entries could not be read */
+    typedef std::function<bool(const ocpp::messages::SendLocalListStreamDecoder::ChunkHandler&)> EntriesReader;
+
     /** @brief Standard OCPP configuration */
     ocpp::config::IOcppConfig& m_ocpp_config;
     /** @brief Charge point's database */
     ocpp::database::Database& m_database;
     /** @brief Charge point's internal configuration */
     IInternalConfigManager& m_internal_config;
+    /** @brief Converter of the SendLocalList responses */
+    ocpp::messages::IMessageConverter<ocpp::messages::SendLocalListConf>& m_send_local_list_conf_converter;
 
     /** @brief Current local list version */
     int m_local_list_version;
@@ -114,10 +140,16 @@ class AuthentLocalList
 
     /** @brief Initialize the database table */
     void initDatabaseTable();
+    /** @brief Update the local list with the entries of a SendLocalList request */
+    ocpp::types::UpdateStatus updateLocalList(const ocpp::messages::SendLocalListReq& request, const EntriesReader& read_entries);
     /** @brief Perform the full update of the local list */
-    bool performFullUpdate(const std::vector<ocpp::types::AuthorizationData>& authorization_datas);
+    bool performFullUpdate(const EntriesReader& read_entries);
     /** @brief Perform the partial update of the local list */
-    bool performPartialUpdate(const std::vector<ocpp::types::AuthorizationData>& authorization_datas);
+    bool performPartialUpdate(const EntriesReader& read_entries);
+    /** @brief Insert new entries in the local list */
+    bool insertEntries(const std::vector<ocpp::types::AuthorizationData>& authorization_datas);
+    /** @brief Update or delete existing entries of the local list */
+    bool updateEntries(const std::vector<ocpp::types::AuthorizationData>& authorization_datas);
 };
 
 } // namespace chargepoint
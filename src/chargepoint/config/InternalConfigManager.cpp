@@ -48,6 +48,9 @@ bool InternalConfigManager::keyExist(const std::string& key)
         {
             LOG_ERROR << "Could not search key [" << key << "] : " << m_insert_query->lastError();
         }
+
+        // Release the result
+        m_find_query->reset();
     }
 
     return ret;
@@ -119,6 +122,9 @@ bool InternalConfigManager::getKey(const std::string& key, std::string& value)
         {
             LOG_ERROR << "Could not search key [" << key << "] : " << m_insert_query->lastError();
         }
+
+        // Release the result
+        m_find_query->reset();
     }
 
     return ret;
@@ -132,7 +132,8 @@ void Connectors::resetConnectors()
 
     // Reset all database data
     LOG_WARNING << "Reset connector data in database";
-    auto query = m_database.query("DELETE FROM Connectors WHERE TRUE;");
+    ocpp::database::Database::Transaction transaction(m_database);
+    auto                                  query = m_database.query("DELETE FROM Connectors WHERE TRUE;");
     if (query && query->exec())
     {
         // Store default connector data
@@ -141,6 +142,7 @@ void Connectors::resetConnectors()
             createConnector(*connector);
         }
     }
+    transaction.commit();
 }
 
 /** @brief Load the connectors states from the database */
@@ -181,6 +183,7 @@ void Connectors::loadConnectors()
         {
             // Reset all database data
             LOG_WARNING << "Reset connector data in database";
+            ocpp::database::Database::Transaction transaction(m_database);
             delete_all = false;
             query      = m_database.query("DELETE FROM Connectors WHERE TRUE;");
             if (query && query->exec())
@@ -191,6 +194,7 @@ void Connectors::loadConnectors()
                     createConnector(*connector);
                 }
             }
+            transaction.commit();
         }
         else
         {
@@ -254,6 +258,9 @@ bool Connectors::loadConnector(Connector& connector)
         {
             LOG_ERROR << "Could not search for connector " << connector.id << " : " << m_find_query->lastError();
         }
+
+        // Release the result
+        m_find_query->reset();
     }
 
     return ret;
@@ -80,6 +80,7 @@ class Connectors
 
     /**
      * @brief Save the state of a connector to the database
+     *        (part of the calling thread's ongoing database transaction if any)
      * @param id Id of the connector
      */
     bool saveConnector(unsigned int id);
@@ -38,8 +38,13 @@ class IChargePointConfig
 
     /** @brief Path to the database to store persistent data */
     virtual std::string databasePath() const = 0;
+    /** @brief Durability profile of the database : safe (WAL + full sync), balanced (WAL + normal sync) or fast (WAL + no sync) */
+    virtual std::string databaseDurability() const = 0;
     /** @brief Path to the JSON schemas to validate the messages */
     virtual std::string jsonSchemasPath() const = 0;
+    /** @brief Validation policy of the sent requests and of their responses : off, sampled or full,
+     *         optionally followed by per action policies (ex: sampled,Authorize=full,MeterValues=off) */
+    virtual std::string messagesValidationPolicy() const = 0;
 
     // Communication parameters
 
@@ -53,6 +58,21 @@ class IChargePointConfig
     virtual std::chrono::milliseconds retryInterval() const = 0;
     /** @brief Call request timeout */
     virtual std::chrono::milliseconds callRequestTimeout() const = 0;
+    /** @brief Maximum number of call requests waiting for their response at the same time (1 = no pipelining) */
+    virtual unsigned int maxPendingCallRequests() const = 0;
+    /** @brief Maximum size in bytes of a message received on the websocket connection */
+    virtual unsigned int websocketMaxMessageSize() const = 0;
+    /** @brief Maximum number of Normal priority messages (requests) waiting to be sent on the websocket connection */
+    virtual unsigned int websocketSendQueueSize() const = 0;
+    /** @brief Offer the permessage-deflate extension to compress the websocket messages
+     *         (the connection fails if the stack has been built without OCPP_WITH_PERMESSAGE_DEFLATE) */
+    virtual bool websocketCompression() const = 0;
+    /** @brief Compression level of the websocket messages (1 = fastest to 9 = best compression) */
+    virtual unsigned int websocketCompressionLevel() const = 0;
+    /** @brief Base 2 logarithm of the compression window size of the websocket messages (9 to 15, 0 = default) */
+    virtual unsigned int websocketCompressionWindowBits() const = 0;
+    /** @brief Number of worker threads for the asynchronous operations (timer callbacks, asynchronous responses), 0 = default */
+    virtual unsigned int workerThreadCount() const = 0;
     /** @brief Cipher list to use for TLSv1.2 connections */
     virtual std::string tlsv12CipherList() const = 0;
     /** @brief Cipher list to use for TLSv1.3 connections */
@@ -53,7 +53,10 @@ MaintenanceManager::MaintenanceManager(IChargePointEventsHandler&
       m_connectors(connectors),
       m_diagnostics_thread(nullptr),
       m_diagnostics_status(DiagnosticsStatus::Idle),
+      m_firmware_mutex(),
       m_firmware_thread(nullptr),
+      m_firmware_scheduled(false),
+      m_firmware_retrieve_job(),
       m_firmware_status(FirmwareStatus::Idle)
 {
     msg_dispatcher.registerHandler(RESET_ACTION, *dynamic_cast<GenericMessageHandler<ResetReq, ResetConf>*>(this));
@@ -68,7 +71,10 @@ MaintenanceManager::MaintenanceManager(IChargePointEventsHandler&
 }
 
 /** @brief Destructor */
-MaintenanceManager::~MaintenanceManager() { }
+MaintenanceManager::~MaintenanceManager()
+{
+    m_firmware_retrieve_job.cancel();
+}
 
 /**
      * @brief Notify the end of a firmware update operation
@@ -104,25 +110,15 @@ bool MaintenanceManager::onTriggerMessage(ocpp::types::MessageTrigger message, u
     {
         case MessageTrigger::DiagnosticsStatusNotification:
         {
-            m_worker_pool.run<void>(
-                [this]
-                {
-                    // To let some time for the trigger message reply
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250u));
-                    sendDiagnosticStatusNotification();
-                });
+            // To let some time for the trigger message reply
+            m_worker_pool.runAfter(std::chrono::milliseconds(250u), [this] { sendDiagnosticStatusNotification(); });
         }
         break;
 
         case MessageTrigger::FirmwareStatusNotification:
         {
-            m_worker_pool.run<void>(
-                [this]
-                {
-                    // To let some time for the trigger message reply
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250u));
-                    sendFirmwareStatusNotification();
-                });
+            // To let some time for the trigger message reply
+            m_worker_pool.runAfter(std::chrono::milliseconds(250u), [this] { sendFirmwareStatusNotification(); });
         }
         break;
 
@@ -262,21 +258,46 @@ bool MaintenanceManager::handleMessage(const ocpp::messages::UpdateFirmwareReq&
              << " - retrieveDate = " << request.retrieveDate.str();
 
     // Check if a request is already in progress
-    if (!m_firmware_thread)
+    std::lock_guard<std::mutex> lock(m_firmware_mutex);
+    if (!m_firmware_thread && !m_firmware_scheduled)
     {
-        // Create a separate thread since the operation can be time consuming
-        m_firmware_thread = new std::thread(std::bind(&MaintenanceManager::processUpdateFirmware,
-                                                      this,
-                                                      request.location,
-                                                      request.retries,
-                                                      request.retryInterval,
-                                                      request.retrieveDate));
-        m_firmware_thread->detach();
+        // Check retrieve date
+        if (request.retrieveDate > DateTime::now())
+        {
+            // Start the update at the retrieve date without blocking any thread until then
+            LOG_INFO << "UpdateFirmware : Waiting until retrieve date";
+            std::string                         location       = request.location;
+            ocpp::types::Optional<unsigned int> retries        = request.retries;
+            ocpp::types::Optional<unsigned int> retry_interval = request.retryInterval;
+
+            m_firmware_scheduled    = true;
+            m_firmware_retrieve_job = m_worker_pool.runAt(std::chrono::system_clock::from_time_t(request.retrieveDate.timestamp()),
+                                                          [this, location, retries, retry_interval]
+                                                          {
+                                                              std::lock_guard<std::mutex> lock(m_firmware_mutex);
+                                                              startUpdateFirmware(location, retries, retry_interval);
+                                                          });
+        }
+        else
+        {
+            startUpdateFirmware(request.location, request.retries, request.retryInterval);
+        }
     }
 
     return true;
 }
 
+/** @brief Start the firmware update thread (the firmware mutex must be locked) */
+void MaintenanceManager::startUpdateFirmware(std::string                         location,
+                                             ocpp::types::Optional<unsigned int> retries,
+                                             ocpp::types::Optional<unsigned int> retry_interval)
+{
+    // Create a separate thread since the operation can be time consuming
+    m_firmware_thread = new std::thread(std::bind(&MaintenanceManager::processUpdateFirmware, this, location, retries, retry_interval));
+    m_firmware_thread->detach();
+    m_firmware_scheduled = false;
+}
+
 /** @brief Process the upload of the diagnostics */
 void MaintenanceManager::processGetDiagnostics(std::string                         location,
                                                ocpp::types::Optional<unsigned int> retries,
@@ -356,25 +377,18 @@ void MaintenanceManager::sendDiagnosticStatusNotification()
 {
     LOG_INFO << "GetDiagnostics status : " << DiagnosticsStatusHelper.toString(m_diagnostics_status);
 
-    DiagnosticsStatusNotificationReq  status_req;
-    DiagnosticsStatusNotificationConf status_conf;
+    // Send request, its response is empty so there is no need to wait for it
+    DiagnosticsStatusNotificationReq status_req;
     status_req.status = m_diagnostics_status;
-    m_msg_sender.call(DIAGNOSTIC_STATUS_NOTIFICATION_ACTION, status_req, status_conf);
+    m_msg_sender.callAsync<DiagnosticsStatusNotificationReq, DiagnosticsStatusNotificationConf>(
+        DIAGNOSTIC_STATUS_NOTIFICATION_ACTION, status_req, [](CallResult, const DiagnosticsStatusNotificationConf&) {});
 }
 
 /** @brief Process the firmware update */
 void MaintenanceManager::processUpdateFirmware(std::string                         location,
                                                ocpp::types::Optional<unsigned int> retries,
-                                               ocpp::types::Optional<unsigned int> retry_interval,
-                                               ocpp::types::DateTime               retrieve_date)
+                                               ocpp::types::Optional<unsigned int> retry_interval)
 {
-    // Check retrieve date
-    if (retrieve_date > DateTime::now())
-    {
-        LOG_INFO << "UpdateFirmware : Waiting until retrieve date";
-        std::this_thread::sleep_until(std::chrono::system_clock::from_time_t(retrieve_date.timestamp()));
-    }
-
     // Notify start of download
     std::string local_firmware_file = m_events_handler.updateFirmwareRequested();
     m_firmware_status               = FirmwareStatus::Downloading;
@@ -438,6 +452,7 @@ void MaintenanceManager::processUpdateFirmware(std::string
     }
 
     // Release thread to allow new firmware update requests
+    std::lock_guard<std::mutex> lock(m_firmware_mutex);
     delete m_firmware_thread;
     m_firmware_thread = nullptr;
 }
@@ -447,10 +462,11 @@ bool MaintenanceManager::sendFirmwareStatusNotification()
 {
     LOG_INFO << "FirmwareUpdate status : " << FirmwareStatusHelper.toString(m_firmware_status);
 
-    FirmwareStatusNotificationReq  status_req;
-    FirmwareStatusNotificationConf status_conf;
+    // Send request, its response is empty so there is no need to wait for it
+    FirmwareStatusNotificationReq status_req;
     status_req.status = m_firmware_status;
-    CallResult ret    = m_msg_sender.call(FIRMWARE_STATUS_NOTIFICATION_ACTION, status_req, status_conf);
+    CallResult ret    = m_msg_sender.callAsync<FirmwareStatusNotificationReq, FirmwareStatusNotificationConf>(
+        FIRMWARE_STATUS_NOTIFICATION_ACTION, status_req, [](CallResult, const FirmwareStatusNotificationConf&) {});
     return (ret == CallResult::Ok);
 }
 
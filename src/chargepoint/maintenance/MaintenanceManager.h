@@ -26,7 +26,9 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "Reset.h"
 #include "UnlockConnector.h"
 #include "UpdateFirmware.h"
+#include "WorkerThreadPool.h"
 
+#include <mutex>
 #include <thread>
 
 namespace ocpp
@@ -141,8 +143,14 @@ class MaintenanceManager
     /** @brief Diagnostics status */
     ocpp::types::DiagnosticsStatus m_diagnostics_status;
 
+    /** @brief Mutex to protect the firmware update thread and its scheduling */
+    std::mutex m_firmware_mutex;
     /** @brief Firmware update thread */
     std::thread* m_firmware_thread;
+    /** @brief Indicate that a firmware update is waiting for its retrieve date */
+    bool m_firmware_scheduled;
+    /** @brief Job starting the firmware update at its retrieve date */
+    ocpp::helpers::CancellationToken m_firmware_retrieve_job;
     /** @brief Firmware update status */
     ocpp::types::FirmwareStatus m_firmware_status;
 
@@ -155,11 +163,15 @@ class MaintenanceManager
     /** @brief Send a diagnostic status notification */
     void sendDiagnosticStatusNotification();
 
+    /** @brief Start the firmware update thread (the firmware mutex must be locked) */
+    void startUpdateFirmware(std::string                         location,
+                             ocpp::types::Optional<unsigned int> retries,
+                             ocpp::types::Optional<unsigned int> retry_interval);
+
     /** @brief Process the firmware update */
     void processUpdateFirmware(std::string                         location,
                                ocpp::types::Optional<unsigned int> retries,
-                               ocpp::types::Optional<unsigned int> retry_interval,
-                               ocpp::types::DateTime               retrieve_date);
+                               ocpp::types::Optional<unsigned int> retry_interval);
 
     /** @brief Send a firmware status notification */
     bool sendFirmwareStatusNotification();
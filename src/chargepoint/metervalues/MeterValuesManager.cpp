@@ -228,36 +228,18 @@ void MeterValuesManager::configureClockAlignedTimer(void)
 
     // Get interval from configuration
     std::chrono::seconds interval = m_ocpp_config.clockAlignedDataInterval();
-    if (interval >= std::chrono::seconds(0))
+    if (interval > std::chrono::seconds(0))
     {
         LOG_INFO << "Configure clock aligned meter values : interval in seconds = " << interval.count();
 
-        // Compute next due date
-        time_t    now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-        struct tm aligned_time_tm;
-        localtime_r(&now, &aligned_time_tm);
-        aligned_time_tm.tm_min = 0;
-        aligned_time_tm.tm_sec = 0;
-        time_t aligned_time    = std::mktime(&aligned_time_tm);
-        while (aligned_time <= now)
-        {
-            aligned_time += interval.count();
-        }
-        std::chrono::seconds next_due_interval = std::chrono::seconds(aligned_time - now);
-        m_clock_aligned_timer.start(std::chrono::milliseconds(next_due_interval));
+        // Start timer on the next aligned due date
+        m_clock_aligned_timer.start(interval);
     }
 }
 
 /** @brief Process clock-aligned meter values */
 void MeterValuesManager::processClockAligned(void)
 {
-    // Check if timer interval must be modified (for first due date only)
-    std::chrono::seconds timer_interval = m_ocpp_config.clockAlignedDataInterval();
-    if (m_clock_aligned_timer.getInterval() != timer_interval)
-    {
-        m_clock_aligned_timer.restart(timer_interval);
-    }
-
     // Check if charge point has been registered
     if (m_status_manager.getRegistrationStatus() == RegistrationStatus::Accepted)
     {
@@ -294,24 +276,29 @@ void MeterValuesManager::processClockAligned(void)
                             LOG_DEBUG << "Clock aligned transaction meter values : " << meter_values;
 
                             // Fill meter value
-                            MeterValue meter_value;
+                            MeterValue               meter_value;
+                            std::vector<std::string> meter_value_strs;
                             for (const Connector* connector : m_connectors.getConnectors())
                             {
                                 if (fillMeterValue(connector->id, measurands, meter_value, ReadingContext::SampleClock))
                                 {
                                     // Serialize value
-                                    std::string meter_value_str = serialize(meter_value);
-
-                                    // Store into database
-                                    for (int transaction_id : transaction_ids)
-                                    {
-                                        m_insert_query->reset();
-                                        m_insert_query->bind(0u, transaction_id);
-                                        m_insert_query->bind(1u, meter_value_str);
-                                        m_insert_query->exec();
-                                    }
+                                    meter_value_strs.push_back(serialize(meter_value));
                                 }
                             }
+
+                            // Store into database in a single transaction
+                            size_t count = meter_value_strs.size();
+                            if (!m_database.execBatch(*m_insert_query,
+                                                      count * transaction_ids.size(),
+                                                      [&](ocpp::database::Database::Query& insert_query, size_t index)
+                                                      {
+                                                          insert_query.bind(0u, transaction_ids[index / count]);
+                                                          insert_query.bind(1u, meter_value_strs[index % count]);
+                                                      }))
+                            {
+                                LOG_ERROR << "Could not store clock aligned transaction meter values : " << m_insert_query->lastError();
+                            }
                         }
                     }
                 }
@@ -371,13 +358,11 @@ void MeterValuesManager::processSampled(unsigned int connector_id)
 /** @brief Process triggered meter values for a given connector */
 void MeterValuesManager::processTriggered(unsigned int connector_id)
 {
-    // Process in background thread
-    m_worker_pool.run<void>(
+    // Process in background thread, let some time for the trigger message reply
+    m_worker_pool.runAfter(
+        std::chrono::milliseconds(250u),
         [this, connector_id]
         {
-            // To let some time for the trigger message reply
-            std::this_thread::sleep_for(std::chrono::milliseconds(250u));
-
             // Process meter value configuration
             std::string meter_values        = m_ocpp_config.meterValuesSampledData();
             size_t      measurands_max_size = m_ocpp_config.meterValuesSampledDataMaxLength();
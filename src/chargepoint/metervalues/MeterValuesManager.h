@@ -19,12 +19,12 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #ifndef METERVALUESMANAGER_H
 #define METERVALUESMANAGER_H
 
+#include "ClockAlignedTimer.h"
 #include "Database.h"
 #include "Enums.h"
 #include "IConfigManager.h"
 #include "IMeterValuesManager.h"
 #include "ITriggerMessageManager.h"
-#include "Timer.h"
 
 namespace ocpp
 {
@@ -117,7 +117,7 @@ class MeterValuesManager : public IMeterValuesManager,
     ocpp::messages::IRequestFifo* m_requests_fifo;
 
     /** @brief Clock-aligned meter values timer */
-    ocpp::helpers::Timer m_clock_aligned_timer;
+    ocpp::helpers::ClockAlignedTimer m_clock_aligned_timer;
 
     /** @brief Query to look for the meter values associated to a transaction */
     std::unique_ptr<ocpp::database::Database::Query> m_find_query;
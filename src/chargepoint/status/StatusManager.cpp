@@ -67,8 +67,12 @@ StatusManager::StatusManager(const ocpp::config::IChargePointConfig&         sta
       m_boot_notification_timer(timer_pool, "Boot notification"),
       m_heartbeat_timer(timer_pool, "Heartbeat")
 {
+    // The processes wait for the central system's responses : run them in the worker threads
+    // to not delay the other timers of the pool
     m_boot_notification_timer.setCallback(std::bind(&StatusManager::bootNotificationProcess, this));
+    m_boot_notification_timer.setExecutor(&m_worker_pool);
     m_heartbeat_timer.setCallback(std::bind(&StatusManager::heartBeatProcess, this));
+    m_heartbeat_timer.setExecutor(&m_worker_pool);
 
     trigger_manager.registerHandler(ocpp::types::MessageTrigger::BootNotification, *this);
     trigger_manager.registerHandler(ocpp::types::MessageTrigger::Heartbeat, *this);
@@ -176,6 +180,7 @@ bool StatusManager::updateConnectorStatus(unsigned int                      conn
                     if (connector->status != connector->last_notified_status)
                     {
                         connector->status_timer.setCallback([connector_id, this] { statusNotificationProcess(connector_id); });
+                        connector->status_timer.setExecutor(&m_worker_pool);
                         connector->status_timer.start(std::chrono::milliseconds(duration), true);
                     }
                 }
@@ -206,37 +211,22 @@ bool StatusManager::onTriggerMessage(ocpp::types::MessageTrigger message, unsign
     {
         case MessageTrigger::BootNotification:
         {
-            m_worker_pool.run<void>(
-                [this]
-                {
-                    // To let some time for the trigger message reply
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250u));
-                    sendBootNotification();
-                });
+            // To let some time for the trigger message reply
+            m_worker_pool.runAfter(std::chrono::milliseconds(250u), [this] { sendBootNotification(); });
         }
         break;
 
         case MessageTrigger::Heartbeat:
         {
-            m_worker_pool.run<void>(
-                [this]
-                {
-                    // To let some time for the trigger message reply
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250u));
-                    heartBeatProcess();
-                });
+            // To let some time for the trigger message reply
+            m_worker_pool.runAfter(std::chrono::milliseconds(250u), [this] { heartBeatProcess(); });
         }
         break;
 
         case MessageTrigger::StatusNotification:
         {
-            m_worker_pool.run<void>(
-                [this, connector_id]
-                {
-                    // To let some time for the trigger message reply
-                    std::this_thread::sleep_for(std::chrono::milliseconds(250u));
-                    statusNotificationProcess(connector_id);
-                });
+            // To let some time for the trigger message reply
+            m_worker_pool.runAfter(std::chrono::milliseconds(250u), [this, connector_id] { statusNotificationProcess(connector_id); });
             break;
         }
 
@@ -353,15 +343,20 @@ void StatusManager::bootNotificationProcess()
 /** @brief Heartbeat process */
 void StatusManager::heartBeatProcess()
 {
-    HeartbeatReq  heartbeat_req;
-    HeartbeatConf heartbeat_conf;
-    CallResult    result = m_msg_sender.call(HEARTBEAT_ACTION, heartbeat_req, heartbeat_conf);
-    if (result == CallResult::Ok)
-    {
-        LOG_INFO << "Heartbeat : " << heartbeat_conf.currentTime.str();
+    // Send request, the response is processed from the RPC reception thread
+    HeartbeatReq heartbeat_req;
+    m_msg_sender.callAsync<HeartbeatReq, HeartbeatConf>(
+        HEARTBEAT_ACTION,
+        heartbeat_req,
+        [this](CallResult result, const HeartbeatConf& heartbeat_conf)
+        {
+            if (result == CallResult::Ok)
+            {
+                LOG_INFO << "Heartbeat : " << heartbeat_conf.currentTime.str();
 
-        m_events_handler.datetimeReceived(heartbeat_conf.currentTime);
-    }
+                m_events_handler.datetimeReceived(heartbeat_conf.currentTime);
+            }
+        });
 }
 
 /** @brief Status notification process */
@@ -390,13 +385,19 @@ void StatusManager::statusNotificationProcess(unsigned int connector_id)
             status_req.vendorErrorCode.value().assign(connector->vendor_error);
         }
 
-        StatusNotificationConf status_conf;
-        CallResult             result = m_msg_sender.call(STATUS_NOTIFICATION_ACTION, status_req, status_conf);
-        if (result == CallResult::Ok)
-        {
-            // Update last notified status
-            connector->last_notified_status = connector->status;
-        }
+        // The last notified status is updated from the RPC reception thread
+        ChargePointStatus status = status_req.status;
+        m_msg_sender.callAsync<StatusNotificationReq, StatusNotificationConf>(
+            STATUS_NOTIFICATION_ACTION,
+            status_req,
+            [connector, status](CallResult result, const StatusNotificationConf&)
+            {
+                if (result == CallResult::Ok)
+                {
+                    // Update last notified status
+                    connector->last_notified_status = status;
+                }
+            });
     }
 }
 
@@ -51,8 +51,7 @@ bool DeleteCertificateReqConverter::toJson(const DeleteCertificateReq& data, rap
 {
     CertificateHashDataTypeConverter certificate_hash_converter;
     certificate_hash_converter.setAllocator(allocator);
-    rapidjson::Document value;
-    value.Parse("{}");
+    rapidjson::Document value(rapidjson::kObjectType, allocator);
     bool ret = certificate_hash_converter.toJson(data.certificateHashData, value);
     json.AddMember(rapidjson::StringRef("certificateHashData"), value.Move(), *allocator);
     return ret;
@@ -0,0 +1,504 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FastValidators.h"
+
+#include <cstring>
+#include <unordered_map>
+
+namespace ocpp
+{
+namespace messages
+{
+
+namespace
+{
+
+/** @brief Check function of a property value */
+typedef bool (*PropertyCheck)(const rapidjson::Value& value, const char*& keyword);
+
+/** @brief Property of an object */
+struct Property
+{
+    /** @brief Name */
+    const char* name;
+    /** @brief Indicate if the property is required */
+    bool required;
+    /** @brief Check function */
+    PropertyCheck check;
+};
+
+/** @brief Compare a JSON string with a C string */
+bool isEqual(const rapidjson::Value& value, const char* str)
+{
+    size_t len = strlen(str);
+    return ((value.GetStringLength() == len) && (memcmp(value.GetString(), str, len) == 0));
+}
+
+/** @brief Check a string value, its length is counted in code points as done by the schema validator */
+bool checkString(const rapidjson::Value& value, size_t max_length, const char*& keyword)
+{
+    bool ret = false;
+    if (value.IsString())
+    {
+        const char* str    = value.GetString();
+        size_t      length = 0;
+        for (rapidjson::SizeType i = 0; i < value.GetStringLength(); i++)
+        {
+            if ((static_cast<unsigned char>(str[i]) & 0xC0u) != 0x80u)
+            {
+                length++;
+            }
+        }
+        ret = (length <= max_length);
+        if (!ret)
+        {
+            keyword = "maxLength";
+        }
+    }
+    else
+    {
+        keyword = "type";
+    }
+    return ret;
+}
+
+/** @brief Check a string value belonging to an enumeration */
+template <size_t N>
+bool checkEnum(const rapidjson::Value& value, const char* const (&values)[N], const char*& keyword)
+{
+    bool ret = false;
+    if (value.IsString())
+    {
+        for (size_t i = 0; !ret && (i < N); i++)
+        {
+            ret = isEqual(value, values[i]);
+        }
+        if (!ret)
+        {
+            keyword = "enum";
+        }
+    }
+    else
+    {
+        keyword = "type";
+    }
+    return ret;
+}
+
+/** @brief Check an object value against the list of its allowed properties */
+template <size_t N>
+bool checkObject(const rapidjson::Value& value, const Property (&properties)[N], const char*& keyword)
+{
+    static_assert(N <= 32u, "Too many properties");
+
+    bool ret = false;
+    if (value.IsObject())
+    {
+        // Check the properties in a single pass
+        uint32_t found = 0;
+        ret            = true;
+        for (auto it = value.MemberBegin(); ret && (it != value.MemberEnd()); ++it)
+        {
+            size_t i = 0;
+            while ((i < N) && !isEqual(it->name, properties[i].name))
+            {
+                i++;
+            }
+            if (i < N)
+            {
+                found |= (1u << i);
+                ret = properties[i].check(it->value, keyword);
+            }
+            else
+            {
+                keyword = "additionalProperties";
+                ret     = false;
+            }
+        }
+
+        // Check the required properties
+        for (size_t i = 0; ret && (i < N); i++)
+        {
+            if (properties[i].required && ((found & (1u << i)) == 0))
+            {
+                keyword = "required";
+                ret     = false;
+            }
+        }
+    }
+    else
+    {
+        keyword = "type";
+    }
+    return ret;
+}
+
+/** @brief Check an array value whose items are checked by the same function */
+bool checkArray(const rapidjson::Value& value, PropertyCheck check, const char*& keyword)
+{
+    bool ret = false;
+    if (value.IsArray())
+    {
+        ret = true;
+        for (auto it = value.Begin(); ret && (it != value.End()); ++it)
+        {
+            ret = check(*it, keyword);
+        }
+    }
+    else
+    {
+        keyword = "type";
+    }
+    return ret;
+}
+
+/** @brief Check an empty object value */
+bool checkEmptyObject(const rapidjson::Value& value, const char*& keyword)
+{
+    bool ret = false;
+    if (value.IsObject())
+    {
+        ret = value.ObjectEmpty();
+        if (!ret)
+        {
+            keyword = "additionalProperties";
+        }
+    }
+    else
+    {
+        keyword = "type";
+    }
+    return ret;
+}
+
+/** @brief Check an integer value */
+bool checkInteger(const rapidjson::Value& value, const char*& keyword)
+{
+    bool ret = (value.IsInt64() || value.IsUint64());
+    if (!ret)
+    {
+        keyword = "type";
+    }
+    return ret;
+}
+
+/** @brief Check a string value without length limit */
+bool checkAnyString(const rapidjson::Value& value, const char*& keyword)
+{
+    bool ret = value.IsString();
+    if (!ret)
+    {
+        keyword = "type";
+    }
+    return ret;
+}
+
+/** @brief Check a string value of at most 20 characters */
+bool checkString20(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkString(value, 20u, keyword);
+}
+
+/** @brief Check a string value of at most 50 characters */
+bool checkString50(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkString(value, 50u, keyword);
+}
+
+/** @brief Check a string value of at most 255 characters */
+bool checkString255(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkString(value, 255u, keyword);
+}
+
+// Enumerations
+
+/** @brief AuthorizationStatus enumeration */
+const char* const AUTHORIZATION_STATUS[] = {"Accepted", "Blocked", "Expired", "Invalid", "ConcurrentTx"};
+
+/** @brief ChargePointErrorCode enumeration */
+const char* const CHARGE_POINT_ERROR_CODE[] = {"ConnectorLockFailure",
+                                               "EVCommunicationError",
+                                               "GroundFailure",
+                                               "HighTemperature",
+                                               "InternalError",
+                                               "LocalListConflict",
+                                               "NoError",
+                                               "OtherError",
+                                               "OverCurrentFailure",
+                                               "PowerMeterFailure",
+                                               "PowerSwitchFailure",
+                                               "ReaderFailure",
+                                               "ResetFailure",
+                                               "UnderVoltage",
+                                               "OverVoltage",
+                                               "WeakSignal"};
+
+/** @brief ChargePointStatus enumeration */
+const char* const CHARGE_POINT_STATUS[] = {
+    "Available", "Preparing", "Charging", "SuspendedEVSE", "SuspendedEV", "Finishing", "Reserved", "Unavailable", "Faulted"};
+
+/** @brief ReadingContext enumeration */
+const char* const READING_CONTEXT[] = {"Interruption.Begin",
+                                       "Interruption.End",
+                                       "Sample.Clock",
+                                       "Sample.Periodic",
+                                       "Transaction.Begin",
+                                       "Transaction.End",
+                                       "Trigger",
+                                       "Other"};
+
+/** @brief ValueFormat enumeration */
+const char* const VALUE_FORMAT[] = {"Raw", "SignedData"};
+
+/** @brief Measurand enumeration */
+const char* const MEASURAND[] = {"Energy.Active.Export.Register",
+                                 "Energy.Active.Import.Register",
+                                 "Energy.Reactive.Export.Register",
+                                 "Energy.Reactive.Import.Register",
+                                 "Energy.Active.Export.Interval",
+                                 "Energy.Active.Import.Interval",
+                                 "Energy.Reactive.Export.Interval",
+                                 "Energy.Reactive.Import.Interval",
+                                 "Power.Active.Export",
+                                 "Power.Active.Import",
+                                 "Power.Offered",
+                                 "Power.Reactive.Export",
+                                 "Power.Reactive.Import",
+                                 "Power.Factor",
+                                 "Current.Import",
+                                 "Current.Export",
+                                 "Current.Offered",
+                                 "Voltage",
+                                 "Frequency",
+                                 "Temperature",
+                                 "SoC",
+                                 "RPM"};
+
+/** @brief Phase enumeration */
+const char* const PHASE[] = {"L1", "L2", "L3", "N", "L1-N", "L2-N", "L3-N", "L1-L2", "L2-L3", "L3-L1"};
+
+/** @brief Location enumeration */
+const char* const LOCATION[] = {"Cable", "EV", "Inlet", "Outlet", "Body"};
+
+/** @brief UnitOfMeasure enumeration */
+const char* const UNIT_OF_MEASURE[] = {"Wh",
+                                       "kWh",
+                                       "varh",
+                                       "kvarh",
+                                       "W",
+                                       "kW",
+                                       "VA",
+                                       "kVA",
+                                       "var",
+                                       "kvar",
+                                       "A",
+                                       "V",
+                                       "K",
+                                       "Celcius",
+                                       "Celsius",
+                                       "Fahrenheit",
+                                       "Percent"};
+
+// Authorize
+
+/** @brief Check the idTagInfo.status property */
+bool checkAuthorizationStatus(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, AUTHORIZATION_STATUS, keyword);
+}
+
+/** @brief Properties of the IdTagInfo type */
+const Property ID_TAG_INFO[] = {
+    {"expiryDate", false, checkAnyString}, {"parentIdTag", false, checkString20}, {"status", true, checkAuthorizationStatus}};
+
+/** @brief Check an IdTagInfo object */
+bool checkIdTagInfo(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkObject(value, ID_TAG_INFO, keyword);
+}
+
+/** @brief Properties of the Authorize request */
+const Property AUTHORIZE[] = {{"idTag", true, checkString20}};
+
+/** @brief Properties of the Authorize response */
+const Property AUTHORIZE_RESPONSE[] = {{"idTagInfo", true, checkIdTagInfo}};
+
+/** @brief Validate an Authorize request */
+bool isValidAuthorize(const rapidjson::Value& payload, const char*& keyword)
+{
+    return checkObject(payload, AUTHORIZE, keyword);
+}
+
+/** @brief Validate an Authorize response */
+bool isValidAuthorizeResponse(const rapidjson::Value& payload, const char*& keyword)
+{
+    return checkObject(payload, AUTHORIZE_RESPONSE, keyword);
+}
+
+// Heartbeat
+
+/** @brief Properties of the Heartbeat response */
+const Property HEARTBEAT_RESPONSE[] = {{"currentTime", true, checkAnyString}};
+
+/** @brief Validate an Heartbeat response */
+bool isValidHeartbeatResponse(const rapidjson::Value& payload, const char*& keyword)
+{
+    return checkObject(payload, HEARTBEAT_RESPONSE, keyword);
+}
+
+// MeterValues
+
+/** @brief Check the sampledValue.context property */
+bool checkReadingContext(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, READING_CONTEXT, keyword);
+}
+
+/** @brief Check the sampledValue.format property */
+bool checkValueFormat(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, VALUE_FORMAT, keyword);
+}
+
+/** @brief Check the sampledValue.measurand property */
+bool checkMeasurand(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, MEASURAND, keyword);
+}
+
+/** @brief Check the sampledValue.phase property */
+bool checkPhase(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, PHASE, keyword);
+}
+
+/** @brief Check the sampledValue.location property */
+bool checkLocation(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, LOCATION, keyword);
+}
+
+/** @brief Check the sampledValue.unit property */
+bool checkUnitOfMeasure(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, UNIT_OF_MEASURE, keyword);
+}
+
+/** @brief Properties of the SampledValue type */
+const Property SAMPLED_VALUE[] = {{"value", true, checkAnyString},
+                                  {"context", false, checkReadingContext},
+                                  {"format", false, checkValueFormat},
+                                  {"measurand", false, checkMeasurand},
+                                  {"phase", false, checkPhase},
+                                  {"location", false, checkLocation},
+                                  {"unit", false, checkUnitOfMeasure}};
+
+/** @brief Check a SampledValue object */
+bool checkSampledValue(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkObject(value, SAMPLED_VALUE, keyword);
+}
+
+/** @brief Check an array of SampledValue objects */
+bool checkSampledValues(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkArray(value, checkSampledValue, keyword);
+}
+
+/** @brief Properties of the MeterValue type */
+const Property METER_VALUE[] = {{"timestamp", true, checkAnyString}, {"sampledValue", true, checkSampledValues}};
+
+/** @brief Check a MeterValue object */
+bool checkMeterValue(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkObject(value, METER_VALUE, keyword);
+}
+
+/** @brief Check an array of MeterValue objects */
+bool checkMeterValues(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkArray(value, checkMeterValue, keyword);
+}
+
+/** @brief Properties of the MeterValues request */
+const Property METER_VALUES[] = {
+    {"connectorId", true, checkInteger}, {"transactionId", false, checkInteger}, {"meterValue", true, checkMeterValues}};
+
+/** @brief Validate a MeterValues request */
+bool isValidMeterValues(const rapidjson::Value& payload, const char*& keyword)
+{
+    return checkObject(payload, METER_VALUES, keyword);
+}
+
+// StatusNotification
+
+/** @brief Check the errorCode property */
+bool checkChargePointErrorCode(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, CHARGE_POINT_ERROR_CODE, keyword);
+}
+
+/** @brief Check the status property */
+bool checkChargePointStatus(const rapidjson::Value& value, const char*& keyword)
+{
+    return checkEnum(value, CHARGE_POINT_STATUS, keyword);
+}
+
+/** @brief Properties of the StatusNotification request */
+const Property STATUS_NOTIFICATION[] = {{"connectorId", true, checkInteger},
+                                        {"errorCode", true, checkChargePointErrorCode},
+                                        {"info", false, checkString50},
+                                        {"status", true, checkChargePointStatus},
+                                        {"timestamp", false, checkAnyString},
+                                        {"vendorId", false, checkString255},
+                                        {"vendorErrorCode", false, checkString50}};
+
+/** @brief Validate a StatusNotification request */
+bool isValidStatusNotification(const rapidjson::Value& payload, const char*& keyword)
+{
+    return checkObject(payload, STATUS_NOTIFICATION, keyword);
+}
+
+} // namespace
+
+/** @brief Get the fast validator of a JSON schema */
+FastValidator getFastValidator(const std::string& schema_name)
+{
+    static const std::unordered_map<std::string, FastValidator> validators = {
+        {"Authorize", isValidAuthorize},
+        {"AuthorizeResponse", isValidAuthorizeResponse},
+        {"Heartbeat", checkEmptyObject},
+        {"HeartbeatResponse", isValidHeartbeatResponse},
+        {"MeterValues", isValidMeterValues},
+        {"MeterValuesResponse", checkEmptyObject},
+        {"StatusNotification", isValidStatusNotification},
+        {"StatusNotificationResponse", checkEmptyObject}};
+
+    FastValidator ret = nullptr;
+    auto          it  = validators.find(schema_name);
+    if (it != validators.end())
+    {
+        ret = it->second;
+    }
+    return ret;
+}
+
+} // namespace messages
+} // namespace ocpp
@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef FASTVALIDATORS_H
+#define FASTVALIDATORS_H
+
+#include "json.h"
+
+#include <string>
+
+namespace ocpp
+{
+namespace messages
+{
+
+/**
+ * @brief Type specialised validator of a message payload
+ * @param payload Payload to validate
+ * @param keyword Schema keyword which has not been satisfied if the payload is invalid
+ * @return true if the payload is valid, false otherwise
+ */
+typedef bool (*FastValidator)(const rapidjson::Value& payload, const char*& keyword);
+
+/**
+ * @brief Get the fast validator of a JSON schema
+ *
+ *  The fast validators are hand written counterparts of the JSON schemas of the most frequent
+ *  messages. They check exactly the same constraints as the schema files (except the formats
+ *  which are not checked by the generic validator either) in a single pass over the payload.
+ *
+ * @param schema_name Name of the JSON schema (ex: MeterValues, MeterValuesResponse)
+ * @return Fast validator of the schema if available, nullptr otherwise
+ */
+FastValidator getFastValidator(const std::string& schema_name);
+
+} // namespace messages
+} // namespace ocpp
+
+#endif // FASTVALIDATORS_H
@@ -22,7 +22,13 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "IChargePointConfig.h"
 #include "IRequestFifo.h"
 #include "IRpc.h"
+#include "JsonArena.h"
+#include "Logger.h"
 #include "MessagesConverter.h"
+#include "MessagesValidator.h"
+
+#include <functional>
+#include <memory>
 
 namespace ocpp
 {
@@ -44,9 +50,18 @@ enum class CallResult
 class GenericMessageSender
 {
   public:
-    /** @brief Constructor */
-    GenericMessageSender(ocpp::rpc::IRpc& rpc, MessagesConverter& messages_converter, std::chrono::milliseconds timeout)
-        : m_rpc(rpc), m_messages_converter(messages_converter), m_timeout(timeout)
+    /**
+     * @brief Constructor
+     * @param rpc RPC to use to send the requests
+     * @param messages_converter Messages converter
+     * @param timeout Request timeout
+     * @param validator Optional. Validator of the requests and of their responses.
+     */
+    GenericMessageSender(ocpp::rpc::IRpc&          rpc,
+                         MessagesConverter&        messages_converter,
+                         std::chrono::milliseconds timeout,
+                         MessagesValidator*        validator = nullptr)
+        : m_rpc(rpc), m_messages_converter(messages_converter), m_timeout(timeout), m_validator(validator)
     {
     }
 
@@ -77,25 +92,25 @@ class GenericMessageSender
         IMessageConverter<ResponseType>* resp_converter = m_messages_converter.getResponseConverter<ResponseType>(action);
         if (req_converter && resp_converter)
         {
-            // Convert request
-            rapidjson::Document payload;
-            payload.Parse("{}");
+            // Convert request, the JSON documents only live during the exchange
+            ocpp::json::JsonArena arena;
+            rapidjson::Document   payload(rapidjson::kObjectType, &arena.allocator());
             req_converter->setAllocator(&payload.GetAllocator());
-            if (req_converter->toJson(request, payload))
+            if (req_converter->toJson(request, payload) && isValidRequest(action, payload))
             {
                 // Check if request_fifo is empty
                 if (!request_fifo || (request_fifo->size() == 0))
                 {
                     // Execute call
-                    rapidjson::Document resp;
-                    resp.Parse("{}");
+                    rapidjson::Document resp(rapidjson::kObjectType, &arena.allocator());
                     if (m_rpc.call(action, payload, resp, m_timeout))
                     {
                         // Convert response
                         const char* error_code = nullptr;
                         std::string error_message;
                         resp_converter->setAllocator(&resp.GetAllocator());
-                        if (resp_converter->fromJson(resp, response, error_code, error_message))
+                        if (isValidResponse(m_validator, action, resp) &&
+                            resp_converter->fromJson(resp, response, error_code, error_message))
                         {
                             ret = CallResult::Ok;
                         }
@@ -139,15 +154,15 @@ class GenericMessageSender
         if (resp_converter)
         {
             // Execute call
-            rapidjson::Document resp;
-            resp.Parse("{}");
+            ocpp::json::JsonArena arena;
+            rapidjson::Document   resp(rapidjson::kObjectType, &arena.allocator());
             if (m_rpc.call(action, request, resp, m_timeout))
             {
                 // Convert response
                 const char* error_code = nullptr;
                 std::string error_message;
                 resp_converter->setAllocator(&resp.GetAllocator());
-                if (resp_converter->fromJson(resp, response, error_code, error_message))
+                if (isValidResponse(m_validator, action, resp) && resp_converter->fromJson(resp, response, error_code, error_message))
                 {
                     ret = CallResult::Ok;
                 }
@@ -157,6 +172,98 @@ class GenericMessageSender
         return ret;
     }
 
+    /**
+     * @brief Execute a call request without waiting for its response
+     *        The completion function is called from the RPC reception thread, or from the thread
+     *        which stops the RPC, with the result of the call request and the response payload
+     *        (only valid if the result is Ok). It must not block.
+     *        A request which fails is only queued in the request FIFO from the completion function,
+     *        so the ordering of the FIFO messages is not guaranteed: transaction related messages
+     *        must be sent with call()
+     * @param action RPC action for the request
+     * @param request Request payload
+     * @param completion Function to call when the call request has been completed
+     * @param request_fifo Optional. Pointer to the request FIFO to use when messages cannot be sent.
+     * @return Ok if the request has been sent and the completion function will be called,
+     *         Delayed if the request has been queued in the request FIFO, Failed otherwise
+     */
+    template <typename RequestType, typename ResponseType>
+    CallResult callAsync(const std::string&                                   action,
+                         const RequestType&                                   request,
+                         std::function<void(CallResult, const ResponseType&)> completion,
+                         IRequestFifo*                                        request_fifo = nullptr)
+    {
+        CallResult ret = CallResult::Failed;
+
+        // Get converters
+        IMessageConverter<RequestType>*  req_converter  = m_messages_converter.getRequestConverter<RequestType>(action);
+        IMessageConverter<ResponseType>* resp_converter = m_messages_converter.getResponseConverter<ResponseType>(action);
+        if (req_converter && resp_converter)
+        {
+            // Convert request, the payload is kept until the completion to be able to queue it in the FIFO
+            std::shared_ptr<rapidjson::Document> payload = std::make_shared<rapidjson::Document>(rapidjson::kObjectType);
+            req_converter->setAllocator(&payload->GetAllocator());
+            if (req_converter->toJson(request, *payload) && isValidRequest(action, *payload))
+            {
+                // Check if request_fifo is empty
+                if (!request_fifo || (request_fifo->size() == 0))
+                {
+                    // Execute call
+                    MessagesValidator* validator       = m_validator;
+                    auto               call_completion = [action, payload, resp_converter, validator, completion, request_fifo](
+                                                             bool success, rapidjson::Document& resp)
+                    {
+                        CallResult   result = CallResult::Failed;
+                        ResponseType response;
+                        if (success)
+                        {
+                            // Convert response
+                            const char* error_code = nullptr;
+                            std::string error_message;
+                            resp_converter->setAllocator(&resp.GetAllocator());
+                            if (isValidResponse(validator, action, resp) &&
+                                resp_converter->fromJson(resp, response, error_code, error_message))
+                            {
+                                result = CallResult::Ok;
+                            }
+                        }
+                        else
+                        {
+                            // Request timed out, queue the message inside the FIFO
+                            if (request_fifo)
+                            {
+                                request_fifo->push(action, *payload);
+                                result = CallResult::Delayed;
+                            }
+                        }
+                        completion(result, response);
+                    };
+                    if (m_rpc.callAsync(action, *payload, call_completion, m_timeout))
+                    {
+                        ret = CallResult::Ok;
+                    }
+                    else
+                    {
+                        // Request cannot be sent, queue the message inside the FIFO
+                        if (request_fifo)
+                        {
+                            request_fifo->push(action, *payload);
+                            ret = CallResult::Delayed;
+                        }
+                    }
+                }
+                else
+                {
+                    // FIFO is not empty, queue the message inside the FIFO to ensure the order of the messages
+                    request_fifo->push(action, *payload);
+                    ret = CallResult::Delayed;
+                }
+            }
+        }
+
+        return ret;
+    }
+
   private:
     /** @brief RPC */
     ocpp::rpc::IRpc& m_rpc;
@@ -164,6 +271,34 @@ class GenericMessageSender
     MessagesConverter& m_messages_converter;
     /** @brief Request timeout */
     std::chrono::milliseconds m_timeout;
+    /** @brief Validator of the requests and of their responses */
+    MessagesValidator* m_validator;
+
+    /** @brief Check if a request payload can be sent */
+    bool isValidRequest(const std::string& action, const rapidjson::Value& payload)
+    {
+        bool        ret = true;
+        std::string error;
+        if (m_validator && !m_validator->isValidRequest(action, payload, error))
+        {
+            LOG_ERROR << "[" << action << "] Invalid request : " << error;
+            ret = false;
+        }
+        return ret;
+    }
+
+    /** @brief Check if a response payload can be converted */
+    static bool isValidResponse(MessagesValidator* validator, const std::string& action, const rapidjson::Value& payload)
+    {
+        bool        ret = true;
+        std::string error;
+        if (validator && !validator->isValidResponse(action, payload, error))
+        {
+            LOG_ERROR << "[" << action << "] Invalid response : " << error;
+            ret = false;
+        }
+        return ret;
+    }
 };
 
 } // namespace messages
@@ -0,0 +1,75 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "GenericMessagesConverter.h"
+#include "MessagesMembers.h"
+
+namespace ocpp
+{
+namespace messages
+{
+
+/** @brief Constructor */
+GenericMessagesConverter::GenericMessagesConverter() : m_req_converters(), m_resp_converters()
+{
+    m_req_converters.actions.resize(Actions::COUNT, nullptr);
+    m_resp_converters.actions.resize(Actions::COUNT, nullptr);
+}
+
+/** @brief Destructor */
+GenericMessagesConverter::~GenericMessagesConverter() { }
+
+/** @brief Look for the converter of an action */
+void* GenericMessagesConverter::find(const Converters& converters, const std::string& action)
+{
+    void* ret = nullptr;
+
+    // Actions described by the schemas are dispatched without hashing their name
+    unsigned int index = Actions::find(action.c_str(), action.size());
+    if (index < Actions::COUNT)
+    {
+        ret = converters.actions[index];
+    }
+    else
+    {
+        auto it = converters.others.find(action);
+        if (it != converters.others.end())
+        {
+            ret = it->second;
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Register the converter of an action */
+void GenericMessagesConverter::add(Converters& converters, const std::string& action, void* converter)
+{
+    unsigned int index = Actions::find(action.c_str(), action.size());
+    if (index < Actions::COUNT)
+    {
+        converters.actions[index] = converter;
+    }
+    else
+    {
+        converters.others[action] = converter;
+    }
+}
+
+} // namespace messages
+} // namespace ocpp
@@ -19,8 +19,10 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #ifndef GENERICMESSAGESCONVERTER_H
 #define GENERICMESSAGESCONVERTER_H
 
-#include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
+
 namespace ocpp
 {
 namespace messages
@@ -33,8 +35,11 @@ class IMessageConverter;
 class GenericMessagesConverter
 {
   public:
+    /** @brief Constructor */
+    GenericMessagesConverter();
+
     /** @brief Destructor */
-    virtual ~GenericMessagesConverter() { }
+    virtual ~GenericMessagesConverter();
 
     /**
      * @brief Get the converter for a request
@@ -44,13 +49,7 @@ class GenericMessagesConverter
     template <typename RequestType>
     IMessageConverter<RequestType>* getRequestConverter(const std::string& action) const
     {
-        IMessageConverter<RequestType>* ret = nullptr;
-        auto                            it  = m_req_converters.find(action);
-        if (it != m_req_converters.end())
-        {
-            ret = reinterpret_cast<IMessageConverter<RequestType>*>(it->second);
-        }
-        return ret;
+        return reinterpret_cast<IMessageConverter<RequestType>*>(find(m_req_converters, action));
     }
 
     /**
@@ -61,13 +60,7 @@ class GenericMessagesConverter
     template <typename ResponseType>
     IMessageConverter<ResponseType>* getResponseConverter(const std::string& action) const
     {
-        IMessageConverter<ResponseType>* ret = nullptr;
-        auto                             it  = m_resp_converters.find(action);
-        if (it != m_resp_converters.end())
-        {
-            ret = reinterpret_cast<IMessageConverter<ResponseType>*>(it->second);
-        }
-        return ret;
+        return reinterpret_cast<IMessageConverter<ResponseType>*>(find(m_resp_converters, action));
     }
 
   protected:
@@ -79,7 +72,7 @@ class GenericMessagesConverter
     template <typename RequestType>
     void registerRequestConverter(const std::string& action, IMessageConverter<RequestType>& converter)
     {
-        m_req_converters[action] = &converter;
+        add(m_req_converters, action, &converter);
     }
 
     /**
@@ -90,14 +83,28 @@ class GenericMessagesConverter
     template <typename ResponseType>
     void registerResponseConverter(const std::string& action, IMessageConverter<ResponseType>& converter)
     {
-        m_resp_converters[action] = &converter;
+        add(m_resp_converters, action, &converter);
     }
 
   private:
+    /** @brief Converters of a message type */
+    struct Converters
+    {
+        /** @brief Converters of the actions described by the JSON schemas, indexed by the generated action indexes */
+        std::vector<void*> actions;
+        /** @brief Converters of the other actions */
+        std::unordered_map<std::string, void*> others;
+    };
+
     /** @brief Request converters */
-    std::map<std::string, void*> m_req_converters;
+    Converters m_req_converters;
     /** @brief Response converters */
-    std::map<std::string, void*> m_resp_converters;
+    Converters m_resp_converters;
+
+    /** @brief Look for the converter of an action */
+    static void* find(const Converters& converters, const std::string& action);
+    /** @brief Register the converter of an action */
+    static void add(Converters& converters, const std::string& action, void* converter);
 };
 
 } // namespace messages
@@ -43,9 +43,10 @@ bool GetCompositeScheduleReqConverter::fromJson(const rapidjson::Value&  json,
 {
     bool ret = extract(json, "connectorId", data.connectorId, error_message);
     ret      = ret && extract(json, "duration", data.duration, error_message);
-    if (json.HasMember("chargingRateUnit"))
+    auto it_charging_rate_unit = json.FindMember("chargingRateUnit");
+    if (it_charging_rate_unit != json.MemberEnd())
     {
-        data.chargingRateUnit = ChargingRateUnitTypeHelper.fromString(json["chargingRateUnit"].GetString());
+        data.chargingRateUnit = ChargingRateUnitTypeHelper.fromString(it_charging_rate_unit->value.GetString());
     }
     if (!ret)
     {
@@ -75,10 +76,11 @@ bool GetCompositeScheduleConfConverter::fromJson(const rapidjson::Value&   json,
     data.status = GetCompositeScheduleStatusHelper.fromString(json["status"].GetString());
     bool ret    = extract(json, "connectorId", data.connectorId, error_message);
     ret         = ret && extract(json, "scheduleStart", data.scheduleStart, error_message);
-    if (json.HasMember("chargingSchedule"))
+    auto it_charging_schedule = json.FindMember("chargingSchedule");
+    if (it_charging_schedule != json.MemberEnd())
     {
         ChargingScheduleConverter charging_schedule_converter;
-        ret = charging_schedule_converter.fromJson(json[""], data.chargingSchedule.value(), error_code, error_message);
+        ret = charging_schedule_converter.fromJson(it_charging_schedule->value, data.chargingSchedule.value(), error_code, error_message);
     }
     if (!ret && !error_code)
     {
@@ -99,8 +101,7 @@ bool GetCompositeScheduleConfConverter::toJson(const GetCompositeScheduleConf& d
         ChargingScheduleConverter charging_schedule_converter;
         charging_schedule_converter.setAllocator(allocator);
 
-        rapidjson::Document value;
-        value.Parse("{}");
+        rapidjson::Document value(rapidjson::kObjectType, allocator);
         ret = charging_schedule_converter.toJson(data.chargingSchedule, value);
         json.AddMember(rapidjson::StringRef("chargingSchedule"), value.Move(), *allocator);
     }
@@ -32,10 +32,11 @@ bool GetConfigurationReqConverter::fromJson(const rapidjson::Value& json,
                                             const char*&            error_code,
                                             std::string&            error_message)
 {
-    if (json.HasMember("key"))
+    auto it_key = json.FindMember("key");
+    if (it_key != json.MemberEnd())
     {
         CiStringType<50u>       key;
-        const rapidjson::Value& keys      = json["key"];
+        const rapidjson::Value& keys      = it_key->value;
         auto&                   data_keys = data.key.value();
         for (auto it = keys.Begin(); it != keys.End(); ++it)
         {
@@ -72,10 +73,11 @@ bool GetConfigurationConfConverter::fromJson(const rapidjson::Value& json,
 {
     (void)error_code;
     (void)error_message;
-    if (json.HasMember("configurationKey"))
+    auto it_configuration_key = json.FindMember("configurationKey");
+    if (it_configuration_key != json.MemberEnd())
     {
         KeyValue                key_value;
-        const rapidjson::Value& configurationKey = json["configurationKey"];
+        const rapidjson::Value& configurationKey = it_configuration_key->value;
         auto&                   data_keys        = data.configurationKey.value();
         for (auto it = configurationKey.Begin(); it != configurationKey.End(); ++it)
         {
@@ -85,10 +87,11 @@ bool GetConfigurationConfConverter::fromJson(const rapidjson::Value& json,
             data_keys.push_back(key_value);
         }
     }
-    if (json.HasMember("unknownKey"))
+    auto it_unknown_key = json.FindMember("unknownKey");
+    if (it_unknown_key != json.MemberEnd())
     {
         CiStringType<50u>       key;
-        const rapidjson::Value& unknownKey = json["unknownKey"];
+        const rapidjson::Value& unknownKey = it_unknown_key->value;
         auto&                   data_keys  = data.unknownKey.value();
         for (auto it = unknownKey.Begin(); it != unknownKey.End(); ++it)
         {
@@ -108,8 +111,7 @@ bool GetConfigurationConfConverter::toJson(const GetConfigurationConf& data, rap
         rapidjson::Document::AllocatorType& allocator = json.GetAllocator();
         for (const KeyValue& key : data.configurationKey.value())
         {
-            rapidjson::Document value;
-            value.Parse("{}");
+            rapidjson::Document value(rapidjson::kObjectType, &allocator);
             fill(value, "key", key.key);
             fill(value, "readonly", key.readonly);
             fill(value, "value", key.value);
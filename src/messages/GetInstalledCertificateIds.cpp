@@ -66,9 +66,10 @@ bool GetInstalledCertificateIdsConfConverter::fromJson(const rapidjson::Value&
 {
     bool ret    = true;
     data.status = GetInstalledCertificateStatusEnumTypeHelper.fromString(json["status"].GetString());
-    if (json.HasMember("certificateHashData"))
+    auto it_certificate_hash_data = json.FindMember("certificateHashData");
+    if (it_certificate_hash_data != json.MemberEnd())
     {
-        const rapidjson::Value&          certificateHashData = json["certificateHashData"];
+        const rapidjson::Value&          certificateHashData = it_certificate_hash_data->value;
         CertificateHashDataTypeConverter certificate_hash_converter;
         for (auto it_cert = certificateHashData.Begin(); ret && (it_cert != certificateHashData.End()); ++it_cert)
         {
@@ -92,8 +93,7 @@ bool GetInstalledCertificateIdsConfConverter::toJson(const GetInstalledCertifica
         certificate_hash_converter.setAllocator(allocator);
         for (const CertificateHashDataType& certificate_hash : data.certificateHashData)
         {
-            rapidjson::Document value;
-            value.Parse("{}");
+            rapidjson::Document value(rapidjson::kObjectType, allocator);
             ret = ret && certificate_hash_converter.toJson(certificate_hash, value);
             certificateHashData.PushBack(value.Move(), *allocator);
         }
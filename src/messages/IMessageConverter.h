@@ -22,6 +22,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "CiStringType.h"
 #include "DateTime.h"
 #include "IMessageDispatcher.h"
+#include "MembersIndex.h"
 #include "Optional.h"
 
 namespace ocpp
@@ -134,25 +135,147 @@ class IMessageConverter
     }
 
     /**
-     * @brief Helper function to extract an integer value from a JSON object
+     * @brief Helper function to extract a value from a JSON object
      * @param json JSON object
      * @param field Name of the field to extract
-     * @param value Integer value extracted
+     * @param value Value extracted
+     */
+    template <typename T>
+    void extract(const rapidjson::Value& json, const char* name, T& value)
+    {
+        extractValue(json[name], value);
+    }
+
+    /**
+     * @brief Helper function to extract a value which needs to be checked from a JSON object
+     * @param json JSON object
+     * @param field Name of the field to extract
+     * @param value Value extracted
+     * @param error_message Error message to fill
+     * @return true if the value is valid, false otherwise
+     */
+    template <typename T>
+    bool extract(const rapidjson::Value& json, const char* name, T& value, std::string& error_message)
+    {
+        return extractValue(json[name], name, value, error_message);
+    }
+
+    /**
+     * @brief Helper function to extract an optional value from a JSON object
+     * @param json JSON object
+     * @param field Name of the field to extract
+     * @param value Optional value extracted
      */
-    void extract(const rapidjson::Value& json, const char* name, int& value) { value = json[name].GetInt(); }
+    template <typename T>
+    void extract(const rapidjson::Value& json, const char* name, ocpp::types::Optional<T>& value)
+    {
+        auto it = json.FindMember(name);
+        if (it != json.MemberEnd())
+        {
+            extractValue(it->value, value.value());
+        }
+    }
 
     /**
-     * @brief Helper function to extract an unsigned integer value from a JSON object
+     * @brief Helper function to extract an optional value from a JSON object
      * @param json JSON object
      * @param field Name of the field to extract
+     * @param value Optional value extracted
+     * @param error_message Error message to fill
+     * @return true if the value is not present or is valid, false otherwise
+     */
+    template <typename T>
+    bool extract(const rapidjson::Value& json, const char* name, ocpp::types::Optional<T>& value, std::string& error_message)
+    {
+        bool ret = true;
+        auto it  = json.FindMember(name);
+        if (it != json.MemberEnd())
+        {
+            ret = extractValue(it->value, name, value.value(), error_message);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Helper function to extract a value from an indexed JSON object
+     * @param members Members of the JSON object
+     * @param index Index of the member to extract
+     * @param value Value extracted
+     */
+    template <typename Members, typename T>
+    void extract(const MembersIndex<Members>& members, unsigned int index, T& value)
+    {
+        extractValue(members[index], value);
+    }
+
+    /**
+     * @brief Helper function to extract a value which needs to be checked from an indexed JSON object
+     * @param members Members of the JSON object
+     * @param index Index of the member to extract
+     * @param value Value extracted
+     * @param error_message Error message to fill
+     * @return true if the value is valid, false otherwise
+     */
+    template <typename Members, typename T>
+    bool extract(const MembersIndex<Members>& members, unsigned int index, T& value, std::string& error_message)
+    {
+        return extractValue(members[index], members.name(index), value, error_message);
+    }
+
+    /**
+     * @brief Helper function to extract an optional value from an indexed JSON object
+     * @param members Members of the JSON object
+     * @param index Index of the member to extract
+     * @param value Optional value extracted
+     */
+    template <typename Members, typename T>
+    void extract(const MembersIndex<Members>& members, unsigned int index, ocpp::types::Optional<T>& value)
+    {
+        const rapidjson::Value* member = members.find(index);
+        if (member)
+        {
+            extractValue(*member, value.value());
+        }
+    }
+
+    /**
+     * @brief Helper function to extract an optional value from an indexed JSON object
+     * @param members Members of the JSON object
+     * @param index Index of the member to extract
+     * @param value Optional value extracted
+     * @param error_message Error message to fill
+     * @return true if the value is not present or is valid, false otherwise
+     */
+    template <typename Members, typename T>
+    bool extract(const MembersIndex<Members>& members, unsigned int index, ocpp::types::Optional<T>& value, std::string& error_message)
+    {
+        bool                    ret    = true;
+        const rapidjson::Value* member = members.find(index);
+        if (member)
+        {
+            ret = extractValue(*member, members.name(index), value.value(), error_message);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Helper function to extract an integer value from a JSON value
+     * @param val JSON value
+     * @param value Integer value extracted
+     */
+    void extractValue(const rapidjson::Value& val, int& value) { value = val.GetInt(); }
+
+    /**
+     * @brief Helper function to extract an unsigned integer value from a JSON value
+     * @param val JSON value
+     * @param field Name of the field to extract
      * @param value Unsigned integer value extracted
      * @param error_message Error message to fill
      * @return true if the value is an unsigned integer, false otherwise
      */
-    bool extract(const rapidjson::Value& json, const char* name, unsigned int& value, std::string& error_message)
+    bool extractValue(const rapidjson::Value& val, const char* name, unsigned int& value, std::string& error_message)
     {
-        bool                    ret = false;
-        const rapidjson::Value& val = json[name];
+        bool ret = false;
         if (val.GetInt() >= 0)
         {
             value = val.GetUint();
@@ -167,44 +290,37 @@ class IMessageConverter
     }
 
     /**
-     * @brief Helper function to extract a floating point value from a JSON object
-     * @param json JSON object
-     * @param field Name of the field to extract
+     * @brief Helper function to extract a floating point value from a JSON value
+     * @param val JSON value
      * @param value Floating point value extracted
      */
-    void extract(const rapidjson::Value& json, const char* name, float& value) { value = json[name].GetFloat(); }
+    void extractValue(const rapidjson::Value& val, float& value) { value = val.GetFloat(); }
 
     /**
-     * @brief Helper function to extract a string value from a JSON object
-     * @param json JSON object
-     * @param field Name of the field to extract
+     * @brief Helper function to extract a string value from a JSON value
+     * @param val JSON value
      * @param value String value extracted
      */
-    void extract(const rapidjson::Value& json, const char* name, std::string& value) { value = json[name].GetString(); }
+    void extractValue(const rapidjson::Value& val, std::string& value) { value = val.GetString(); }
 
     /**
-     * @brief Helper function to extract a size limited string value from a JSON object
-     * @param json JSON object
-     * @param field Name of the field to extract
+     * @brief Helper function to extract a size limited string value from a JSON value
+     * @param val JSON value
      * @param value Size limited string value extracted
      */
-    void extract(const rapidjson::Value& json, const char* name, ocpp::types::ICiStringType& value)
-    {
-        value.assign(json[name].GetString());
-    }
+    void extractValue(const rapidjson::Value& val, ocpp::types::ICiStringType& value) { value.assign(val.GetString()); }
 
     /**
-     * @brief Helper function to extract a date and time value from a JSON object
-     * @param json JSON object
+     * @brief Helper function to extract a date and time value from a JSON value
+     * @param val JSON value
      * @param field Name of the field to extract
      * @param value Date and time value extracted
      * @param error_message Error message to fill
      * @return true if the value is a date and time, false otherwise
      */
-    bool extract(const rapidjson::Value& json, const char* name, ocpp::types::DateTime& value, std::string& error_message)
+    bool extractValue(const rapidjson::Value& val, const char* name, ocpp::types::DateTime& value, std::string& error_message)
     {
-        bool                    ret = false;
-        const rapidjson::Value& val = json[name];
+        bool ret = false;
         if (val.IsString())
         {
             ret = value.assign(val.GetString());
@@ -218,54 +334,24 @@ class IMessageConverter
     }
 
     /**
-     * @brief Helper function to extract a boolean value from a JSON object
-     * @param json JSON object
-     * @param field Name of the field to extract
+     * @brief Helper function to extract a boolean value from a JSON value
+     * @param val JSON value
      * @param value Boolean value extracted
      */
-    void extract(const rapidjson::Value& json, const char* name, bool& value) { value = json[name].GetBool(); }
+    void extractValue(const rapidjson::Value& val, bool& value) { value = val.GetBool(); }
 
-    /**
-     * @brief Helper function to extract an optional value from a JSON object
-     * @param json JSON object
-     * @param field Name of the field to extract
-     * @param value Optional value extracted
-     */
-    template <typename T>
-    void extract(const rapidjson::Value& json, const char* name, ocpp::types::Optional<T>& value)
-    {
-        if (json.HasMember(name))
-        {
-            extract(json, name, value.value());
-        }
-    }
-
-    /**
-     * @brief Helper function to extract an optional value from a JSON object
-     * @param json JSON object
-     * @param field Name of the field to extract
-     * @param value Optional value extracted
-     * @param error_message Error message to fill
-     * @return true if the value is not present or is valid, false otherwise
-     */
-    template <typename T>
-    bool extract(const rapidjson::Value& json, const char* name, ocpp::types::Optional<T>& value, std::string& error_message)
-    {
-        bool ret = true;
-        if (json.HasMember(name))
-        {
-            ret = extract(json, name, value.value(), error_message);
-        }
-        return ret;
-    }
-
-    /** @brief Set the allocator to use */
+    /** @brief Set the allocator to use for the next conversions of the calling thread */
     void setAllocator(rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>* _allocator) { allocator = _allocator; }
 
-    /** @brief Allocator */
-    rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>* allocator;
+    /** @brief Allocator, stored per thread since the converters are shared between the threads
+     *         which can convert messages of the same type at the same time on different documents */
+    static thread_local rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>* allocator;
 };
 
+/** @brief Allocator */
+template <typename DataType>
+thread_local rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>* IMessageConverter<DataType>::allocator = nullptr;
+
 /** @brief Helper macro to declare a converter class for req and conf messages
  *  @param MessageType Message type name
  */
@@ -34,6 +34,7 @@ class IMessageDispatcher
   public:
     // Forward declarations
     class IMessageHandler;
+    class IStreamHandler;
 
     /** @brief Destructor */
     virtual ~IMessageDispatcher() { }
@@ -61,6 +62,32 @@ class IMessageDispatcher
                                  const char*&            error_code,
                                  std::string&            error_message) = 0;
 
+    /**
+     * @brief Register a stream handler for a specific action
+     * @param action Action
+     * @param handler Stream handler
+     * @return false if a stream handler is already regstered for this action or if the schema
+     *         of the action cannot be loaded, true otherwise
+     */
+    virtual bool registerStreamHandler(const std::string& action, IStreamHandler& handler) = 0;
+
+    /**
+     * @brief Dispatch a received action to the registered stream handler
+     * @param action Action
+     * @param frame Received RPC frame containing the payload of the action
+     * @param size Size of the frame in bytes
+     * @param response JSON response to send
+     * @param error_code Standard error code, set to nullptr if no error
+     * @param error_msg Additionnal error message, empty if no error
+     * @return true if the call is accepted, false otherwise
+     */
+    virtual bool dispatchStreamedMessage(const std::string&   action,
+                                         const char*          frame,
+                                         size_t               size,
+                                         rapidjson::Document& response,
+                                         const char*&         error_code,
+                                         std::string&         error_message) = 0;
+
     /** @brief Interface for messages handlers implementations */
     class IMessageHandler
     {
@@ -83,6 +110,34 @@ class IMessageDispatcher
                             const char*&            error_code,
                             std::string&            error_message) = 0;
     };
+
+    /** @brief Interface for stream handlers implementations, which validate and decode the payload by themselves
+     *         with the compiled schema of the action */
+    class IStreamHandler
+    {
+      public:
+        /** @brief Destructor */
+        virtual ~IStreamHandler() { }
+
+        /**
+         * @brief Handle a received action
+         * @param action Action
+         * @param frame Received RPC frame containing the payload of the action
+         * @param size Size of the frame in bytes
+         * @param schema Compiled schema of the action's payload
+         * @param response JSON response to send
+         * @param error_code Standard error code, set to nullptr if no error
+         * @param error_msg Additionnal error message, empty if no error
+         * @return true if the call is accepted, false otherwise
+         */
+        virtual bool handleStream(const std::string&               action,
+                                  const char*                      frame,
+                                  size_t                           size,
+                                  const rapidjson::SchemaDocument& schema,
+                                  rapidjson::Document&             response,
+                                  const char*&                     error_code,
+                                  std::string&                     error_message) = 0;
+    };
 };
 
 } // namespace messages
@@ -0,0 +1,92 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MEMBERSINDEX_H
+#define MEMBERSINDEX_H
+
+#include "json.h"
+
+namespace ocpp
+{
+namespace messages
+{
+
+/** @brief Index of the members of a JSON object built in a single pass over the object
+ *
+ *  The Members type is a members table generated from the JSON schemas (see MessagesMembers.h)
+ *  which gives the index of each member name.
+ */
+template <typename Members>
+class MembersIndex
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param json JSON object to index
+     */
+    MembersIndex(const rapidjson::Value& json) : m_members()
+    {
+        for (auto it = json.MemberBegin(); it != json.MemberEnd(); ++it)
+        {
+            unsigned int index = Members::find(it->name.GetString(), it->name.GetStringLength());
+            // Keep the first occurence of a member as FindMember() does
+            if ((index < Members::COUNT) && !m_members[index])
+            {
+                m_members[index] = &it->value;
+            }
+        }
+    }
+
+    /**
+     * @brief Get a member which must be present in the JSON object
+     * @param index Index of the member
+     * @return Value of the member
+     */
+    const rapidjson::Value& operator[](unsigned int index) const
+    {
+        // Same behavior as rapidjson::Value::operator[] on a missing member
+        if (!m_members[index])
+        {
+            throw rapidjson::parse_exception("Missing member");
+        }
+        return *m_members[index];
+    }
+
+    /**
+     * @brief Look for a member of the JSON object
+     * @param index Index of the member
+     * @return Value of the member if present, nullptr otherwise
+     */
+    const rapidjson::Value* find(unsigned int index) const { return m_members[index]; }
+
+    /**
+     * @brief Get the name of a member
+     * @param index Index of the member
+     * @return Name of the member
+     */
+    static const char* name(unsigned int index) { return Members::NAMES[index]; }
+
+  private:
+    /** @brief Members values */
+    const rapidjson::Value* m_members[Members::COUNT];
+};
+
+} // namespace messages
+} // namespace ocpp
+
+#endif // MEMBERSINDEX_H
@@ -28,7 +28,7 @@ namespace messages
 {
 
 /** @brief Constructor */
-MessageDispatcher::MessageDispatcher(const std::string& schemas_path) : m_schemas_path(schemas_path), m_handlers() { }
+MessageDispatcher::MessageDispatcher(const std::string& schemas_path) : m_schemas_path(schemas_path), m_handlers(), m_stream_handlers() { }
 
 /** @brief Destructor */
 MessageDispatcher::~MessageDispatcher() { }
@@ -106,5 +106,65 @@ bool MessageDispatcher::dispatchMessage(const std::string&      action,
     return ret;
 }
 
+/** @copydoc bool IMessageDispatcher::registerStreamHandler(const std::string&, IStreamHandler&) */
+bool MessageDispatcher::registerStreamHandler(const std::string& action, IStreamHandler& handler)
+{
+    bool ret = false;
+
+    // Check if stream handler exists for this action
+    if (m_stream_handlers.find(action) == m_stream_handlers.end())
+    {
+        // Load the payload schema, the payload is validated by the handler itself with this schema
+        std::shared_ptr<ocpp::json::JsonValidator> validator = std::make_shared<ocpp::json::JsonValidator>();
+        std::filesystem::path                      filepath(m_schemas_path);
+        filepath.append(action + ".json");
+        if (validator->init(filepath))
+        {
+            LOG_DEBUG << "[" << action << "] Stream validator loaded : " << filepath;
+
+            // Add stream handler
+            m_stream_handlers[action] = std::make_pair(validator, &handler);
+            ret                       = true;
+        }
+        else
+        {
+            LOG_ERROR << "[" << action << "] Unable to load stream validator : " << filepath;
+        }
+    }
+
+    return ret;
+}
+
+/** @copydoc bool IMessageDispatcher::dispatchStreamedMessage(const std::string&,
+                                                                  const char*,
+                                                                  size_t,
+                                                                  rapidjson::Document&,
+                                                                  const char*&,
+                                                                  std::string&) */
+bool MessageDispatcher::dispatchStreamedMessage(const std::string&   action,
+                                                const char*          frame,
+                                                size_t               size,
+                                                rapidjson::Document& response,
+                                                const char*&         error_code,
+                                                std::string&         error_message)
+{
+    bool ret = false;
+
+    // Look for a stream handler
+    auto it = m_stream_handlers.find(action);
+    if (it != m_stream_handlers.end())
+    {
+        auto& handler_data = it->second;
+        ret                = handler_data.second->handleStream(action, frame, size, *handler_data.first->schema(), response, error_code, error_message);
+    }
+    else
+    {
+        // Not implemented
+        error_code = ocpp::rpc::IRpc::RPC_ERROR_NOT_IMPLEMENTED;
+    }
+
+    return ret;
+}
+
 } // namespace messages
 } // namespace ocpp
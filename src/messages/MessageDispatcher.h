@@ -56,11 +56,29 @@ class MessageDispatcher : public IMessageDispatcher
                          const char*&            error_code,
                          std::string&            error_message) override;
 
+    /** @copydoc bool IMessageDispatcher::registerStreamHandler(const std::string&, IStreamHandler&) */
+    bool registerStreamHandler(const std::string& action, IStreamHandler& handler) override;
+
+    /** @copydoc bool IMessageDispatcher::dispatchStreamedMessage(const std::string&,
+                                                                  const char*,
+                                                                  size_t,
+                                                                  rapidjson::Document&,
+                                                                  const char*&,
+                                                                  std::string&) */
+    bool dispatchStreamedMessage(const std::string&   action,
+                                 const char*          frame,
+                                 size_t               size,
+                                 rapidjson::Document& response,
+                                 const char*&         error_code,
+                                 std::string&         error_message) override;
+
   private:
     /** @brief Path to the JSON schemas needed to validate payloads */
     const std::string m_schemas_path;
     /** @brief Handlers */
     std::map<std::string, std::pair<std::shared_ptr<ocpp::json::JsonValidator>, IMessageHandler*>> m_handlers;
+    /** @brief Stream handlers */
+    std::map<std::string, std::pair<std::shared_ptr<ocpp::json::JsonValidator>, IStreamHandler*>> m_stream_handlers;
 };
 
 } // namespace messages
@@ -0,0 +1,676 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Generated by converters_generator from the OCPP JSON schemas, do not edit */
+
+#include "MessagesMembers.h"
+
+#include <cstring>
+
+namespace ocpp
+{
+namespace messages
+{
+
+/** @brief Names */
+const char* const Actions::NAMES[Actions::COUNT] = {
+    "Authorize",
+    "BootNotification",
+    "CancelReservation",
+    "ChangeAvailability",
+    "ChangeConfiguration",
+    "ClearCache",
+    "ClearChargingProfile",
+    "DataTransfer",
+    "DiagnosticsStatusNotification",
+    "FirmwareStatusNotification",
+    "GetCompositeSchedule",
+    "GetConfiguration",
+    "GetDiagnostics",
+    "GetLocalListVersion",
+    "Heartbeat",
+    "MeterValues",
+    "RemoteStartTransaction",
+    "RemoteStopTransaction",
+    "ReserveNow",
+    "Reset",
+    "SendLocalList",
+    "SetChargingProfile",
+    "StartTransaction",
+    "StatusNotification",
+    "StopTransaction",
+    "TriggerMessage",
+    "UnlockConnector",
+    "UpdateFirmware",
+};
+
+/** @brief Get the index of a name */
+unsigned int Actions::find(const char* name, size_t length)
+{
+    unsigned int ret = COUNT;
+    switch (length)
+    {
+        case 5u:
+        {
+            if (memcmp(name, "Reset", 5u) == 0)
+            {
+                ret = Reset;
+            }
+            break;
+        }
+        case 9u:
+        {
+            switch (name[0])
+            {
+                case 'A':
+                {
+                    if (memcmp(name, "Authorize", 9u) == 0)
+                    {
+                        ret = Authorize;
+                    }
+                    break;
+                }
+                case 'H':
+                {
+                    if (memcmp(name, "Heartbeat", 9u) == 0)
+                    {
+                        ret = Heartbeat;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 10u:
+        {
+            switch (name[0])
+            {
+                case 'C':
+                {
+                    if (memcmp(name, "ClearCache", 10u) == 0)
+                    {
+                        ret = ClearCache;
+                    }
+                    break;
+                }
+                case 'R':
+                {
+                    if (memcmp(name, "ReserveNow", 10u) == 0)
+                    {
+                        ret = ReserveNow;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 11u:
+        {
+            if (memcmp(name, "MeterValues", 11u) == 0)
+            {
+                ret = MeterValues;
+            }
+            break;
+        }
+        case 12u:
+        {
+            if (memcmp(name, "DataTransfer", 12u) == 0)
+            {
+                ret = DataTransfer;
+            }
+            break;
+        }
+        case 13u:
+        {
+            if (memcmp(name, "SendLocalList", 13u) == 0)
+            {
+                ret = SendLocalList;
+            }
+            break;
+        }
+        case 14u:
+        {
+            switch (name[0])
+            {
+                case 'G':
+                {
+                    if (memcmp(name, "GetDiagnostics", 14u) == 0)
+                    {
+                        ret = GetDiagnostics;
+                    }
+                    break;
+                }
+                case 'T':
+                {
+                    if (memcmp(name, "TriggerMessage", 14u) == 0)
+                    {
+                        ret = TriggerMessage;
+                    }
+                    break;
+                }
+                case 'U':
+                {
+                    if (memcmp(name, "UpdateFirmware", 14u) == 0)
+                    {
+                        ret = UpdateFirmware;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 15u:
+        {
+            switch (name[0])
+            {
+                case 'S':
+                {
+                    if (memcmp(name, "StopTransaction", 15u) == 0)
+                    {
+                        ret = StopTransaction;
+                    }
+                    break;
+                }
+                case 'U':
+                {
+                    if (memcmp(name, "UnlockConnector", 15u) == 0)
+                    {
+                        ret = UnlockConnector;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 16u:
+        {
+            switch (name[0])
+            {
+                case 'B':
+                {
+                    if (memcmp(name, "BootNotification", 16u) == 0)
+                    {
+                        ret = BootNotification;
+                    }
+                    break;
+                }
+                case 'G':
+                {
+                    if (memcmp(name, "GetConfiguration", 16u) == 0)
+                    {
+                        ret = GetConfiguration;
+                    }
+                    break;
+                }
+                case 'S':
+                {
+                    if (memcmp(name, "StartTransaction", 16u) == 0)
+                    {
+                        ret = StartTransaction;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 17u:
+        {
+            if (memcmp(name, "CancelReservation", 17u) == 0)
+            {
+                ret = CancelReservation;
+            }
+            break;
+        }
+        case 18u:
+        {
+            switch (name[1])
+            {
+                case 'e':
+                {
+                    if (memcmp(name, "SetChargingProfile", 18u) == 0)
+                    {
+                        ret = SetChargingProfile;
+                    }
+                    break;
+                }
+                case 'h':
+                {
+                    if (memcmp(name, "ChangeAvailability", 18u) == 0)
+                    {
+                        ret = ChangeAvailability;
+                    }
+                    break;
+                }
+                case 't':
+                {
+                    if (memcmp(name, "StatusNotification", 18u) == 0)
+                    {
+                        ret = StatusNotification;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 19u:
+        {
+            switch (name[0])
+            {
+                case 'C':
+                {
+                    if (memcmp(name, "ChangeConfiguration", 19u) == 0)
+                    {
+                        ret = ChangeConfiguration;
+                    }
+                    break;
+                }
+                case 'G':
+                {
+                    if (memcmp(name, "GetLocalListVersion", 19u) == 0)
+                    {
+                        ret = GetLocalListVersion;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 20u:
+        {
+            switch (name[0])
+            {
+                case 'C':
+                {
+                    if (memcmp(name, "ClearChargingProfile", 20u) == 0)
+                    {
+                        ret = ClearChargingProfile;
+                    }
+                    break;
+                }
+                case 'G':
+                {
+                    if (memcmp(name, "GetCompositeSchedule", 20u) == 0)
+                    {
+                        ret = GetCompositeSchedule;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 21u:
+        {
+            if (memcmp(name, "RemoteStopTransaction", 21u) == 0)
+            {
+                ret = RemoteStopTransaction;
+            }
+            break;
+        }
+        case 22u:
+        {
+            if (memcmp(name, "RemoteStartTransaction", 22u) == 0)
+            {
+                ret = RemoteStartTransaction;
+            }
+            break;
+        }
+        case 26u:
+        {
+            if (memcmp(name, "FirmwareStatusNotification", 26u) == 0)
+            {
+                ret = FirmwareStatusNotification;
+            }
+            break;
+        }
+        case 29u:
+        {
+            if (memcmp(name, "DiagnosticsStatusNotification", 29u) == 0)
+            {
+                ret = DiagnosticsStatusNotification;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return ret;
+}
+
+/** @brief Names */
+const char* const MeterValuesReqMembers::NAMES[MeterValuesReqMembers::COUNT] = {
+    "connectorId",
+    "transactionId",
+    "meterValue",
+};
+
+/** @brief Get the index of a name */
+unsigned int MeterValuesReqMembers::find(const char* name, size_t length)
+{
+    unsigned int ret = COUNT;
+    switch (length)
+    {
+        case 10u:
+        {
+            if (memcmp(name, "meterValue", 10u) == 0)
+            {
+                ret = meterValue;
+            }
+            break;
+        }
+        case 11u:
+        {
+            if (memcmp(name, "connectorId", 11u) == 0)
+            {
+                ret = connectorId;
+            }
+            break;
+        }
+        case 13u:
+        {
+            if (memcmp(name, "transactionId", 13u) == 0)
+            {
+                ret = transactionId;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return ret;
+}
+
+/** @brief Names */
+const char* const MeterValueMembers::NAMES[MeterValueMembers::COUNT] = {
+    "timestamp",
+    "sampledValue",
+};
+
+/** @brief Get the index of a name */
+unsigned int MeterValueMembers::find(const char* name, size_t length)
+{
+    unsigned int ret = COUNT;
+    switch (length)
+    {
+        case 9u:
+        {
+            if (memcmp(name, "timestamp", 9u) == 0)
+            {
+                ret = timestamp;
+            }
+            break;
+        }
+        case 12u:
+        {
+            if (memcmp(name, "sampledValue", 12u) == 0)
+            {
+                ret = sampledValue;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return ret;
+}
+
+/** @brief Names */
+const char* const SampledValueMembers::NAMES[SampledValueMembers::COUNT] = {
+    "value",
+    "context",
+    "format",
+    "measurand",
+    "phase",
+    "location",
+    "unit",
+};
+
+/** @brief Get the index of a name */
+unsigned int SampledValueMembers::find(const char* name, size_t length)
+{
+    unsigned int ret = COUNT;
+    switch (length)
+    {
+        case 4u:
+        {
+            if (memcmp(name, "unit", 4u) == 0)
+            {
+                ret = unit;
+            }
+            break;
+        }
+        case 5u:
+        {
+            switch (name[0])
+            {
+                case 'p':
+                {
+                    if (memcmp(name, "phase", 5u) == 0)
+                    {
+                        ret = phase;
+                    }
+                    break;
+                }
+                case 'v':
+                {
+                    if (memcmp(name, "value", 5u) == 0)
+                    {
+                        ret = value;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 6u:
+        {
+            if (memcmp(name, "format", 6u) == 0)
+            {
+                ret = format;
+            }
+            break;
+        }
+        case 7u:
+        {
+            if (memcmp(name, "context", 7u) == 0)
+            {
+                ret = context;
+            }
+            break;
+        }
+        case 8u:
+        {
+            if (memcmp(name, "location", 8u) == 0)
+            {
+                ret = location;
+            }
+            break;
+        }
+        case 9u:
+        {
+            if (memcmp(name, "measurand", 9u) == 0)
+            {
+                ret = measurand;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return ret;
+}
+
+/** @brief Names */
+const char* const StartTransactionReqMembers::NAMES[StartTransactionReqMembers::COUNT] = {
+    "connectorId",
+    "idTag",
+    "meterStart",
+    "reservationId",
+    "timestamp",
+};
+
+/** @brief Get the index of a name */
+unsigned int StartTransactionReqMembers::find(const char* name, size_t length)
+{
+    unsigned int ret = COUNT;
+    switch (length)
+    {
+        case 5u:
+        {
+            if (memcmp(name, "idTag", 5u) == 0)
+            {
+                ret = idTag;
+            }
+            break;
+        }
+        case 9u:
+        {
+            if (memcmp(name, "timestamp", 9u) == 0)
+            {
+                ret = timestamp;
+            }
+            break;
+        }
+        case 10u:
+        {
+            if (memcmp(name, "meterStart", 10u) == 0)
+            {
+                ret = meterStart;
+            }
+            break;
+        }
+        case 11u:
+        {
+            if (memcmp(name, "connectorId", 11u) == 0)
+            {
+                ret = connectorId;
+            }
+            break;
+        }
+        case 13u:
+        {
+            if (memcmp(name, "reservationId", 13u) == 0)
+            {
+                ret = reservationId;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return ret;
+}
+
+/** @brief Names */
+const char* const StopTransactionReqMembers::NAMES[StopTransactionReqMembers::COUNT] = {
+    "idTag",
+    "meterStop",
+    "timestamp",
+    "transactionId",
+    "reason",
+    "transactionData",
+};
+
+/** @brief Get the index of a name */
+unsigned int StopTransactionReqMembers::find(const char* name, size_t length)
+{
+    unsigned int ret = COUNT;
+    switch (length)
+    {
+        case 5u:
+        {
+            if (memcmp(name, "idTag", 5u) == 0)
+            {
+                ret = idTag;
+            }
+            break;
+        }
+        case 6u:
+        {
+            if (memcmp(name, "reason", 6u) == 0)
+            {
+                ret = reason;
+            }
+            break;
+        }
+        case 9u:
+        {
+            switch (name[0])
+            {
+                case 'm':
+                {
+                    if (memcmp(name, "meterStop", 9u) == 0)
+                    {
+                        ret = meterStop;
+                    }
+                    break;
+                }
+                case 't':
+                {
+                    if (memcmp(name, "timestamp", 9u) == 0)
+                    {
+                        ret = timestamp;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            break;
+        }
+        case 13u:
+        {
+            if (memcmp(name, "transactionId", 13u) == 0)
+            {
+                ret = transactionId;
+            }
+            break;
+        }
+        case 15u:
+        {
+            if (memcmp(name, "transactionData", 15u) == 0)
+            {
+                ret = transactionData;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return ret;
+}
+
+} // namespace messages
+} // namespace ocpp
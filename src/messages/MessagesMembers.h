@@ -0,0 +1,211 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Generated by converters_generator from the OCPP JSON schemas, do not edit */
+
+#ifndef MESSAGESMEMBERS_H
+#define MESSAGESMEMBERS_H
+
+#include <cstddef>
+
+namespace ocpp
+{
+namespace messages
+{
+
+/** @brief Actions described by the schemas */
+struct Actions
+{
+    /** @brief Indexes */
+    enum : unsigned int
+    {
+        Authorize,
+        BootNotification,
+        CancelReservation,
+        ChangeAvailability,
+        ChangeConfiguration,
+        ClearCache,
+        ClearChargingProfile,
+        DataTransfer,
+        DiagnosticsStatusNotification,
+        FirmwareStatusNotification,
+        GetCompositeSchedule,
+        GetConfiguration,
+        GetDiagnostics,
+        GetLocalListVersion,
+        Heartbeat,
+        MeterValues,
+        RemoteStartTransaction,
+        RemoteStopTransaction,
+        ReserveNow,
+        Reset,
+        SendLocalList,
+        SetChargingProfile,
+        StartTransaction,
+        StatusNotification,
+        StopTransaction,
+        TriggerMessage,
+        UnlockConnector,
+        UpdateFirmware,
+        COUNT
+    };
+
+    /** @brief Names */
+    static const char* const NAMES[COUNT];
+
+    /**
+     * @brief Get the index of a name
+     * @param name Name (not null terminated)
+     * @param length Length of the name in bytes
+     * @return Index of the name, COUNT if the name is unknown
+     */
+    static unsigned int find(const char* name, size_t length);
+};
+
+/** @brief Members of the MeterValues request payload */
+struct MeterValuesReqMembers
+{
+    /** @brief Indexes */
+    enum : unsigned int
+    {
+        connectorId,
+        transactionId,
+        meterValue,
+        COUNT
+    };
+
+    /** @brief Names */
+    static const char* const NAMES[COUNT];
+
+    /**
+     * @brief Get the index of a name
+     * @param name Name (not null terminated)
+     * @param length Length of the name in bytes
+     * @return Index of the name, COUNT if the name is unknown
+     */
+    static unsigned int find(const char* name, size_t length);
+};
+
+/** @brief Members of the meterValue objects */
+struct MeterValueMembers
+{
+    /** @brief Indexes */
+    enum : unsigned int
+    {
+        timestamp,
+        sampledValue,
+        COUNT
+    };
+
+    /** @brief Names */
+    static const char* const NAMES[COUNT];
+
+    /**
+     * @brief Get the index of a name
+     * @param name Name (not null terminated)
+     * @param length Length of the name in bytes
+     * @return Index of the name, COUNT if the name is unknown
+     */
+    static unsigned int find(const char* name, size_t length);
+};
+
+/** @brief Members of the sampledValue objects */
+struct SampledValueMembers
+{
+    /** @brief Indexes */
+    enum : unsigned int
+    {
+        value,
+        context,
+        format,
+        measurand,
+        phase,
+        location,
+        unit,
+        COUNT
+    };
+
+    /** @brief Names */
+    static const char* const NAMES[COUNT];
+
+    /**
+     * @brief Get the index of a name
+     * @param name Name (not null terminated)
+     * @param length Length of the name in bytes
+     * @return Index of the name, COUNT if the name is unknown
+     */
+    static unsigned int find(const char* name, size_t length);
+};
+
+/** @brief Members of the StartTransaction request payload */
+struct StartTransactionReqMembers
+{
+    /** @brief Indexes */
+    enum : unsigned int
+    {
+        connectorId,
+        idTag,
+        meterStart,
+        reservationId,
+        timestamp,
+        COUNT
+    };
+
+    /** @brief Names */
+    static const char* const NAMES[COUNT];
+
+    /**
+     * @brief Get the index of a name
+     * @param name Name (not null terminated)
+     * @param length Length of the name in bytes
+     * @return Index of the name, COUNT if the name is unknown
+     */
+    static unsigned int find(const char* name, size_t length);
+};
+
+/** @brief Members of the StopTransaction request payload */
+struct StopTransactionReqMembers
+{
+    /** @brief Indexes */
+    enum : unsigned int
+    {
+        idTag,
+        meterStop,
+        timestamp,
+        transactionId,
+        reason,
+        transactionData,
+        COUNT
+    };
+
+    /** @brief Names */
+    static const char* const NAMES[COUNT];
+
+    /**
+     * @brief Get the index of a name
+     * @param name Name (not null terminated)
+     * @param length Length of the name in bytes
+     * @return Index of the name, COUNT if the name is unknown
+     */
+    static unsigned int find(const char* name, size_t length);
+};
+
+} // namespace messages
+} // namespace ocpp
+
+#endif // MESSAGESMEMBERS_H
@@ -0,0 +1,212 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "MessagesValidator.h"
+#include "Logger.h"
+#include "String.h"
+
+#include <filesystem>
+
+using namespace ocpp::helpers;
+
+namespace ocpp
+{
+namespace messages
+{
+
+/** @brief Constructor */
+MessagesValidator::MessagesValidator(const std::string& schemas_path, unsigned int sampling_period)
+    : m_schemas_path(schemas_path),
+      m_sampling_period((sampling_period != 0) ? sampling_period : 1u),
+      m_default_policy(ValidationPolicy::Off),
+      m_policies(),
+      m_mutex(),
+      m_validators()
+{
+}
+
+/** @brief Destructor */
+MessagesValidator::~MessagesValidator() { }
+
+/** @brief Configure the policies from a string */
+bool MessagesValidator::configure(const std::string& policies)
+{
+    bool ret = true;
+
+    std::vector<std::string> items = split(policies, ',');
+    for (size_t i = 0; ret && (i < items.size()); i++)
+    {
+        std::string item = items[i];
+        trim(item);
+
+        ValidationPolicy policy;
+        size_t           pos = item.find('=');
+        if (pos == std::string::npos)
+        {
+            // Default policy
+            ret = policyFromString(item, policy);
+            if (ret)
+            {
+                m_default_policy = policy;
+            }
+        }
+        else
+        {
+            // Policy of an action
+            std::string action = item.substr(0, pos);
+            std::string value  = item.substr(pos + 1u);
+            trim(action);
+            trim(value);
+            ret = !action.empty() && policyFromString(value, policy);
+            if (ret)
+            {
+                m_policies[action] = policy;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Get the policy of an action */
+ValidationPolicy MessagesValidator::getPolicy(const std::string& action) const
+{
+    ValidationPolicy policy = m_default_policy;
+    auto             it     = m_policies.find(action);
+    if (it != m_policies.end())
+    {
+        policy = it->second;
+    }
+    return policy;
+}
+
+/** @brief Validate a request payload */
+bool MessagesValidator::isValidRequest(const std::string& action, const rapidjson::Value& payload, std::string& error)
+{
+    return isValid(action, action, payload, error);
+}
+
+/** @brief Validate a response payload */
+bool MessagesValidator::isValidResponse(const std::string& action, const rapidjson::Value& payload, std::string& error)
+{
+    return isValid(action, action + "Response", payload, error);
+}
+
+/** @brief Convert a string into a validation policy */
+bool MessagesValidator::policyFromString(const std::string& str, ValidationPolicy& policy)
+{
+    bool ret = true;
+    if (str == "off")
+    {
+        policy = ValidationPolicy::Off;
+    }
+    else if (str == "sampled")
+    {
+        policy = ValidationPolicy::Sampled;
+    }
+    else if (str == "full")
+    {
+        policy = ValidationPolicy::Full;
+    }
+    else
+    {
+        ret = false;
+    }
+    return ret;
+}
+
+/** @brief Validate a payload against a schema */
+bool MessagesValidator::isValid(const std::string&      action,
+                                const std::string&      schema_name,
+                                const rapidjson::Value& payload,
+                                std::string&            error)
+{
+    bool ret = true;
+
+    ValidationPolicy policy = getPolicy(action);
+    if (policy != ValidationPolicy::Off)
+    {
+        SchemaValidator* validator = getValidator(schema_name);
+        if (validator)
+        {
+            // Check if the payload must be validated
+            bool check = true;
+            if (policy == ValidationPolicy::Sampled)
+            {
+                check = ((validator->count.fetch_add(1u, std::memory_order_relaxed) % m_sampling_period) == 0);
+            }
+            if (check)
+            {
+                if (validator->fast)
+                {
+                    const char* keyword = "";
+                    ret                 = validator->fast(payload, keyword);
+                    if (!ret)
+                    {
+                        error = "Invalid '" + std::string(keyword) + "' keyword";
+                    }
+                }
+                else
+                {
+                    ret = validator->generic->isValid(payload);
+                    if (!ret)
+                    {
+                        error = validator->generic->lastError();
+                    }
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Get the validator of a schema, load it if needed */
+MessagesValidator::SchemaValidator* MessagesValidator::getValidator(const std::string& schema_name)
+{
+    SchemaValidator* validator = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_validators.find(schema_name);
+    if (it == m_validators.end())
+    {
+        std::unique_ptr<SchemaValidator> new_validator = std::make_unique<SchemaValidator>();
+        new_validator->fast                            = getFastValidator(schema_name);
+        new_validator->count                           = 0;
+        if (!new_validator->fast)
+        {
+            // Load the schema file, the messages without schema are not validated
+            std::filesystem::path filepath(m_schemas_path);
+            filepath.append(schema_name + ".json");
+            new_validator->generic = std::make_unique<ocpp::json::JsonValidator>();
+            if (!new_validator->generic->init(filepath))
+            {
+                LOG_WARNING << "[" << schema_name << "] Unable to load validator : " << filepath;
+                new_validator.reset();
+            }
+        }
+        it = m_validators.emplace(schema_name, std::move(new_validator)).first;
+    }
+    validator = it->second.get();
+
+    return validator;
+}
+
+} // namespace messages
+} // namespace ocpp
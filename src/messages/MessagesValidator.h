@@ -0,0 +1,142 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MESSAGESVALIDATOR_H
+#define MESSAGESVALIDATOR_H
+
+#include "FastValidators.h"
+#include "JsonValidator.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ocpp
+{
+namespace messages
+{
+
+/** @brief Validation policy of the messages of an action */
+enum class ValidationPolicy
+{
+    /** @brief Messages are not validated */
+    Off,
+    /** @brief Only 1 message out of the sampling period is validated */
+    Sampled,
+    /** @brief All the messages are validated */
+    Full
+};
+
+/**
+ * @brief Validator of the outgoing requests and of their responses
+ *
+ *  The policy is configured per action. Actions having a fast validator are checked
+ *  without walking the generic JSON schema, the others use the schema files.
+ */
+class MessagesValidator
+{
+  public:
+    /** @brief Default sampling period */
+    static constexpr unsigned int DEFAULT_SAMPLING_PERIOD = 16u;
+
+    /**
+     * @brief Constructor
+     * @param schemas_path Path to the JSON schemas needed to validate payloads
+     * @param sampling_period Number of messages of an action between 2 validations with the Sampled policy
+     */
+    MessagesValidator(const std::string& schemas_path, unsigned int sampling_period = DEFAULT_SAMPLING_PERIOD);
+
+    /** @brief Destructor */
+    virtual ~MessagesValidator();
+
+    /**
+     * @brief Configure the policies from a string
+     *        Format : default policy followed by optional per action policies (ex: sampled,Authorize=full,MeterValues=off)
+     *        Must be called before any validation
+     * @param policies Policies to apply
+     * @return true if the string is valid, false otherwise
+     */
+    bool configure(const std::string& policies);
+
+    /** @brief Set the policy of the actions which have no specific policy */
+    void setDefaultPolicy(ValidationPolicy policy) { m_default_policy = policy; }
+
+    /** @brief Set the policy of an action, must be called before any validation */
+    void setPolicy(const std::string& action, ValidationPolicy policy) { m_policies[action] = policy; }
+
+    /** @brief Get the policy of an action */
+    ValidationPolicy getPolicy(const std::string& action) const;
+
+    /**
+     * @brief Validate a request payload
+     * @param action RPC action of the request
+     * @param payload Request payload
+     * @param error Error message if the payload is invalid
+     * @return true if the payload is valid or has not been checked, false otherwise
+     */
+    bool isValidRequest(const std::string& action, const rapidjson::Value& payload, std::string& error);
+
+    /**
+     * @brief Validate a response payload
+     * @param action RPC action of the request
+     * @param payload Response payload
+     * @param error Error message if the payload is invalid
+     * @return true if the payload is valid or has not been checked, false otherwise
+     */
+    bool isValidResponse(const std::string& action, const rapidjson::Value& payload, std::string& error);
+
+    /** @brief Convert a string into a validation policy */
+    static bool policyFromString(const std::string& str, ValidationPolicy& policy);
+
+  private:
+    /** @brief Validator of a JSON schema */
+    struct SchemaValidator
+    {
+        /** @brief Fast validator, nullptr if not available */
+        FastValidator fast;
+        /** @brief Generic validator, nullptr if the fast validator is available */
+        std::unique_ptr<ocpp::json::JsonValidator> generic;
+        /** @brief Number of messages received for the Sampled policy */
+        std::atomic<unsigned int> count;
+    };
+
+    /** @brief Path to the JSON schemas needed to validate payloads */
+    const std::string m_schemas_path;
+    /** @brief Sampling period */
+    const unsigned int m_sampling_period;
+    /** @brief Policy of the actions which have no specific policy */
+    ValidationPolicy m_default_policy;
+    /** @brief Policies per action */
+    std::unordered_map<std::string, ValidationPolicy> m_policies;
+    /** @brief Mutex to protect the validators */
+    std::mutex m_mutex;
+    /** @brief Validators per schema name, loaded on first use */
+    std::unordered_map<std::string, std::unique_ptr<SchemaValidator>> m_validators;
+
+    /** @brief Validate a payload against a schema */
+    bool isValid(const std::string& action, const std::string& schema_name, const rapidjson::Value& payload, std::string& error);
+    /** @brief Get the validator of a schema, load it if needed */
+    SchemaValidator* getValidator(const std::string& schema_name);
+};
+
+} // namespace messages
+} // namespace ocpp
+
+#endif // MESSAGESVALIDATOR_H
@@ -18,6 +18,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 
 #include "MeterValues.h"
 #include "IRpc.h"
+#include "MessagesMembers.h"
 #include "MeterValueConverter.h"
 
 using namespace ocpp::types;
@@ -102,10 +103,12 @@ bool MeterValuesReqConverter::fromJson(const rapidjson::Value& json,
                                        const char*&            error_code,
                                        std::string&            error_message)
 {
-    bool ret = extract(json, "connectorId", data.connectorId, error_message);
-    extract(json, "transactionId", data.transactionId);
+    MembersIndex<MeterValuesReqMembers> members(json);
 
-    const rapidjson::Value& meterValue = json["meterValue"];
+    bool ret = extract(members, MeterValuesReqMembers::connectorId, data.connectorId, error_message);
+    extract(members, MeterValuesReqMembers::transactionId, data.transactionId);
+
+    const rapidjson::Value& meterValue = members[MeterValuesReqMembers::meterValue];
     MeterValueConverter     metervalue_converter;
     for (auto it_meter = meterValue.Begin(); ret && (it_meter != meterValue.End()); ++it_meter)
     {
@@ -129,8 +132,7 @@ bool MeterValuesReqConverter::toJson(const MeterValuesReq& data, rapidjson::Docu
     metervalue_converter.setAllocator(allocator);
     for (const MeterValue& meter_value : data.meterValue)
     {
-        rapidjson::Document value;
-        value.Parse("{}");
+        rapidjson::Document value(rapidjson::kObjectType, allocator);
         ret = ret && metervalue_converter.toJson(meter_value, value);
         meterValue.PushBack(value.Move(), *allocator);
     }
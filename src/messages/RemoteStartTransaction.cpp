@@ -47,10 +47,11 @@ bool RemoteStartTransactionReqConverter::fromJson(const rapidjson::Value&    jso
         error_message = "connectorId field must be > 0";
     }
     extract(json, "idTag", data.idTag);
-    if (json.HasMember("chargingProfile"))
+    auto it_charging_profile = json.FindMember("chargingProfile");
+    if (it_charging_profile != json.MemberEnd())
     {
         ChargingProfileConverter charging_profile_converter;
-        ret = ret && charging_profile_converter.fromJson(json["chargingProfile"], data.chargingProfile, error_code, error_message);
+        ret = ret && charging_profile_converter.fromJson(it_charging_profile->value, data.chargingProfile, error_code, error_message);
     }
     if (!ret)
     {
@@ -70,8 +71,7 @@ bool RemoteStartTransactionReqConverter::toJson(const RemoteStartTransactionReq&
         ChargingProfileConverter charging_profile_converter;
         charging_profile_converter.setAllocator(allocator);
 
-        rapidjson::Document chargingProfile;
-        chargingProfile.Parse("{}");
+        rapidjson::Document chargingProfile(rapidjson::kObjectType, allocator);
 
         ret = charging_profile_converter.toJson(data.chargingProfile, chargingProfile);
         json.AddMember(rapidjson::StringRef("chargingProfile"), chargingProfile.Move(), *allocator);
@@ -46,11 +46,12 @@ bool SendLocalListReqConverter::fromJson(const rapidjson::Value& json,
 {
     bool ret = true;
     extract(json, "listVersion", data.listVersion);
-    if (json.HasMember(""))
+    auto it_list = json.FindMember("localAuthorizationList");
+    if (it_list != json.MemberEnd())
     {
         AuthorizationDataConverter      authorization_data_converter;
         std::vector<AuthorizationData>& local_authorization_list = data.localAuthorizationList;
-        const rapidjson::Value&         localAuthorizationList   = json["localAuthorizationList"];
+        const rapidjson::Value&         localAuthorizationList   = it_list->value;
         for (auto it_authorization_data = localAuthorizationList.Begin(); ret && (it_authorization_data != localAuthorizationList.End());
              ++it_authorization_data)
         {
@@ -75,8 +76,7 @@ bool SendLocalListReqConverter::toJson(const SendLocalListReq& data, rapidjson::
         rapidjson::Value localAuthorizationList(rapidjson::kArrayType);
         for (const AuthorizationData& authorization_data : data.localAuthorizationList)
         {
-            rapidjson::Document value;
-            value.Parse("{}");
+            rapidjson::Document value(rapidjson::kObjectType, allocator);
             ret = ret && authorization_data_converter.toJson(authorization_data, value);
             localAuthorizationList.PushBack(value.Move(), *allocator);
         }
@@ -0,0 +1,496 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SendLocalListStreamDecoder.h"
+#include "IRpc.h"
+
+#include <limits>
+#include <string_view>
+
+using namespace ocpp::types;
+
+namespace ocpp
+{
+namespace messages
+{
+
+namespace
+{
+
+/** @brief Decoding levels inside the request payload */
+enum class Level
+{
+    /** @brief Events are ignored */
+    Ignored,
+    /** @brief Before the payload */
+    Root,
+    /** @brief Inside the request payload */
+    Payload,
+    /** @brief Inside the local authorization list */
+    List,
+    /** @brief Inside an AuthorizationData object */
+    Entry,
+    /** @brief Inside an IdTagInfo object */
+    IdTagInfo,
+    /** @brief After the payload */
+    Done
+};
+
+/** @brief SAX handler decoding a SendLocalList payload
+ *
+ *  The events it receives have already been validated against the SendLocalList schema,
+ *  so it only decodes the values.
+ */
+class PayloadDecoder : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, PayloadDecoder>
+{
+  public:
+    /** @brief Default constructor, needed by the schema validator for its internal validators, the events are ignored */
+    PayloadDecoder() : PayloadDecoder(nullptr, 0, nullptr) { m_level = Level::Ignored; }
+
+    /**
+     * @brief Constructor
+     * @param request Request to fill
+     * @param chunk_size Maximum number of entries in a chunk
+     * @param chunk_handler Function to call for each chunk, nullptr to only decode the fields of the request
+     */
+    PayloadDecoder(SendLocalListReq* request, size_t chunk_size, const SendLocalListStreamDecoder::ChunkHandler* chunk_handler)
+        : entries_count(0),
+          error_message(),
+          m_request(request),
+          m_chunk_size(chunk_size),
+          m_chunk_handler(chunk_handler),
+          m_chunk(),
+          m_level(Level::Root),
+          m_key()
+    {
+    }
+
+    /** @brief Pass the last decoded entries to the chunk handler */
+    bool flush()
+    {
+        bool ret = true;
+        if (m_chunk_handler && !m_chunk.empty())
+        {
+            ret = (*m_chunk_handler)(m_chunk);
+            m_chunk.clear();
+        }
+        return ret;
+    }
+
+    // SAX interface
+
+    /** @brief Integer value */
+    bool Int(int value) { return integer(value); }
+    /** @brief Unsigned integer value */
+    bool Uint(unsigned int value) { return integer(value); }
+    /** @brief 64 bits integer value */
+    bool Int64(int64_t value) { return integer(value); }
+    /** @brief 64 bits unsigned integer value, always out of the int range */
+    bool Uint64(uint64_t) { return integer(std::numeric_limits<int64_t>::max()); }
+
+    /** @brief String value */
+    bool String(const char* str, rapidjson::SizeType length, bool)
+    {
+        bool             ret = true;
+        std::string_view value(str, length);
+        if ((m_level == Level::Payload) && (m_key == "updateType"))
+        {
+            UpdateTypeHelper.fromString(value, m_request->updateType);
+        }
+        else if ((m_level == Level::Entry) && m_chunk_handler)
+        {
+            m_chunk.back().idTag.assign(std::string(value));
+        }
+        else if (m_level == Level::IdTagInfo)
+        {
+            ret = idTagInfoField(value);
+        }
+        else
+        {
+        }
+        return ret;
+    }
+
+    /** @brief Start of an object */
+    bool StartObject()
+    {
+        if (m_level == Level::Root)
+        {
+            m_level = Level::Payload;
+        }
+        else if (m_level == Level::List)
+        {
+            m_level = Level::Entry;
+            if (m_chunk_handler)
+            {
+                m_chunk.emplace_back();
+            }
+        }
+        else if (m_level == Level::Entry)
+        {
+            m_level = Level::IdTagInfo;
+            if (m_chunk_handler)
+            {
+                m_chunk.back().idTagInfo.value();
+            }
+        }
+        else
+        {
+        }
+        return true;
+    }
+
+    /** @brief Key of an object member */
+    bool Key(const char* str, rapidjson::SizeType length, bool)
+    {
+        if (m_level != Level::Ignored)
+        {
+            m_key.assign(str, length);
+        }
+        return true;
+    }
+
+    /** @brief End of an object */
+    bool EndObject(rapidjson::SizeType)
+    {
+        bool ret = true;
+        switch (m_level)
+        {
+            case Level::Payload:
+                m_level = Level::Done;
+                break;
+            case Level::Entry:
+                m_level = Level::List;
+                entries_count++;
+                if (m_chunk.size() >= m_chunk_size)
+                {
+                    ret = flush();
+                }
+                break;
+            case Level::IdTagInfo:
+                m_level = Level::Entry;
+                break;
+            default:
+                break;
+        }
+        return ret;
+    }
+
+    /** @brief Start of an array */
+    bool StartArray()
+    {
+        if (m_level == Level::Payload)
+        {
+            m_level = Level::List;
+        }
+        return true;
+    }
+
+    /** @brief End of an array */
+    bool EndArray(rapidjson::SizeType)
+    {
+        if (m_level == Level::List)
+        {
+            m_level = Level::Payload;
+        }
+        return true;
+    }
+
+    /** @brief Number of entries in the local authorization list */
+    size_t entries_count;
+    /** @brief Error message if a value cannot be decoded */
+    std::string error_message;
+
+  private:
+    /** @brief Request to fill */
+    SendLocalListReq* m_request;
+    /** @brief Maximum number of entries in a chunk */
+    size_t m_chunk_size;
+    /** @brief Function to call for each chunk */
+    const SendLocalListStreamDecoder::ChunkHandler* m_chunk_handler;
+    /** @brief Current chunk */
+    std::vector<AuthorizationData> m_chunk;
+    /** @brief Current level */
+    Level m_level;
+    /** @brief Current key */
+    std::string m_key;
+
+    /** @brief Integer value */
+    bool integer(int64_t value)
+    {
+        bool ret = true;
+        if (m_level == Level::Payload)
+        {
+            // listVersion is the only integer field
+            ret = ((value >= std::numeric_limits<int>::min()) && (value <= std::numeric_limits<int>::max())) ||
+                  invalid("listVersion", "range");
+            m_request->listVersion = static_cast<int>(value);
+        }
+        return ret;
+    }
+
+    /** @brief Field of an IdTagInfo object */
+    bool idTagInfoField(std::string_view value)
+    {
+        bool       ret      = true;
+        IdTagInfo* tag_info = (m_chunk_handler ? &m_chunk.back().idTagInfo.value() : nullptr);
+        if (m_key == "expiryDate")
+        {
+            DateTime expiry_date;
+            ret = expiry_date.assign(std::string(value)) || invalid("expiryDate", "date-time");
+            if (ret && tag_info)
+            {
+                tag_info->expiryDate = expiry_date;
+            }
+        }
+        else if (tag_info)
+        {
+            if (m_key == "parentIdTag")
+            {
+                tag_info->parentIdTag.value().assign(std::string(value));
+            }
+            else
+            {
+                AuthorizationStatusHelper.fromString(value, tag_info->status);
+            }
+        }
+        else
+        {
+        }
+        return ret;
+    }
+
+    /** @brief Set the error of a value which cannot be decoded */
+    bool invalid(const char* name, const char* keyword)
+    {
+        if (error_message.empty())
+        {
+            error_message = "Invalid '" + std::string(keyword) + "' keyword for " + name;
+        }
+        return false;
+    }
+};
+
+/** @brief Validator of a SendLocalList payload, forwarding the valid events to the payload decoder */
+typedef rapidjson::GenericSchemaValidator<rapidjson::SchemaDocument, PayloadDecoder> PayloadValidator;
+
+/** @brief SAX handler of a SendLocalList RPC frame, forwarding the events of the payload to a payload handler */
+template <typename PayloadHandler>
+class FrameHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, FrameHandler<PayloadHandler>>
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param payload_handler Handler of the payload events
+     */
+    FrameHandler(PayloadHandler& payload_handler)
+        : m_payload_handler(payload_handler), m_in_frame(false), m_index(0), m_depth(0), m_complete(false)
+    {
+    }
+
+    /** @brief Indicate if the whole frame has been decoded */
+    bool isComplete() const { return m_complete; }
+
+    // SAX interface
+
+    /** @brief Null value */
+    bool Null() { return inPayload() ? m_payload_handler.Null() : element(); }
+    /** @brief Boolean value */
+    bool Bool(bool value) { return inPayload() ? m_payload_handler.Bool(value) : element(); }
+    /** @brief Integer value */
+    bool Int(int value) { return inPayload() ? m_payload_handler.Int(value) : element(); }
+    /** @brief Unsigned integer value */
+    bool Uint(unsigned int value) { return inPayload() ? m_payload_handler.Uint(value) : element(); }
+    /** @brief 64 bits integer value */
+    bool Int64(int64_t value) { return inPayload() ? m_payload_handler.Int64(value) : element(); }
+    /** @brief 64 bits unsigned integer value */
+    bool Uint64(uint64_t value) { return inPayload() ? m_payload_handler.Uint64(value) : element(); }
+    /** @brief Double value */
+    bool Double(double value) { return inPayload() ? m_payload_handler.Double(value) : element(); }
+
+    /** @brief String value */
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        return inPayload() ? m_payload_handler.String(str, length, copy) : element();
+    }
+
+    /** @brief Start of an object */
+    bool StartObject()
+    {
+        bool ret = false;
+        if (inPayload() || (m_in_frame && (m_index == 3u)))
+        {
+            m_depth++;
+            ret = m_payload_handler.StartObject();
+        }
+        return ret;
+    }
+
+    /** @brief Key of an object member */
+    bool Key(const char* str, rapidjson::SizeType length, bool copy) { return inPayload() && m_payload_handler.Key(str, length, copy); }
+
+    /** @brief End of an object */
+    bool EndObject(rapidjson::SizeType count)
+    {
+        bool ret = false;
+        if (inPayload())
+        {
+            m_depth--;
+            if (m_depth == 0)
+            {
+                // End of the payload
+                m_index++;
+            }
+            ret = m_payload_handler.EndObject(count);
+        }
+        return ret;
+    }
+
+    /** @brief Start of an array */
+    bool StartArray()
+    {
+        bool ret = false;
+        if (inPayload())
+        {
+            m_depth++;
+            ret = m_payload_handler.StartArray();
+        }
+        else if (!m_in_frame && !m_complete)
+        {
+            m_in_frame = true;
+            ret        = true;
+        }
+        else
+        {
+        }
+        return ret;
+    }
+
+    /** @brief End of an array */
+    bool EndArray(rapidjson::SizeType count)
+    {
+        bool ret = false;
+        if (inPayload())
+        {
+            m_depth--;
+            ret = m_payload_handler.EndArray(count);
+        }
+        else
+        {
+            m_in_frame = false;
+            m_complete = (m_index == 4u);
+            ret        = m_complete;
+        }
+        return ret;
+    }
+
+  private:
+    /** @brief Handler of the payload events */
+    PayloadHandler& m_payload_handler;
+    /** @brief Indicate if the current event is inside the RPC frame */
+    bool m_in_frame;
+    /** @brief Index of the current element in the frame */
+    unsigned int m_index;
+    /** @brief Nesting depth inside the payload */
+    unsigned int m_depth;
+    /** @brief Indicate if the whole frame has been decoded */
+    bool m_complete;
+
+    /** @brief Indicate if the current event belongs to the payload */
+    bool inPayload() const { return (m_depth != 0); }
+
+    /** @brief Element of the frame preceding the payload */
+    bool element()
+    {
+        bool ret = m_in_frame && (m_index < 3u);
+        m_index++;
+        return ret;
+    }
+};
+
+} // namespace
+
+/** @brief Constructor */
+SendLocalListStreamDecoder::SendLocalListStreamDecoder(const rapidjson::SchemaDocument& schema, const char* frame, size_t size)
+    : m_schema(schema), m_frame(frame), m_size(size)
+{
+}
+
+/** @brief Destructor */
+SendLocalListStreamDecoder::~SendLocalListStreamDecoder() { }
+
+/** @brief Validate the payload and decode its fields except the local authorization list */
+bool SendLocalListStreamDecoder::decodeHeader(SendLocalListReq& request,
+                                              size_t&           entries_count,
+                                              const char*&      error_code,
+                                              std::string&      error_message)
+{
+    bool ret = false;
+
+    // The payload events are validated against the schema before being decoded
+    PayloadDecoder                 decoder(&request, 0, nullptr);
+    PayloadValidator               validator(m_schema, decoder);
+    FrameHandler<PayloadValidator> handler(validator);
+    rapidjson::Reader              reader;
+    rapidjson::MemoryStream        stream(m_frame, m_size);
+    reader.Parse(stream, handler);
+    if (handler.isComplete() && !reader.HasParseError())
+    {
+        entries_count = decoder.entries_count;
+        ret           = true;
+    }
+    else if (!validator.IsValid())
+    {
+        error_code = ocpp::rpc::IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION;
+        if (!decoder.error_message.empty())
+        {
+            error_message = decoder.error_message;
+        }
+        else if (validator.GetInvalidSchemaKeyword())
+        {
+            error_message = "Error on keyword : " + std::string(validator.GetInvalidSchemaKeyword());
+        }
+        else
+        {
+            error_message = "Unknown error";
+        }
+    }
+    else
+    {
+        error_code    = ocpp::rpc::IRpc::RPC_ERROR_FORMATION_VIOLATION;
+        error_message = rapidjson::GetParseError_En(reader.GetParseErrorCode());
+    }
+
+    return ret;
+}
+
+/** @brief Decode the local authorization list by chunks */
+bool SendLocalListStreamDecoder::decodeEntries(size_t chunk_size, const ChunkHandler& handler)
+{
+    // The payload has already been validated by decodeHeader()
+    SendLocalListReq             request;
+    PayloadDecoder               decoder(&request, ((chunk_size != 0) ? chunk_size : 1u), &handler);
+    FrameHandler<PayloadDecoder> frame_handler(decoder);
+    rapidjson::Reader            reader;
+    rapidjson::MemoryStream      stream(m_frame, m_size);
+    reader.Parse(stream, frame_handler);
+    return frame_handler.isComplete() && !reader.HasParseError() && decoder.flush();
+}
+
+} // namespace messages
+} // namespace ocpp
@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SENDLOCALLISTSTREAMDECODER_H
+#define SENDLOCALLISTSTREAMDECODER_H
+
+#include "SendLocalList.h"
+
+#include <functional>
+
+namespace ocpp
+{
+namespace messages
+{
+
+/**
+ * @brief Decoder of the SendLocalList requests working directly on the received RPC frame
+ *
+ *  The frame is parsed with a SAX reader instead of being loaded into a JSON document so that
+ *  large local lists are never entirely in memory : a first pass validates the payload with the
+ *  compiled SendLocalList schema, chained to the decoding of its header fields, a second pass
+ *  decodes the local authorization list by chunks.
+ */
+class SendLocalListStreamDecoder
+{
+  public:
+    /** @brief Function called for each decoded chunk of the local authorization list, returns false to stop the decoding */
+    typedef std::function<bool(const std::vector<ocpp::types::AuthorizationData>&)> ChunkHandler;
+
+    /**
+     * @brief Constructor
+     * @param schema Compiled schema of the SendLocalList requests
+     * @param frame RPC frame containing the SendLocalList request
+     * @param size Size of the frame in bytes
+     */
+    SendLocalListStreamDecoder(const rapidjson::SchemaDocument& schema, const char* frame, size_t size);
+
+    /** @brief Destructor */
+    virtual ~SendLocalListStreamDecoder();
+
+    /**
+     * @brief Validate the payload and decode its fields except the local authorization list
+     * @param request Request to fill, its local authorization list is left empty
+     * @param entries_count Number of entries of the local authorization list
+     * @param error_code Standard error code if the payload is invalid
+     * @param error_message Error message if the payload is invalid
+     * @return true if the payload is valid, false otherwise
+     */
+    bool decodeHeader(SendLocalListReq& request, size_t& entries_count, const char*& error_code, std::string& error_message);
+
+    /**
+     * @brief Decode the local authorization list by chunks, must be called after a successful call to decodeHeader()
+     * @param chunk_size Maximum number of entries in a chunk
+     * @param handler Function to call for each chunk
+     * @return true if all the entries have been decoded and accepted by the handler, false otherwise
+     */
+    bool decodeEntries(size_t chunk_size, const ChunkHandler& handler);
+
+  private:
+    /** @brief Compiled schema of the SendLocalList requests */
+    const rapidjson::SchemaDocument& m_schema;
+    /** @brief RPC frame */
+    const char* m_frame;
+    /** @brief Size of the frame in bytes */
+    size_t m_size;
+};
+
+} // namespace messages
+} // namespace ocpp
+
+#endif // SENDLOCALLISTSTREAMDECODER_H
@@ -79,8 +79,7 @@ bool SetChargingProfileReqConverter::toJson(const SetChargingProfileReq& data, r
     ChargingProfileConverter charging_profile_converter;
     charging_profile_converter.setAllocator(allocator);
 
-    rapidjson::Document csChargingProfiles;
-    csChargingProfiles.Parse("{}");
+    rapidjson::Document csChargingProfiles(rapidjson::kObjectType, allocator);
 
     bool ret = charging_profile_converter.toJson(data.csChargingProfiles, csChargingProfiles);
     json.AddMember(rapidjson::StringRef("csChargingProfiles"), csChargingProfiles.Move(), *allocator);
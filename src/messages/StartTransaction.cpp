@@ -19,6 +19,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "StartTransaction.h"
 #include "IRpc.h"
 #include "IdTagInfoConverter.h"
+#include "MessagesMembers.h"
 
 using namespace ocpp::types;
 
@@ -33,15 +34,17 @@ bool StartTransactionReqConverter::fromJson(const rapidjson::Value& json,
                                             const char*&            error_code,
                                             std::string&            error_message)
 {
-    bool ret = extract(json, "connectorId", data.connectorId, error_message);
+    MembersIndex<StartTransactionReqMembers> members(json);
+
+    bool ret = extract(members, StartTransactionReqMembers::connectorId, data.connectorId, error_message);
     if (ret && (data.connectorId == 0))
     {
         error_message = "connectorId field must be > 0";
     }
-    extract(json, "idTag", data.idTag);
-    ret = ret && extract(json, "meterStart", data.meterStart, error_message);
-    extract(json, "reservationId", data.reservationId);
-    ret = ret && extract(json, "timestamp", data.timestamp, error_message);
+    extract(members, StartTransactionReqMembers::idTag, data.idTag);
+    ret = ret && extract(members, StartTransactionReqMembers::meterStart, data.meterStart, error_message);
+    extract(members, StartTransactionReqMembers::reservationId, data.reservationId);
+    ret = ret && extract(members, StartTransactionReqMembers::timestamp, data.timestamp, error_message);
     if (!ret)
     {
         error_code = ocpp::rpc::IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION;
@@ -82,8 +85,7 @@ bool StartTransactionConfConverter::toJson(const StartTransactionConf& data, rap
     IdTagInfoConverter id_tag_info_converter;
     id_tag_info_converter.setAllocator(allocator);
 
-    rapidjson::Document id_tag_info;
-    id_tag_info.Parse("{}");
+    rapidjson::Document id_tag_info(rapidjson::kObjectType, allocator);
     bool ret = id_tag_info_converter.toJson(data.idTagInfo, id_tag_info);
     json.AddMember(rapidjson::StringRef("idTagInfo"), id_tag_info.Move(), *allocator);
     fill(json, "transactionId", data.transactionId);
@@ -19,6 +19,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "StopTransaction.h"
 #include "IRpc.h"
 #include "IdTagInfoConverter.h"
+#include "MessagesMembers.h"
 #include "MeterValueConverter.h"
 
 using namespace ocpp::types;
@@ -53,14 +54,17 @@ bool StopTransactionReqConverter::fromJson(const rapidjson::Value& json,
                                            const char*&            error_code,
                                            std::string&            error_message)
 {
-    extract(json, "idTag", data.idTag);
-    bool ret = extract(json, "meterStop", data.meterStop, error_message);
-    ret      = ret && extract(json, "timestamp", data.timestamp, error_message);
-    extract(json, "transactionId", data.transactionId);
-    data.reason = ReasonHelper.fromString(json["reason"].GetString());
-    if (json.HasMember("transactionData"))
+    MembersIndex<StopTransactionReqMembers> members(json);
+
+    extract(members, StopTransactionReqMembers::idTag, data.idTag);
+    bool ret = extract(members, StopTransactionReqMembers::meterStop, data.meterStop, error_message);
+    ret      = ret && extract(members, StopTransactionReqMembers::timestamp, data.timestamp, error_message);
+    extract(members, StopTransactionReqMembers::transactionId, data.transactionId);
+    data.reason = ReasonHelper.fromString(members[StopTransactionReqMembers::reason].GetString());
+    const rapidjson::Value* transaction_data = members.find(StopTransactionReqMembers::transactionData);
+    if (transaction_data)
     {
-        const rapidjson::Value& transactionData = json["transactionData"];
+        const rapidjson::Value& transactionData = *transaction_data;
         MeterValueConverter     metervalue_converter;
         for (auto it_meter = transactionData.Begin(); ret && (it_meter != transactionData.End()); ++it_meter)
         {
@@ -92,8 +96,7 @@ bool StopTransactionReqConverter::toJson(const StopTransactionReq& data, rapidjs
         metervalue_converter.setAllocator(allocator);
         for (const MeterValue& meter_value : data.transactionData)
         {
-            rapidjson::Document value;
-            value.Parse("{}");
+            rapidjson::Document value(rapidjson::kObjectType, allocator);
             ret = ret && metervalue_converter.toJson(meter_value, value);
             transactionData.PushBack(value.Move(), *allocator);
         }
@@ -109,10 +112,11 @@ bool StopTransactionConfConverter::fromJson(const rapidjson::Value& json,
                                             std::string&            error_message)
 {
     bool ret = true;
-    if (json.HasMember("idTagInfo"))
+    auto it_id_tag_info = json.FindMember("idTagInfo");
+    if (it_id_tag_info != json.MemberEnd())
     {
         IdTagInfoConverter id_tag_info_converter;
-        ret = id_tag_info_converter.fromJson(json["idTagInfo"], data.idTagInfo, error_code, error_message);
+        ret = id_tag_info_converter.fromJson(it_id_tag_info->value, data.idTagInfo, error_code, error_message);
     }
     return ret;
 }
@@ -126,8 +130,7 @@ bool StopTransactionConfConverter::toJson(const StopTransactionConf& data, rapid
         IdTagInfoConverter id_tag_info_converter;
         id_tag_info_converter.setAllocator(allocator);
 
-        rapidjson::Document id_tag_info;
-        id_tag_info.Parse("{}");
+        rapidjson::Document id_tag_info(rapidjson::kObjectType, allocator);
         ret = id_tag_info_converter.toJson(data.idTagInfo, id_tag_info);
         json.AddMember(rapidjson::StringRef("idTagInfo"), id_tag_info.Move(), *allocator);
     }
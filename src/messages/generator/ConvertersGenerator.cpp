@@ -0,0 +1,502 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Generates the members tables used by the message converters from the OCPP JSON schemas :
+ *  - one table per object decoded through a MembersIndex by the converters (see GENERATED_OBJECTS),
+ *    which gives an index to each member and finds the index of a member name with a switch on its
+ *    length and on its most discriminating characters
+ *  - one table for the actions, used to dispatch the conversions to the converters
+ *
+ * The generated files are committed in src/messages so that cross-compiled builds do not have to
+ * run this tool, they are regenerated with the regenerate_messages_members target.
+ *
+ * Usage : converters_generator schemas_dir output_dir
+ */
+
+#include "json.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/** @brief Object described by a JSON schema */
+struct ObjectSchema
+{
+    /** @brief Name of the members table */
+    std::string name;
+    /** @brief Description of the object */
+    std::string description;
+    /** @brief Names of the members */
+    std::vector<std::string> members;
+};
+
+/** @brief License header of the generated files */
+static const char* const LICENSE_HEADER = R"(/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+)";
+
+/** @brief Set of names to generate a lookup function for */
+struct NamesTable
+{
+    /** @brief Name of the table */
+    std::string name;
+    /** @brief Names */
+    std::vector<std::string> names;
+};
+
+/** @brief Objects decoded through a MembersIndex by the converters, add an object here when its converter starts using one
+ *         (nested objects with the same members share the table named after the first of them in the schemas order) */
+static const std::set<std::string> GENERATED_OBJECTS = {
+    "MeterValue", "MeterValuesReq", "SampledValue", "StartTransactionReq", "StopTransactionReq"};
+
+/** @brief C++ keywords which cannot be used as member names */
+static const std::set<std::string> CPP_KEYWORDS = {
+    "alignas",   "alignof",  "and",      "asm",       "auto",     "bool",       "break",    "case",         "catch",
+    "char",      "class",    "const",    "constexpr", "continue", "decltype",   "default",  "delete",       "do",
+    "double",    "else",     "enum",     "explicit",  "export",   "extern",     "false",    "float",        "for",
+    "friend",    "goto",     "if",       "inline",    "int",      "long",       "mutable",  "namespace",    "new",
+    "noexcept",  "not",      "nullptr",  "operator",  "or",       "private",    "protected", "public",      "register",
+    "return",    "short",    "signed",   "sizeof",    "static",   "struct",     "switch",   "template",     "this",
+    "throw",     "true",     "try",      "typedef",   "typeid",   "typename",   "union",    "unsigned",     "using",
+    "virtual",   "void",     "volatile", "while",     "xor",      "COUNT",      "NAMES",    "find"};
+
+/** @brief Check if a name can be used as a C++ identifier inside a members table */
+static bool isValidIdentifier(const std::string& name)
+{
+    bool ret = !name.empty() && !isdigit(static_cast<unsigned char>(name[0])) && (CPP_KEYWORDS.find(name) == CPP_KEYWORDS.end());
+    for (char c : name)
+    {
+        ret = ret && (isalnum(static_cast<unsigned char>(c)) || (c == '_'));
+    }
+    return ret;
+}
+
+/** @brief Collect the objects described by a schema and by its nested properties */
+static bool collectObjects(const rapidjson::Value&                                   schema,
+                           const std::string&                                        name,
+                           const std::string&                                        description,
+                           std::vector<ObjectSchema>&                                objects,
+                           std::map<std::vector<std::string>, std::string>&          nested_objects,
+                           bool                                                      nested)
+{
+    bool ret = true;
+
+    auto it_type = schema.FindMember("type");
+    if ((it_type != schema.MemberEnd()) && it_type->value.IsString())
+    {
+        std::string type = it_type->value.GetString();
+        if (type == "array")
+        {
+            auto it_items = schema.FindMember("items");
+            if (it_items != schema.MemberEnd())
+            {
+                ret = collectObjects(it_items->value, name, description, objects, nested_objects, nested);
+            }
+        }
+        else if (type == "object")
+        {
+            auto it_properties = schema.FindMember("properties");
+            if ((it_properties != schema.MemberEnd()) && (it_properties->value.MemberCount() != 0))
+            {
+                // Members of the object
+                ObjectSchema object;
+                object.name        = name;
+                object.description = description;
+                for (auto it = it_properties->value.MemberBegin(); it != it_properties->value.MemberEnd(); ++it)
+                {
+                    std::string member = it->name.GetString();
+                    if (!isValidIdentifier(member))
+                    {
+                        std::cerr << "Invalid member name : " << name << "." << member << std::endl;
+                        ret = false;
+                    }
+                    object.members.push_back(member);
+                }
+
+                // Nested objects with the same members share the same table
+                bool add = true;
+                if (nested)
+                {
+                    auto it_nested = nested_objects.find(object.members);
+                    if (it_nested != nested_objects.end())
+                    {
+                        add = false;
+                    }
+                    else
+                    {
+                        nested_objects[object.members] = name;
+                    }
+                }
+                if (add)
+                {
+                    objects.push_back(object);
+                }
+
+                // Nested objects
+                for (auto it = it_properties->value.MemberBegin(); ret && (it != it_properties->value.MemberEnd()); ++it)
+                {
+                    std::string member = it->name.GetString();
+                    std::string nested_name(member);
+                    nested_name[0] = static_cast<char>(toupper(static_cast<unsigned char>(nested_name[0])));
+                    ret            = collectObjects(
+                        it->value, nested_name, "Members of the " + member + " objects", objects, nested_objects, true);
+                }
+            }
+        }
+        else
+        {
+            // Not an object
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Generate the switch which finds the index of a name among names of the same length */
+static void generateSwitch(std::ostream&                                           out,
+                           const std::vector<std::pair<std::string, std::string>>& names,
+                           size_t                                                  length,
+                           std::set<size_t>                                        used_positions,
+                           const std::string&                                      indent)
+{
+    // Look for the position of the character which splits the names in the most groups
+    size_t best_position = length;
+    size_t best_count    = 1u;
+    if (names.size() > 1u)
+    {
+        for (size_t position = 0; position < length; position++)
+        {
+            if (used_positions.find(position) == used_positions.end())
+            {
+                std::set<char> chars;
+                for (const auto& name : names)
+                {
+                    chars.insert(name.first[position]);
+                }
+                if (chars.size() > best_count)
+                {
+                    best_position = position;
+                    best_count    = chars.size();
+                }
+            }
+        }
+    }
+
+    if (best_position == length)
+    {
+        // Compare the whole names
+        for (const auto& name : names)
+        {
+            out << indent << "if (memcmp(name, \"" << name.first << "\", " << length << "u) == 0)\n";
+            out << indent << "{\n";
+            out << indent << "    ret = " << name.second << ";\n";
+            out << indent << "}\n";
+        }
+    }
+    else
+    {
+        // Dispatch on the discriminating character
+        std::map<char, std::vector<std::pair<std::string, std::string>>> groups;
+        for (const auto& name : names)
+        {
+            groups[name.first[best_position]].push_back(name);
+        }
+        used_positions.insert(best_position);
+        out << indent << "switch (name[" << best_position << "])\n";
+        out << indent << "{\n";
+        for (const auto& group : groups)
+        {
+            out << indent << "    case '" << group.first << "':\n";
+            out << indent << "    {\n";
+            generateSwitch(out, group.second, length, used_positions, indent + "        ");
+            out << indent << "        break;\n";
+            out << indent << "    }\n";
+        }
+        out << indent << "    default:\n";
+        out << indent << "        break;\n";
+        out << indent << "}\n";
+    }
+}
+
+/** @brief Generate the declaration of a names table */
+static void generateDeclaration(std::ostream& out, const NamesTable& table, const std::string& description)
+{
+    out << "/** @brief " << description << " */\n";
+    out << "struct " << table.name << "\n";
+    out << "{\n";
+    out << "    /** @brief Indexes */\n";
+    out << "    enum : unsigned int\n";
+    out << "    {\n";
+    for (const auto& name : table.names)
+    {
+        out << "        " << name << ",\n";
+    }
+    out << "        COUNT\n";
+    out << "    };\n";
+    out << "\n";
+    out << "    /** @brief Names */\n";
+    out << "    static const char* const NAMES[COUNT];\n";
+    out << "\n";
+    out << "    /**\n";
+    out << "     * @brief Get the index of a name\n";
+    out << "     * @param name Name (not null terminated)\n";
+    out << "     * @param length Length of the name in bytes\n";
+    out << "     * @return Index of the name, COUNT if the name is unknown\n";
+    out << "     */\n";
+    out << "    static unsigned int find(const char* name, size_t length);\n";
+    out << "};\n";
+    out << "\n";
+}
+
+/** @brief Generate the definition of a names table */
+static void generateDefinition(std::ostream& out, const NamesTable& table)
+{
+    // Names
+    out << "/** @brief Names */\n";
+    out << "const char* const " << table.name << "::NAMES[" << table.name << "::COUNT] = {\n";
+    for (const auto& name : table.names)
+    {
+        out << "    \"" << name << "\",\n";
+    }
+    out << "};\n";
+    out << "\n";
+
+    // Lookup function
+    std::map<size_t, std::vector<std::pair<std::string, std::string>>> lengths;
+    for (const auto& name : table.names)
+    {
+        lengths[name.size()].push_back({name, name});
+    }
+    out << "/** @brief Get the index of a name */\n";
+    out << "unsigned int " << table.name << "::find(const char* name, size_t length)\n";
+    out << "{\n";
+    out << "    unsigned int ret = COUNT;\n";
+    out << "    switch (length)\n";
+    out << "    {\n";
+    for (const auto& length : lengths)
+    {
+        out << "        case " << length.first << "u:\n";
+        out << "        {\n";
+        generateSwitch(out, length.second, length.first, std::set<size_t>(), "            ");
+        out << "            break;\n";
+        out << "        }\n";
+    }
+    out << "        default:\n";
+    out << "            break;\n";
+    out << "    }\n";
+    out << "    return ret;\n";
+    out << "}\n";
+    out << "\n";
+}
+
+/** @brief Write a file only if its contents has changed to avoid useless rebuilds */
+static bool writeFile(const std::filesystem::path& path, const std::string& contents)
+{
+    bool ret = true;
+
+    std::ifstream     current_file(path);
+    std::stringstream current;
+    current << current_file.rdbuf();
+    if (!current_file.is_open() || (current.str() != contents))
+    {
+        std::ofstream file(path, std::ios::trunc);
+        file << contents;
+        ret = file.good();
+        if (!ret)
+        {
+            std::cerr << "Unable to write " << path << std::endl;
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Entry point */
+int main(int argc, char* argv[])
+{
+    int ret = 1;
+
+    if (argc != 3)
+    {
+        std::cerr << "Usage : " << argv[0] << " schemas_dir output_dir" << std::endl;
+        return ret;
+    }
+
+    // List the schemas
+    std::vector<std::filesystem::path> schemas;
+    for (const auto& entry : std::filesystem::directory_iterator(argv[1]))
+    {
+        if (entry.path().extension() == ".json")
+        {
+            schemas.push_back(entry.path());
+        }
+    }
+    std::sort(schemas.begin(), schemas.end());
+
+    // Collect the actions and the described objects
+    static const std::string                        RESPONSE_SUFFIX = "Response";
+    NamesTable                                      actions         = {"Actions", {}};
+    std::vector<ObjectSchema>                       objects;
+    std::map<std::vector<std::string>, std::string> nested_objects;
+    bool                                            success = !schemas.empty();
+    for (const auto& path : schemas)
+    {
+        std::ifstream     file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        rapidjson::Document schema;
+        schema.Parse(contents.str().c_str());
+        if (schema.HasParseError())
+        {
+            std::cerr << "Invalid schema : " << path << std::endl;
+            success = false;
+            continue;
+        }
+
+        std::string stem = path.stem().string();
+        std::string action;
+        std::string name;
+        std::string description;
+        if ((stem.size() > RESPONSE_SUFFIX.size()) &&
+            (stem.compare(stem.size() - RESPONSE_SUFFIX.size(), RESPONSE_SUFFIX.size(), RESPONSE_SUFFIX) == 0))
+        {
+            action      = stem.substr(0, stem.size() - RESPONSE_SUFFIX.size());
+            name        = action + "Conf";
+            description = "Members of the " + action + " response payload";
+        }
+        else
+        {
+            action      = stem;
+            name        = action + "Req";
+            description = "Members of the " + action + " request payload";
+            actions.names.push_back(action);
+        }
+        if (!isValidIdentifier(action))
+        {
+            std::cerr << "Invalid action name : " << action << std::endl;
+            success = false;
+        }
+        success = collectObjects(schema, name, description, objects, nested_objects, false) && success;
+    }
+
+    // Check that the nested objects have distinct names and keep only the objects used by the converters
+    std::set<std::string>     names;
+    std::vector<ObjectSchema> generated_objects;
+    for (const auto& object : objects)
+    {
+        if (!names.insert(object.name).second)
+        {
+            std::cerr << "Duplicated object name : " << object.name << std::endl;
+            success = false;
+        }
+        if (GENERATED_OBJECTS.find(object.name) != GENERATED_OBJECTS.end())
+        {
+            generated_objects.push_back(object);
+        }
+    }
+    for (const auto& name : GENERATED_OBJECTS)
+    {
+        if (names.find(name) == names.end())
+        {
+            std::cerr << "Unknown object : " << name << std::endl;
+            success = false;
+        }
+    }
+
+    if (success)
+    {
+        // Generate the header
+        std::stringstream header;
+        header << LICENSE_HEADER;
+        header << "/* Generated by converters_generator from the OCPP JSON schemas, do not edit */\n";
+        header << "\n";
+        header << "#ifndef MESSAGESMEMBERS_H\n";
+        header << "#define MESSAGESMEMBERS_H\n";
+        header << "\n";
+        header << "#include <cstddef>\n";
+        header << "\n";
+        header << "namespace ocpp\n";
+        header << "{\n";
+        header << "namespace messages\n";
+        header << "{\n";
+        header << "\n";
+        generateDeclaration(header, actions, "Actions described by the schemas");
+        for (const auto& object : generated_objects)
+        {
+            generateDeclaration(header, {object.name + "Members", object.members}, object.description);
+        }
+        header << "} // namespace messages\n";
+        header << "} // namespace ocpp\n";
+        header << "\n";
+        header << "#endif // MESSAGESMEMBERS_H\n";
+
+        // Generate the source
+        std::stringstream source;
+        source << LICENSE_HEADER;
+        source << "/* Generated by converters_generator from the OCPP JSON schemas, do not edit */\n";
+        source << "\n";
+        source << "#include \"MessagesMembers.h\"\n";
+        source << "\n";
+        source << "#include <cstring>\n";
+        source << "\n";
+        source << "namespace ocpp\n";
+        source << "{\n";
+        source << "namespace messages\n";
+        source << "{\n";
+        source << "\n";
+        generateDefinition(source, actions);
+        for (const auto& object : generated_objects)
+        {
+            generateDefinition(source, {object.name + "Members", object.members});
+        }
+        source << "} // namespace messages\n";
+        source << "} // namespace ocpp\n";
+
+        // Write the files
+        std::filesystem::path output_dir(argv[2]);
+        if (writeFile(output_dir / "MessagesMembers.h", header.str()) && writeFile(output_dir / "MessagesMembers.cpp", source.str()))
+        {
+            ret = 0;
+        }
+    }
+
+    return ret;
+}
@@ -39,10 +39,11 @@ bool AuthorizationDataConverter::fromJson(const rapidjson::Value&         json,
 {
     bool ret = true;
     extract(json, "idTag", data.idTag);
-    if (json.HasMember("idTagInfo"))
+    auto it_id_tag_info = json.FindMember("idTagInfo");
+    if (it_id_tag_info != json.MemberEnd())
     {
         IdTagInfoConverter id_tag_info_converter;
-        ret = id_tag_info_converter.fromJson(json["idTagInfo"], data.idTagInfo, error_code, error_message);
+        ret = id_tag_info_converter.fromJson(it_id_tag_info->value, data.idTagInfo, error_code, error_message);
     }
     return ret;
 }
@@ -57,8 +58,7 @@ bool AuthorizationDataConverter::toJson(const ocpp::types::AuthorizationData& da
     {
         IdTagInfoConverter id_tag_info_converter;
         id_tag_info_converter.setAllocator(allocator);
-        rapidjson::Document value;
-        value.Parse("{}");
+        rapidjson::Document value(rapidjson::kObjectType, allocator);
         ret = id_tag_info_converter.toJson(data.idTagInfo, value);
         json.AddMember(rapidjson::StringRef("idTagInfo"), value.Move(), *allocator);
     }
@@ -43,9 +43,10 @@ bool ChargingProfileConverter::fromJson(const rapidjson::Value&       json,
     ret                         = extract(json, "stackLevel", data.stackLevel, error_message);
     data.chargingProfilePurpose = ChargingProfilePurposeTypeHelper.fromString(json["chargingProfilePurpose"].GetString());
     data.chargingProfileKind    = ChargingProfileKindTypeHelper.fromString(json["chargingProfileKind"].GetString());
-    if (json.HasMember("recurrencyKind"))
+    auto it_recurrency_kind = json.FindMember("recurrencyKind");
+    if (it_recurrency_kind != json.MemberEnd())
     {
-        data.recurrencyKind = RecurrencyKindTypeHelper.fromString(json["recurrencyKind"].GetString());
+        data.recurrencyKind = RecurrencyKindTypeHelper.fromString(it_recurrency_kind->value.GetString());
     }
     ret = ret && extract(json, "validFrom", data.validFrom, error_message);
     ret = ret && extract(json, "validTo", data.validTo, error_message);
@@ -78,8 +79,7 @@ bool ChargingProfileConverter::toJson(const ocpp::types::ChargingProfile& data,
 
     ChargingScheduleConverter charging_schedule_converter;
     charging_schedule_converter.setAllocator(allocator);
-    rapidjson::Document charging_schedule;
-    charging_schedule.Parse("{}");
+    rapidjson::Document charging_schedule(rapidjson::kObjectType, allocator);
     bool ret = charging_schedule_converter.toJson(data.chargingSchedule, charging_schedule);
     json.AddMember(rapidjson::StringRef("chargingSchedule"), charging_schedule.Move(), *allocator);
 
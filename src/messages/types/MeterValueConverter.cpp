@@ -18,6 +18,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 
 #include "MeterValueConverter.h"
 #include "IRpc.h"
+#include "MessagesMembers.h"
 
 using namespace ocpp::types;
 
@@ -35,9 +36,11 @@ bool MeterValueConverter::fromJson(const rapidjson::Value&  json,
                                    const char*&             error_code,
                                    std::string&             error_message)
 {
-    bool ret = extract(json, "timestamp", data.timestamp, error_message);
+    MembersIndex<MeterValueMembers> members(json);
 
-    const rapidjson::Value& sampledValue = json["sampledValue"];
+    bool ret = extract(members, MeterValueMembers::timestamp, data.timestamp, error_message);
+
+    const rapidjson::Value& sampledValue = members[MeterValueMembers::sampledValue];
     for (auto it_sampled = sampledValue.Begin(); ret && (it_sampled != sampledValue.End()); ++it_sampled)
     {
         data.sampledValue.emplace_back();
@@ -47,30 +50,36 @@ bool MeterValueConverter::fromJson(const rapidjson::Value&  json,
         sampled_value.measurand     = Measurand::EnergyActiveImportRegister;
         sampled_value.location      = Location::Outlet;
 
-        extract(*it_sampled, "value", sampled_value.value);
-        if ((*it_sampled).HasMember("context"))
-        {
-            sampled_value.context = ReadingContextHelper.fromString((*it_sampled)["context"].GetString());
-        }
-        if ((*it_sampled).HasMember("format"))
-        {
-            sampled_value.format = ValueFormatHelper.fromString((*it_sampled)["format"].GetString());
-        }
-        if ((*it_sampled).HasMember("measurand"))
-        {
-            sampled_value.measurand = MeasurandHelper.fromString((*it_sampled)["measurand"].GetString());
-        }
-        if ((*it_sampled).HasMember("phase"))
-        {
-            sampled_value.phase = PhaseHelper.fromString((*it_sampled)["phase"].GetString());
-        }
-        if ((*it_sampled).HasMember("location"))
-        {
-            sampled_value.location = LocationHelper.fromString((*it_sampled)["location"].GetString());
-        }
-        if ((*it_sampled).HasMember("unit"))
+        // Single pass over the members, the key is dispatched on its generated index
+        for (auto it_member = it_sampled->MemberBegin(); it_member != it_sampled->MemberEnd(); ++it_member)
         {
-            sampled_value.unit = UnitOfMeasureHelper.fromString((*it_sampled)["unit"].GetString());
+            const rapidjson::Value& value = it_member->value;
+            switch (SampledValueMembers::find(it_member->name.GetString(), it_member->name.GetStringLength()))
+            {
+                case SampledValueMembers::value:
+                    extractValue(value, sampled_value.value);
+                    break;
+                case SampledValueMembers::context:
+                    sampled_value.context = ReadingContextHelper.fromString(value.GetString());
+                    break;
+                case SampledValueMembers::format:
+                    sampled_value.format = ValueFormatHelper.fromString(value.GetString());
+                    break;
+                case SampledValueMembers::measurand:
+                    sampled_value.measurand = MeasurandHelper.fromString(value.GetString());
+                    break;
+                case SampledValueMembers::phase:
+                    sampled_value.phase = PhaseHelper.fromString(value.GetString());
+                    break;
+                case SampledValueMembers::location:
+                    sampled_value.location = LocationHelper.fromString(value.GetString());
+                    break;
+                case SampledValueMembers::unit:
+                    sampled_value.unit = UnitOfMeasureHelper.fromString(value.GetString());
+                    break;
+                default:
+                    break;
+            }
         }
     }
     if (!ret)
@@ -90,8 +99,7 @@ bool MeterValueConverter::toJson(const ocpp::types::MeterValue& data, rapidjson:
     rapidjson::Value sampledValue(rapidjson::kArrayType);
     for (const SampledValue& sampled_value : data.sampledValue)
     {
-        rapidjson::Document sampled;
-        sampled.Parse("{}");
+        rapidjson::Document sampled(rapidjson::kObjectType, allocator);
         fill(sampled, "value", sampled_value.value);
         if (sampled_value.context.isSet())
         {
@@ -22,6 +22,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "json.h"
 
 #include <chrono>
+#include <functional>
 #include <string>
 
 namespace ocpp
@@ -36,6 +37,14 @@ class IRpc
     // Forward declarations
     class IListener;
     class ISpy;
+    class IStreamHandler;
+
+    /**
+     * @brief Completion function of an asynchronous call
+     * @param success true if a response has been received, false otherwise
+     * @param response JSON response received
+     */
+    typedef std::function<void(bool success, rapidjson::Document& response)> CallCompletionFunc;
 
     /** @brief Destructor */
     virtual ~IRpc() { }
@@ -59,6 +68,23 @@ class IRpc
                       rapidjson::Document&       response,
                       std::chrono::milliseconds  timeout = std::chrono::seconds(2)) = 0;
 
+    /**
+     * @brief Call a remote action without waiting for its response
+     *        The completion function is called from the RPC reception thread when the
+     *        response has been received or when the timeout has expired, and from the thread
+     *        which stops the RPC for the calls still pending at this time. It must not block
+     * @param action Remote action
+     * @param payload JSON payload for the action
+     * @param completion Function to call when the call has been completed
+     * @param timeout Response timeout
+     * @return true if the request has been sent and the completion function will be called,
+     *         false otherwise (the completion function will not be called)
+     */
+    virtual bool callAsync(const std::string&         action,
+                           const rapidjson::Document& payload,
+                           CallCompletionFunc         completion,
+                           std::chrono::milliseconds  timeout = std::chrono::seconds(2)) = 0;
+
     /**
      * @brief Register a listener to the RPC events
      * @param listener Listener object
@@ -71,6 +97,14 @@ class IRpc
      */
     virtual void registerSpy(ISpy& spy) = 0;
 
+    /**
+     * @brief Register a handler which decodes the CALL messages of an action directly from the received frame,
+     *        the frame is then not parsed into a JSON document
+     * @param action Action
+     * @param handler Handler object
+     */
+    virtual void registerStreamHandler(const std::string& action, IStreamHandler& handler) = 0;
+
     /** @brief Interface for the RPC listeners */
     class IListener
     {
@@ -100,6 +134,31 @@ class IRpc
                                      std::string&            error_message) = 0;
     };
 
+    /** @brief Interface for the handlers of the CALL messages decoded directly from the received frame */
+    class IStreamHandler
+    {
+      public:
+        /** @brief Destructor */
+        virtual ~IStreamHandler() { }
+
+        /**
+         * @brief Called when a CALL message has been received
+         * @param action Action
+         * @param frame Received RPC frame (JSON array containing the payload)
+         * @param size Size of the frame in bytes
+         * @param response JSON response to send
+         * @param error_code Standard error code, set to nullptr if no error
+         * @param error_msg Additionnal error message, empty if no error
+         * @return true if the call is accepted, false otherwise
+         */
+        virtual bool rpcStreamedCallReceived(const std::string&   action,
+                                             const char*          frame,
+                                             size_t               size,
+                                             rapidjson::Document& response,
+                                             const char*&         error_code,
+                                             std::string&         error_message) = 0;
+    };
+
     /** @brief Interface for the RPC clients spies */
     class ISpy
     {
@@ -17,9 +17,13 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "RpcBase.h"
+#include "JsonArena.h"
+#include "RpcFrameWriter.h"
+#include "RpcPool.h"
 
+#include <cctype>
 #include <functional>
-#include <sstream>
+#include <limits>
 
 namespace ocpp
 {
@@ -27,15 +31,96 @@ namespace rpc
 {
 
 /** @brief RPC call type */
-static constexpr const char* CALL = "2";
-/** @brief RPC call result type */
-static constexpr const char* CALLRESULT = "3";
-/** @brief RPC call error type */
-static constexpr const char* CALLERROR = "4";
+static constexpr char CALL = '2';
+/** @brief Maximum number of messages processed at each scheduling of a connection in the shared pool */
+static constexpr unsigned int MAX_MESSAGES_PER_POOL_SCHEDULING = 16u;
+
+/** @brief Indicate if a received frame is a CALL message by looking at its first characters */
+static bool isCallFrame(const std::string& frame)
+{
+    bool   ret = false;
+    size_t pos = frame.find_first_not_of(" \t\r\n");
+    if ((pos != std::string::npos) && (frame[pos] == '['))
+    {
+        pos = frame.find_first_not_of(" \t\r\n", pos + 1u);
+        ret = ((pos != std::string::npos) && (frame[pos] == CALL) && ((pos + 1u) < frame.size()) && !std::isdigit(frame[pos + 1u]));
+    }
+    return ret;
+}
+
+/** @brief SAX handler extracting the unique identifier and the action of a CALL frame */
+class CallHeaderHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, CallHeaderHandler>
+{
+  public:
+    /** @brief Constructor */
+    CallHeaderHandler() : unique_id(), action(), m_depth(0), m_index(0) { }
+
+    /** @brief Indicate if the header has been completely decoded */
+    bool isComplete() const { return (m_index == 3u); }
+
+    /** @brief Message type */
+    bool Uint(unsigned int value) { return element((m_index == 0) && (value == static_cast<unsigned int>(CALL - '0'))); }
+    /** @brief Unique identifier and action */
+    bool String(const char* str, rapidjson::SizeType length, bool copy)
+    {
+        (void)copy;
+        if (m_index == 1u)
+        {
+            unique_id.assign(str, length);
+        }
+        if (m_index == 2u)
+        {
+            action.assign(str, length);
+        }
+        return element((m_index == 1u) || (m_index == 2u));
+    }
+    /** @brief Start of the frame */
+    bool StartArray()
+    {
+        m_depth++;
+        return (m_depth == 1u);
+    }
+    /** @brief Any other value is invalid */
+    bool Default() { return false; }
+
+    /** @brief Unique identifier */
+    std::string unique_id;
+    /** @brief Action */
+    std::string action;
+
+  private:
+    /** @brief Depth in the frame */
+    unsigned int m_depth;
+    /** @brief Index of the current element in the frame */
+    unsigned int m_index;
+
+    /** @brief Check an element of the frame, the parsing stops after the action */
+    bool element(bool valid)
+    {
+        bool ret = valid && (m_depth == 1u);
+        if (ret)
+        {
+            m_index++;
+            ret = !isComplete();
+        }
+        return ret;
+    }
+};
 
 /** @brief Constructor */
 RpcBase::RpcBase()
-    : m_rpc_listener(nullptr), m_spies(), m_transaction_id(0), m_call_mutex(), m_requests_queue(), m_results_queue(), m_rx_thread(nullptr)
+    : m_rpc_listener(nullptr),
+      m_spies(),
+      m_stream_handlers(),
+      m_transaction_id(0),
+      m_pending_calls_mutex(),
+      m_pending_calls_cond_var(),
+      m_pending_calls(),
+      m_max_pending_calls(1u),
+      m_requests_queue(),
+      m_rx_thread(nullptr),
+      m_rx_thread_stop(false),
+      m_pool(nullptr)
 {
 }
 
@@ -56,71 +141,95 @@ bool RpcBase::call(const std::string&         action,
     // Check connection state
     if (isConnected())
     {
-        // Only one RPC request/response at a time
-        std::lock_guard<std::mutex> call_lock(m_call_mutex);
+        // Wait for a free slot in the pending calls window
+        auto                         wait_time = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(m_pending_calls_mutex);
+        if (m_pending_calls_cond_var.wait_until(lock, wait_time, [this] { return (m_pending_calls.size() < m_max_pending_calls); }))
+        {
+            // Initialize call context
+            PendingCall pending_call(response);
+            std::string unique_id      = std::to_string(m_transaction_id);
+            m_pending_calls[unique_id] = &pending_call;
+            m_transaction_id++;
+            lock.unlock();
 
-        // Serialize message
-        rapidjson::StringBuffer                    buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-        payload.Accept(writer);
-
-        std::stringstream serialized_message;
-        serialized_message << "[";
-        serialized_message << CALL << ", ";
-        serialized_message << "\"" << m_transaction_id << "\", ";
-        serialized_message << "\"" << action << "\", ";
-        serialized_message << buffer.GetString();
-        serialized_message << "]";
-
-        // Initialize call context
-        std::stringstream id;
-        id << m_transaction_id;
-
-        // Send message
-        std::string msg = serialized_message.str();
-        if (send(msg))
+            // Send message
+            RpcFrameWriter frame(sendHeadroom());
+            bool           sent = frame.writeCall(unique_id, action, payload) && send(frame, ocpp::websockets::SendPriority::Normal);
+            lock.lock();
+            if (sent)
+            {
+                // Wait for response
+                pending_call.cond_var.wait_until(lock, wait_time, [&pending_call] { return pending_call.completed; });
+                ret = pending_call.success;
+            }
+
+            // Release call context
+            m_pending_calls.erase(unique_id);
+            m_pending_calls_cond_var.notify_one();
+        }
+    }
+
+    return ret;
+}
+
+/** @copydoc bool IRpc::callAsync(const std::string&, const rapidjson::Document&, CallCompletionFunc, std::chrono::milliseconds) */
+bool RpcBase::callAsync(const std::string&         action,
+                        const rapidjson::Document& payload,
+                        CallCompletionFunc         completion,
+                        std::chrono::milliseconds  timeout)
+{
+    bool ret = false;
+
+    // Check connection state, the completion is notified by the reception thread
+    if (isConnected() && (m_rx_thread || m_pool) && completion)
+    {
+        // Wait for a free slot in the pending calls window, the reception thread
+        // must not wait since it is the one which releases the slots
+        auto wait_time = std::chrono::steady_clock::now();
+        if (!isReceptionThread())
+        {
+            wait_time += timeout;
+        }
+        std::unique_lock<std::mutex> lock(m_pending_calls_mutex);
+        if (m_pending_calls_cond_var.wait_until(lock, wait_time, [this] { return (m_pending_calls.size() < m_max_pending_calls); }))
         {
-            // Wait for response
-            std::stringstream expected_id;
-            expected_id << m_transaction_id;
-            RpcMessage* rpc_message = nullptr;
-            auto        wait_time   = std::chrono::steady_clock().now() + timeout;
-            do
+            // Initialize call context, it will be released after the completion
+            PendingCall* pending_call  = new PendingCall(completion);
+            std::string  unique_id     = std::to_string(m_transaction_id);
+            m_pending_calls[unique_id] = pending_call;
+            m_transaction_id++;
+            lock.unlock();
+
+            // Send message
+            RpcFrameWriter frame(sendHeadroom());
+            bool           sent = frame.writeCall(unique_id, action, payload) && send(frame, ocpp::websockets::SendPriority::Normal);
+            lock.lock();
+
+            // The response may already have been received
+            auto it = m_pending_calls.find(unique_id);
+            if (it != m_pending_calls.end())
             {
-                // Compute timeout
-                auto now       = std::chrono::steady_clock().now();
-                auto left_time = std::chrono::duration_cast<std::chrono::milliseconds>(wait_time - now);
-                if (left_time.count() >= 0)
+                if (sent)
                 {
-                    // Wait for a message
-                    ret = m_results_queue.pop(rpc_message, left_time.count());
-                    if (ret)
-                    {
-                        // Check id
-                        if (rpc_message->unique_id != expected_id.str())
-                        {
-                            // Wrong message
-                            delete rpc_message;
-                            rpc_message = nullptr;
-                        }
-                    }
+                    // Start response timeout
+                    pending_call->deadline = std::chrono::steady_clock::now() + timeout;
+                    scheduleDeadline(pending_call->deadline);
+                    ret = true;
+                }
+                else
+                {
+                    // Release call context
+                    m_pending_calls.erase(it);
+                    m_pending_calls_cond_var.notify_one();
+                    delete pending_call;
                 }
-            } while (ret && (rpc_message == nullptr));
-
-            // Extract response
-            if (rpc_message)
-            {
-                response.CopyFrom(rpc_message->payload, response.GetAllocator());
-                delete rpc_message;
             }
             else
             {
-                ret = false;
+                ret = true;
             }
         }
-
-        // Update transaction id
-        m_transaction_id++;
     }
 
     return ret;
@@ -138,13 +247,33 @@ void RpcBase::registerSpy(IRpc::ISpy& spy)
     m_spies.push_back(&spy);
 }
 
+/** @copydoc void IRpc::registerStreamHandler(const std::string&, IStreamHandler&) */
+void RpcBase::registerStreamHandler(const std::string& action, IRpc::IStreamHandler& handler)
+{
+    m_stream_handlers[action] = &handler;
+}
+
+/** @brief Set the maximum number of CALL requests which can wait for their response at the same time */
+void RpcBase::setMaxPendingCalls(unsigned int max_pending_calls)
+{
+    std::lock_guard<std::mutex> lock(m_pending_calls_mutex);
+
+    // At least 1 request must be allowed
+    if (max_pending_calls == 0)
+    {
+        max_pending_calls = 1u;
+    }
+    m_max_pending_calls = max_pending_calls;
+    m_pending_calls_cond_var.notify_all();
+}
+
 // RpcBase interface
 
 /** @brief Start RPC operations */
-void RpcBase::start()
+void RpcBase::start(RpcPool* pool)
 {
     // Check if already started
-    if (!m_rx_thread)
+    if (!m_rx_thread && !m_pool)
     {
         // Initialize transaction id sequence
         m_transaction_id = std::rand();
@@ -152,10 +281,19 @@ void RpcBase::start()
         // Flush queues
         m_requests_queue.clear();
         m_requests_queue.setEnable(true);
-        m_results_queue.clear();
 
-        // Start reception thread
-        m_rx_thread = new std::thread(std::bind(&RpcBase::rxThread, this));
+        if (pool)
+        {
+            // Received messages are processed by the shared pool
+            pool->registerConnection(*this);
+            m_pool = pool;
+        }
+        else
+        {
+            // Start reception thread
+            m_rx_thread_stop = false;
+            m_rx_thread      = new std::thread(std::bind(&RpcBase::rxThread, this));
+        }
     }
 }
 
@@ -166,84 +304,111 @@ void RpcBase::stop()
     if (m_rx_thread)
     {
         // Stop reception thread
+        m_rx_thread_stop = true;
         m_requests_queue.setEnable(false);
         m_rx_thread->join();
         delete m_rx_thread;
         m_rx_thread = nullptr;
     }
+    RpcPool* pool = m_pool.exchange(nullptr);
+    if (pool)
+    {
+        // Wait for the end of the processing in the shared pool
+        pool->unregisterConnection(*this);
+    }
+
+    // No response will be received for the pending calls
+    abortPendingCalls();
 }
 
 /** @brief Process received data */
 void RpcBase::processReceivedData(const void* data, size_t size)
 {
-    // Decode received data
-    std::string received_data(reinterpret_cast<const char*>(data), size);
+    // Decode received data, the message keeps the received frame so that
+    // it can be moved to the reception thread without any copy
+    RpcMessage* rpc_message = new RpcMessage(data, size);
     for (ISpy* spy : m_spies)
     {
-        spy->rcpMessageReceived(received_data);
+        spy->rcpMessageReceived(rpc_message->frame);
     }
 
-    // RPC frame must be a JSON array
-    bool                valid = false;
-    rapidjson::Document rpc_frame;
-    try
-    {
-        rpc_frame.Parse(received_data.c_str());
-        valid = !rpc_frame.HasParseError();
-    }
-    catch (const std::exception&)
+    // CALL messages of the streamed actions are decoded by their handler directly from the frame
+    if (m_stream_handlers.empty() || !isCallFrame(rpc_message->frame) || !decodeStreamedCall(rpc_message))
     {
-    }
-    if (valid && rpc_frame.IsArray() && (rpc_frame.Size() >= 3))
-    {
-        // Extract message type
-        const rapidjson::Value& msg_type_value = rpc_frame[0];
-        if (msg_type_value.IsUint())
+        // RPC frame must be a JSON array, CALL messages are parsed in-situ since their
+        // payload does not outlive the frame while CALLRESULT payloads are moved to the caller
+        bool                 valid     = false;
+        rapidjson::Document& rpc_frame = rpc_message->document;
+        try
         {
-            // Check message type
-            MessageType  msg_type     = MessageType::INVALID;
-            unsigned int msg_type_int = msg_type_value.GetUint();
-            switch (msg_type_int)
+            if (isCallFrame(rpc_message->frame))
+            {
+                rpc_frame.ParseInsitu(&rpc_message->frame[0]);
+            }
+            else
             {
-                case static_cast<unsigned int>(MessageType::CALL):
-                    msg_type = MessageType::CALL;
-                    valid    = (rpc_frame.Size() == 4u);
-                    break;
-                case static_cast<unsigned int>(MessageType::CALLRESULT):
-                    msg_type = MessageType::CALLRESULT;
-                    valid    = (rpc_frame.Size() == 3u);
-                    break;
-                case static_cast<unsigned int>(MessageType::CALLERROR):
-                    msg_type = MessageType::CALLERROR;
-                    valid    = (rpc_frame.Size() == 5u);
-                    break;
-                default:
-                    // Unknown type
-                    valid = false;
-                    break;
+                rpc_frame.Parse(rpc_message->frame.c_str(), rpc_message->frame.size());
             }
-            if (valid)
+            valid = !rpc_frame.HasParseError();
+        }
+        catch (const std::exception&)
+        {
+        }
+        if (valid && rpc_frame.IsArray() && (rpc_frame.Size() >= 3))
+        {
+            // Extract message type
+            const rapidjson::Value& msg_type_value = rpc_frame[0];
+            if (msg_type_value.IsUint())
             {
-                // Extract unique identifier
-                const rapidjson::Value& unique_id_value = rpc_frame[1];
-                if (unique_id_value.IsString())
+                // Check message type
+                MessageType  msg_type     = MessageType::INVALID;
+                unsigned int msg_type_int = msg_type_value.GetUint();
+                switch (msg_type_int)
+                {
+                    case static_cast<unsigned int>(MessageType::CALL):
+                        msg_type = MessageType::CALL;
+                        valid    = (rpc_frame.Size() == 4u);
+                        break;
+                    case static_cast<unsigned int>(MessageType::CALLRESULT):
+                        msg_type = MessageType::CALLRESULT;
+                        valid    = (rpc_frame.Size() == 3u);
+                        break;
+                    case static_cast<unsigned int>(MessageType::CALLERROR):
+                        msg_type = MessageType::CALLERROR;
+                        valid    = (rpc_frame.Size() == 5u);
+                        break;
+                    default:
+                        // Unknown type
+                        valid = false;
+                        break;
+                }
+                if (valid)
                 {
-                    // Decode message
-                    std::string unique_id = unique_id_value.GetString();
-                    switch (msg_type)
+                    // Extract unique identifier
+                    const rapidjson::Value& unique_id_value = rpc_frame[1];
+                    if (unique_id_value.IsString())
                     {
-                        case MessageType::CALL:
-                            valid = decodeCall(unique_id, rpc_frame[2], rpc_frame[3]);
-                            break;
-                        case MessageType::CALLRESULT:
-                            valid = decodeCallResult(unique_id, rpc_frame[2]);
-                            break;
-                        case MessageType::CALLERROR:
-                        default:
-                            valid = decodeCallError(unique_id, rpc_frame[2], rpc_frame[3], rpc_frame[4]);
-                            break;
+                        // Decode message
+                        rpc_message->unique_id.assign(unique_id_value.GetString(), unique_id_value.GetStringLength());
+                        switch (msg_type)
+                        {
+                            case MessageType::CALL:
+                                valid = decodeCall(rpc_message, rpc_frame[2], rpc_frame[3]);
+                                break;
+                            case MessageType::CALLRESULT:
+                                valid = decodeCallResult(*rpc_message, rpc_frame[2]);
+                                break;
+                            case MessageType::CALLERROR:
+                            default:
+                                valid = decodeCallError(rpc_message->unique_id, rpc_frame[2], rpc_frame[3], rpc_frame[4]);
+                                break;
+                        }
+                        if (!valid)
+                        {
+                            sendCallError("", RPC_ERROR_PROTOCOL, "");
+                        }
                     }
-                    if (!valid)
+                    else
                     {
                         sendCallError("", RPC_ERROR_PROTOCOL, "");
                     }
@@ -263,27 +428,197 @@ void RpcBase::processReceivedData(const void* data, size_t size)
             sendCallError("", RPC_ERROR_PROTOCOL, "");
         }
     }
-    else
-    {
-        sendCallError("", RPC_ERROR_PROTOCOL, "");
-    }
+
+    // Free resources if the message has not been queued
+    delete rpc_message;
 }
 
-/** @brief Send a message throug the websocket connection */
-bool RpcBase::send(const std::string& msg)
+/** @brief Send a message through the websocket connection */
+bool RpcBase::send(RpcFrameWriter& frame, ocpp::websockets::SendPriority priority)
 {
     // Notify spy
-    for (ISpy* spy : m_spies)
+    if (!m_spies.empty())
     {
-        spy->rcpMessageSent(msg);
+        std::string msg(frame.message(), frame.size());
+        for (ISpy* spy : m_spies)
+        {
+            spy->rcpMessageSent(msg);
+        }
     }
 
     // Send message
-    return doSend(msg);
+    return doSend(std::move(frame.frame()), priority);
+}
+
+/** @brief Complete a pending call */
+void RpcBase::completePendingCall(const std::string& unique_id, rapidjson::Document* response)
+{
+    std::lock_guard<std::mutex> lock(m_pending_calls_mutex);
+
+    // Look for the corresponding call, responses to timed out calls are discarded
+    auto it = m_pending_calls.find(unique_id);
+    if ((it != m_pending_calls.end()) && !it->second->completed)
+    {
+        PendingCall* pending_call = it->second;
+        pending_call->completed   = true;
+        pending_call->success     = (response != nullptr);
+        if (pending_call->completion)
+        {
+            // Asynchronous call, release the slot and notify the reception thread
+            RpcMessage* rpc_message = new RpcMessage(pending_call);
+            if (response)
+            {
+                rpc_message->document.Swap(*response);
+            }
+            m_pending_calls.erase(it);
+            m_pending_calls_cond_var.notify_one();
+            queueMessage(rpc_message);
+        }
+        else
+        {
+            // Move response
+            if (response)
+            {
+                pending_call->response->Swap(*response);
+            }
+
+            // Wakeup caller
+            pending_call->cond_var.notify_one();
+        }
+    }
+}
+
+/** @brief Abort all the pending calls */
+void RpcBase::abortPendingCalls()
+{
+    std::vector<PendingCall*> aborted_calls;
+    {
+        std::lock_guard<std::mutex> lock(m_pending_calls_mutex);
+
+        auto it = m_pending_calls.begin();
+        while (it != m_pending_calls.end())
+        {
+            PendingCall* pending_call = it->second;
+            pending_call->completed   = true;
+            if (pending_call->completion)
+            {
+                aborted_calls.push_back(pending_call);
+                it = m_pending_calls.erase(it);
+            }
+            else
+            {
+                pending_call->cond_var.notify_one();
+                ++it;
+            }
+        }
+        m_pending_calls_cond_var.notify_all();
+    }
+
+    // Notify the completions which have not been processed by the reception thread
+    RpcMessage* rpc_message = nullptr;
+    m_requests_queue.setEnable(true);
+    while (m_requests_queue.pop(rpc_message, 0))
+    {
+        if (rpc_message && rpc_message->pending_call)
+        {
+            processCallCompletion(*rpc_message);
+        }
+        delete rpc_message;
+    }
+    m_requests_queue.setEnable(false);
+
+    // Notify the aborted asynchronous calls
+    for (PendingCall* pending_call : aborted_calls)
+    {
+        RpcMessage aborted_call(pending_call);
+        processCallCompletion(aborted_call);
+    }
+}
+
+/** @brief Get the next asynchronous call deadline */
+std::chrono::steady_clock::time_point RpcBase::nextPendingCallDeadline()
+{
+    std::lock_guard<std::mutex> lock(m_pending_calls_mutex);
+
+    // Look for the nearest deadline
+    auto next_deadline = std::chrono::steady_clock::time_point::max();
+    for (const auto& pending_call : m_pending_calls)
+    {
+        if (pending_call.second->completion && (pending_call.second->deadline < next_deadline))
+        {
+            next_deadline = pending_call.second->deadline;
+        }
+    }
+
+    return next_deadline;
+}
+
+/** @brief Complete the asynchronous calls which have reached their deadline */
+void RpcBase::expirePendingCalls()
+{
+    std::vector<PendingCall*> expired_calls;
+    {
+        std::lock_guard<std::mutex> lock(m_pending_calls_mutex);
+
+        auto now = std::chrono::steady_clock::now();
+        auto it  = m_pending_calls.begin();
+        while (it != m_pending_calls.end())
+        {
+            PendingCall* pending_call = it->second;
+            if (pending_call->completion && (pending_call->deadline <= now))
+            {
+                pending_call->completed = true;
+                expired_calls.push_back(pending_call);
+                it = m_pending_calls.erase(it);
+                m_pending_calls_cond_var.notify_one();
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Notify the timed out calls
+    for (PendingCall* pending_call : expired_calls)
+    {
+        RpcMessage expired_call(pending_call);
+        processCallCompletion(expired_call);
+    }
+}
+
+/** @brief Decode the header of a CALL message whose payload is decoded by a stream handler */
+bool RpcBase::decodeStreamedCall(RpcMessage*& rpc_message)
+{
+    bool ret = false;
+
+    // Only the header of the frame is parsed
+    CallHeaderHandler       header;
+    rapidjson::Reader       reader;
+    rapidjson::MemoryStream stream(rpc_message->frame.c_str(), rpc_message->frame.size());
+    reader.Parse(stream, header);
+    if (header.isComplete())
+    {
+        // Look for a stream handler
+        auto it = m_stream_handlers.find(header.action);
+        if (it != m_stream_handlers.end())
+        {
+            // Add request to the queue
+            rpc_message->unique_id      = std::move(header.unique_id);
+            rpc_message->action         = std::move(header.action);
+            rpc_message->stream_handler = it->second;
+            queueMessage(rpc_message);
+            rpc_message = nullptr;
+
+            ret = true;
+        }
+    }
+
+    return ret;
 }
 
 /** @brief Decode a CALL message */
-bool RpcBase::decodeCall(const std::string& unique_id, const rapidjson::Value& action, const rapidjson::Value& payload)
+bool RpcBase::decodeCall(RpcMessage*& rpc_message, const rapidjson::Value& action, rapidjson::Value& payload)
 {
     bool ret = false;
 
@@ -291,8 +626,10 @@ bool RpcBase::decodeCall(const std::string& unique_id, const rapidjson::Value& a
     if (action.IsString() && payload.IsObject())
     {
         // Add request to the queue
-        RpcMessage* msg = new RpcMessage(unique_id, action.GetString(), payload);
-        m_requests_queue.push(msg);
+        rpc_message->action.assign(action.GetString(), action.GetStringLength());
+        rpc_message->payload = &payload;
+        queueMessage(rpc_message);
+        rpc_message = nullptr;
 
         ret = true;
     }
@@ -301,16 +638,21 @@ bool RpcBase::decodeCall(const std::string& unique_id, const rapidjson::Value& a
 }
 
 /** @brief Decode a CALLRESULT message */
-bool RpcBase::decodeCallResult(const std::string& unique_id, const rapidjson::Value& payload)
+bool RpcBase::decodeCallResult(RpcMessage& rpc_message, rapidjson::Value& payload)
 {
     bool ret = false;
 
     // Check types
     if (payload.IsObject())
     {
-        // Add result to the queue
-        RpcMessage* msg = new RpcMessage(unique_id, payload);
-        m_results_queue.push(msg);
+        // Make the payload the root of the parsed document so that
+        // it can be moved to the caller without any copy
+        rapidjson::Value response;
+        response.Swap(payload);
+        static_cast<rapidjson::Value&>(rpc_message.document).Swap(response);
+
+        // Notify the corresponding call
+        completePendingCall(rpc_message.unique_id, &rpc_message.document);
 
         ret = true;
     }
@@ -329,7 +671,9 @@ bool RpcBase::decodeCallError(const std::string&      unique_id,
     // Check types
     if (error.IsString() && message.IsString() && payload.IsObject())
     {
-        (void)unique_id;
+        // Notify the corresponding call
+        completePendingCall(unique_id, nullptr);
+
         ret = true;
     }
 
@@ -340,58 +684,117 @@ bool RpcBase::decodeCallError(const std::string&      unique_id,
 void RpcBase::sendCallError(const std::string& unique_id, const char* error, const std::string& message)
 {
     // Serialize message
-    std::stringstream serialized_message;
-    serialized_message << "[";
-    serialized_message << CALLERROR << ", ";
-    serialized_message << "\"" << unique_id << "\", ";
-    serialized_message << "\"" << error << "\", ";
-    serialized_message << "\"" << message << "\", ";
-    serialized_message << "{}";
-    serialized_message << "]";
-
-    // Send message
-    std::string msg = serialized_message.str();
-    send(msg);
+    RpcFrameWriter frame(sendHeadroom());
+    if (frame.writeCallError(unique_id, error, message))
+    {
+        // Send message, the connection is closed if the High priority lane is full since a response cannot be dropped
+        send(frame, ocpp::websockets::SendPriority::High);
+    }
 }
 
-/** @brief Reception thread */
-void RpcBase::rxThread()
+/** @brief Process an incomming CALL request */
+void RpcBase::processCall(const RpcMessage& rpc_message)
 {
-    // Thread loop
-    RpcMessage* rpc_message = nullptr;
-    while (m_requests_queue.pop(rpc_message))
-    {
-        // Notify call
-        rapidjson::Document response;
-        std::string         error;
-        const char*         error_code = nullptr;
-        response.Parse("{}");
-        if (m_rpc_listener->rpcCallReceived(rpc_message->action, rpc_message->payload, response, error_code, error))
+    // Notify call, the response only lives until it has been serialized
+    ocpp::json::JsonArena arena;
+    rapidjson::Document   response(rapidjson::kObjectType, &arena.allocator());
+    std::string           error;
+    const char*           error_code = nullptr;
+    bool                  accepted;
+    if (rpc_message.stream_handler)
+    {
+        accepted = rpc_message.stream_handler->rpcStreamedCallReceived(
+            rpc_message.action, rpc_message.frame.c_str(), rpc_message.frame.size(), response, error_code, error);
+    }
+    else
+    {
+        accepted = m_rpc_listener->rpcCallReceived(rpc_message.action, *rpc_message.payload, response, error_code, error);
+    }
+    if (accepted)
+    {
+        // Serialize message
+        RpcFrameWriter frame(sendHeadroom());
+        if (frame.writeCallResult(rpc_message.unique_id, response))
         {
-            // Serialize message
-            rapidjson::StringBuffer                    buffer;
-            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-            response.Accept(writer);
-
-            std::stringstream serialized_message;
-            serialized_message << "[";
-            serialized_message << CALLRESULT << ", ";
-            serialized_message << "\"" << rpc_message->unique_id << "\", ";
-            serialized_message << buffer.GetString();
-            serialized_message << "]";
-
             // Send message
-            std::string msg = serialized_message.str();
-            send(msg);
+            send(frame, ocpp::websockets::SendPriority::High);
+        }
+    }
+    else
+    {
+        // Error
+        if (!error_code)
+        {
+            error_code = RPC_ERROR_GENERIC;
+        }
+        sendCallError(rpc_message.unique_id, error_code, error);
+    }
+}
+
+/** @brief Notify the completion of an asynchronous call */
+void RpcBase::processCallCompletion(RpcMessage& rpc_message)
+{
+    PendingCall* pending_call = rpc_message.pending_call;
+    pending_call->completion(pending_call->success, rpc_message.document);
+    delete pending_call;
+    rpc_message.pending_call = nullptr;
+}
+
+/** @brief Queue a message for the reception thread */
+void RpcBase::queueMessage(RpcMessage* rpc_message)
+{
+    m_requests_queue.push(rpc_message);
+    RpcPool* pool = m_pool;
+    if (pool)
+    {
+        pool->schedule(*this);
+    }
+}
+
+/** @brief Wakeup the reception thread at a given deadline */
+void RpcBase::scheduleDeadline(std::chrono::steady_clock::time_point deadline)
+{
+    RpcPool* pool = m_pool;
+    if (pool)
+    {
+        pool->scheduleAt(*this, deadline);
+    }
+    else
+    {
+        // Wakeup the reception thread so that it takes the deadline into account
+        m_requests_queue.push(nullptr);
+    }
+}
+
+/** @brief Indicate if the current thread is the reception thread */
+bool RpcBase::isReceptionThread() const
+{
+    bool     ret  = false;
+    RpcPool* pool = m_pool;
+    if (pool)
+    {
+        ret = pool->isPoolThread();
+    }
+    else if (m_rx_thread)
+    {
+        ret = (std::this_thread::get_id() == m_rx_thread->get_id());
+    }
+    return ret;
+}
+
+/** @brief Process a message from the reception queue */
+void RpcBase::processMessage(RpcMessage* rpc_message)
+{
+    // Null messages are only used to wakeup the reception thread
+    if (rpc_message)
+    {
+        if (rpc_message->pending_call)
+        {
+            processCallCompletion(*rpc_message);
         }
         else
         {
-            // Error
-            if (!error_code)
-            {
-                error_code = RPC_ERROR_GENERIC;
-            }
-            sendCallError(rpc_message->unique_id, error_code, error);
+            processCall(*rpc_message);
         }
 
         // Free resources
@@ -399,5 +802,67 @@ void RpcBase::rxThread()
     }
 }
 
+/** @brief Process the queued messages from a thread of the shared pool */
+void RpcBase::processQueuedMessages()
+{
+    // Limit the number of processed messages to share the pool between the connections
+    RpcMessage*  rpc_message = nullptr;
+    unsigned int count       = 0;
+    while ((count < MAX_MESSAGES_PER_POOL_SCHEDULING) && m_requests_queue.pop(rpc_message, 0))
+    {
+        processMessage(rpc_message);
+        count++;
+    }
+
+    // The connection may have been stopped while processing the messages
+    RpcPool* pool = m_pool;
+    if (pool)
+    {
+        if (count == MAX_MESSAGES_PER_POOL_SCHEDULING)
+        {
+            pool->schedule(*this);
+        }
+
+        // Check asynchronous calls timeouts
+        expirePendingCalls();
+        auto next_deadline = nextPendingCallDeadline();
+        if (next_deadline != std::chrono::steady_clock::time_point::max())
+        {
+            pool->scheduleAt(*this, next_deadline);
+        }
+    }
+}
+
+/** @brief Reception thread */
+void RpcBase::rxThread()
+{
+    // Thread loop
+    while (!m_rx_thread_stop)
+    {
+        // Compute the timeout until the next asynchronous call deadline
+        unsigned int timeout       = std::numeric_limits<unsigned int>::max();
+        auto         next_deadline = nextPendingCallDeadline();
+        if (next_deadline != std::chrono::steady_clock::time_point::max())
+        {
+            auto now = std::chrono::steady_clock::now();
+            timeout  = 0;
+            if (next_deadline > now)
+            {
+                timeout = static_cast<unsigned int>(std::chrono::ceil<std::chrono::milliseconds>(next_deadline - now).count());
+            }
+        }
+
+        // Wait for a message or for the next asynchronous call deadline
+        RpcMessage* rpc_message = nullptr;
+        if (m_requests_queue.pop(rpc_message, timeout))
+        {
+            processMessage(rpc_message);
+        }
+
+        // Check asynchronous calls timeouts
+        expirePendingCalls();
+    }
+}
+
 } // namespace rpc
 } // namespace ocpp
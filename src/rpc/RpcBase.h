@@ -21,10 +21,13 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 
 #include "IRpc.h"
 #include "Queue.h"
+#include "SendPriority.h"
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace ocpp
@@ -32,9 +35,14 @@ namespace ocpp
 namespace rpc
 {
 
+class RpcFrameWriter;
+class RpcPool;
+
 /** @brief Base class for RPC implementations */
 class RpcBase : public IRpc
 {
+    friend class RpcPool;
+
   public:
     /** @brief Constructor */
     RpcBase();
@@ -50,15 +58,33 @@ class RpcBase : public IRpc
               rapidjson::Document&       response,
               std::chrono::milliseconds  timeout = std::chrono::seconds(2)) override;
 
+    /** @copydoc bool IRpc::callAsync(const std::string&, const rapidjson::Document&, CallCompletionFunc, std::chrono::milliseconds) */
+    bool callAsync(const std::string&         action,
+                   const rapidjson::Document& payload,
+                   CallCompletionFunc         completion,
+                   std::chrono::milliseconds  timeout = std::chrono::seconds(2)) override;
+
     /** @copydoc void IRpc::registerListener(IListener&) */
     void registerListener(IRpc::IListener& listener) override;
 
     /** @copydoc void IRpc::registerSpy(ISpy&) */
     void registerSpy(IRpc::ISpy& spy) override;
 
+    /** @copydoc void IRpc::registerStreamHandler(const std::string&, IStreamHandler&) */
+    void registerStreamHandler(const std::string& action, IRpc::IStreamHandler& handler) override;
+
+    /**
+     * @brief Set the maximum number of CALL requests which can wait for their response at the same time
+     * @param max_pending_calls Maximum number of pending CALL requests (1 = only one request at a time)
+     */
+    void setMaxPendingCalls(unsigned int max_pending_calls);
+
   protected:
-    /** @brief Start RPC operations */
-    void start();
+    /**
+     * @brief Start RPC operations
+     * @param pool Shared pool to process the received messages, if nullptr a dedicated reception thread is started
+     */
+    void start(RpcPool* pool = nullptr);
     /** @brief Stop RPC operations */
     void stop();
     /** @brief Process received data */
@@ -66,12 +92,19 @@ class RpcBase : public IRpc
     /** @brief Get the RPC listener */
     IRpc::IListener* rpcListener() { return m_rpc_listener; }
 
+    /**
+     * @brief Get the number of bytes to reserve at the start of the frames given to doSend()
+     * @return Number of bytes to reserve
+     */
+    virtual size_t sendHeadroom() const = 0;
+
     /**
      * @brief Send data through the websocket connection
-     * @param msg Message to send
+     * @param frame Frame to send, starting with sendHeadroom() reserved bytes
+     * @param priority Priority of the frame
      * @return true if the message has been sent, false otherwise
      */
-    virtual bool doSend(const std::string& msg) = 0;
+    virtual bool doSend(std::string&& frame, ocpp::websockets::SendPriority priority) = 0;
 
   private:
     /** @brief Message types */
@@ -83,46 +116,124 @@ class RpcBase : public IRpc
         INVALID    = 5
     };
 
+    /** @brief Pending CALL request */
+    struct PendingCall
+    {
+        /** @brief Constructor for a synchronous call */
+        PendingCall(rapidjson::Document& _response)
+            : response(&_response), completion(), deadline(), cond_var(), completed(false), success(false)
+        {
+        }
+        /** @brief Constructor for an asynchronous call */
+        PendingCall(IRpc::CallCompletionFunc _completion)
+            : response(nullptr),
+              completion(_completion),
+              deadline(std::chrono::steady_clock::time_point::max()),
+              cond_var(),
+              completed(false),
+              success(false)
+        {
+        }
+
+        /** @brief JSON response to fill (synchronous call only) */
+        rapidjson::Document* response;
+        /** @brief Completion function (asynchronous call only) */
+        IRpc::CallCompletionFunc completion;
+        /** @brief Response deadline (asynchronous call only) */
+        std::chrono::steady_clock::time_point deadline;
+        /** @brief Condition variable for end of call synchronization (synchronous call only) */
+        std::condition_variable cond_var;
+        /** @brief Indicate that the call has been completed */
+        bool completed;
+        /** @brief Indicate that a response has been received */
+        bool success;
+    };
+
     /** @brief RPC message */
     struct RpcMessage
     {
-        RpcMessage(const std::string& _unique_id, const char* _action, const rapidjson::Value& _payload)
-            : unique_id(_unique_id), action(_action), payload()
+        /** @brief Constructor for a received frame */
+        RpcMessage(const void* data, size_t size)
+            : frame(reinterpret_cast<const char*>(data), size),
+              document(),
+              unique_id(),
+              action(),
+              payload(nullptr),
+              pending_call(nullptr),
+              stream_handler(nullptr)
         {
-            payload.CopyFrom(_payload, payload.GetAllocator());
         }
-        RpcMessage(const std::string& _unique_id, const rapidjson::Value& _payload) : unique_id(_unique_id), action(), payload()
+        /** @brief Constructor for the completion of an asynchronous call */
+        RpcMessage(PendingCall* _pending_call)
+            : frame(), document(), unique_id(), action(), payload(&document), pending_call(_pending_call), stream_handler(nullptr)
         {
-            payload.CopyFrom(_payload, payload.GetAllocator());
+            document.SetObject();
         }
-        const std::string   unique_id;
-        const std::string   action;
-        rapidjson::Document payload;
+
+        /** @brief Received frame, also used as buffer for in-situ parsing */
+        std::string frame;
+        /** @brief Parsed JSON document */
+        rapidjson::Document document;
+        /** @brief Unique identifier */
+        std::string unique_id;
+        /** @brief Action */
+        std::string action;
+        /** @brief JSON payload (stored inside the parsed JSON document) */
+        const rapidjson::Value* payload;
+        /** @brief Asynchronous call to complete (nullptr for an incomming CALL request) */
+        PendingCall* pending_call;
+        /** @brief Handler decoding the payload from the frame (nullptr if the frame has been parsed) */
+        IRpc::IStreamHandler* stream_handler;
     };
 
     /** @brief RPC listener */
     IRpc::IListener* m_rpc_listener;
     /** @brief RPC spies */
     std::vector<IRpc::ISpy*> m_spies;
+    /** @brief Handlers of the CALL messages decoded directly from the received frame */
+    std::unordered_map<std::string, IRpc::IStreamHandler*> m_stream_handlers;
     /** @brief Transaction id */
     int m_transaction_id;
-    /** @brief Mutex for concurrent call access */
-    std::mutex m_call_mutex;
+    /** @brief Mutex for concurrent access to the pending calls */
+    std::mutex m_pending_calls_mutex;
+    /** @brief Condition variable to wait for a free slot in the pending calls window */
+    std::condition_variable m_pending_calls_cond_var;
+    /** @brief Pending calls indexed by unique id */
+    std::unordered_map<std::string, PendingCall*> m_pending_calls;
+    /** @brief Maximum number of pending calls */
+    unsigned int m_max_pending_calls;
     /** @brief Queue for incomming call requests */
     ocpp::helpers::Queue<RpcMessage*> m_requests_queue;
-    /** @brief Queue for incomming call results */
-    ocpp::helpers::Queue<RpcMessage*> m_results_queue;
     /** @brief Reception thread */
     std::thread* m_rx_thread;
+    /** @brief Indicate that the reception thread must stop */
+    std::atomic<bool> m_rx_thread_stop;
+    /** @brief Shared pool processing the received messages (replaces the reception thread) */
+    std::atomic<RpcPool*> m_pool;
 
     /** @brief Send a message through the websocket connection */
-    bool send(const std::string& msg);
+    bool send(RpcFrameWriter& frame, ocpp::websockets::SendPriority priority);
+
+    /** @brief Complete a pending call */
+    void completePendingCall(const std::string& unique_id, rapidjson::Document* response);
+
+    /** @brief Abort all the pending calls */
+    void abortPendingCalls();
+
+    /** @brief Get the next asynchronous call deadline */
+    std::chrono::steady_clock::time_point nextPendingCallDeadline();
+
+    /** @brief Complete the asynchronous calls which have reached their deadline */
+    void expirePendingCalls();
+
+    /** @brief Decode the header of a CALL message whose payload is decoded by a stream handler */
+    bool decodeStreamedCall(RpcMessage*& rpc_message);
 
     /** @brief Decode a CALL message */
-    bool decodeCall(const std::string& unique_id, const rapidjson::Value& action, const rapidjson::Value& payload);
+    bool decodeCall(RpcMessage*& rpc_message, const rapidjson::Value& action, rapidjson::Value& payload);
 
     /** @brief Decode a CALLRESULT message */
-    bool decodeCallResult(const std::string& unique_id, const rapidjson::Value& payload);
+    bool decodeCallResult(RpcMessage& rpc_message, rapidjson::Value& payload);
 
     /** @brief Decode a CALLERROR message */
     bool decodeCallError(const std::string&      unique_id,
@@ -133,6 +244,27 @@ class RpcBase : public IRpc
     /** @brief Send a CALLERROR message */
     void sendCallError(const std::string& unique_id, const char* error, const std::string& message);
 
+    /** @brief Process an incomming CALL request */
+    void processCall(const RpcMessage& rpc_message);
+
+    /** @brief Notify the completion of an asynchronous call */
+    void processCallCompletion(RpcMessage& rpc_message);
+
+    /** @brief Queue a message for the reception thread */
+    void queueMessage(RpcMessage* rpc_message);
+
+    /** @brief Wakeup the reception thread at a given deadline */
+    void scheduleDeadline(std::chrono::steady_clock::time_point deadline);
+
+    /** @brief Indicate if the current thread is the reception thread */
+    bool isReceptionThread() const;
+
+    /** @brief Process a message from the reception queue */
+    void processMessage(RpcMessage* rpc_message);
+
+    /** @brief Process the queued messages from a thread of the shared pool */
+    void processQueuedMessages();
+
     /** @brief Reception thread */
     void rxThread();
 };
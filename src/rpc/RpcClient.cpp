@@ -134,11 +134,17 @@ void RpcClient::wsClientDataReceived(const void* data, size_t size)
 
 // RpcBase interface
 
-/** @copydoc bool RpcBase::doSend(const std::string&) */
-bool RpcClient::doSend(const std::string& msg)
+/** @copydoc size_t RpcBase::sendHeadroom() const */
+size_t RpcClient::sendHeadroom() const
+{
+    return m_websocket.sendHeadroom();
+}
+
+/** @copydoc bool RpcBase::doSend(std::string&&, ocpp::websockets::SendPriority) */
+bool RpcClient::doSend(std::string&& frame, ocpp::websockets::SendPriority priority)
 {
     // Send message
-    return m_websocket.send(msg.c_str(), msg.size());
+    return m_websocket.send(std::move(frame), priority);
 }
 
 } // namespace rpc
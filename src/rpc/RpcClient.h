@@ -103,8 +103,11 @@ class RpcClient : public RpcBase, public ocpp::websockets::IWebsocketClient::ILi
     };
 
   protected:
-    /** @copydoc bool RpcBase::doSend(const std::string&) */
-    bool doSend(const std::string& msg) override;
+    /** @copydoc size_t RpcBase::sendHeadroom() const */
+    size_t sendHeadroom() const override;
+
+    /** @copydoc bool RpcBase::doSend(std::string&&, ocpp::websockets::SendPriority) */
+    bool doSend(std::string&& frame, ocpp::websockets::SendPriority priority) override;
 
   private:
     /** @brief Protocol version */
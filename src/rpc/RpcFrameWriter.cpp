@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RpcFrameWriter.h"
+
+#include <cstring>
+
+namespace ocpp
+{
+namespace rpc
+{
+
+/** @brief RPC call type */
+static constexpr unsigned int CALL = 2u;
+/** @brief RPC call result type */
+static constexpr unsigned int CALLRESULT = 3u;
+/** @brief RPC call error type */
+static constexpr unsigned int CALLERROR = 4u;
+
+/** @brief Constructor */
+RpcFrameWriter::RpcFrameWriter(size_t headroom) : m_headroom(headroom), m_frame(headroom, '\0'), m_stack_buffer() { }
+
+/** @brief Destructor */
+RpcFrameWriter::~RpcFrameWriter() { }
+
+/** @brief Serialize a CALL message */
+bool RpcFrameWriter::writeCall(const std::string& unique_id, const std::string& action, const rapidjson::Value& payload)
+{
+    Message message = {CALL, &unique_id, action.c_str(), action.size(), nullptr, &payload};
+    return write(message);
+}
+
+/** @brief Serialize a CALLRESULT message */
+bool RpcFrameWriter::writeCallResult(const std::string& unique_id, const rapidjson::Value& payload)
+{
+    Message message = {CALLRESULT, &unique_id, nullptr, 0, nullptr, &payload};
+    return write(message);
+}
+
+/** @brief Serialize a CALLERROR message */
+bool RpcFrameWriter::writeCallError(const std::string& unique_id, const char* error, const std::string& message)
+{
+    Message error_message = {CALLERROR, &unique_id, error, strlen(error), &message, nullptr};
+    return write(error_message);
+}
+
+/** @brief Serialize a message into the frame buffer */
+bool RpcFrameWriter::write(const Message& message)
+{
+    bool ret = false;
+
+    // Serialize the message once in the reusable buffer of the thread
+    std::string& buffer = threadBuffer();
+    buffer.clear();
+    BufferStream buffer_stream(buffer);
+    if (serialize(buffer_stream, message))
+    {
+        // Copy it after the headroom, the frame buffer is allocated only once with its final size
+        m_frame.resize(m_headroom);
+        m_frame.reserve(m_headroom + buffer.size());
+        m_frame.append(buffer);
+        ret = true;
+    }
+
+    return ret;
+}
+
+/** @brief Get the serialization buffer of the calling thread, its capacity is kept between the messages */
+std::string& RpcFrameWriter::threadBuffer()
+{
+    static thread_local std::string buffer;
+    return buffer;
+}
+
+/** @brief Serialize a message into an output stream */
+template <typename OutputStream>
+bool RpcFrameWriter::serialize(OutputStream& stream, const Message& message)
+{
+    // The writer's stack is allocated inside the internal buffer
+    rapidjson::MemoryPoolAllocator<> stack_allocator(m_stack_buffer, sizeof(m_stack_buffer));
+    rapidjson::Writer<OutputStream, rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>> writer(stream,
+                                                                                                                   &stack_allocator);
+
+    // [type, "unique_id", ("action" | "error", "message",) payload]
+    bool ret = writer.StartArray();
+    ret      = ret && writer.Uint(message.type);
+    ret      = ret && writer.String(message.unique_id->c_str(), static_cast<rapidjson::SizeType>(message.unique_id->size()));
+    if (message.action)
+    {
+        ret = ret && writer.String(message.action, static_cast<rapidjson::SizeType>(message.action_length));
+    }
+    if (message.error_message)
+    {
+        ret = ret && writer.String(message.error_message->c_str(), static_cast<rapidjson::SizeType>(message.error_message->size()));
+    }
+    if (message.payload)
+    {
+        ret = ret && message.payload->Accept(writer);
+    }
+    else
+    {
+        ret = ret && writer.StartObject() && writer.EndObject();
+    }
+    ret = ret && writer.EndArray();
+
+    return ret;
+}
+
+} // namespace rpc
+} // namespace ocpp
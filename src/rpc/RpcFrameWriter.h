@@ -0,0 +1,138 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RPCFRAMEWRITER_H
+#define RPCFRAMEWRITER_H
+
+#include "json.h"
+
+#include <string>
+
+namespace ocpp
+{
+namespace rpc
+{
+
+/** @brief Serialize RPC frames in a single buffer which can be directly moved to the websocket layer */
+class RpcFrameWriter
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param headroom Number of bytes to reserve at the start of the frame buffer for the websocket layer
+     */
+    RpcFrameWriter(size_t headroom);
+
+    /** @brief Destructor */
+    virtual ~RpcFrameWriter();
+
+    /**
+     * @brief Serialize a CALL message
+     * @param unique_id Unique identifier of the message
+     * @param action Action
+     * @param payload JSON payload
+     * @return true if the message has been serialized, false otherwise
+     */
+    bool writeCall(const std::string& unique_id, const std::string& action, const rapidjson::Value& payload);
+
+    /**
+     * @brief Serialize a CALLRESULT message
+     * @param unique_id Unique identifier of the message
+     * @param payload JSON payload
+     * @return true if the message has been serialized, false otherwise
+     */
+    bool writeCallResult(const std::string& unique_id, const rapidjson::Value& payload);
+
+    /**
+     * @brief Serialize a CALLERROR message
+     * @param unique_id Unique identifier of the message
+     * @param error Error code
+     * @param message Error message
+     * @return true if the message has been serialized, false otherwise
+     */
+    bool writeCallError(const std::string& unique_id, const char* error, const std::string& message);
+
+    /**
+     * @brief Get the serialized message
+     * @return Serialized message (without the headroom)
+     */
+    const char* message() const { return &m_frame[m_headroom]; }
+
+    /**
+     * @brief Get the size of the serialized message
+     * @return Size of the serialized message in bytes (without the headroom)
+     */
+    size_t size() const { return m_frame.size() - m_headroom; }
+
+    /**
+     * @brief Get the frame buffer, it can be moved to the websocket layer
+     * @return Frame buffer starting with the headroom
+     */
+    std::string& frame() { return m_frame; }
+
+  private:
+    /** @brief Contents of an RPC message */
+    struct Message
+    {
+        /** @brief Message type */
+        unsigned int type;
+        /** @brief Unique identifier */
+        const std::string* unique_id;
+        /** @brief Action or error code */
+        const char* action;
+        /** @brief Action or error code length */
+        size_t action_length;
+        /** @brief Error message (CALLERROR only) */
+        const std::string* error_message;
+        /** @brief JSON payload (not used for CALLERROR) */
+        const rapidjson::Value* payload;
+    };
+
+    /** @brief Output stream which appends the serialized characters to a buffer */
+    class BufferStream
+    {
+      public:
+        typedef char Ch;
+        BufferStream(std::string& _buffer) : buffer(_buffer) { }
+        void         Put(Ch c) { buffer.push_back(c); }
+        void         Flush() { }
+        std::string& buffer;
+    };
+
+    /** @brief Number of bytes reserved at the start of the frame buffer */
+    const size_t m_headroom;
+    /** @brief Frame buffer */
+    std::string m_frame;
+    /** @brief Buffer for the internal stack of the JSON writers (avoids dynamic allocations) */
+    char m_stack_buffer[1024u];
+
+    /** @brief Serialize a message into the frame buffer */
+    bool write(const Message& message);
+
+    /** @brief Get the serialization buffer of the calling thread, its capacity is kept between the messages */
+    static std::string& threadBuffer();
+
+    /** @brief Serialize a message into an output stream */
+    template <typename OutputStream>
+    bool serialize(OutputStream& stream, const Message& message);
+};
+
+} // namespace rpc
+} // namespace ocpp
+
+#endif // RPCFRAMEWRITER_H
@@ -0,0 +1,266 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RpcPool.h"
+#include "RpcBase.h"
+
+#include <functional>
+
+namespace ocpp
+{
+namespace rpc
+{
+
+/** @brief Constructor */
+RpcPool::RpcPool(unsigned int thread_count)
+    : m_mutex(),
+      m_cond_var(),
+      m_end_of_processing_cond_var(),
+      m_stop(false),
+      m_threads(),
+      m_connections(),
+      m_ready_connections(),
+      m_deadlines()
+{
+    // At least 1 thread is needed
+    if (thread_count == 0)
+    {
+        thread_count = 1u;
+    }
+
+    // Start threads
+    for (unsigned int i = 0; i < thread_count; i++)
+    {
+        m_threads.push_back(new std::thread(std::bind(&RpcPool::processingThread, this)));
+    }
+}
+
+/** @brief Destructor */
+RpcPool::~RpcPool()
+{
+    // Stop threads
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_cond_var.notify_all();
+    }
+    for (std::thread* thread : m_threads)
+    {
+        thread->join();
+        delete thread;
+    }
+}
+
+/** @brief Register a connection to the pool */
+void RpcPool::registerConnection(RpcBase& rpc)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // A connection registered again during its own processing keeps its running state
+    // so that it is not processed by 2 threads at the same time
+    auto it = m_connections.find(&rpc);
+    if (it == m_connections.end())
+    {
+        m_connections[&rpc] = Connection();
+    }
+    else
+    {
+        it->second.active       = true;
+        it->second.unregistered = false;
+    }
+}
+
+/** @brief Unregister a connection from the pool (waits for the end of its processing,
+ *         unless it is called from the thread which is processing the connection) */
+void RpcPool::unregisterConnection(RpcBase& rpc)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto it = m_connections.find(&rpc);
+    if (it != m_connections.end())
+    {
+        // Wait for the end of the current processing, when the connection is unregistered
+        // from its own processing, the processing thread will remove it once done
+        Connection& connection = it->second;
+        connection.active      = false;
+        connection.scheduled   = false;
+        bool self_processing   = (connection.running && (connection.thread == std::this_thread::get_id()));
+        if (self_processing)
+        {
+            connection.unregistered = true;
+        }
+        else
+        {
+            m_end_of_processing_cond_var.wait(lock, [&connection] { return !connection.running; });
+        }
+
+        // Remove all the references to the connection
+        for (auto iter = m_ready_connections.begin(); iter != m_ready_connections.end();)
+        {
+            if (*iter == &rpc)
+            {
+                iter = m_ready_connections.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+        for (auto iter = m_deadlines.begin(); iter != m_deadlines.end();)
+        {
+            if (iter->second == &rpc)
+            {
+                iter = m_deadlines.erase(iter);
+            }
+            else
+            {
+                ++iter;
+            }
+        }
+        if (!self_processing)
+        {
+            m_connections.erase(&rpc);
+        }
+    }
+}
+
+/** @brief Schedule the processing of a connection */
+void RpcPool::schedule(RpcBase& rpc)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_connections.find(&rpc);
+    if (it != m_connections.end())
+    {
+        setReady(&rpc, it->second);
+    }
+}
+
+/** @brief Schedule the processing of a connection at a given time */
+void RpcPool::scheduleAt(RpcBase& rpc, std::chrono::steady_clock::time_point deadline)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Only keep the nearest deadline of each connection
+    auto it = m_connections.find(&rpc);
+    if ((it != m_connections.end()) && (deadline < it->second.deadline))
+    {
+        it->second.deadline = deadline;
+        m_deadlines.emplace(deadline, &rpc);
+        m_cond_var.notify_one();
+    }
+}
+
+/** @brief Indicate if the current thread belongs to the pool */
+bool RpcPool::isPoolThread() const
+{
+    bool ret = false;
+    for (const std::thread* thread : m_threads)
+    {
+        if (thread->get_id() == std::this_thread::get_id())
+        {
+            ret = true;
+            break;
+        }
+    }
+    return ret;
+}
+
+/** @brief Mark a connection as ready to be processed (mutex must be locked) */
+void RpcPool::setReady(RpcBase* rpc, Connection& connection)
+{
+    // A connection which is being processed will be queued again at the end of its processing
+    if (connection.active && !connection.scheduled)
+    {
+        connection.scheduled = true;
+        if (!connection.running)
+        {
+            m_ready_connections.push_back(rpc);
+            m_cond_var.notify_one();
+        }
+    }
+}
+
+/** @brief Thread processing function */
+void RpcPool::processingThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    // Thread loop
+    while (!m_stop)
+    {
+        // Check deadlines
+        auto now = std::chrono::steady_clock::now();
+        while (!m_deadlines.empty() && (m_deadlines.begin()->first <= now))
+        {
+            auto it = m_connections.find(m_deadlines.begin()->second);
+            if ((it != m_connections.end()) && (it->second.deadline == m_deadlines.begin()->first))
+            {
+                it->second.deadline = std::chrono::steady_clock::time_point::max();
+                setReady(it->first, it->second);
+            }
+            m_deadlines.erase(m_deadlines.begin());
+        }
+
+        if (!m_ready_connections.empty())
+        {
+            // Process the next connection
+            RpcBase*    rpc        = m_ready_connections.front();
+            Connection& connection = m_connections[rpc];
+            m_ready_connections.pop_front();
+            connection.scheduled = false;
+            connection.running   = true;
+            connection.thread    = std::this_thread::get_id();
+            lock.unlock();
+
+            rpc->processQueuedMessages();
+
+            lock.lock();
+            if (connection.unregistered)
+            {
+                // The connection has been unregistered during its processing
+                m_connections.erase(rpc);
+            }
+            else
+            {
+                connection.running = false;
+                connection.thread  = std::thread::id();
+                if (connection.scheduled)
+                {
+                    m_ready_connections.push_back(rpc);
+                }
+                m_end_of_processing_cond_var.notify_all();
+            }
+        }
+        else
+        {
+            // Wait for a connection to process or for the next deadline
+            if (m_deadlines.empty())
+            {
+                m_cond_var.wait(lock);
+            }
+            else
+            {
+                m_cond_var.wait_until(lock, m_deadlines.begin()->first);
+            }
+        }
+    }
+}
+
+} // namespace rpc
+} // namespace ocpp
@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RPCPOOL_H
+#define RPCPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ocpp
+{
+namespace rpc
+{
+
+class RpcBase;
+
+/**
+ * @brief Pool of threads shared by multiple RPC connections to process their incoming messages
+ *        The messages of a connection are always processed by one thread at a time to preserve their order
+ */
+class RpcPool
+{
+    friend class RpcBase;
+
+  public:
+    /**
+     * @brief Constructor
+     * @param thread_count Number of threads in the pool
+     */
+    RpcPool(unsigned int thread_count);
+
+    /** @brief Destructor */
+    virtual ~RpcPool();
+
+    /**
+     * @brief Get the number of threads in the pool
+     * @return Number of threads in the pool
+     */
+    unsigned int threadCount() const { return static_cast<unsigned int>(m_threads.size()); }
+
+  private:
+    /** @brief Scheduling state of a connection */
+    struct Connection
+    {
+        /** @brief Constructor */
+        Connection()
+            : active(true),
+              scheduled(false),
+              running(false),
+              unregistered(false),
+              thread(),
+              deadline(std::chrono::steady_clock::time_point::max())
+        {
+        }
+
+        /** @brief Indicate that the connection can be scheduled */
+        bool active;
+        /** @brief Indicate that the connection has messages to process */
+        bool scheduled;
+        /** @brief Indicate that the connection is being processed by a thread */
+        bool running;
+        /** @brief Indicate that the connection has been unregistered during its own processing */
+        bool unregistered;
+        /** @brief Thread processing the connection */
+        std::thread::id thread;
+        /** @brief Next processing deadline */
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    /** @brief Mutex for concurrent access */
+    std::mutex m_mutex;
+    /** @brief Condition variable to wakeup the threads */
+    std::condition_variable m_cond_var;
+    /** @brief Condition variable to signal the end of the processing of a connection */
+    std::condition_variable m_end_of_processing_cond_var;
+    /** @brief Indicate that the threads must stop */
+    bool m_stop;
+    /** @brief Threads */
+    std::vector<std::thread*> m_threads;
+    /** @brief Registered connections */
+    std::unordered_map<RpcBase*, Connection> m_connections;
+    /** @brief Connections ready to be processed */
+    std::deque<RpcBase*> m_ready_connections;
+    /** @brief Processing deadlines */
+    std::multimap<std::chrono::steady_clock::time_point, RpcBase*> m_deadlines;
+
+    /** @brief Register a connection to the pool */
+    void registerConnection(RpcBase& rpc);
+
+    /** @brief Unregister a connection from the pool (waits for the end of its processing,
+     *         unless it is called from the thread which is processing the connection) */
+    void unregisterConnection(RpcBase& rpc);
+
+    /** @brief Schedule the processing of a connection */
+    void schedule(RpcBase& rpc);
+
+    /** @brief Schedule the processing of a connection at a given time */
+    void scheduleAt(RpcBase& rpc, std::chrono::steady_clock::time_point deadline);
+
+    /** @brief Indicate if the current thread belongs to the pool */
+    bool isPoolThread() const;
+
+    /** @brief Mark a connection as ready to be processed (mutex must be locked) */
+    void setReady(RpcBase* rpc, Connection& connection);
+
+    /** @brief Thread processing function */
+    void processingThread();
+};
+
+} // namespace rpc
+} // namespace ocpp
+
+#endif // RPCPOOL_H
@@ -26,9 +26,15 @@ namespace rpc
 {
 
 /** @brief Constructor */
-RpcServer::RpcServer(ocpp::websockets::IWebsocketServer& websocket, const std::string& protocol)
-    : m_protocol(protocol), m_websocket(websocket), m_listener(nullptr), m_started(false)
+RpcServer::RpcServer(ocpp::websockets::IWebsocketServer& websocket, const std::string& protocol, unsigned int pool_threads)
+    : m_protocol(protocol), m_websocket(websocket), m_listener(nullptr), m_started(false), m_pool()
 {
+    // Shared pool for the clients
+    if (pool_threads != 0)
+    {
+        m_pool = std::make_shared<RpcPool>(pool_threads);
+    }
+
     m_websocket.registerListener(*this);
 }
 
@@ -103,7 +109,7 @@ void RpcServer::wsClientConnected(const char* uri, std::shared_ptr<ocpp::websock
     std::string           chargepoint_id = uri_path.filename();
 
     // Instanciate client
-    std::shared_ptr<IClient> rpc_client(new IClient(client));
+    std::shared_ptr<IClient> rpc_client(new IClient(client, m_pool));
 
     // Notify connection
     m_listener->rpcClientConnected(chargepoint_id, rpc_client);
@@ -116,11 +122,12 @@ void RpcServer::wsServerError()
 }
 
 /** @brief Constructor */
-RpcServer::IClient::IClient(std::shared_ptr<ocpp::websockets::IWebsocketServer::IClient> websocket) : RpcBase(), m_websocket(websocket)
+RpcServer::IClient::IClient(std::shared_ptr<ocpp::websockets::IWebsocketServer::IClient> websocket, std::shared_ptr<RpcPool> pool)
+    : RpcBase(), m_websocket(websocket), m_pool(pool)
 {
     // Start processing
     m_websocket->registerListener(*this);
-    RpcBase::start();
+    RpcBase::start(m_pool.get());
 }
 
 /** @brief Destructor */
@@ -164,11 +171,17 @@ void RpcServer::IClient::wsClientDataReceived(const void* data, size_t size)
 
 // RpxBase interface
 
-/** @copydoc bool RpcBase::doSend(const std::string&) */
-bool RpcServer::IClient::doSend(const std::string& msg)
+/** @copydoc size_t RpcBase::sendHeadroom() const */
+size_t RpcServer::IClient::sendHeadroom() const
+{
+    return m_websocket->sendHeadroom();
+}
+
+/** @copydoc bool RpcBase::doSend(std::string&&, ocpp::websockets::SendPriority) */
+bool RpcServer::IClient::doSend(std::string&& frame, ocpp::websockets::SendPriority priority)
 {
     // Send message
-    return m_websocket->send(msg.c_str(), msg.size());
+    return m_websocket->send(std::move(frame), priority);
 }
 
 } // namespace rpc
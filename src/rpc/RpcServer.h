@@ -22,6 +22,9 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "IWebsocketServer.h"
 #include "Queue.h"
 #include "RpcBase.h"
+#include "RpcPool.h"
+
+#include <memory>
 
 namespace ocpp
 {
@@ -36,8 +39,14 @@ class RpcServer : public ocpp::websockets::IWebsocketServer::IListener
     class IClient;
     class IListener;
 
-    /** @brief Constructor */
-    RpcServer(ocpp::websockets::IWebsocketServer& websocket, const std::string& protocol);
+    /**
+     * @brief Constructor
+     * @param websocket Websocket server
+     * @param protocol Protocol version
+     * @param pool_threads Number of threads shared by all the clients to process their received messages,
+     *                     if 0 each client has its own reception thread
+     */
+    RpcServer(ocpp::websockets::IWebsocketServer& websocket, const std::string& protocol, unsigned int pool_threads = 0);
 
     /** @brief Destructor */
     virtual ~RpcServer();
@@ -106,8 +115,12 @@ class RpcServer : public ocpp::websockets::IWebsocketServer::IListener
     class IClient : public RpcBase, public ocpp::websockets::IWebsocketServer::IClient::IListener
     {
       public:
-        /** @brief Constructor */
-        IClient(std::shared_ptr<ocpp::websockets::IWebsocketServer::IClient> websocket);
+        /**
+         * @brief Constructor
+         * @param websocket Websocket connection
+         * @param pool Shared pool to process the received messages, if nullptr a dedicated reception thread is used
+         */
+        IClient(std::shared_ptr<ocpp::websockets::IWebsocketServer::IClient> websocket, std::shared_ptr<RpcPool> pool = nullptr);
         /** @brief Destructor */
         virtual ~IClient();
 
@@ -128,12 +141,17 @@ class RpcServer : public ocpp::websockets::IWebsocketServer::IListener
         void wsClientDataReceived(const void* data, size_t size) override;
 
       protected:
-        /** @copydoc bool RpcBase::doSend(const std::string&) */
-        bool doSend(const std::string& msg) override;
+        /** @copydoc size_t RpcBase::sendHeadroom() const */
+        size_t sendHeadroom() const override;
+
+        /** @copydoc bool RpcBase::doSend(std::string&&, ocpp::websockets::SendPriority) */
+        bool doSend(std::string&& frame, ocpp::websockets::SendPriority priority) override;
 
       private:
         /** @brief Websocket connection */
         std::shared_ptr<ocpp::websockets::IWebsocketServer::IClient> m_websocket;
+        /** @brief Shared pool processing the received messages */
+        std::shared_ptr<RpcPool> m_pool;
     };
 
   private:
@@ -145,6 +163,8 @@ class RpcServer : public ocpp::websockets::IWebsocketServer::IListener
     IListener* m_listener;
     /** @brief Started state */
     bool m_started;
+    /** @brief Shared pool processing the received messages of all the clients */
+    std::shared_ptr<RpcPool> m_pool;
 };
 
 } // namespace rpc
@@ -26,28 +26,156 @@ namespace ocpp
 namespace database
 {
 
+/** @brief Time in ms to wait for a lock before returning SQLITE_BUSY */
+static constexpr int BUSY_TIMEOUT_MS = 5000;
+
+/** @brief Size in bytes of the memory mapped I/O in fast mode */
+static constexpr int64_t FAST_MMAP_SIZE = 64ll * 1024ll * 1024ll;
+/** @brief Size in kB of the page cache in fast mode */
+static constexpr int FAST_CACHE_SIZE_KB = 8 * 1024;
+
+/** @brief Unique identifier generator for the queries */
+static std::atomic<uint64_t> s_next_query_id(1u);
+
+/** @brief Reference to a database which stays valid after its destruction */
+struct Database::Owner
+{
+    /** @brief Mutex to prevent the destruction of the database while it is used */
+    std::mutex mutex;
+    /** @brief Database (nullptr once destroyed) */
+    Database* database;
+};
+
+/** @brief Release the contexts of a thread in all the databases it has used when it exits */
+struct Database::ThreadContextsReleaser
+{
+    /** @brief Destructor */
+    ~ThreadContextsReleaser()
+    {
+        for (auto& weak_owner : owners)
+        {
+            std::shared_ptr<Owner> owner = weak_owner.lock();
+            if (owner)
+            {
+                std::lock_guard<std::mutex> lock(owner->mutex);
+                if (owner->database)
+                {
+                    owner->database->releaseContext(std::this_thread::get_id());
+                }
+            }
+        }
+    }
+
+    /** @brief Register a database used by the thread */
+    void add(const std::shared_ptr<Owner>& owner)
+    {
+        bool found = false;
+        for (auto it = owners.begin(); it != owners.end();)
+        {
+            std::shared_ptr<Owner> registered = it->lock();
+            if (!registered)
+            {
+                it = owners.erase(it);
+            }
+            else
+            {
+                found = found || (registered == owner);
+                ++it;
+            }
+        }
+        if (!found)
+        {
+            owners.push_back(owner);
+        }
+    }
+
+    /** @brief Databases used by the thread */
+    std::vector<std::weak_ptr<Owner>> owners;
+};
+
 /** @brief Constructor */
-Database::Database() : m_db(nullptr) { }
+Database::Database(size_t max_readers)
+    : m_max_readers(max_readers),
+      m_path(),
+      m_db(nullptr),
+      m_durability(Durability::Safe),
+      m_wal(false),
+      m_readers_count(0),
+      m_mutex(),
+      m_contexts(),
+      m_writer_mutex(),
+      m_generation(0),
+      m_owner(std::make_shared<Owner>())
+{
+    m_owner->database = this;
+}
 /** @brief Destructor */
 Database::~Database()
 {
+    // Exiting threads must not access the database anymore
+    {
+        std::lock_guard<std::mutex> lock(m_owner->mutex);
+        m_owner->database = nullptr;
+    }
     close();
 }
 
+/** @brief Get a durability profile from its name */
+Database::Durability Database::durabilityFromString(const std::string& name)
+{
+    Durability durability = Durability::Safe;
+    if (name == "balanced")
+    {
+        durability = Durability::Balanced;
+    }
+    else if (name == "fast")
+    {
+        durability = Durability::Fast;
+    }
+    return durability;
+}
+
 /** @brief Open a database */
-bool Database::open(const std::string& database_path)
+bool Database::open(const std::string& database_path, Durability durability)
 {
     bool ret = false;
 
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     // Check if the database is opened
     if (!m_db)
     {
-        // Open database
+        // Open writer connection
         if (sqlite3_open_v2(database_path.c_str(), &m_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX, nullptr) ==
             SQLITE_OK)
         {
+            sqlite3_busy_timeout(m_db, BUSY_TIMEOUT_MS);
+
+            // Switch to WAL mode so that readers and writer don't block each other,
+            // in-memory databases stay in memory journal mode and have no readers
+            sqlite3_stmt* stmt = nullptr;
+            if ((sqlite3_prepare_v2(m_db, "PRAGMA journal_mode=WAL;", -1, &stmt, nullptr) == SQLITE_OK) &&
+                (sqlite3_step(stmt) == SQLITE_ROW))
+            {
+                const char* mode = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                m_wal            = (mode && (strcmp(mode, "wal") == 0));
+            }
+            sqlite3_finalize(stmt);
+
+            // Apply durability profile
+            m_durability = durability;
+            configure(m_db);
+
+            m_path = database_path;
+            m_generation++;
             ret = true;
         }
+        else
+        {
+            // Free resources
+            sqlite3_close_v2(m_db);
+            m_db = nullptr;
+        }
     }
 
     return ret;
@@ -58,13 +186,24 @@ bool Database::close()
 {
     bool ret = false;
 
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     // Check if the database is opened
     if (m_db)
     {
+        // Free the prepared statements and the read-only connections
+        for (auto& context : m_contexts)
+        {
+            freeContextUnlocked(*context.second);
+        }
+        m_contexts.clear();
+
         // Close and free resources
         sqlite3_close_v2(m_db);
-        m_db = nullptr;
-        ret  = true;
+        m_db  = nullptr;
+        m_wal = false;
+        m_generation++;
+        ret = true;
     }
 
     return ret;
@@ -75,55 +214,332 @@ std::unique_ptr<Database::Query> Database::query(const std::string& sql)
 {
     std::unique_ptr<Database::Query> query(nullptr);
 
-    // Check if the database is opened
+    // Check if the query is valid for the calling thread
+    Statement* statement = this->statement(sql);
+    if (statement)
+    {
+        // The statement may have been used by another query with the same SQL text
+        sqlite3_reset(statement->stmt);
+        sqlite3_clear_bindings(statement->stmt);
+
+        // Allocate new query
+        query = std::make_unique<Database::Query>(*this, sql);
+    }
+
+    return query;
+}
+
+/** @brief Execute a query once for each item of a batch inside a single transaction */
+bool Database::execBatch(Query& query, size_t count, const std::function<void(Query&, size_t)>& bind)
+{
+    Transaction transaction(*this);
+    bool        ret = transaction.isActive();
+    for (size_t i = 0; ret && (i < count); i++)
+    {
+        query.reset();
+        bind(query, i);
+        ret = query.exec();
+    }
+    if (ret)
+    {
+        ret = transaction.commit();
+    }
+
+    return ret;
+}
+
+/** @brief Get the string explaining the last error */
+std::string Database::lastError() const
+{
+    std::string error;
     if (m_db)
     {
-        // Create new statement
-        sqlite3_stmt* stmt = nullptr;
-        if (sqlite3_prepare_v2(m_db, sql.c_str(), sql.size() + 1, &stmt, nullptr) == SQLITE_OK)
+        error = sqlite3_errmsg(m_db);
+    }
+    return error;
+}
+
+/** @brief Get the prepared statement of the calling thread for an SQL text */
+Database::Statement* Database::statement(const std::string& sql, bool in_transaction)
+{
+    Statement* ret = nullptr;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Get the context of the calling thread
+    ThreadContext* context = contextUnlocked();
+    if (context)
+    {
+        // Look for an already prepared statement
+        auto& statements = (in_transaction ? context->transaction_statements : context->statements);
+        auto  it         = statements.find(sql);
+        if (it != statements.end())
         {
-            // Allocate new query
-            query = std::make_unique<Database::Query>(*this, stmt);
+            ret = &it->second;
         }
         else
         {
-            // Free resources
-            if (stmt)
+            Statement statement = {nullptr, context, false};
+
+            // Read-only queries returning rows are executed on the reader connection
+            if (!in_transaction && context->reader)
             {
-                sqlite3_finalize(stmt);
+                if ((sqlite3_prepare_v2(context->reader, sql.c_str(), sql.size() + 1, &statement.stmt, nullptr) == SQLITE_OK) &&
+                    statement.stmt && sqlite3_stmt_readonly(statement.stmt) && (sqlite3_column_count(statement.stmt) > 0))
+                {
+                    statement.on_reader = true;
+                }
+                else
+                {
+                    sqlite3_finalize(statement.stmt);
+                    statement.stmt = nullptr;
+                }
+            }
+
+            // Other queries are executed on the writer connection
+            if (!statement.stmt)
+            {
+                if (sqlite3_prepare_v2(m_db, sql.c_str(), sql.size() + 1, &statement.stmt, nullptr) != SQLITE_OK)
+                {
+                    sqlite3_finalize(statement.stmt);
+                    statement.stmt = nullptr;
+                }
+            }
+
+            // Cache the statement
+            if (statement.stmt)
+            {
+                ret = &statements.emplace(sql, statement).first->second;
             }
         }
     }
 
-    return query;
+    return ret;
 }
 
-/** @brief Get the string explaining the last error */
-std::string Database::lastError() const
+/** @brief Get the context of the calling thread, the contexts must be locked */
+Database::ThreadContext* Database::contextUnlocked()
 {
-    std::string error;
+    ThreadContext* ret = nullptr;
+
+    // Check if the database is opened
     if (m_db)
     {
-        error = sqlite3_errmsg(m_db);
+        auto& context = m_contexts[std::this_thread::get_id()];
+        if (!context)
+        {
+            context                    = std::make_unique<ThreadContext>();
+            context->reader            = openReader();
+            context->transaction_depth = 0;
+            context->rollback_only     = false;
+
+            // The context will be released when the thread exits
+            thread_local ThreadContextsReleaser s_releaser;
+            s_releaser.add(m_owner);
+        }
+        ret = context.get();
+    }
+
+    return ret;
+}
+
+/** @brief Release the context of an exiting thread */
+void Database::releaseContext(std::thread::id thread)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_contexts.find(thread);
+    if (it != m_contexts.end())
+    {
+        // Its read-only connection can now be used by another thread
+        freeContextUnlocked(*it->second);
+        m_contexts.erase(it);
+    }
+}
+
+/** @brief Release the resources of a context, the contexts must be locked */
+void Database::freeContextUnlocked(ThreadContext& context)
+{
+    for (auto& statement : context.statements)
+    {
+        sqlite3_finalize(statement.second.stmt);
+    }
+    for (auto& statement : context.transaction_statements)
+    {
+        sqlite3_finalize(statement.second.stmt);
+    }
+    if (context.reader)
+    {
+        sqlite3_close_v2(context.reader);
+        m_readers_count--;
     }
-    return error;
+}
+
+/** @brief Begin a transaction for the calling thread */
+bool Database::beginTransaction()
+{
+    bool ret = false;
+
+    ThreadContext* context = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        context = contextUnlocked();
+    }
+    if (context)
+    {
+        // Block the writes of the other threads until the end of the transaction
+        m_writer_mutex.lock();
+        if (context->transaction_depth == 0)
+        {
+            // Take the write lock immediately to avoid busy errors on the first write
+            ret                    = (sqlite3_exec(m_db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) == SQLITE_OK);
+            context->rollback_only = false;
+        }
+        else
+        {
+            // Merged into the outermost transaction
+            ret = true;
+        }
+        if (ret)
+        {
+            context->transaction_depth++;
+        }
+        else
+        {
+            m_writer_mutex.unlock();
+        }
+    }
+
+    return ret;
+}
+
+/** @brief End the transaction of the calling thread */
+bool Database::endTransaction(bool commit)
+{
+    bool ret = false;
+
+    ThreadContext* context = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        context = contextUnlocked();
+    }
+    if (context && (context->transaction_depth != 0))
+    {
+        context->transaction_depth--;
+        if (context->transaction_depth == 0)
+        {
+            // Outermost transaction
+            if (commit && !context->rollback_only)
+            {
+                ret = (sqlite3_exec(m_db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK);
+                if (!ret)
+                {
+                    sqlite3_exec(m_db, "ROLLBACK;", nullptr, nullptr, nullptr);
+                }
+            }
+            else
+            {
+                // A commit request fails if a nested transaction has been rolled back
+                bool rolled_back = (sqlite3_exec(m_db, "ROLLBACK;", nullptr, nullptr, nullptr) == SQLITE_OK);
+                ret              = (rolled_back && !commit);
+            }
+            context->rollback_only = false;
+        }
+        else
+        {
+            // Nested transaction, the outermost one will not be committed if it is rolled back
+            if (!commit)
+            {
+                context->rollback_only = true;
+            }
+            ret = true;
+        }
+        m_writer_mutex.unlock();
+    }
+
+    return ret;
+}
+
+/** @brief Open a read-only connection */
+sqlite3* Database::openReader()
+{
+    sqlite3* reader = nullptr;
+
+    // Readers are only useful in WAL mode
+    if (m_wal && (m_readers_count < m_max_readers))
+    {
+        // Each reader is used by a single thread
+        if (sqlite3_open_v2(m_path.c_str(), &reader, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) == SQLITE_OK)
+        {
+            sqlite3_busy_timeout(reader, BUSY_TIMEOUT_MS);
+            configure(reader);
+            m_readers_count++;
+        }
+        else
+        {
+            sqlite3_close_v2(reader);
+            reader = nullptr;
+        }
+    }
+
+    return reader;
+}
+
+/** @brief Apply the durability profile to a connection */
+void Database::configure(sqlite3* db)
+{
+    std::string pragmas;
+    switch (m_durability)
+    {
+        case Durability::Balanced:
+            pragmas = "PRAGMA synchronous=NORMAL;";
+            break;
+
+        case Durability::Fast:
+            pragmas = "PRAGMA synchronous=OFF;PRAGMA temp_store=MEMORY;";
+            pragmas += "PRAGMA mmap_size=" + std::to_string(FAST_MMAP_SIZE) + ";";
+            pragmas += "PRAGMA cache_size=-" + std::to_string(FAST_CACHE_SIZE_KB) + ";";
+            break;
+
+        case Durability::Safe:
+        default:
+            pragmas = "PRAGMA synchronous=FULL;";
+            break;
+    }
+    sqlite3_exec(db, pragmas.c_str(), nullptr, nullptr, nullptr);
 }
 
 // Database::Query
 
 /** @brief Constructor */
-Database::Query::Query(Database& database, sqlite3_stmt* stmt) : m_database(database), m_stmt(stmt), m_has_rows(false) { }
+Database::Query::Query(Database& database, const std::string& sql)
+    : m_database(database), m_sql(sql), m_id(s_next_query_id++), m_result_thread(), m_result_generation(0)
+{
+}
 /** @brief Destructor */
 Database::Query::~Query()
 {
-    sqlite3_finalize(m_stmt);
+    // Release the snapshot held by an unfinished result, the statement can
+    // only be accessed by the thread which owns the read-only connection
+    if ((m_result_thread == std::this_thread::get_id()) && (m_result_generation == m_database.m_generation))
+    {
+        Statement* statement = m_database.statement(m_sql);
+        if (statement)
+        {
+            sqlite3_reset(statement->stmt);
+        }
+    }
 }
 
 /** @brief Reset the query so it can be reused for another execution */
 void Database::Query::reset()
 {
     // Reset query
-    sqlite3_reset(m_stmt);
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt)
+    {
+        sqlite3_reset(stmt);
+    }
 }
 
 /** @brief Bind a NULL value to a query parameter */
@@ -131,8 +547,8 @@ bool Database::Query::bind(int number)
 {
     bool ret = false;
 
-    int result = sqlite3_bind_null(m_stmt, number + 1);
-    if (result == SQLITE_OK)
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt && (sqlite3_bind_null(stmt, number + 1) == SQLITE_OK))
     {
         ret = true;
     }
@@ -145,8 +561,8 @@ bool Database::Query::bind(int number, const std::vector<uint8_t>& value)
 {
     bool ret = false;
 
-    int result = sqlite3_bind_blob(m_stmt, number + 1, &value[0], value.size(), nullptr);
-    if (result == SQLITE_OK)
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt && (sqlite3_bind_blob(stmt, number + 1, &value[0], value.size(), nullptr) == SQLITE_OK))
     {
         ret = true;
     }
@@ -159,8 +575,8 @@ bool Database::Query::bind(int number, double value)
 {
     bool ret = false;
 
-    int result = sqlite3_bind_double(m_stmt, number + 1, value);
-    if (result == SQLITE_OK)
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt && (sqlite3_bind_double(stmt, number + 1, value) == SQLITE_OK))
     {
         ret = true;
     }
@@ -173,8 +589,8 @@ bool Database::Query::bind(int number, int32_t value)
 {
     bool ret = false;
 
-    int result = sqlite3_bind_int(m_stmt, number + 1, value);
-    if (result == SQLITE_OK)
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt && (sqlite3_bind_int(stmt, number + 1, value) == SQLITE_OK))
     {
         ret = true;
     }
@@ -193,8 +609,8 @@ bool Database::Query::bind(int number, int64_t value)
 {
     bool ret = false;
 
-    int result = sqlite3_bind_int(m_stmt, number + 1, value);
-    if (result == SQLITE_OK)
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt && (sqlite3_bind_int(stmt, number + 1, value) == SQLITE_OK))
     {
         ret = true;
     }
@@ -213,8 +629,8 @@ bool Database::Query::bind(int number, const std::string& value)
 {
     bool ret = false;
 
-    int result = sqlite3_bind_text(m_stmt, number + 1, value.c_str(), -1, nullptr);
-    if (result == SQLITE_OK)
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt && (sqlite3_bind_text(stmt, number + 1, value.c_str(), -1, nullptr) == SQLITE_OK))
     {
         ret = true;
     }
@@ -225,21 +641,23 @@ bool Database::Query::bind(int number, const std::string& value)
 /** @brief Execute the query */
 bool Database::Query::exec()
 {
-    bool ret   = false;
-    m_has_rows = false;
+    bool ret = false;
 
-    // Execute query
-    int result = sqlite3_step(m_stmt);
-    if (result == SQLITE_DONE)
+    Statement* statement = this->statement();
+    if (statement)
     {
-        ret = true;
-    }
-    else
-    {
-        if (result == SQLITE_ROW)
+        // Execute query
+        int result = step(statement);
+        if ((result == SQLITE_DONE) || (result == SQLITE_ROW))
+        {
+            ret = true;
+        }
+
+        // Remember the thread holding a snapshot until the end of the result
+        if (statement->on_reader && (result == SQLITE_ROW))
         {
-            m_has_rows = true;
-            ret        = true;
+            m_result_thread     = std::this_thread::get_id();
+            m_result_generation = m_database.m_generation;
         }
     }
 
@@ -248,7 +666,9 @@ bool Database::Query::exec()
 /** @brief Indicate if the query result has rows to extract data */
 bool Database::Query::hasRows() const
 {
-    return m_has_rows;
+    // A statement stays busy while it has rows left to extract
+    sqlite3_stmt* stmt = this->stmt();
+    return (stmt && sqlite3_stmt_busy(stmt));
 }
 
 /** @brief Get to the next value of the query result */
@@ -257,8 +677,8 @@ bool Database::Query::next()
     bool ret = false;
 
     // Execute next step
-    int result = sqlite3_step(m_stmt);
-    if (result == SQLITE_ROW)
+    Statement* statement = this->statement();
+    if (statement && (step(statement) == SQLITE_ROW))
     {
         ret = true;
     }
@@ -269,41 +689,62 @@ bool Database::Query::next()
 /** @brief Get the string explaining the last error */
 std::string Database::Query::lastError() const
 {
-    return m_database.lastError();
+    std::string   error;
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt)
+    {
+        error = sqlite3_errmsg(sqlite3_db_handle(stmt));
+    }
+    else
+    {
+        error = m_database.lastError();
+    }
+    return error;
 }
 
 /** @brief Indicate if a value from a query result is NULL */
 bool Database::Query::isNull(int column) const
 {
-    bool ret = (sqlite3_column_type(m_stmt, column) == SQLITE_NULL);
+    sqlite3_stmt* stmt = this->stmt();
+    bool          ret  = (!stmt || (sqlite3_column_type(stmt, column) == SQLITE_NULL));
     return ret;
 }
 
 /** @brief Get a blob value from a query result */
 std::vector<uint8_t> Database::Query::getBlob(int column) const
 {
-    int         size = 0;
-    const void* blob = sqlite3_column_blob(m_stmt, column);
-    if (blob)
+    int           size = 0;
+    const void*   blob = nullptr;
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt)
     {
-        size = sqlite3_column_bytes(m_stmt, column);
+        blob = sqlite3_column_blob(stmt, column);
+        if (blob)
+        {
+            size = sqlite3_column_bytes(stmt, column);
+        }
     }
 
     std::vector<uint8_t> value(size);
-    memcpy(&value[0], blob, size);
+    if (size != 0)
+    {
+        memcpy(&value[0], blob, size);
+    }
     return value;
 }
 
 /** @brief Get a floating point value from a query result */
 double Database::Query::getFloat(int column) const
 {
-    return sqlite3_column_double(m_stmt, column);
+    sqlite3_stmt* stmt = this->stmt();
+    return (stmt ? sqlite3_column_double(stmt, column) : 0.);
 }
 
 /** @brief Get a 32bits signed integer value from a query result */
 int32_t Database::Query::getInt32(int column) const
 {
-    return sqlite3_column_int(m_stmt, column);
+    sqlite3_stmt* stmt = this->stmt();
+    return (stmt ? sqlite3_column_int(stmt, column) : 0);
 }
 
 /** @brief Get a 32bits unsigned integer value from a query result */
@@ -315,7 +756,8 @@ uint32_t Database::Query::getUInt32(int column) const
 /** @brief Get a 64bits signed integer value from a query result */
 int64_t Database::Query::getInt64(int column) const
 {
-    return sqlite3_column_int64(m_stmt, column);
+    sqlite3_stmt* stmt = this->stmt();
+    return (stmt ? sqlite3_column_int64(stmt, column) : 0);
 }
 
 /** @brief Get a 64bits unsigned integer value from a query result */
@@ -327,10 +769,125 @@ uint64_t Database::Query::getUInt64(int column) const
 /** @brief Get a string value from a query result */
 std::string Database::Query::getString(int column) const
 {
-    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(m_stmt, column));
-    std::string value(text);
+    std::string   value;
+    sqlite3_stmt* stmt = this->stmt();
+    if (stmt)
+    {
+        const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+        if (text)
+        {
+            value = text;
+        }
+    }
     return value;
 }
 
+/** @brief Get the statement handle of the calling thread */
+sqlite3_stmt* Database::Query::stmt() const
+{
+    Statement* statement = this->statement();
+    return (statement ? statement->stmt : nullptr);
+}
+
+/** @brief Get the prepared statement of the calling thread */
+Database::Statement* Database::Query::statement() const
+{
+    // Last statement resolved by the calling thread, queries are
+    // usually executed several times in a row which avoids locking
+    // the database to look for the statement
+    thread_local uint64_t   s_id         = 0;
+    thread_local uint64_t   s_generation = 0;
+    thread_local Statement* s_statement  = nullptr;
+
+    uint64_t generation = m_database.m_generation.load();
+    if ((s_id != m_id) || (s_generation != generation))
+    {
+        s_statement = m_database.statement(m_sql);
+        if (s_statement)
+        {
+            s_id         = m_id;
+            s_generation = generation;
+        }
+        else
+        {
+            s_id = 0;
+        }
+    }
+
+    // Inside a transaction, read-only queries must see the pending changes of the writer connection
+    Statement* statement = s_statement;
+    if (statement && statement->on_reader && (statement->context->transaction_depth != 0))
+    {
+        statement = m_database.statement(m_sql, true);
+    }
+
+    return statement;
+}
+
+/** @brief Execute a step of a statement */
+int Database::Query::step(Statement* statement) const
+{
+    int result;
+    if (statement->on_reader)
+    {
+        result = sqlite3_step(statement->stmt);
+    }
+    else
+    {
+        // Wait for the end of the other threads' transactions
+        std::lock_guard<std::recursive_mutex> lock(m_database.m_writer_mutex);
+        result = sqlite3_step(statement->stmt);
+    }
+    if (result != SQLITE_ROW)
+    {
+        // Release the snapshot and the locks held by the statement as soon as it is done
+        sqlite3_reset(statement->stmt);
+    }
+    return result;
+}
+
+// Database::Transaction
+
+/** @brief Constructor, begins the transaction */
+Database::Transaction::Transaction(Database& database) : m_database(database), m_active(false)
+{
+    m_active = m_database.beginTransaction();
+}
+/** @brief Destructor, rolls back the transaction if it has not been committed */
+Database::Transaction::~Transaction()
+{
+    rollback();
+}
+
+/** @brief Indicate if the transaction has begun and is not ended yet */
+bool Database::Transaction::isActive() const
+{
+    return m_active;
+}
+
+/** @brief Commit the changes made during the transaction */
+bool Database::Transaction::commit()
+{
+    bool ret = false;
+    if (m_active)
+    {
+        m_active = false;
+        ret      = m_database.endTransaction(true);
+    }
+    return ret;
+}
+
+/** @brief Discard the changes made during the transaction */
+bool Database::Transaction::rollback()
+{
+    bool ret = false;
+    if (m_active)
+    {
+        m_active = false;
+        ret      = m_database.endTransaction(false);
+    }
+    return ret;
+}
+
 } // namespace database
 } // namespace ocpp
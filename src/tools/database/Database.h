@@ -19,9 +19,14 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #ifndef DATABASE_H
 #define DATABASE_H
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 // Forward declarations
@@ -33,24 +38,71 @@ namespace ocpp
 namespace database
 {
 
-/** @brief Basic database implementation */
+/** @brief Basic database implementation
+ *
+ *  The database is opened in WAL mode with one shared writer connection
+ *  and up to max_readers read-only connections, one per thread executing
+ *  read-only queries, so that reads never wait behind writes.
+ *  Prepared statements are cached per thread and keyed by their SQL text,
+ *  so a Query object can be safely used from any thread.
+ *  A read-only query holds a snapshot of the database until its last row has
+ *  been read, or until it is reset or destroyed by the thread which executed it,
+ *  so that the WAL file can be checkpointed.
+ *  The read-only connection and the prepared statements of a thread are
+ *  released when the thread exits.
+ *  Inside a transaction, all the queries of the owning thread are executed
+ *  on the writer connection and the other threads' writes are blocked.
+ */
 class Database
 {
+  private:
+    // Forward declarations
+    struct Statement;
+    struct ThreadContext;
+    struct Owner;
+    struct ThreadContextsReleaser;
+
   public:
-    // Forward declaration
+    // Forward declarations
     class Query;
+    class Transaction;
+
+    /** @brief Default maximum number of read-only connections */
+    static constexpr size_t DEFAULT_MAX_READERS = 4u;
+
+    /** @brief Durability profiles */
+    enum class Durability
+    {
+        /** @brief WAL journal, synchronous=FULL : no committed transaction is lost on power failure */
+        Safe,
+        /** @brief WAL journal, synchronous=NORMAL : last transactions may be lost on power failure, no corruption */
+        Balanced,
+        /** @brief WAL journal, synchronous=OFF, memory temporary store, memory mapped I/O and bigger cache */
+        Fast
+    };
 
-    /** @brief Constructor */
-    Database();
+    /**
+     * @brief Get a durability profile from its name
+     * @param name Name of the profile : "safe", "balanced" or "fast"
+     * @return Corresponding durability profile, Durability::Safe if the name is unknown
+     */
+    static Durability durabilityFromString(const std::string& name);
+
+    /**
+     * @brief Constructor
+     * @param max_readers Maximum number of read-only connections (0 = all the queries are executed on the writer connection)
+     */
+    Database(size_t max_readers = DEFAULT_MAX_READERS);
     /** @brief Destructor */
     virtual ~Database();
 
     /**
      * @brief Open a database
      * @param database_path Path to the database file
+     * @param durability Durability profile
      * @return true if the database exists, false otherwise
      */
-    bool open(const std::string& database_path);
+    bool open(const std::string& database_path, Durability durability = Durability::Safe);
 
     /**
      * @brief Close the database
@@ -65,6 +117,15 @@ class Database
      */
     std::unique_ptr<Query> query(const std::string& sql);
 
+    /**
+     * @brief Execute a query once for each item of a batch inside a single transaction
+     * @param query Query to execute
+     * @param count Number of items in the batch
+     * @param bind Function called to bind the query parameters for the item at the given index
+     * @return true if all the items have been written, false otherwise (nothing is written)
+     */
+    bool execBatch(Query& query, size_t count, const std::function<void(Query&, size_t)>& bind);
+
     /**
      * @brief Get the string explaining the last error
      * @return String explaining the last error
@@ -76,7 +137,7 @@ class Database
     {
       public:
         /** @brief Constructor */
-        Query(Database& database, sqlite3_stmt* stmt);
+        Query(Database& database, const std::string& sql);
         /** @brief Destructor */
         virtual ~Query();
 
@@ -229,15 +290,129 @@ class Database
       private:
         /** @brief Associated database */
         Database& m_database;
-        /** @brief Statement handle */
-        sqlite3_stmt* m_stmt;
-        /** @brief Indicate if the query result has rows to extract data */
-        bool m_has_rows;
+        /** @brief SQL text of the query */
+        const std::string m_sql;
+        /** @brief Unique identifier of the query */
+        const uint64_t m_id;
+        /** @brief Thread holding an unfinished result of the query on its read-only connection */
+        std::thread::id m_result_thread;
+        /** @brief Database generation of the unfinished result */
+        uint64_t m_result_generation;
+
+        /** @brief Get the statement handle of the calling thread */
+        sqlite3_stmt* stmt() const;
+        /** @brief Get the prepared statement of the calling thread */
+        Statement* statement() const;
+        /** @brief Execute a step of a statement */
+        int step(Statement* statement) const;
+    };
+
+    /** @brief Transaction on the database, rolled back on destruction if not committed
+     *
+     *  Nested transactions of a same thread are merged into the outermost one.
+     */
+    class Transaction
+    {
+      public:
+        /** @brief Constructor, begins the transaction */
+        Transaction(Database& database);
+        /** @brief Destructor, rolls back the transaction if it has not been committed */
+        virtual ~Transaction();
+
+        Transaction(const Transaction&)            = delete;
+        Transaction& operator=(const Transaction&) = delete;
+
+        /**
+         * @brief Indicate if the transaction has begun and is not ended yet
+         * @return true if the transaction is active, false otherwise
+         */
+        bool isActive() const;
+
+        /**
+         * @brief Commit the changes made during the transaction
+         * @return true if the changes have been committed, false otherwise
+         */
+        bool commit();
+
+        /**
+         * @brief Discard the changes made during the transaction
+         * @return true if the changes have been discarded, false otherwise
+         */
+        bool rollback();
+
+      private:
+        /** @brief Associated database */
+        Database& m_database;
+        /** @brief Indicate if the transaction is active */
+        bool m_active;
     };
 
   private:
-    /** @brief Database handle */
+    /** @brief Prepared statement of a thread */
+    struct Statement
+    {
+        /** @brief Statement handle */
+        sqlite3_stmt* stmt;
+        /** @brief Owning thread context */
+        ThreadContext* context;
+        /** @brief Indicate if the statement is executed on the thread's read-only connection */
+        bool on_reader;
+    };
+
+    /** @brief Connection and prepared statements of a thread */
+    struct ThreadContext
+    {
+        /** @brief Read-only connection (nullptr if none is available) */
+        sqlite3* reader;
+        /** @brief Prepared statements indexed by SQL text */
+        std::unordered_map<std::string, Statement> statements;
+        /** @brief Prepared statements executed on the writer connection inside a transaction, indexed by SQL text */
+        std::unordered_map<std::string, Statement> transaction_statements;
+        /** @brief Number of nested transactions */
+        unsigned int transaction_depth;
+        /** @brief Indicate if a nested transaction has been rolled back */
+        bool rollback_only;
+    };
+
+    /** @brief Maximum number of read-only connections */
+    const size_t m_max_readers;
+    /** @brief Path to the database file */
+    std::string m_path;
+    /** @brief Writer connection handle */
     sqlite3* m_db;
+    /** @brief Durability profile */
+    Durability m_durability;
+    /** @brief Indicate if the database is in WAL mode */
+    bool m_wal;
+    /** @brief Number of opened read-only connections */
+    size_t m_readers_count;
+    /** @brief Mutex to protect the thread contexts */
+    mutable std::mutex m_mutex;
+    /** @brief Thread contexts */
+    std::unordered_map<std::thread::id, std::unique_ptr<ThreadContext>> m_contexts;
+    /** @brief Mutex to serialize the writes between transactions */
+    std::recursive_mutex m_writer_mutex;
+    /** @brief Incremented at each close to invalidate the statements cached by the queries */
+    std::atomic<uint64_t> m_generation;
+    /** @brief Reference to the database held by the threads which have a context */
+    std::shared_ptr<Owner> m_owner;
+
+    /** @brief Get the prepared statement of the calling thread for an SQL text */
+    Statement* statement(const std::string& sql, bool in_transaction = false);
+    /** @brief Get the context of the calling thread, the contexts must be locked */
+    ThreadContext* contextUnlocked();
+    /** @brief Release the context of an exiting thread */
+    void releaseContext(std::thread::id thread);
+    /** @brief Release the resources of a context, the contexts must be locked */
+    void freeContextUnlocked(ThreadContext& context);
+    /** @brief Begin a transaction for the calling thread */
+    bool beginTransaction();
+    /** @brief End the transaction of the calling thread */
+    bool endTransaction(bool commit);
+    /** @brief Open a read-only connection */
+    sqlite3* openReader();
+    /** @brief Apply the durability profile to a connection */
+    void configure(sqlite3* db);
 };
 
 } // namespace database
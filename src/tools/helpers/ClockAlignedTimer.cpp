@@ -0,0 +1,170 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ClockAlignedTimer.h"
+#include "TimerPool.h"
+
+#include <ctime>
+
+namespace ocpp
+{
+namespace helpers
+{
+
+/** @brief Maximum duration between 2 checks of the wall-clock */
+constexpr std::chrono::seconds ClockAlignedTimer::RESYNC_PERIOD;
+
+/** @brief Constructor */
+ClockAlignedTimer::ClockAlignedTimer(TimerPool& pool, const char* name)
+    : m_pool(pool), m_timer(pool, name), m_interval(0), m_due_time_point(), m_callback()
+{
+    m_timer.setCallback(std::bind(&ClockAlignedTimer::elapsed, this));
+}
+
+/** @brief Destructor */
+ClockAlignedTimer::~ClockAlignedTimer()
+{
+    stop();
+}
+
+/** @brief Start or restart the timer with the specified interval */
+bool ClockAlignedTimer::start(std::chrono::seconds interval)
+{
+    bool ret = false;
+
+    // Check interval
+    if (interval > std::chrono::seconds(0))
+    {
+        // Lock timers
+        m_pool.lock();
+
+        // Compute first due date
+        auto now         = std::chrono::system_clock::now();
+        m_interval       = interval;
+        m_due_time_point = nextAlignedTimePoint(now, m_interval);
+        schedule(now);
+
+        // Unlock timers
+        m_pool.unlock();
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/** @brief Stop the timer */
+bool ClockAlignedTimer::stop()
+{
+    // Lock timers
+    m_pool.lock();
+
+    // Stop timer
+    bool ret = m_timer.stopUnlocked();
+
+    // Unlock timers
+    m_pool.unlock();
+
+    return ret;
+}
+
+/** @brief Indicate if the timer is started */
+bool ClockAlignedTimer::isStarted() const
+{
+    return m_timer.isStarted();
+}
+
+/** @brief Set the timer's callback */
+void ClockAlignedTimer::setCallback(std::function<void()> callback)
+{
+    // Lock timers
+    m_pool.lock();
+
+    // Save callback
+    m_callback = callback;
+
+    // Unlock timers
+    m_pool.unlock();
+}
+
+/** @brief Get the timer's interval */
+std::chrono::seconds ClockAlignedTimer::getInterval() const
+{
+    return m_interval;
+}
+
+/** @brief Compute the first wall-clock date aligned on the specified interval strictly after a given date */
+std::chrono::system_clock::time_point ClockAlignedTimer::nextAlignedTimePoint(std::chrono::system_clock::time_point now,
+                                                                              std::chrono::seconds                  interval)
+{
+    // Local midnight of the reference date
+    time_t    now_time = std::chrono::system_clock::to_time_t(now);
+    struct tm midnight_tm;
+    localtime_r(&now_time, &midnight_tm);
+    midnight_tm.tm_hour  = 0;
+    midnight_tm.tm_min   = 0;
+    midnight_tm.tm_sec   = 0;
+    midnight_tm.tm_isdst = -1;
+    auto midnight        = std::chrono::system_clock::from_time_t(std::mktime(&midnight_tm));
+
+    // Next multiple of the interval, the alignment restarts at each midnight
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - midnight);
+    auto next    = midnight + (elapsed / interval + 1) * interval;
+    midnight_tm.tm_mday++;
+    midnight_tm.tm_isdst = -1;
+    auto next_midnight   = std::chrono::system_clock::from_time_t(std::mktime(&midnight_tm));
+    if (next > next_midnight)
+    {
+        next = next_midnight;
+    }
+    return next;
+}
+
+/** @brief Program the underlying timer to wakeup at the next due date, the timers must be locked by the caller */
+void ClockAlignedTimer::schedule(std::chrono::system_clock::time_point now)
+{
+    // Wakeup at the due date or earlier to check for clock adjustments
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(m_due_time_point - now) + std::chrono::milliseconds(1);
+    if (delay > RESYNC_PERIOD)
+    {
+        delay = RESYNC_PERIOD;
+    }
+    m_timer.restartUnlocked(delay, true);
+}
+
+/** @brief Underlying timer callback */
+void ClockAlignedTimer::elapsed()
+{
+    // Check if the due date has been reached
+    auto now    = std::chrono::system_clock::now();
+    bool notify = (now >= m_due_time_point);
+
+    // Re-anchor on the wall-clock : this skips the due dates missed
+    // after a forward jump and takes into account a backward jump
+    m_due_time_point = nextAlignedTimePoint(now, m_interval);
+    schedule(now);
+
+    // Notify user
+    if (notify && m_callback)
+    {
+        m_callback();
+    }
+}
+
+} // namespace helpers
+} // namespace ocpp
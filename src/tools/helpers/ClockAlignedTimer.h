@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CLOCKALIGNEDTIMER_H
+#define CLOCKALIGNEDTIMER_H
+
+#include "Timer.h"
+
+#include <chrono>
+#include <functional>
+
+namespace ocpp
+{
+namespace helpers
+{
+
+class TimerPool;
+
+/**
+ * @brief Periodic timer which elapses on wall-clock dates aligned on multiples of its interval since midnight
+ *
+ * The next due date is computed again from the wall-clock at each wakeup so that the timer re-anchors itself
+ * after a clock adjustment and elapses only once whatever the number of due dates skipped by a forward jump.
+ */
+class ClockAlignedTimer
+{
+  public:
+    /** @brief Maximum duration between 2 checks of the wall-clock */
+    static constexpr std::chrono::seconds RESYNC_PERIOD = std::chrono::seconds(60u);
+
+    /**
+     * @brief Constructor
+     * @param pool Pool which will handle the timer
+     * @param name Name of the timer
+     */
+    ClockAlignedTimer(TimerPool& pool, const char* name = "");
+
+    /** @brief Destructor */
+    virtual ~ClockAlignedTimer();
+
+    /**
+     * @brief Start or restart the timer with the specified interval
+     * @param interval Timer interval in seconds
+     * @return true if the timer has been started, false otherwise
+     */
+    bool start(std::chrono::seconds interval);
+
+    /**
+     * @brief Stop the timer
+     * @return true if the timer has been stopped, false otherwise
+     */
+    bool stop();
+
+    /**
+     * @brief Indicate if the timer is started
+     * @return true if the timer is started, false otherwise
+     */
+    bool isStarted() const;
+
+    /**
+     * @brief Set the timer's callback
+     * @param callback Function to call when the timer elapse
+     */
+    void setCallback(std::function<void()> callback);
+
+    /**
+     * @brief Get the timer's interval
+     * @return Timer's interval
+     */
+    std::chrono::seconds getInterval() const;
+
+    /**
+     * @brief Compute the first wall-clock date aligned on the specified interval strictly after a given date
+     * @param now Reference date
+     * @param interval Alignment interval in seconds
+     * @return Next aligned date
+     */
+    static std::chrono::system_clock::time_point nextAlignedTimePoint(std::chrono::system_clock::time_point now,
+                                                                      std::chrono::seconds                  interval);
+
+  private:
+    /** @brief Timer pool */
+    TimerPool& m_pool;
+    /** @brief Underlying single shot timer */
+    Timer m_timer;
+    /** @brief Alignment interval */
+    std::chrono::seconds m_interval;
+    /** @brief Next due date */
+    std::chrono::system_clock::time_point m_due_time_point;
+    /** @brief Callback */
+    std::function<void()> m_callback;
+
+    /** @brief Program the underlying timer to wakeup at the next due date, the timers must be locked by the caller */
+    void schedule(std::chrono::system_clock::time_point now);
+    /** @brief Underlying timer callback */
+    void elapsed();
+};
+
+} // namespace helpers
+} // namespace ocpp
+
+#endif // CLOCKALIGNEDTIMER_H
@@ -79,7 +79,7 @@ class Queue
      * @brief Get the number of items in the queue
      * @return Number of items in the queue
      */
-    size_t count()
+    size_t count() const
     {
         // Lock queue
         std::unique_lock<std::mutex> lock(m_mutex);
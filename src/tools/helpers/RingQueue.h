@@ -0,0 +1,309 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+namespace ocpp
+{
+namespace helpers
+{
+
+/**
+ * @brief Lock-free fixed capacity message queue for inter-thread communication
+ *
+ * Items are exchanged through a ring buffer without any lock, the mutex is only used
+ * to put the consumer to sleep when the queue is empty. Only one thread can consume
+ * the items, and only one thread can produce them if MULTI_PRODUCER is false.
+ */
+template <typename ItemType, size_t MAX_SIZE, bool MULTI_PRODUCER = true>
+class RingQueue
+{
+    static_assert(MAX_SIZE > 0, "RingQueue capacity must not be 0");
+
+  public:
+    /** @brief Constructor */
+    RingQueue() : m_cells(), m_head(0), m_tail(0), m_enabled(true), m_consumer_waiting(false), m_mutex(), m_cond_var()
+    {
+        for (size_t i = 0; i < MAX_SIZE; i++)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    /** @brief Destructor */
+    virtual ~RingQueue() { }
+
+    /**
+     * @brief Get the size of the queue
+     * @return Size of the queue in number of items
+     */
+    size_t size() const { return MAX_SIZE; }
+
+    /**
+     * @brief Indicate if the queue is empty
+     * @return true if the queue is empty, false otherwise
+     */
+    bool empty() const { return (count() == 0); }
+
+    /**
+     * @brief Indicate if the queue is full
+     * @return true if the queue is full, false otherwise
+     */
+    bool full() const { return (count() == MAX_SIZE); }
+
+    /**
+     * @brief Get the number of items in the queue
+     * @return Number of items in the queue (approximate while items are being pushed or popped)
+     */
+    size_t count() const
+    {
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        return ((tail > head) ? (tail - head) : 0);
+    }
+
+    /**
+     * @brief Adds an item to the queue
+     * @param item Item to add
+     * @return true if the item has been added, fale if the maximum capacity has been reached
+     */
+    bool push(const ItemType& item)
+    {
+        bool ret = false;
+
+        size_t pos  = 0;
+        Cell*  cell = reserve(pos);
+        if (cell)
+        {
+            cell->item = item;
+            publish(cell, pos);
+            ret = true;
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief Adds an item to the queue by moving it
+     * @param item Item to add, left untouched if the maximum capacity has been reached
+     * @return true if the item has been added, fale if the maximum capacity has been reached
+     */
+    bool push(ItemType&& item)
+    {
+        bool ret = false;
+
+        size_t pos  = 0;
+        Cell*  cell = reserve(pos);
+        if (cell)
+        {
+            cell->item = std::move(item);
+            publish(cell, pos);
+            ret = true;
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief Get an item from the queue (must only be called by the consumer thread)
+     * @param item Item retrieved from the queue
+     * @param ms_timeout Max wait time in milliseconds
+     * @return true if the item has been retrieved, false if the timeout has been reached
+     */
+    bool pop(ItemType& item, unsigned int ms_timeout = std::numeric_limits<unsigned int>::max())
+    {
+        bool ret = false;
+
+        // Fast path
+        if (m_enabled.load(std::memory_order_acquire))
+        {
+            ret = tryPop(item);
+            if (!ret && (ms_timeout != 0))
+            {
+                // Wait for an item
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_consumer_waiting.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                m_cond_var.wait_for(lock,
+                                    std::chrono::milliseconds(ms_timeout),
+                                    [this, &item, &ret]
+                                    {
+                                        ret = (m_enabled.load(std::memory_order_acquire) && tryPop(item));
+                                        return (ret || !m_enabled.load(std::memory_order_acquire));
+                                    });
+                m_consumer_waiting.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        return ret;
+    }
+
+    /** @brief Clear the contents of the queue (must only be called by the consumer thread) */
+    void clear()
+    {
+        ItemType item;
+        while (tryPop(item))
+        {
+        }
+    }
+
+    /**
+     * @brief Update the state of the queue
+     * @param enabled If true messages can be received,
+     *                if false abort current waiting operation
+     *                and disable further message reception
+     */
+    void setEnable(bool enabled)
+    {
+        // Update state
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled.store(enabled, std::memory_order_release);
+
+        // Wakeup waiting thread
+        m_cond_var.notify_all();
+    }
+
+  private:
+    /** @brief Size of a cache line, used to prevent false sharing between producers and consumer */
+    static constexpr size_t CACHE_LINE_SIZE = 64u;
+
+    /** @brief Cell of the ring buffer */
+    struct Cell
+    {
+        /** @brief Sequence number indicating if the cell is free or contains an item */
+        std::atomic<size_t> sequence;
+        /** @brief Stored item */
+        ItemType item;
+    };
+
+    /** @brief Ring buffer */
+    std::array<Cell, MAX_SIZE> m_cells;
+    /** @brief Position of the next item to pop */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+    /** @brief Position of the next item to push */
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+    /** @brief Indicate that the queue is enabled */
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> m_enabled;
+    /** @brief Indicate that the consumer is waiting for an item */
+    std::atomic<bool> m_consumer_waiting;
+    /** @brief Mutex used to put the consumer to sleep */
+    std::mutex m_mutex;
+    /** @brief Condition variable used to wake up the consumer */
+    std::condition_variable m_cond_var;
+
+    /** @brief Reserve a cell to push an item, nullptr if the queue is full */
+    Cell* reserve(size_t& pos)
+    {
+        Cell* cell = nullptr;
+        pos        = m_tail.load(std::memory_order_relaxed);
+        if (MULTI_PRODUCER)
+        {
+            // Compete with the other producers
+            while (!cell)
+            {
+                Cell&          candidate = m_cells[pos % MAX_SIZE];
+                size_t         sequence  = candidate.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff      = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_tail.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed))
+                    {
+                        cell = &candidate;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    // Queue is full
+                    break;
+                }
+                else
+                {
+                    // Another producer has taken the cell
+                    pos = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+        else
+        {
+            // Single producer, no competition
+            Cell& candidate = m_cells[pos % MAX_SIZE];
+            if (candidate.sequence.load(std::memory_order_acquire) == pos)
+            {
+                m_tail.store(pos + 1u, std::memory_order_relaxed);
+                cell = &candidate;
+            }
+        }
+        return cell;
+    }
+
+    /** @brief Publish the item stored in a reserved cell */
+    void publish(Cell* cell, size_t pos)
+    {
+        cell->sequence.store(pos + 1u, std::memory_order_release);
+
+        // Wakeup consumer if it is waiting
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_consumer_waiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cond_var.notify_one();
+        }
+    }
+
+    /** @brief Get an item without waiting */
+    bool tryPop(ItemType& item)
+    {
+        bool ret = false;
+
+        // Check if the next cell contains an item
+        size_t pos  = m_head.load(std::memory_order_relaxed);
+        Cell&  cell = m_cells[pos % MAX_SIZE];
+        if (cell.sequence.load(std::memory_order_acquire) == (pos + 1u))
+        {
+            // Retrieve item and release the cell
+            item = std::move(cell.item);
+            cell.sequence.store(pos + MAX_SIZE, std::memory_order_release);
+            m_head.store(pos + 1u, std::memory_order_release);
+            ret = true;
+        }
+
+        return ret;
+    }
+};
+
+/** @brief Lock-free queue with multiple producers and a single consumer */
+template <typename ItemType, size_t MAX_SIZE>
+using MpscRingQueue = RingQueue<ItemType, MAX_SIZE, true>;
+
+/** @brief Lock-free queue with a single producer and a single consumer */
+template <typename ItemType, size_t MAX_SIZE>
+using SpscRingQueue = RingQueue<ItemType, MAX_SIZE, false>;
+
+} // namespace helpers
+} // namespace ocpp
+
+#endif // RINGQUEUE_H
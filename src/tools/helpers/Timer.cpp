@@ -30,9 +30,12 @@ Timer::Timer(TimerPool& pool, const char* name)
       m_name(name),
       m_single_shot(false),
       m_interval(std::chrono::milliseconds(0)),
-      m_wake_up_time_point(std::chrono::time_point<std::chrono::system_clock>::min()),
+      m_wake_up_time_point(std::chrono::time_point<std::chrono::steady_clock>::min()),
       m_started(false),
-      m_callback()
+      m_heap_index(0),
+      m_callback(),
+      m_executor(nullptr),
+      m_executor_state(std::make_shared<ExecutorState>())
 {
 }
 
@@ -44,7 +47,10 @@ Timer::Timer(const Timer& timer)
       m_interval(timer.m_interval),
       m_wake_up_time_point(timer.m_wake_up_time_point),
       m_started(timer.m_started),
-      m_callback(timer.m_callback)
+      m_heap_index(timer.m_heap_index),
+      m_callback(timer.m_callback),
+      m_executor(timer.m_executor),
+      m_executor_state(std::make_shared<ExecutorState>())
 {
 }
 
@@ -68,7 +74,7 @@ bool Timer::start(std::chrono::milliseconds interval, bool single_shot)
         // Configure timer
         m_interval           = interval;
         m_single_shot        = single_shot;
-        m_wake_up_time_point = std::chrono::system_clock::now() + m_interval;
+        m_wake_up_time_point = std::chrono::steady_clock::now() + m_interval;
 
         // Add timer to the list
         m_pool.addTimer(this);
@@ -84,29 +90,35 @@ bool Timer::start(std::chrono::milliseconds interval, bool single_shot)
 
 /** @brief Restart the timer with the specified interval */
 bool Timer::restart(std::chrono::milliseconds interval, bool single_shot)
+{
+    // Lock timers
+    m_pool.lock();
+
+    // Restart timer
+    restartUnlocked(interval, single_shot);
+
+    // Unlock timers
+    m_pool.unlock();
+
+    return true;
+}
+
+/** @brief Start the timer as a single shot timer or bring forward its wakeup */
+bool Timer::startBefore(std::chrono::milliseconds interval)
 {
     bool ret = false;
 
     // Lock timers
     m_pool.lock();
 
-    // Check if the timer is already started
-    if (m_started)
+    // Check if the timer would elapse after the specified interval
+    if (!m_started || ((std::chrono::steady_clock::now() + interval) < m_wake_up_time_point))
     {
-        // Remove timer from the list
-        m_pool.removeTimer(this);
+        // Restart timer
+        restartUnlocked(interval, true);
+        ret = true;
     }
 
-    // Configure timer
-    m_interval           = interval;
-    m_single_shot        = single_shot;
-    m_wake_up_time_point = std::chrono::system_clock::now() + m_interval;
-
-    // Add timer to the list
-    m_pool.addTimer(this);
-
-    ret = true;
-
     // Unlock timers
     m_pool.unlock();
 
@@ -116,23 +128,18 @@ bool Timer::restart(std::chrono::milliseconds interval, bool single_shot)
 /** @brief Stop the timer */
 bool Timer::stop()
 {
-    bool ret = false;
-
     // Lock timers
     m_pool.lock();
 
-    // Check if the timer is started
-    if (m_started)
-    {
-        // Remove timer from the list
-        m_pool.removeTimer(this);
-
-        ret = true;
-    }
+    // Stop timer
+    bool ret = stopUnlocked();
 
     // Unlock timers
     m_pool.unlock();
 
+    // The callback must not be executed anymore once the timer is stopped
+    cancelExecutions();
+
     return ret;
 }
 
@@ -155,11 +162,79 @@ void Timer::setCallback(std::function<void()> callback)
     m_pool.unlock();
 }
 
+/** @brief Set the executor which will run the timer's callback */
+void Timer::setExecutor(WorkerThreadPool* executor)
+{
+    // Lock timers
+    m_pool.lock();
+
+    // Save executor
+    m_executor = executor;
+
+    // Unlock timers
+    m_pool.unlock();
+}
+
 /** @brief Get the timer's interval */
 std::chrono::milliseconds Timer::getInterval() const
 {
     return m_interval;
 }
 
+/** @brief Restart the timer, the timers must be locked by the caller */
+void Timer::restartUnlocked(std::chrono::milliseconds interval, bool single_shot)
+{
+    // Check if the timer is already started
+    if (m_started)
+    {
+        // Remove timer from the list
+        m_pool.removeTimer(this);
+    }
+
+    // Configure timer
+    m_interval           = interval;
+    m_single_shot        = single_shot;
+    m_wake_up_time_point = std::chrono::steady_clock::now() + m_interval;
+
+    // Add timer to the list
+    m_pool.addTimer(this);
+}
+
+/** @brief Stop the timer, the timers must be locked by the caller */
+bool Timer::stopUnlocked()
+{
+    bool ret = false;
+
+    // Check if the timer is started
+    if (m_started)
+    {
+        // Remove timer from the list
+        m_pool.removeTimer(this);
+
+        ret = true;
+    }
+
+    return ret;
+}
+
+/** @brief Cancel the queued executions of the callback and wait for the end of the running one */
+void Timer::cancelExecutions()
+{
+    std::unique_lock<std::mutex> lock(m_executor_state->mutex);
+    if (m_executor_state->pending != 0)
+    {
+        // Queued executions will be discarded by the executor
+        m_executor_state->generation++;
+
+        // The running execution can't be waited for from the callback itself, nor from
+        // the timers thread since it holds the timers lock which the callback may need
+        ExecutorState& state = *m_executor_state;
+        if (state.running && (state.thread != std::this_thread::get_id()) && !m_pool.inTimersThread())
+        {
+            state.end_of_execution.wait(lock, [&state] { return !state.running; });
+        }
+    }
+}
+
 } // namespace helpers
 } // namespace ocpp
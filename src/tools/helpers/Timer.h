@@ -20,19 +20,25 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #define TIMER_H
 
 #include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 namespace ocpp
 {
 namespace helpers
 {
 
 class TimerPool;
+class WorkerThreadPool;
 
 /** @brief Timer */
 class Timer
 {
     friend class TimerPool;
+    friend class ClockAlignedTimer;
 
   public:
     /**
@@ -64,8 +70,19 @@ class Timer
      */
     bool restart(std::chrono::milliseconds interval, bool single_shot = false);
 
+    /**
+     * @brief Start the timer as a single shot timer or bring forward its wakeup if it is
+     *        already started and would elapse after the specified interval
+     * @param interval Maximum duration before the timer elapses in milliseconds
+     * @return true if the timer has been (re)started, false if it already elapses before
+     */
+    bool startBefore(std::chrono::milliseconds interval);
+
     /**
      * @brief Stop the timer
+     *        The executions of the callback pending on the executor are cancelled and the
+     *        running one is waited for, unless the timer is stopped from its own callback or
+     *        from the callback of a timer executed in the timers thread
      * @return true if the timer has been stopped, false otherwise
      */
     bool stop();
@@ -82,6 +99,14 @@ class Timer
      */
     void setCallback(std::function<void()> callback);
 
+    /**
+     * @brief Set the executor which will run the timer's callback
+     *        If an execution of the callback of a periodic timer is still pending when the timer
+     *        elapses again, this new expiry is dropped instead of being queued
+     * @param executor Worker thread pool to use, nullptr to run the callback in the timer pool's thread
+     */
+    void setExecutor(WorkerThreadPool* executor);
+
     /**
      * @brief Get the timer's interval
      * @return Timer's interval
@@ -89,6 +114,26 @@ class Timer
     std::chrono::milliseconds getInterval() const;
 
   private:
+    /** @brief State of the executions of the callback on the executor, shared with the queued jobs */
+    struct ExecutorState
+    {
+        /** @brief Constructor */
+        ExecutorState() : mutex(), end_of_execution(), generation(0), pending(0), running(false), thread() { }
+
+        /** @brief Mutex for concurrent access */
+        std::mutex mutex;
+        /** @brief Condition variable to signal the end of an execution */
+        std::condition_variable end_of_execution;
+        /** @brief Incremented when the timer is stopped to cancel the queued executions */
+        unsigned int generation;
+        /** @brief Number of executions queued or running */
+        unsigned int pending;
+        /** @brief Indicate if an execution is running */
+        bool running;
+        /** @brief Thread running the execution */
+        std::thread::id thread;
+    };
+
     /** @brief Timer pool */
     TimerPool& m_pool;
     /** @brief Name */
@@ -98,11 +143,24 @@ class Timer
     /** @brief Wake uo interval */
     std::chrono::milliseconds m_interval;
     /** @brief Next wakeup time point */
-    std::chrono::time_point<std::chrono::system_clock> m_wake_up_time_point;
+    std::chrono::time_point<std::chrono::steady_clock> m_wake_up_time_point;
     /** @brief Indicate if the timer is started */
     bool m_started;
+    /** @brief Position of the timer in the pool's heap of active timers */
+    size_t m_heap_index;
     /** @brief Callback */
     std::function<void()> m_callback;
+    /** @brief Executor of the callback, nullptr if the callback is run by the timer pool's thread */
+    WorkerThreadPool* m_executor;
+    /** @brief State of the executions of the callback on the executor */
+    std::shared_ptr<ExecutorState> m_executor_state;
+
+    /** @brief Restart the timer, the timers must be locked by the caller */
+    void restartUnlocked(std::chrono::milliseconds interval, bool single_shot);
+    /** @brief Stop the timer, the timers must be locked by the caller */
+    bool stopUnlocked();
+    /** @brief Cancel the queued executions of the callback and wait for the end of the running one */
+    void cancelExecutions();
 };
 
 } // namespace helpers
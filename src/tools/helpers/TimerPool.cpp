@@ -18,19 +18,36 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 
 #include "TimerPool.h"
 #include "Timer.h"
+#include "WorkerThreadPool.h"
+
+#include <exception>
 
 namespace ocpp
 {
 namespace helpers
 {
 
+/** @brief Number of buckets of the lateness histogram */
+constexpr size_t TimerPool::LATENESS_BUCKET_COUNT;
+/** @brief Upper bounds of the buckets of the lateness histogram, the last bucket has no upper bound */
+const std::array<std::chrono::microseconds, TimerPool::LATENESS_BUCKET_COUNT> TimerPool::LATENESS_BUCKET_BOUNDS = {
+    std::chrono::microseconds(100u),
+    std::chrono::milliseconds(1u),
+    std::chrono::milliseconds(10u),
+    std::chrono::milliseconds(50u),
+    std::chrono::milliseconds(100u),
+    std::chrono::milliseconds(500u),
+    std::chrono::seconds(1u),
+    std::chrono::microseconds::max()};
+
 /** @brief Constructor */
 TimerPool::TimerPool()
     : m_stop(false),
       m_update_wakeup_time(false),
       m_wakeup_mutex(),
       m_wakeup_cond(),
-      m_wake_up_time_point(std::chrono::system_clock::now() + std::chrono::hours(2400u)),
+      m_wake_up_time_point(std::chrono::steady_clock::now() + std::chrono::hours(2400u)),
+      m_statistics(std::make_shared<StatisticsCounters>()),
       m_thread(std::bind(&TimerPool::threadLoop, this)),
       m_timers()
 {
@@ -51,6 +68,32 @@ Timer* TimerPool::createTimer()
     return new Timer(*this);
 }
 
+/** @brief Get the statistics of the timers of the pool */
+TimerPool::Statistics TimerPool::getStatistics() const
+{
+    Statistics stats;
+    stats.expiries     = m_statistics->expiries;
+    stats.dropped      = m_statistics->dropped;
+    stats.max_lateness = std::chrono::microseconds(m_statistics->max_lateness);
+    for (size_t i = 0; i < LATENESS_BUCKET_COUNT; i++)
+    {
+        stats.lateness_histogram[i] = m_statistics->lateness_histogram[i];
+    }
+    return stats;
+}
+
+/** @brief Reset the statistics of the timers of the pool */
+void TimerPool::resetStatistics()
+{
+    m_statistics->expiries     = 0;
+    m_statistics->dropped      = 0;
+    m_statistics->max_lateness = 0;
+    for (auto& bucket : m_statistics->lateness_histogram)
+    {
+        bucket = 0;
+    }
+}
+
 /** @brief TimerPool thread loop */
 void TimerPool::threadLoop()
 {
@@ -73,30 +116,133 @@ void TimerPool::threadLoop()
         else
         {
             // Timer has elapsed
-            Timer* timer = m_timers.front();
-            if (timer->m_single_shot)
-            {
-                // Single shot : remove timer from the list
-                m_timers.pop_front();
-
-                // Timer is now stopped
-                timer->m_started = false;
-            }
-            else
+            Timer*                                              timer              = nullptr;
+            std::chrono::time_point<std::chrono::steady_clock> wake_up_time_point = m_wake_up_time_point;
+            if (!m_timers.empty())
             {
-                // Periodic : compute next wakeup time point
-                timer->m_wake_up_time_point += timer->m_interval;
+                timer              = m_timers.front();
+                wake_up_time_point = timer->m_wake_up_time_point;
+                if (timer->m_single_shot)
+                {
+                    // Single shot : remove timer from the heap
+                    removeTimer(timer);
+                }
+                else
+                {
+                    // Periodic : compute next wakeup time point
+                    timer->m_wake_up_time_point += timer->m_interval;
+                    siftDown(0);
+                }
             }
 
             // New wakeup time point
             computeNextWakeupTimepoint();
 
             // Notify user
-            timer->m_callback();
+            if (timer)
+            {
+                fire(timer, wake_up_time_point);
+            }
         }
     }
 }
 
+/** @brief Run the callback of an elapsed timer inline or on its executor */
+void TimerPool::fire(Timer* timer, std::chrono::time_point<std::chrono::steady_clock> wake_up_time_point)
+{
+    if (timer->m_executor)
+    {
+        // Drop the expiry of a periodic timer if the previous one has not been processed yet,
+        // the expiry of a single shot timer is never dropped
+        std::shared_ptr<Timer::ExecutorState> state = timer->m_executor_state;
+        unsigned int                          generation;
+        bool                                  queue;
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            queue = (timer->m_single_shot || (state->pending == 0));
+            if (queue)
+            {
+                state->pending++;
+            }
+            generation = state->generation;
+        }
+        if (queue)
+        {
+            // Queue callback execution, it is discarded if the timer is stopped in the meantime
+            std::shared_ptr<StatisticsCounters> statistics = m_statistics;
+            std::function<void()>               callback   = timer->m_callback;
+            timer->m_executor->run<void>(
+                [statistics, state, generation, callback, wake_up_time_point]
+                {
+                    std::exception_ptr           exception;
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    if (generation == state->generation)
+                    {
+                        state->running = true;
+                        state->thread  = std::this_thread::get_id();
+                        lock.unlock();
+
+                        statistics->record(wake_up_time_point);
+                        try
+                        {
+                            callback();
+                        }
+                        catch (...)
+                        {
+                            exception = std::current_exception();
+                        }
+
+                        lock.lock();
+                        state->running = false;
+                        state->thread  = std::thread::id();
+                    }
+                    state->pending--;
+                    state->end_of_execution.notify_all();
+                    lock.unlock();
+
+                    // Let the executor handle the exceptions of the callback
+                    if (exception)
+                    {
+                        std::rethrow_exception(exception);
+                    }
+                });
+        }
+        else
+        {
+            m_statistics->dropped++;
+        }
+    }
+    else
+    {
+        // Execute callback in the timers thread
+        m_statistics->record(wake_up_time_point);
+        timer->m_callback();
+    }
+}
+
+/** @brief Record the execution of a callback */
+void TimerPool::StatisticsCounters::record(std::chrono::time_point<std::chrono::steady_clock> wake_up_time_point)
+{
+    // Compute lateness
+    auto lateness = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wake_up_time_point);
+    if (lateness < std::chrono::microseconds(0))
+    {
+        lateness = std::chrono::microseconds(0);
+    }
+
+    // Update counters
+    expiries++;
+    uint64_t lateness_us = static_cast<uint64_t>(lateness.count());
+    uint64_t max         = max_lateness;
+    while ((lateness_us > max) && !max_lateness.compare_exchange_weak(max, lateness_us)) { }
+    size_t bucket = 0;
+    while (lateness > LATENESS_BUCKET_BOUNDS[bucket])
+    {
+        bucket++;
+    }
+    lateness_histogram[bucket]++;
+}
+
 /** @brief Compute next wakeup time point */
 void TimerPool::computeNextWakeupTimepoint()
 {
@@ -104,20 +250,25 @@ void TimerPool::computeNextWakeupTimepoint()
     if (m_timers.empty())
     {
         // Next wakeup in 100days
-        m_wake_up_time_point = std::chrono::system_clock::now() + std::chrono::hours(2400u);
+        m_wake_up_time_point = std::chrono::steady_clock::now() + std::chrono::hours(2400u);
     }
     else
     {
-        // Re-order timer list
-        m_timers.sort([](const Timer* a, const Timer* b) { return (a->m_wake_up_time_point < b->m_wake_up_time_point); });
+        // The next timer to wakeup is always at the front of the heap
         m_wake_up_time_point = m_timers.front()->m_wake_up_time_point;
     }
 }
 
+/** @brief Indicate if the caller is running in the timers thread */
+bool TimerPool::inTimersThread() const
+{
+    return (std::this_thread::get_id() == m_thread.get_id());
+}
+
 /** @brief Lock access to the timers */
 void TimerPool::lock()
 {
-    if (std::this_thread::get_id() != m_thread.get_id())
+    if (!inTimersThread())
     {
         m_wakeup_mutex.lock();
     }
@@ -126,7 +277,7 @@ void TimerPool::lock()
 /** @brief Unlock access to the timers */
 void TimerPool::unlock()
 {
-    if (std::this_thread::get_id() != m_thread.get_id())
+    if (!inTimersThread())
     {
         m_wakeup_mutex.unlock();
     }
@@ -144,8 +295,10 @@ void TimerPool::addTimer(Timer* timer)
         m_wakeup_cond.notify_one();
     }
 
-    // Add timer to the list
+    // Add timer to the heap
     m_timers.push_back(timer);
+    timer->m_heap_index = m_timers.size() - 1u;
+    siftUp(timer->m_heap_index);
 
     // Timer is now started
     timer->m_started = true;
@@ -154,20 +307,83 @@ void TimerPool::addTimer(Timer* timer)
 /** @brief Remove timer from the list of active timers */
 void TimerPool::removeTimer(Timer* timer)
 {
-    // Check if the timer is the next timer to wakeup
-    if (timer == m_timers.front())
+    // Check if the timer is really in the heap
+    size_t index = timer->m_heap_index;
+    if ((index < m_timers.size()) && (m_timers[index] == timer))
     {
-        // Trigger update of wakeup timepoint
-        m_update_wakeup_time = true;
-        m_wakeup_cond.notify_one();
-    }
+        // Check if the timer is the next timer to wakeup
+        if (index == 0)
+        {
+            // Trigger update of wakeup timepoint
+            m_update_wakeup_time = true;
+            m_wakeup_cond.notify_one();
+        }
 
-    // Remove timer from the list
-    m_timers.remove(timer);
+        // Replace the timer by the last timer of the heap
+        Timer* last = m_timers.back();
+        m_timers.pop_back();
+        if (last != timer)
+        {
+            place(last, index);
+            siftUp(index);
+            siftDown(last->m_heap_index);
+        }
+    }
 
     // Timer is now stopped
     timer->m_started = false;
 }
 
+/** @brief Move the timer at the specified heap position towards the front */
+void TimerPool::siftUp(size_t index)
+{
+    Timer* timer = m_timers[index];
+    while (index > 0)
+    {
+        size_t parent = (index - 1u) / 2u;
+        if (m_timers[parent]->m_wake_up_time_point <= timer->m_wake_up_time_point)
+        {
+            break;
+        }
+        place(m_timers[parent], index);
+        index = parent;
+    }
+    place(timer, index);
+}
+
+/** @brief Move the timer at the specified heap position towards the back */
+void TimerPool::siftDown(size_t index)
+{
+    Timer* timer = m_timers[index];
+    size_t count = m_timers.size();
+    while (true)
+    {
+        // Look for the child which wakes up first
+        size_t child = 2u * index + 1u;
+        if (child >= count)
+        {
+            break;
+        }
+        if (((child + 1u) < count) && (m_timers[child + 1u]->m_wake_up_time_point < m_timers[child]->m_wake_up_time_point))
+        {
+            child++;
+        }
+        if (timer->m_wake_up_time_point <= m_timers[child]->m_wake_up_time_point)
+        {
+            break;
+        }
+        place(m_timers[child], index);
+        index = child;
+    }
+    place(timer, index);
+}
+
+/** @brief Store a timer at the specified heap position */
+void TimerPool::place(Timer* timer, size_t index)
+{
+    m_timers[index]     = timer;
+    timer->m_heap_index = index;
+}
+
 } // namespace helpers
 } // namespace ocpp
@@ -19,12 +19,16 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #ifndef TIMERPOOL_H
 #define TIMERPOOL_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
-#include <list>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace ocpp
 {
@@ -33,12 +37,31 @@ namespace helpers
 
 class Timer;
 
-/** @brief Handle a pool of timers */
+/** @brief Handle a pool of timers, the active timers are stored in a binary min-heap ordered by wakeup time point */
 class TimerPool
 {
     friend class Timer;
+    friend class ClockAlignedTimer;
 
   public:
+    /** @brief Number of buckets of the lateness histogram */
+    static constexpr size_t LATENESS_BUCKET_COUNT = 8u;
+    /** @brief Upper bounds of the buckets of the lateness histogram, the last bucket has no upper bound */
+    static const std::array<std::chrono::microseconds, LATENESS_BUCKET_COUNT> LATENESS_BUCKET_BOUNDS;
+
+    /** @brief Statistics of the timers of the pool */
+    struct Statistics
+    {
+        /** @brief Number of executed callbacks */
+        uint64_t expiries;
+        /** @brief Number of expiries dropped because the previous execution of the callback was still pending */
+        uint64_t dropped;
+        /** @brief Maximum delay between the programmed wakeup time point and the execution of a callback */
+        std::chrono::microseconds max_lateness;
+        /** @brief Histogram of the delays between the programmed wakeup time point and the execution of a callback */
+        std::array<uint64_t, LATENESS_BUCKET_COUNT> lateness_histogram;
+    };
+
     /** @brief Constructor */
     TimerPool();
     /** @brief Destructor */
@@ -47,7 +70,33 @@ class TimerPool
     /** @brief Create a timer */
     Timer* createTimer();
 
+    /**
+     * @brief Get the statistics of the timers of the pool
+     * @return Statistics since the creation of the pool or the last reset
+     */
+    Statistics getStatistics() const;
+
+    /** @brief Reset the statistics of the timers of the pool */
+    void resetStatistics();
+
   private:
+    /** @brief Statistics counters, shared with the callbacks pending on an executor */
+    struct StatisticsCounters
+    {
+        /** @brief Number of executed callbacks */
+        std::atomic<uint64_t> expiries;
+        /** @brief Number of dropped expiries */
+        std::atomic<uint64_t> dropped;
+        /** @brief Maximum lateness in microseconds */
+        std::atomic<uint64_t> max_lateness;
+        /** @brief Lateness histogram */
+        std::array<std::atomic<uint64_t>, LATENESS_BUCKET_COUNT> lateness_histogram;
+
+        /** @brief Record the execution of a callback */
+        void record(std::chrono::time_point<std::chrono::steady_clock> wake_up_time_point);
+    };
+
+
     /** @brief Indicate that the timers must stop */
     bool m_stop;
     /** @brief Indicate that the next wakeup time has changed */
@@ -57,16 +106,22 @@ class TimerPool
     /** @brief Wakeup condition */
     std::condition_variable m_wakeup_cond;
     /** @brief Next wakeup time point */
-    std::chrono::time_point<std::chrono::system_clock> m_wake_up_time_point;
+    std::chrono::time_point<std::chrono::steady_clock> m_wake_up_time_point;
+    /** @brief Statistics counters */
+    std::shared_ptr<StatisticsCounters> m_statistics;
     /** @brief Timers thread */
     std::thread m_thread;
-    /** @brief List of active timers */
-    std::list<Timer*> m_timers;
+    /** @brief Heap of active timers, the next timer to wakeup is at the front */
+    std::vector<Timer*> m_timers;
 
     /** @brief Timers thread loop */
     void threadLoop();
+    /** @brief Run the callback of an elapsed timer inline or on its executor */
+    void fire(Timer* timer, std::chrono::time_point<std::chrono::steady_clock> wake_up_time_point);
     /** @brief Compute next wakeup time point */
     void computeNextWakeupTimepoint();
+    /** @brief Indicate if the caller is running in the timers thread */
+    bool inTimersThread() const;
     /** @brief Lock access to the timers */
     void lock();
     /** @brief Unlock access to the timers */
@@ -75,6 +130,12 @@ class TimerPool
     void addTimer(Timer* timer);
     /** @brief Remove timer from the list of active timers */
     void removeTimer(Timer* timer);
+    /** @brief Move the timer at the specified heap position towards the front */
+    void siftUp(size_t index);
+    /** @brief Move the timer at the specified heap position towards the back */
+    void siftDown(size_t index);
+    /** @brief Store a timer at the specified heap position */
+    void place(Timer* timer, size_t index);
 };
 
 } // namespace helpers
@@ -17,55 +17,349 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "WorkerThreadPool.h"
+#include "Timer.h"
+#include "TimerPool.h"
 
 namespace ocpp
 {
 namespace helpers
 {
 
+/** @brief Pool owning the calling thread, nullptr if the calling thread is not a worker thread */
+static thread_local WorkerThreadPool* s_current_pool = nullptr;
+/** @brief Index of the calling worker thread in its pool */
+static thread_local size_t s_current_index = 0;
+
+/** @brief Slots */
+JobCompletion::Slot JobCompletion::m_slots[JobCompletion::SLOT_COUNT];
+
+/** @brief Notify the end of a job */
+void JobCompletion::notify(const void* job)
+{
+    // Only take the lock if someone is waiting in the job's slot
+    Slot& slot = JobCompletion::slot(job);
+    if (slot.waiters != 0)
+    {
+        std::lock_guard<std::mutex> lock(slot.mutex);
+        slot.cond.notify_all();
+    }
+}
+
+/** @brief Wait for the end of a job */
+bool JobCompletion::wait(const void* job, const std::atomic<bool>& end, std::chrono::milliseconds timeout)
+{
+    bool ret = end;
+    if (!ret)
+    {
+        Slot& slot = JobCompletion::slot(job);
+        slot.waiters++;
+        {
+            std::unique_lock<std::mutex> lock(slot.mutex);
+            ret = slot.cond.wait_for(lock, timeout, [&end] { return end.load(); });
+        }
+        slot.waiters--;
+    }
+    return ret;
+}
+
+/** @brief Get the slot of a job */
+JobCompletion::Slot& JobCompletion::slot(const void* job)
+{
+    // Jobs are allocated on the heap, the lowest bits of their address are always the same
+    uintptr_t address = reinterpret_cast<uintptr_t>(job);
+    return m_slots[(address >> 6u) % SLOT_COUNT];
+}
+
 /** @brief Constructor */
-WorkerThreadPool::WorkerThreadPool(size_t thread_count) : m_stop(false), m_threads(), m_job_queue()
+WorkerThreadPool::WorkerThreadPool(size_t thread_count, TimerPool* timer_pool)
+    : m_stop(false),
+      m_workers(),
+      m_mutex(),
+      m_cond(),
+      m_jobs(),
+      m_pending(0),
+      m_idle(0),
+      m_timer_pool(timer_pool),
+      m_own_timer_pool(),
+      m_delayed_timer(),
+      m_delayed_mutex(),
+      m_delayed_jobs(),
+      m_delayed_sequence(0)
 {
-    // Create thread
+    // Create threads once all the workers exist since they can steal jobs from each other
     for (size_t i = 0; i < thread_count; i++)
     {
-        m_threads.push_back(new std::thread(std::bind(&WorkerThreadPool::workerThread, this)));
+        m_workers.emplace_back(new Worker());
+    }
+    for (size_t i = 0; i < thread_count; i++)
+    {
+        m_workers[i]->thread = std::thread(std::bind(&WorkerThreadPool::workerThread, this, i));
     }
 }
 
 /** @brief Destructor */
 WorkerThreadPool::~WorkerThreadPool()
 {
-    // Stop threads
-    m_stop = true;
-    m_job_queue.setEnable(false);
+    // Stop threads, no delayed job can be added anymore
+    {
+        std::lock_guard<std::mutex> delayed_lock(m_delayed_mutex);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+
+    // Stop scheduling delayed jobs
+    std::unique_ptr<Timer> delayed_timer;
+    {
+        std::lock_guard<std::mutex> lock(m_delayed_mutex);
+        delayed_timer = std::move(m_delayed_timer);
+    }
+    delayed_timer.reset();
+    while (!m_delayed_jobs.empty())
+    {
+        m_delayed_jobs.top().job->release();
+        m_delayed_jobs.pop();
+    }
 
     // Wait end of thread an release resources
-    for (std::thread* thread : m_threads)
+    for (auto& worker : m_workers)
+    {
+        worker->thread.join();
+    }
+
+    // Release the jobs which have not been executed
+    for (IJob* job : m_jobs)
+    {
+        job->release();
+    }
+    for (auto& worker : m_workers)
+    {
+        for (IJob* job : worker->jobs)
+        {
+            job->release();
+        }
+    }
+}
+
+/** @brief Run a function in a worker thread after a delay */
+CancellationToken WorkerThreadPool::runAfter(std::chrono::milliseconds delay, std::function<void()> func)
+{
+    // The cancellation is checked when the job is executed
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+    this->delay(delay, cancelled, func);
+    return CancellationToken(cancelled);
+}
+
+/** @brief Run a function in a worker thread at a given date */
+CancellationToken WorkerThreadPool::runAt(std::chrono::system_clock::time_point date, std::function<void()> func)
+{
+    // The cancellation is checked when the job is executed
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+    delayUntil(date, cancelled, func);
+    return CancellationToken(cancelled);
+}
+
+/** @brief Queue the delayed jobs which have reached their date */
+void WorkerThreadPool::processDelayedJobs()
+{
+    std::lock_guard<std::mutex> lock(m_delayed_mutex);
+
+    // Queue the jobs which have reached their date
+    auto now = std::chrono::steady_clock::now();
+    while (!m_delayed_jobs.empty() && (m_delayed_jobs.top().date <= now))
+    {
+        schedule(m_delayed_jobs.top().job);
+        m_delayed_jobs.pop();
+    }
+
+    // Wakeup at the date of the next job
+    if (m_delayed_timer && !m_delayed_jobs.empty())
+    {
+        m_delayed_timer->restart(std::chrono::ceil<std::chrono::milliseconds>(m_delayed_jobs.top().date - now), true);
+    }
+}
+
+/** @brief Add a function to the delayed jobs */
+void WorkerThreadPool::delay(std::chrono::milliseconds                 delay,
+                             const std::shared_ptr<std::atomic<bool>>& cancelled,
+                             std::function<void()>                     func)
+{
+    IJob* job = Job<void>::create(
+        [cancelled, func]
+        {
+            if (!cancelled->load())
+            {
+                func();
+            }
+        });
+    if (delay < std::chrono::milliseconds(0))
+    {
+        delay = std::chrono::milliseconds(0);
+    }
+
+    // Add the job to the delayed jobs
+    Timer* timer = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_delayed_mutex);
+        if (!m_stop)
+        {
+            if (!m_delayed_timer)
+            {
+                if (!m_timer_pool)
+                {
+                    m_own_timer_pool.reset(new TimerPool());
+                    m_timer_pool = m_own_timer_pool.get();
+                }
+                m_delayed_timer.reset(new Timer(*m_timer_pool, "Delayed jobs"));
+                m_delayed_timer->setCallback(std::bind(&WorkerThreadPool::processDelayedJobs, this));
+            }
+            m_delayed_jobs.push({std::chrono::steady_clock::now() + delay, m_delayed_sequence++, job});
+            timer = m_delayed_timer.get();
+        }
+        else
+        {
+            // The pool is being destroyed
+            job->release();
+        }
+    }
+
+    // Make sure the timer elapses at the latest at the job's date
+    if (timer)
     {
-        thread->join();
-        delete thread;
+        timer->startBefore(delay);
     }
 }
 
+/** @brief Add a function to the delayed jobs until a given date of the system clock */
+void WorkerThreadPool::delayUntil(std::chrono::system_clock::time_point     date,
+                                  const std::shared_ptr<std::atomic<bool>>& cancelled,
+                                  std::function<void()>                     func)
+{
+    // The delay is computed on the steady clock, check the date again when
+    // it elapses in case the system clock has been changed in the meantime
+    delay(std::chrono::ceil<std::chrono::milliseconds>(date - std::chrono::system_clock::now()),
+          cancelled,
+          [this, date, cancelled, func]
+          {
+              if (std::chrono::system_clock::now() < date)
+              {
+                  delayUntil(date, cancelled, func);
+              }
+              else
+              {
+                  func();
+              }
+          });
+}
+
+/** @brief Queue a job */
+void WorkerThreadPool::schedule(IJob* job)
+{
+    if (s_current_pool == this)
+    {
+        // Submitted from a worker thread : add to its own queue
+        Worker& worker = *m_workers[s_current_index];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.jobs.push_back(job);
+        }
+        m_pending++;
+
+        // Wake up an idle thread to steal the job
+        if (m_idle != 0)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_cond.notify_one();
+        }
+    }
+    else
+    {
+        // Submitted from outside the pool : add to the shared queue
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(job);
+            m_pending++;
+        }
+        m_cond.notify_one();
+    }
+}
+
+/** @brief Get the next job to execute by a worker thread */
+IJob* WorkerThreadPool::nextJob(size_t index)
+{
+    IJob* job = nullptr;
+
+    // Own queue first, oldest job first
+    Worker& worker = *m_workers[index];
+    {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.jobs.empty())
+        {
+            job = worker.jobs.front();
+            worker.jobs.pop_front();
+        }
+    }
+
+    // Then shared queue
+    if (!job)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_jobs.empty())
+        {
+            job = m_jobs.front();
+            m_jobs.pop_front();
+        }
+    }
+
+    // Then steal the most recent job of the other threads
+    for (size_t i = 1u; !job && (i < m_workers.size()); i++)
+    {
+        Worker&                     victim = *m_workers[(index + i) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = victim.jobs.back();
+            victim.jobs.pop_back();
+        }
+    }
+
+    if (job)
+    {
+        m_pending--;
+    }
+    return job;
+}
+
 /** @brief Worker thread */
-void WorkerThreadPool::workerThread()
+void WorkerThreadPool::workerThread(size_t index)
 {
-    std::shared_ptr<IJob> job;
+    s_current_pool  = this;
+    s_current_index = index;
 
     // Thread loop
     while (!m_stop)
     {
-        // Wait for a job
-        if (m_job_queue.pop(job))
+        // Look for a job
+        IJob* job = nextJob(index);
+        if (job)
         {
             // Execute job
             job->run();
 
             // Release resources
-            job.reset();
+            job->release();
+        }
+        else
+        {
+            // Wait for a job
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle++;
+            m_cond.wait(lock, [this] { return (m_stop || (m_pending != 0)); });
+            m_idle--;
         }
     }
+
+    s_current_pool = nullptr;
 }
 
 } // namespace helpers
@@ -19,15 +19,15 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #ifndef WORKERTHREADPOOL_H
 #define WORKERTHREADPOOL_H
 
-#include "Queue.h"
-
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
-#include <list>
 #include <memory>
 #include <mutex>
-#include <optional>
+#include <queue>
 #include <thread>
 #include <vector>
 
@@ -36,6 +36,9 @@ namespace ocpp
 namespace helpers
 {
 
+class Timer;
+class TimerPool;
+
 /** @brief Interface for job for a worker thread implementations */
 class IJob
 {
@@ -44,34 +47,74 @@ class IJob
     virtual ~IJob() { }
     /** @brief Run the job */
     virtual void run() = 0;
+    /** @brief Release a reference on the job */
+    virtual void release() = 0;
 };
 
-/** @brief Base class for a job for a worker thread */
-template <typename ReturnType>
-class JobBase : public IJob
+/** @brief Allow the waiters to be notified of the end of the jobs without a synchronization object per job
+ *
+ *  The jobs are spread over a fixed number of slots by address, only the waiters of the slot of
+ *  a job are woken up at its end.
+ */
+class JobCompletion
 {
   public:
-    /** @brief Constructor */
-    JobBase(const std::function<ReturnType()>& func) : success(true), end_of_job_mutex(), end_of_job_var(), end(false), function(func) { }
+    /** @brief Notify the end of a job */
+    static void notify(const void* job);
+    /** @brief Wait for the end of a job */
+    static bool wait(const void* job, const std::atomic<bool>& end, std::chrono::milliseconds timeout);
 
-    /** @brief Destructor */
-    virtual ~JobBase() { }
+  private:
+    /** @brief Number of slots */
+    static constexpr size_t SLOT_COUNT = 32u;
 
-    /** @brief Indicate the job did execute without uncatched exception */
-    bool success;
-    /** @brief Mutex for end of job synchronization */
-    std::mutex end_of_job_mutex;
-    /** @brief Condition variable for end of job synchronization */
-    std::condition_variable end_of_job_var;
-    /** @brief Indicate end of job */
-    bool end;
-    /** @brief Function to execute */
-    std::function<ReturnType()> function;
+    /** @brief Synchronization objects shared by the jobs of a slot */
+    struct Slot
+    {
+        /** @brief Mutex for end of job synchronization */
+        std::mutex mutex;
+        /** @brief Condition variable for end of job synchronization */
+        std::condition_variable cond;
+        /** @brief Number of threads waiting for the end of a job */
+        std::atomic<size_t> waiters{0};
+    };
+
+    /** @brief Slots */
+    static Slot m_slots[SLOT_COUNT];
+
+    /** @brief Get the slot of a job */
+    static Slot& slot(const void* job);
 };
 
-/** @brief Job for a worker thread */
+/** @brief Storage of the value returned by a job */
 template <typename ReturnType>
-class Job : public JobBase<ReturnType>
+struct JobResult
+{
+    /** @brief Execute the job's function and store the returned value */
+    void run(const std::function<ReturnType()>& function) { value = function(); }
+    /** @brief Release the returned value */
+    void reset() { value = ReturnType(); }
+    /** @brief Returned value */
+    ReturnType value;
+};
+
+/** @brief Storage of the value returned by a job without return value */
+template <>
+struct JobResult<void>
+{
+    /** @brief Execute the job's function */
+    void run(const std::function<void()>& function) { function(); }
+    /** @brief Release the returned value */
+    void reset() { }
+};
+
+/** @brief Job for a worker thread, the jobs are recycled once they have been released by the pool and by the futures
+ *
+ *  The recycled jobs are kept in a per thread cache which exchanges batches of jobs with a shared depot,
+ *  so that the jobs released by the worker threads can be reused by the threads submitting them.
+ */
+template <typename ReturnType>
+class Job : public IJob
 {
     // Needed to protect instanciation outside of WorkerThreadPool class
     friend class WorkerThreadPool;
@@ -86,153 +129,383 @@ class Job : public JobBase<ReturnType>
         try
         {
             // Execute the job and store the returned value
-            ret_value = this->function();
+            result.run(function);
         }
         catch (...)
         {
-            this->success = false;
+            success = false;
         }
+        function = nullptr;
 
         // Notify end of job
-        this->end = true;
-        this->end_of_job_var.notify_all();
+        end = true;
+        JobCompletion::notify(this);
     }
 
+    /** @brief Add a reference on the job */
+    void addRef() { refs.fetch_add(1u, std::memory_order_relaxed); }
+
+    /** @brief Release a reference on the job */
+    void release() override
+    {
+        if (refs.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        {
+            // Recycle the job in the calling thread's cache, a full cache
+            // gives half of its jobs to the shared depot
+            result.reset();
+            function = nullptr;
+            Cache& cache = threadCache();
+            if (cache.jobs.size() >= CACHE_SIZE)
+            {
+                depot().put(cache.jobs, BATCH_SIZE);
+            }
+            cache.jobs.push_back(this);
+        }
+    }
+
+    /** @brief Indicate the job did execute without uncatched exception */
+    bool success;
+    /** @brief Indicate end of job */
+    std::atomic<bool> end;
     /** @brief Returned value */
-    ReturnType ret_value;
+    JobResult<ReturnType> result;
 
   private:
-    /** @brief Constructor */
-    Job(const std::function<ReturnType()>& func) : JobBase<ReturnType>(func), ret_value() { }
-};
-
-/** @brief Job for a worker thread without return value */
-template <>
-class Job<void> : public JobBase<void>
-{
-    // Needed to protect instanciation outside of WorkerThreadPool class
-    friend class WorkerThreadPool;
+    /** @brief Maximum number of recycled jobs per thread */
+    static constexpr size_t CACHE_SIZE = 64u;
+    /** @brief Number of jobs exchanged at once between a thread's cache and the shared depot */
+    static constexpr size_t BATCH_SIZE = CACHE_SIZE / 2u;
+    /** @brief Maximum number of recycled jobs in the shared depot */
+    static constexpr size_t DEPOT_SIZE = 16u * CACHE_SIZE;
+
+    /** @brief Recycled jobs shared between the threads */
+    struct Depot
+    {
+        /** @brief Destructor */
+        ~Depot()
+        {
+            for (Job* job : jobs)
+            {
+                delete job;
+            }
+        }
+        /** @brief Move jobs from a thread's cache to the depot, the jobs which don't fit are freed */
+        void put(std::vector<Job*>& cache, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; (i < count) && !cache.empty(); i++)
+            {
+                Job* job = cache.back();
+                cache.pop_back();
+                if (jobs.size() < DEPOT_SIZE)
+                {
+                    jobs.push_back(job);
+                }
+                else
+                {
+                    delete job;
+                }
+            }
+        }
+        /** @brief Move jobs from the depot to a thread's cache */
+        void get(std::vector<Job*>& cache, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = 0; (i < count) && !jobs.empty(); i++)
+            {
+                cache.push_back(jobs.back());
+                jobs.pop_back();
+            }
+        }
+        /** @brief Mutex to protect the jobs */
+        std::mutex mutex;
+        /** @brief Recycled jobs */
+        std::vector<Job*> jobs;
+    };
+
+    /** @brief Per thread cache of recycled jobs */
+    struct Cache
+    {
+        /** @brief Destructor, the jobs are given back to the shared depot */
+        ~Cache() { depot().put(jobs, jobs.size()); }
+        /** @brief Recycled jobs */
+        std::vector<Job*> jobs;
+    };
+
+    /** @brief Number of references on the job */
+    std::atomic<uint32_t> refs;
+    /** @brief Function to execute */
+    std::function<ReturnType()> function;
 
-  public:
-    /** @brief Destructor */
-    virtual ~Job() { }
+    /** @brief Constructor */
+    Job() : IJob(), success(true), end(false), result(), refs(0), function() { }
 
-    /** @brief Run the job */
-    void run() override
+    /** @brief Get a job from the calling thread's cache or allocate a new one */
+    static Job* create(std::function<ReturnType()>&& func)
     {
-        try
+        Job*   job   = nullptr;
+        Cache& cache = threadCache();
+        if (cache.jobs.empty())
         {
-            // Execute the job and store the returned value
-            this->function();
+            depot().get(cache.jobs, BATCH_SIZE);
         }
-        catch (...)
+        if (cache.jobs.empty())
+        {
+            job = new Job();
+        }
+        else
         {
-            this->success = false;
+            job = cache.jobs.back();
+            cache.jobs.pop_back();
         }
+        job->success  = true;
+        job->end      = false;
+        job->refs     = 1u;
+        job->function = std::move(func);
+        return job;
+    }
 
-        // Notify end of job
-        this->end = true;
-        this->end_of_job_var.notify_all();
+    /** @brief Get the calling thread's cache of recycled jobs */
+    static Cache& threadCache()
+    {
+        static thread_local Cache cache;
+        return cache;
     }
 
-  private:
-    /** @brief Constructor */
-    Job(const std::function<void()>& func) : JobBase<void>(func) { }
+    /** @brief Get the shared depot of recycled jobs */
+    static Depot& depot()
+    {
+        static Depot depot;
+        return depot;
+    }
+};
+
+/** @brief Base class for the futures of the jobs */
+template <typename ReturnType>
+class FutureBase
+{
+  public:
+    /** @brief Copy constructor */
+    FutureBase(const FutureBase& copy) : m_job(copy.m_job) { m_job->addRef(); }
+
+    /** @brief Copy operator */
+    FutureBase& operator=(const FutureBase& copy)
+    {
+        copy.m_job->addRef();
+        m_job->release();
+        m_job = copy.m_job;
+        return *this;
+    }
+
+    /** @brief Destructor */
+    ~FutureBase() { m_job->release(); }
+
+    /** @brief Indicate if the job has been executed */
+    bool ready() const { return m_job->end; }
+
+    /** @brief Indicate the job did execute without uncatched exception */
+    bool success() const { return m_job->success; }
+
+    /** @brief Wait for completion */
+    bool wait(std::chrono::milliseconds timeout = std::chrono::hours(24u)) { return JobCompletion::wait(m_job, m_job->end, timeout); }
+
+  protected:
+    /** @brief Constructor, takes the ownership of a reference on the job */
+    FutureBase(Job<ReturnType>* job) : m_job(job) { }
+
+    /** @brief Associated job */
+    Job<ReturnType>* m_job;
 };
 
 /** @brief Allow to wait on asynchronous execution of a function */
 template <typename ReturnType>
-class Waiter
+class Future : public FutureBase<ReturnType>
 {
     // Needed to protect instanciation outside of WorkerThreadPool class
     friend class WorkerThreadPool;
 
   public:
     /** @brief Get the returned value */
-    const ReturnType& value() const { return (dynamic_cast<Job<ReturnType>*>(m_job.get()))->ret_value; }
-
-    /** @brief Indicate the job did execute without uncatched exception */
-    bool success() { return (dynamic_cast<Job<ReturnType>*>(m_job.get()))->success; }
-
-    /** @brief Wait for completion */
-    bool wait(std::chrono::milliseconds timeout = std::chrono::hours(24u))
-    {
-        Job<ReturnType>*             job = dynamic_cast<Job<ReturnType>*>(m_job.get());
-        std::unique_lock<std::mutex> lock(job->end_of_job_mutex);
-        return job->end_of_job_var.wait_for(lock, timeout, [job] { return job->end; });
-    }
+    const ReturnType& value() const { return this->m_job->result.value; }
 
   private:
     /** @brief Constructor */
-    Waiter(const std::shared_ptr<IJob>& job) : m_job(job) { }
-
-    /** @brief Associated job */
-    std::shared_ptr<IJob> m_job;
+    Future(Job<ReturnType>* job) : FutureBase<ReturnType>(job) { }
 };
 
 /** @brief Allow to wait on asynchronous execution of a function withour return value */
 template <>
-class Waiter<void>
+class Future<void> : public FutureBase<void>
+{
+    // Needed to protect instanciation outside of WorkerThreadPool class
+    friend class WorkerThreadPool;
+
+  private:
+    /** @brief Constructor */
+    Future(Job<void>* job) : FutureBase<void>(job) { }
+};
+
+/** @brief Allow to cancel a delayed job before its execution */
+class CancellationToken
 {
     // Needed to protect instanciation outside of WorkerThreadPool class
     friend class WorkerThreadPool;
 
   public:
-    /** @brief Indicate the job did execute without uncatched exception */
-    bool success() { return (dynamic_cast<Job<void>*>(m_job.get()))->success; }
+    /** @brief Constructor of a token which is not associated to any job */
+    CancellationToken() : m_cancelled() { }
 
-    /** @brief Wait for completion */
-    bool wait(std::chrono::milliseconds timeout = std::chrono::hours(24u))
+    /** @brief Cancel the job, has no effect if the job has already been executed */
+    void cancel()
     {
-        Job<void>*                   job = dynamic_cast<Job<void>*>(m_job.get());
-        std::unique_lock<std::mutex> lock(job->end_of_job_mutex);
-        return job->end_of_job_var.wait_for(lock, timeout, [job] { return job->end; });
+        if (m_cancelled)
+        {
+            m_cancelled->store(true);
+        }
     }
 
+    /** @brief Indicate if the job has been cancelled */
+    bool isCancelled() const { return (m_cancelled && m_cancelled->load()); }
+
   private:
     /** @brief Constructor */
-    Waiter(const std::shared_ptr<IJob>& job) : m_job(job) { }
+    CancellationToken(const std::shared_ptr<std::atomic<bool>>& cancelled) : m_cancelled(cancelled) { }
 
-    /** @brief Associated job */
-    std::shared_ptr<IJob> m_job;
+    /** @brief Cancellation flag shared with the job */
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
 };
 
-/** @brief Handle a pool of worker threads */
+/** @brief Former name of the futures */
+template <typename ReturnType>
+using Waiter = Future<ReturnType>;
+
+/**
+ * @brief Handle a pool of worker threads
+ *
+ * Each worker thread owns a queue of jobs. The jobs submitted from outside the pool go to a shared queue
+ * and are executed in submission order, the jobs submitted from a worker thread go to its own queue.
+ * An idle worker thread steals the most recent jobs from the queues of the other worker threads.
+ * The delayed jobs are kept aside and queued by a single timer of a timer pool, no worker thread sleeps waiting for them.
+ */
 class WorkerThreadPool
 {
   public:
     /**
      * @brief Constructor
      * @param thread_count Number of worker threads
+     * @param timer_pool Timer pool to use for the delayed jobs, if nullptr a dedicated one is created on first use
      */
-    WorkerThreadPool(size_t thread_count);
+    WorkerThreadPool(size_t thread_count, TimerPool* timer_pool = nullptr);
     /** @brief Destructor */
     virtual ~WorkerThreadPool();
 
+    /** @brief Get the number of worker threads */
+    size_t threadCount() const { return m_workers.size(); }
+
     /** @brief Run a function in a worker thread */
     template <typename ReturnType>
-    Waiter<ReturnType> run(std::function<ReturnType()> func)
+    Future<ReturnType> run(std::function<ReturnType()> func)
     {
-        // Create job
-        std::shared_ptr<IJob> job(new Job<ReturnType>(func));
+        // Create job, 1 reference for the future + 1 reference for the pool
+        Job<ReturnType>* job = Job<ReturnType>::create(std::move(func));
+        job->addRef();
 
-        // Add the job to the queue
-        m_job_queue.push(job);
+        // Add the job to the queues
+        schedule(job);
 
-        // Create the waiter object
-        return Waiter<ReturnType>(job);
+        // Create the future object
+        return Future<ReturnType>(job);
     }
 
+    /**
+     * @brief Run a function in a worker thread after a delay
+     * @param delay Delay before queuing the function
+     * @param func Function to run
+     * @return Token to cancel the execution of the function
+     */
+    CancellationToken runAfter(std::chrono::milliseconds delay, std::function<void()> func);
+
+    /**
+     * @brief Run a function in a worker thread at a given date
+     *        (the date is converted into a delay when the function is scheduled, and the function
+     *        is scheduled again if the system clock has been set back when the delay elapses)
+     * @param date Date at which the function must be queued
+     * @param func Function to run
+     * @return Token to cancel the execution of the function
+     */
+    CancellationToken runAt(std::chrono::system_clock::time_point date, std::function<void()> func);
+
   private:
+    /** @brief Delayed job */
+    struct DelayedJob
+    {
+        /** @brief Date at which the job must be queued */
+        std::chrono::steady_clock::time_point date;
+        /** @brief Sequence number to keep the scheduling order of jobs having the same date */
+        uint64_t sequence;
+        /** @brief Job */
+        IJob* job;
+
+        /** @brief Ordering of the delayed jobs heap, the earliest job is at the top */
+        bool operator<(const DelayedJob& other) const
+        {
+            return ((date > other.date) || ((date == other.date) && (sequence > other.sequence)));
+        }
+    };
+
+    /** @brief Worker thread */
+    struct Worker
+    {
+        /** @brief Mutex to protect the queue */
+        std::mutex mutex;
+        /** @brief Queue of jobs submitted from the worker thread */
+        std::deque<IJob*> jobs;
+        /** @brief Thread */
+        std::thread thread;
+    };
+
     /** @brief Indicate that the threads must stop */
-    bool m_stop;
+    std::atomic<bool> m_stop;
     /** @brief Worker threads */
-    std::vector<std::thread*> m_threads;
-    /** @brief Job queue */
-    Queue<std::shared_ptr<IJob>> m_job_queue;
-
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    /** @brief Mutex to protect the shared queue and the idle state of the threads */
+    std::mutex m_mutex;
+    /** @brief Condition variable to wake up the idle threads */
+    std::condition_variable m_cond;
+    /** @brief Queue of jobs submitted from outside the pool */
+    std::deque<IJob*> m_jobs;
+    /** @brief Number of queued jobs */
+    std::atomic<size_t> m_pending;
+    /** @brief Number of idle threads */
+    std::atomic<size_t> m_idle;
+
+    /** @brief Timer pool used for the delayed jobs */
+    TimerPool* m_timer_pool;
+    /** @brief Dedicated timer pool created when no timer pool has been specified */
+    std::unique_ptr<TimerPool> m_own_timer_pool;
+    /** @brief Timer which elapses at the date of the earliest delayed job */
+    std::unique_ptr<Timer> m_delayed_timer;
+    /** @brief Mutex to protect the delayed jobs */
+    std::mutex m_delayed_mutex;
+    /** @brief Delayed jobs */
+    std::priority_queue<DelayedJob> m_delayed_jobs;
+    /** @brief Sequence number of the next delayed job */
+    uint64_t m_delayed_sequence;
+
+    /** @brief Queue a job */
+    void schedule(IJob* job);
+    /** @brief Get the next job to execute by a worker thread */
+    IJob* nextJob(size_t index);
     /** @brief Worker thread */
-    void workerThread();
+    void workerThread(size_t index);
+    /** @brief Queue the delayed jobs which have reached their date */
+    void processDelayedJobs();
+    /** @brief Add a function to the delayed jobs */
+    void delay(std::chrono::milliseconds delay, const std::shared_ptr<std::atomic<bool>>& cancelled, std::function<void()> func);
+    /** @brief Add a function to the delayed jobs until a given date of the system clock */
+    void delayUntil(std::chrono::system_clock::time_point date,
+                    const std::shared_ptr<std::atomic<bool>>& cancelled,
+                    std::function<void()>                     func);
 };
 
 } // namespace helpers
@@ -0,0 +1,54 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "JsonArena.h"
+
+namespace ocpp
+{
+namespace json
+{
+
+/** @brief Constructor, enters the scope */
+JsonArena::JsonArena() : m_pool(threadPool())
+{
+    m_pool.depth++;
+}
+
+/** @brief Destructor, leaves the scope and clears the pool if it is the outermost one */
+JsonArena::~JsonArena()
+{
+    m_pool.depth--;
+    if (m_pool.depth == 0)
+    {
+        // Releases the additional chunks, the first one is kept for the next exchange
+        m_pool.allocator.Clear();
+    }
+}
+
+/** @brief Get the pool of the calling thread */
+JsonArena::Pool& JsonArena::threadPool()
+{
+    thread_local Pool pool;
+    return pool;
+}
+
+/** @brief Constructor */
+JsonArena::Pool::Pool() : buffer(new char[BUFFER_SIZE]), allocator(buffer.get(), BUFFER_SIZE), depth(0) { }
+
+} // namespace json
+} // namespace ocpp
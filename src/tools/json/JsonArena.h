@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef JSONARENA_H
+#define JSONARENA_H
+
+#include "json.h"
+
+#include <memory>
+
+namespace ocpp
+{
+namespace json
+{
+
+/** @brief Scope of a per-thread memory pool for the JSON documents which only live during a message exchange
+ *
+ *  Each thread owns a memory pool whose first chunk is a buffer allocated once. The JSON documents
+ *  built with the allocator of a JsonArena draw their values from this pool, which is cleared when
+ *  the outermost JsonArena of the thread is destroyed : the exchanges whose documents fit in the
+ *  first chunk do not perform any dynamic allocation. Scopes can be nested, the documents must not
+ *  outlive the scope they have been created in.
+ */
+class JsonArena
+{
+  public:
+    /** @brief Allocator type of the arena, same as the one of the rapidjson documents */
+    typedef rapidjson::Document::AllocatorType Allocator;
+
+    /** @brief Size in bytes of the reusable first chunk of each thread */
+    static constexpr size_t BUFFER_SIZE = 16384u;
+
+    /** @brief Constructor, enters the scope */
+    JsonArena();
+    /** @brief Destructor, leaves the scope and clears the pool if it is the outermost one */
+    virtual ~JsonArena();
+
+    JsonArena(const JsonArena&)            = delete;
+    JsonArena& operator=(const JsonArena&) = delete;
+
+    /**
+     * @brief Get the allocator of the calling thread's pool
+     * @return Allocator to give to the documents and to the converters
+     */
+    Allocator& allocator() { return m_pool.allocator; }
+
+  private:
+    /** @brief Memory pool of a thread */
+    struct Pool
+    {
+        /** @brief Constructor */
+        Pool();
+
+        /** @brief First chunk of the pool */
+        std::unique_ptr<char[]> buffer;
+        /** @brief Allocator */
+        Allocator allocator;
+        /** @brief Number of nested scopes */
+        unsigned int depth;
+    };
+
+    /** @brief Pool of the calling thread */
+    Pool& m_pool;
+
+    /** @brief Get the pool of the calling thread */
+    static Pool& threadPool();
+};
+
+} // namespace json
+} // namespace ocpp
+
+#endif // JSONARENA_H
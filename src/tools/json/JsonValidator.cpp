@@ -19,14 +19,23 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "JsonValidator.h"
 
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
 
 namespace ocpp
 {
 namespace json
 {
 
+/** @brief Mutex to protect the compiled schemas cache */
+static std::mutex s_schemas_mutex;
+/** @brief Compiled schemas cache, the schemas are never released so that
+ *         their address can safely identify the per-thread validators */
+static std::unordered_map<std::string, std::shared_ptr<const rapidjson::SchemaDocument>> s_schemas;
+
 /** @brief Constructor */
-JsonValidator::JsonValidator() : m_schema(nullptr), m_validator(nullptr), m_last_error() { }
+JsonValidator::JsonValidator() : m_schema(nullptr) { }
 
 /** @brief Destructor */
 JsonValidator::~JsonValidator() { }
@@ -34,39 +43,8 @@ JsonValidator::~JsonValidator() { }
 /** @brief Initialize the validator with a specific JSON schema file */
 bool JsonValidator::init(const std::string& schema_file)
 {
-    bool ret = false;
-
-    // Open schema file
-    std::ifstream file;
-    file.open(schema_file);
-    if (!file.fail())
-    {
-        // Read the whole file
-        std::string     json;
-        char            buffer[256u];
-        std::streamsize size;
-        do
-        {
-            size         = file.readsome(buffer, sizeof(buffer) - 1u);
-            buffer[size] = 0;
-            json.append(buffer);
-        } while (size != 0);
-
-        // Parse JSON schema
-        rapidjson::Document schema_doc;
-        schema_doc.Parse(json.c_str());
-        rapidjson::ParseErrorCode error = schema_doc.GetParseError();
-        if (error == rapidjson::ParseErrorCode ::kParseErrorNone)
-        {
-            // Instanciate validator
-            m_schema     = std::make_unique<rapidjson::SchemaDocument>(schema_doc);
-            m_validator  = std::make_unique<rapidjson::SchemaValidator>(*(m_schema.get()));
-            m_last_error = "";
-            ret          = true;
-        }
-    }
-
-    return ret;
+    m_schema = loadSchema(schema_file);
+    return (m_schema != nullptr);
 }
 
 /** @brief Validate a JSON document according to the schema file */
@@ -74,20 +52,25 @@ bool JsonValidator::isValid(const rapidjson::Value& json_document)
 {
     bool ret = false;
 
-    if (m_validator.get())
+    if (m_schema)
     {
-        m_validator->Reset();
-        ret = json_document.Accept((*(m_validator.get())));
-        if (!ret)
+        ThreadValidator& thread_validator = threadValidator();
+        thread_validator.validator->Reset();
+        ret = json_document.Accept(*thread_validator.validator);
+        if (ret)
+        {
+            thread_validator.last_error.clear();
+        }
+        else
         {
-            const char* invalid_keyword = m_validator->GetInvalidSchemaKeyword();
+            const char* invalid_keyword = thread_validator.validator->GetInvalidSchemaKeyword();
             if (invalid_keyword)
             {
-                m_last_error = "Error on keyword : " + std::string(invalid_keyword);
+                thread_validator.last_error = "Error on keyword : " + std::string(invalid_keyword);
             }
             else
             {
-                m_last_error = "Unknown error";
+                thread_validator.last_error = "Unknown error";
             }
         }
     }
@@ -95,10 +78,70 @@ bool JsonValidator::isValid(const rapidjson::Value& json_document)
     return ret;
 }
 
-/** @brief Get the last error message */
+/** @brief Get the last error message of the calling thread */
 const std::string& JsonValidator::lastError() const
 {
-    return m_last_error;
+    static const std::string no_error;
+
+    const std::string* error = &no_error;
+    if (m_schema)
+    {
+        error = &threadValidator().last_error;
+    }
+    return *error;
+}
+
+/** @brief Get the validator of the calling thread */
+JsonValidator::ThreadValidator& JsonValidator::threadValidator() const
+{
+    // Validators are stateful and must not be shared between threads
+    thread_local std::unordered_map<const rapidjson::SchemaDocument*, ThreadValidator> validators;
+
+    ThreadValidator& thread_validator = validators[m_schema.get()];
+    if (!thread_validator.validator)
+    {
+        thread_validator.validator = std::make_unique<rapidjson::SchemaValidator>(*m_schema);
+    }
+    return thread_validator;
+}
+
+/** @brief Get a compiled schema from the process wide cache, load it if needed */
+std::shared_ptr<const rapidjson::SchemaDocument> JsonValidator::loadSchema(const std::string& schema_file)
+{
+    std::shared_ptr<const rapidjson::SchemaDocument> schema;
+
+    std::lock_guard<std::mutex> lock(s_schemas_mutex);
+
+    // Look into the cache
+    auto it = s_schemas.find(schema_file);
+    if (it != s_schemas.end())
+    {
+        schema = it->second;
+    }
+    else
+    {
+        // Open schema file
+        std::ifstream file(schema_file);
+        if (!file.fail())
+        {
+            // Read the whole file
+            std::stringstream json;
+            json << file.rdbuf();
+
+            // Parse JSON schema
+            rapidjson::Document schema_doc;
+            schema_doc.Parse(json.str().c_str());
+            rapidjson::ParseErrorCode error = schema_doc.GetParseError();
+            if (error == rapidjson::ParseErrorCode ::kParseErrorNone)
+            {
+                // Compile schema
+                schema                 = std::make_shared<const rapidjson::SchemaDocument>(schema_doc);
+                s_schemas[schema_file] = schema;
+            }
+        }
+    }
+
+    return schema;
 }
 
 } // namespace json
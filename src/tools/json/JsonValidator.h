@@ -22,13 +22,19 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "json.h"
 
 #include <memory>
+#include <string>
 
 namespace ocpp
 {
 namespace json
 {
 
-/** @brief Helper class to validate JSON schemas */
+/** @brief Helper class to validate JSON schemas
+ *
+ *  The schema files are parsed and compiled only once per process, and each thread
+ *  validates the documents with its own validator instance so that a JsonValidator
+ *  can be used concurrently from several threads.
+ */
 class JsonValidator
 {
   public:
@@ -44,16 +50,30 @@ class JsonValidator
     /** @brief Validate a JSON document according to the schema file */
     bool isValid(const rapidjson::Value& json_document);
 
-    /** @brief Get the last error message */
+    /** @brief Get the last error message of the calling thread */
     const std::string& lastError() const;
 
+    /** @brief Get the compiled schema, nullptr if the validator has not been initialized */
+    const rapidjson::SchemaDocument* schema() const { return m_schema.get(); }
+
   private:
-    /** @brief Schema document */
-    std::unique_ptr<rapidjson::SchemaDocument> m_schema;
-    /** @brief Schema validator */
-    std::unique_ptr<rapidjson::SchemaValidator> m_validator;
-    /** @brief Last error message */
-    std::string m_last_error;
+    /** @brief Validator of a thread */
+    struct ThreadValidator
+    {
+        /** @brief Schema validator */
+        std::unique_ptr<rapidjson::SchemaValidator> validator;
+        /** @brief Last error message */
+        std::string last_error;
+    };
+
+    /** @brief Compiled schema, shared by all the validators using the same schema file */
+    std::shared_ptr<const rapidjson::SchemaDocument> m_schema;
+
+    /** @brief Get the validator of the calling thread */
+    ThreadValidator& threadValidator() const;
+
+    /** @brief Get a compiled schema from the process wide cache, load it if needed */
+    static std::shared_ptr<const rapidjson::SchemaDocument> loadSchema(const std::string& schema_file);
 };
 
 } // namespace json
@@ -51,6 +51,7 @@ class parse_exception : public std::logic_error
 // Include rapidjson's headers
 #include "rapidjson/document.h"
 #include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
 #include "rapidjson/schema.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
@@ -29,28 +29,121 @@ namespace log
 
 /** @brief Constructor */
 LogDatabase::LogDatabase(ocpp::database::Database& database, const std::string& table_name, unsigned int max_entries)
-    : m_database(database), m_insert_query()
+    : m_database(database),
+      m_insert_query(),
+      m_queue(),
+      m_queued(0),
+      m_processed(0),
+      m_written(0),
+      m_dropped(0),
+      m_mutex(),
+      m_processed_cond(),
+      m_stop(false),
+      m_thread()
 {
     initDatabaseTable(table_name, max_entries);
+    m_thread = std::thread(&LogDatabase::process, this);
 }
 
 /** @brief Destructor */
-LogDatabase::~LogDatabase() { }
+LogDatabase::~LogDatabase()
+{
+    // Write pending entries and stop thread
+    flush();
+    m_stop = true;
+    m_queue.setEnable(false);
+    m_thread.join();
+}
 
 /** @brief Add a log entry */
 void LogDatabase::log(std::time_t timestamp, unsigned int level, const std::string& file, const std::string& message)
 {
     if (m_insert_query)
     {
-        m_insert_query->reset();
-        m_insert_query->bind(0, timestamp);
-        m_insert_query->bind(1, level);
-        m_insert_query->bind(2, file);
-        m_insert_query->bind(3, message);
-        m_insert_query->exec();
+        Record record = {timestamp, level, file, message};
+        bool   queued = m_queue.push(std::move(record));
+        if (!queued && (level >= BLOCKING_LEVEL))
+        {
+            // Important entries wait for the writer thread to make room
+            auto timeout = std::chrono::steady_clock::now() + MAX_BLOCKING_TIME;
+            while (!queued && (std::chrono::steady_clock::now() < timeout))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                queued = m_queue.push(std::move(record));
+            }
+        }
+        if (queued)
+        {
+            m_queued++;
+        }
+        else
+        {
+            m_dropped++;
+        }
+    }
+}
+
+/** @brief Wait for all the queued log entries to be written */
+void LogDatabase::flush()
+{
+    uint64_t                     queued = m_queued;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_processed_cond.wait(lock, [this, queued] { return (m_processed >= queued); });
+}
+
+/** @brief Writer thread */
+void LogDatabase::process()
+{
+    std::vector<Record> batch;
+    batch.reserve(MAX_BATCH_SIZE);
+
+    Record record;
+    while (!m_stop)
+    {
+        // Wait for an entry, then take all the available ones
+        if (m_queue.pop(record))
+        {
+            batch.push_back(std::move(record));
+            while ((batch.size() < MAX_BATCH_SIZE) && m_queue.pop(record, 0))
+            {
+                batch.push_back(std::move(record));
+            }
+            write(batch);
+        }
     }
 }
 
+/** @brief Write a batch of log entries */
+void LogDatabase::write(std::vector<Record>& batch)
+{
+    bool success = m_database.execBatch(*m_insert_query,
+                                        batch.size(),
+                                        [&batch](Database::Query& query, size_t index)
+                                        {
+                                            const Record& record = batch[index];
+                                            query.bind(0, record.timestamp);
+                                            query.bind(1, record.level);
+                                            query.bind(2, record.file);
+                                            query.bind(3, record.message);
+                                        });
+    if (success)
+    {
+        m_written += batch.size();
+    }
+    else
+    {
+        m_dropped += batch.size();
+    }
+
+    // Notify flushing threads
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_processed += batch.size();
+    }
+    m_processed_cond.notify_all();
+    batch.clear();
+}
+
 /** @brief Initialize the database table */
 void LogDatabase::initDatabaseTable(const std::string& table_name, unsigned int max_entries)
 {
@@ -69,16 +162,34 @@ void LogDatabase::initDatabaseTable(const std::string& table_name, unsigned int
     {
         query->exec();
     }
+
+    // Keep only the last max_entries logs, ids are always increasing
+    // so only the oldest rows are touched at each insert
+    std::stringstream drop_query;
+    drop_query << "DROP TRIGGER IF EXISTS delete_oldest_" << table_name << ";";
+    query = m_database.query(drop_query.str());
+    if (query.get())
+    {
+        query->exec();
+    }
     std::stringstream trigger_query;
-    trigger_query << "CREATE TRIGGER delete_oldest_" << table_name << " AFTER INSERT ON " << table_name << " WHEN ((SELECT count() FROM "
-                  << table_name << ") > " << max_entries << ") BEGIN DELETE FROM " << table_name << " WHERE ROWID IN (SELECT ROWID FROM "
-                  << table_name << " LIMIT 1);END;";
+    trigger_query << "CREATE TRIGGER delete_oldest_" << table_name << " AFTER INSERT ON " << table_name << " BEGIN DELETE FROM "
+                  << table_name << " WHERE id <= (NEW.id - " << max_entries << ");END;";
     query = m_database.query(trigger_query.str());
     if (query.get())
     {
         query->exec();
     }
 
+    // Apply a retention size reduction
+    std::stringstream trim_query;
+    trim_query << "DELETE FROM " << table_name << " WHERE id <= ((SELECT max(id) FROM " << table_name << ") - " << max_entries << ");";
+    query = m_database.query(trim_query.str());
+    if (query.get())
+    {
+        query->exec();
+    }
+
     // Create parametrized queries
     std::stringstream insert_query;
     insert_query << "INSERT INTO " << table_name << " VALUES (NULL, ?, ?, ?, ?);";
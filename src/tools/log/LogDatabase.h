@@ -20,18 +20,39 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #define LOGDATABASE_H
 
 #include "Database.h"
+#include "RingQueue.h"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace ocpp
 {
 namespace log
 {
 
-/** @brief Handle persistency of logs */
+/** @brief Handle persistency of logs
+ *
+ *  The logs are queued without locking and written by a background
+ *  thread in batched transactions so that the logging threads never
+ *  wait for the database. When the queue is full, warnings and errors
+ *  wait for some room during a limited time while other levels are
+ *  dropped immediately.
+ */
 class LogDatabase
 {
   public:
+    /** @brief Maximum number of logs waiting to be written */
+    static constexpr size_t QUEUE_SIZE = 1024u;
+    /** @brief Maximum number of logs written in a single transaction */
+    static constexpr size_t MAX_BATCH_SIZE = 128u;
+    /** @brief Minimum log level which waits for room in the queue when it is full */
+    static constexpr unsigned int BLOCKING_LEVEL = 3u;
+    /** @brief Maximum time to wait for room in the queue */
+    static constexpr std::chrono::milliseconds MAX_BLOCKING_TIME = std::chrono::milliseconds(100);
+
     /** @brief Constructor */
     LogDatabase(ocpp::database::Database& database, const std::string& table_name, unsigned int max_entries);
 
@@ -47,15 +68,66 @@ class LogDatabase
      */
     void log(std::time_t timestamp, unsigned int level, const std::string& file, const std::string& message);
 
+    /** @brief Wait for all the queued log entries to be written */
+    void flush();
+
+    /**
+     * @brief Get the number of log entries written to the database
+     * @return Number of log entries written to the database
+     */
+    uint64_t writtenCount() const { return m_written; }
+
+    /**
+     * @brief Get the number of log entries dropped because the queue was full or the database write failed
+     * @return Number of dropped log entries
+     */
+    uint64_t droppedCount() const { return m_dropped; }
+
   private:
+    /** @brief Log entry */
+    struct Record
+    {
+        /** @brief Timestamp in UNIX format of the entry */
+        std::time_t timestamp;
+        /** @brief Log level */
+        unsigned int level;
+        /** @brief File which generated the log */
+        std::string file;
+        /** @brief Log message */
+        std::string message;
+    };
+
     /** @brief Database to store the logs */
     ocpp::database::Database& m_database;
 
     /** @brief Query to insert a log */
     std::unique_ptr<ocpp::database::Database::Query> m_insert_query;
 
+    /** @brief Queued log entries */
+    ocpp::helpers::MpscRingQueue<Record, QUEUE_SIZE> m_queue;
+    /** @brief Number of queued log entries */
+    std::atomic<uint64_t> m_queued;
+    /** @brief Number of processed log entries (written or dropped after having been queued) */
+    uint64_t m_processed;
+    /** @brief Number of log entries written to the database */
+    std::atomic<uint64_t> m_written;
+    /** @brief Number of dropped log entries */
+    std::atomic<uint64_t> m_dropped;
+    /** @brief Mutex to protect the number of processed entries */
+    std::mutex m_mutex;
+    /** @brief Condition variable to wait for the processing of the queued entries */
+    std::condition_variable m_processed_cond;
+    /** @brief Indicate the end of processing to the thread */
+    std::atomic<bool> m_stop;
+    /** @brief Writer thread */
+    std::thread m_thread;
+
     /** @brief Initialize the database table */
     void initDatabaseTable(const std::string& table_name, unsigned int max_entries);
+    /** @brief Writer thread */
+    void process();
+    /** @brief Write a batch of log entries */
+    void write(std::vector<Record>& batch);
 };
 
 } // namespace log
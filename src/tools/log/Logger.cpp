@@ -28,26 +28,21 @@ namespace ocpp
 namespace log
 {
 
-/** @brief Loggers */
-std::map<std::string, std::unique_ptr<LogDatabase>> Logger::m_loggers;
-/** @brief Default logger */
-LogDatabase* Logger::m_default_logger = nullptr;
+/** @brief Mutex to serialize the updates of the loggers registry */
+std::mutex Logger::m_loggers_mutex;
+/** @brief Current loggers registry */
+std::shared_ptr<const Logger::Registry> Logger::m_registry;
 
 /** @brief Constructor with default logger */
 Logger::Logger(const char* level_str, unsigned int level, const char* filename, const char* line)
-    : m_log_output(), m_log_database(m_default_logger), m_level_str(level_str), m_level(level), m_filename(filename), m_line(line)
+    : m_log_output(), m_log_database(getLogger(nullptr)), m_level_str(level_str), m_level(level), m_filename(filename), m_line(line)
 {
 }
 
 /** @brief Constructor */
 Logger::Logger(const char* name, const char* level_str, unsigned int level, const char* filename, const char* line)
-    : m_log_output(), m_log_database(nullptr), m_level_str(level_str), m_level(level), m_filename(filename), m_line(line)
+    : m_log_output(), m_log_database(getLogger(name)), m_level_str(level_str), m_level(level), m_filename(filename), m_line(line)
 {
-    auto iter = m_loggers.find(name);
-    if (iter != m_loggers.end())
-    {
-        m_log_database = iter->second.get();
-    }
 }
 
 /** @brief Destructor */
@@ -75,32 +70,116 @@ Logger::~Logger()
 /** @brief Register the default logger */
 void Logger::registerDefaultLogger(ocpp::database::Database& database, unsigned int max_entries)
 {
-    auto iter = m_loggers.find(DEFAULT_LOG_NAME);
-    if (iter == m_loggers.end())
+    std::lock_guard<std::mutex> lock(m_loggers_mutex);
+
+    std::shared_ptr<Registry> registry = copyRegistry();
+    auto                      iter     = registry->loggers.find(DEFAULT_LOG_NAME);
+    if (iter == registry->loggers.end())
     {
-        m_default_logger = new LogDatabase(database, DEFAULT_LOG_NAME, max_entries);
-        m_loggers.emplace(DEFAULT_LOG_NAME, m_default_logger);
+        registry->default_logger = std::make_shared<LogDatabase>(database, DEFAULT_LOG_NAME, max_entries);
+        registry->loggers.emplace(DEFAULT_LOG_NAME, registry->default_logger);
+        std::atomic_store(&m_registry, std::shared_ptr<const Registry>(registry));
     }
 }
 
 /** @brief Unregister the default logger */
 void Logger::unregisterDefaultLogger()
 {
-    auto iter = m_loggers.find(DEFAULT_LOG_NAME);
-    if (iter != m_loggers.end())
-    {
-        m_loggers.erase(iter);
-    }
+    unregisterLogger(DEFAULT_LOG_NAME);
 }
 
 /** @brief Register a logger */
 void Logger::registerLogger(ocpp::database::Database& database, const std::string& name, unsigned int max_entries)
 {
-    auto iter = m_loggers.find(name);
-    if (iter == m_loggers.end())
+    std::lock_guard<std::mutex> lock(m_loggers_mutex);
+
+    std::shared_ptr<Registry> registry = copyRegistry();
+    auto                      iter     = registry->loggers.find(name);
+    if (iter == registry->loggers.end())
+    {
+        registry->loggers.emplace(name, std::make_shared<LogDatabase>(database, name, max_entries));
+        std::atomic_store(&m_registry, std::shared_ptr<const Registry>(registry));
+    }
+}
+
+/** @brief Unregister a logger */
+void Logger::unregisterLogger(const std::string& name)
+{
+    std::shared_ptr<LogDatabase> logger;
+    {
+        std::lock_guard<std::mutex> lock(m_loggers_mutex);
+
+        std::shared_ptr<Registry> registry = copyRegistry();
+        auto                      iter     = registry->loggers.find(name);
+        if (iter != registry->loggers.end())
+        {
+            logger = iter->second;
+            if (logger == registry->default_logger)
+            {
+                registry->default_logger.reset();
+            }
+            registry->loggers.erase(iter);
+            std::atomic_store(&m_registry, std::shared_ptr<const Registry>(registry));
+        }
+    }
+
+    // The logger is destroyed by the last of its users : its destructor writes
+    // the pending logs and stops the writer thread
+    logger.reset();
+}
+
+/** @brief Wait for the pending logs of all the loggers to be written */
+void Logger::flushLoggers()
+{
+    std::shared_ptr<const Registry> registry = std::atomic_load(&m_registry);
+    if (registry)
+    {
+        for (auto& logger : registry->loggers)
+        {
+            logger.second->flush();
+        }
+    }
+}
+
+/** @brief Get a logger */
+std::shared_ptr<LogDatabase> Logger::getLogger(const char* name)
+{
+    std::shared_ptr<LogDatabase> logger;
+
+    std::shared_ptr<const Registry> registry = std::atomic_load(&m_registry);
+    if (registry)
+    {
+        if (name)
+        {
+            auto iter = registry->loggers.find(name);
+            if (iter != registry->loggers.end())
+            {
+                logger = iter->second;
+            }
+        }
+        else
+        {
+            logger = registry->default_logger;
+        }
+    }
+
+    return logger;
+}
+
+/** @brief Get a modifiable copy of the current loggers registry, the registry updates must be locked by the caller */
+std::shared_ptr<Logger::Registry> Logger::copyRegistry()
+{
+    std::shared_ptr<Registry>       registry;
+    std::shared_ptr<const Registry> current = std::atomic_load(&m_registry);
+    if (current)
+    {
+        registry = std::make_shared<Registry>(*current);
+    }
+    else
     {
-        m_loggers.emplace(name, new LogDatabase(database, name, max_entries));
+        registry = std::make_shared<Registry>();
     }
+    return registry;
 }
 
 } // namespace log
@@ -23,6 +23,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -148,12 +149,20 @@ class Logger
     static void unregisterDefaultLogger();
     /** @brief Register a logger */
     static void registerLogger(ocpp::database::Database& database, const std::string& name, unsigned int max_entries);
+    /**
+     * @brief Unregister a logger
+     *        Its pending logs are written and its writer thread is stopped as soon as the logs
+     *        being generated with it are complete, the last of them does it if any
+     */
+    static void unregisterLogger(const std::string& name);
+    /** @brief Wait for the pending logs of all the loggers to be written */
+    static void flushLoggers();
 
   private:
     /** @brief Log output */
     std::stringstream m_log_output;
-    /** @brief Log database */
-    LogDatabase* m_log_database;
+    /** @brief Log database, kept alive until the end of the log even if it is unregistered in the meantime */
+    std::shared_ptr<LogDatabase> m_log_database;
     /** @brief Log level */
     const char* m_level_str;
     /** @brief Log level */
@@ -163,10 +172,24 @@ class Logger
     /** @brief Code line */
     const char* m_line;
 
-    /** @brief Loggers */
-    static std::map<std::string, std::unique_ptr<LogDatabase>> m_loggers;
-    /** @brief Default logger */
-    static LogDatabase* m_default_logger;
+    /** @brief Registered loggers, never modified once published */
+    struct Registry
+    {
+        /** @brief Loggers */
+        std::map<std::string, std::shared_ptr<LogDatabase>> loggers;
+        /** @brief Default logger */
+        std::shared_ptr<LogDatabase> default_logger;
+    };
+
+    /** @brief Mutex to serialize the updates of the loggers registry */
+    static std::mutex m_loggers_mutex;
+    /** @brief Current loggers registry, atomically replaced by a modified copy on each update */
+    static std::shared_ptr<const Registry> m_registry;
+
+    /** @brief Get a logger */
+    static std::shared_ptr<LogDatabase> getLogger(const char* name);
+    /** @brief Get a modifiable copy of the current loggers registry, the registry updates must be locked by the caller */
+    static std::shared_ptr<Registry> copyRegistry();
 };
 
 /** @brief Null logger */
@@ -22,6 +22,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "String.h"
 
 #include <map>
+#include <string_view>
 #include <vector>
 
 namespace ocpp
@@ -45,19 +46,20 @@ class EnumToStringFromString
     }
 
     /** @brief Get the string representation of the enum value */
-    std::string toString(EnumType value) const
+    const std::string& toString(EnumType value) const
     {
-        std::string ret;
-        auto        it = m_enum_to_string.find(value);
+        static const std::string empty;
+        const std::string*       ret = &empty;
+        auto                     it  = m_enum_to_string.find(value);
         if (it != m_enum_to_string.end())
         {
-            ret = it->second;
+            ret = &it->second;
         }
-        return ret;
+        return *ret;
     }
 
     /** @brief Get the value represented by a string */
-    EnumType fromString(const std::string& str) const
+    EnumType fromString(std::string_view str) const
     {
         EnumType ret = m_string_to_enum.begin()->second;
         auto     it  = m_string_to_enum.find(str);
@@ -69,7 +71,7 @@ class EnumToStringFromString
     }
 
     /** @brief Get the value represented by a string */
-    bool fromString(const std::string& str, EnumType& val) const
+    bool fromString(std::string_view str, EnumType& val) const
     {
         bool ret = false;
         auto it  = m_string_to_enum.find(str);
@@ -84,8 +86,8 @@ class EnumToStringFromString
   private:
     /** @brief Map for enum to string conversion */
     std::map<EnumType, std::string> m_enum_to_string;
-    /** @brief Map for string to enum conversion */
-    std::map<std::string, EnumType> m_string_to_enum;
+    /** @brief Map for string to enum conversion, searchable without building a std::string */
+    std::map<std::string, EnumType, std::less<>> m_string_to_enum;
 };
 
 /** @brief Helper function to get an enum list from a CSL string */
@@ -19,6 +19,8 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #ifndef IWEBSOCKETCLIENT_H
 #define IWEBSOCKETCLIENT_H
 
+#include "SendPriority.h"
+
 #include <chrono>
 #include <string>
 
@@ -71,9 +73,48 @@ class IWebsocketClient
      * @brief Send data through the websocket connection
      * @param buffer Buffer containing the data to send
      * @param size Size of the buffer in bytes
-     * @return true is the data has been sent, false otherwise
+     * @param priority Priority of the data
+     * @return true is the data has been queued for sending,
+     *         false if not connected or if the send queue of the priority is full,
+     *         a full High priority queue also closes the connection
+     */
+    virtual bool send(const void* data, size_t size, SendPriority priority = SendPriority::Normal) = 0;
+
+    /**
+     * @brief Get the number of bytes which must be reserved at the start of the buffers given to send(std::string&&, SendPriority)
+     * @return Number of bytes to reserve
+     */
+    virtual size_t sendHeadroom() const = 0;
+
+    /**
+     * @brief Send data through the websocket connection without copying it
+     * @param buffer Buffer containing sendHeadroom() reserved bytes followed by the data to send,
+     *               its ownership is transfered to the websocket
+     * @param priority Priority of the data
+     * @return true is the data has been queued for sending,
+     *         false if not connected or if the send queue of the priority is full,
+     *         a full High priority queue also closes the connection
+     */
+    virtual bool send(std::string&& buffer, SendPriority priority = SendPriority::Normal) = 0;
+
+    /**
+     * @brief Get the number of messages waiting to be sent
+     * @return Number of queued messages
      */
-    virtual bool send(const void* data, size_t size) = 0;
+    virtual size_t sendQueueDepth() const = 0;
+
+    /**
+     * @brief Get the number of payload bytes waiting to be sent
+     * @return Number of queued bytes
+     */
+    virtual size_t sendQueueBytes() const = 0;
+
+    /**
+     * @brief Get the highest number of messages which have been waiting to be sent at the same time
+     * @param priority Priority of the messages
+     * @return High-water mark of the send queue of the priority
+     */
+    virtual size_t sendQueueHighWaterMark(SendPriority priority) const = 0;
 
     /**
      * @brief Register a listener to the websocket events
@@ -141,6 +182,16 @@ class IWebsocketClient
         /** @brief Skip server name check in certificates for TLS connections
          *         (Warning : enabling this feature is not recommended in production) */
         bool skip_server_name_check;
+
+        // Compression (permessage-deflate extension)
+
+        /** @brief Offer the permessage-deflate extension to compress the messages
+         *         (connect() fails if the library has been built without OCPP_WITH_PERMESSAGE_DEFLATE) */
+        bool permessage_deflate;
+        /** @brief Compression level (1 = fastest to 9 = best compression) */
+        unsigned int compression_level;
+        /** @brief Base 2 logarithm of the compression window size (9 to 15, 0 = default) */
+        unsigned int compression_window_bits;
     };
 };
 
@@ -0,0 +1,44 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SENDPRIORITY_H
+#define SENDPRIORITY_H
+
+#include <cstddef>
+
+namespace ocpp
+{
+namespace websockets
+{
+
+/** @brief Priority of the messages sent through a websocket connection */
+enum class SendPriority
+{
+    /** @brief Responses and control messages, sent before any other queued message */
+    High,
+    /** @brief Requests and bulk telemetry */
+    Normal
+};
+
+/** @brief Number of send priorities */
+static constexpr size_t SEND_PRIORITY_COUNT = 2u;
+
+} // namespace websockets
+} // namespace ocpp
+
+#endif // SENDPRIORITY_H
@@ -26,15 +26,15 @@ namespace websockets
 {
 
 /** @brief Instanciate a client websocket */
-IWebsocketClient* WebsocketFactory::newClient()
+IWebsocketClient* WebsocketFactory::newClient(size_t max_message_size, size_t send_queue_size)
 {
-    return new LibWebsocketClient();
+    return new LibWebsocketClient(max_message_size, send_queue_size);
 }
 
 /** @brief Instanciate a server websocket */
-IWebsocketServer* WebsocketFactory::newServer()
+IWebsocketServer* WebsocketFactory::newServer(size_t max_message_size, size_t send_queue_size)
 {
-    return new LibWebsocketServer();
+    return new LibWebsocketServer(max_message_size, send_queue_size);
 }
 
 } // namespace websockets
@@ -22,6 +22,8 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #include "IWebsocketClient.h"
 #include "IWebsocketServer.h"
 
+#include <cstddef>
+
 namespace ocpp
 {
 namespace websockets
@@ -31,10 +33,17 @@ namespace websockets
 class WebsocketFactory
 {
   public:
+    /** @brief Default maximum size in bytes of a received message */
+    static constexpr size_t DEFAULT_MAX_MESSAGE_SIZE = 16u * 1024u * 1024u;
+    /** @brief Default maximum number of messages waiting to be sent for each priority */
+    static constexpr size_t DEFAULT_SEND_QUEUE_SIZE = 1000u;
+
     /** @brief Instanciate a client websocket */
-    static IWebsocketClient* newClient();
+    static IWebsocketClient* newClient(size_t max_message_size = DEFAULT_MAX_MESSAGE_SIZE,
+                                       size_t send_queue_size  = DEFAULT_SEND_QUEUE_SIZE);
     /** @brief Instanciate a server websocket */
-    static IWebsocketServer* newServer();
+    static IWebsocketServer* newServer(size_t max_message_size = DEFAULT_MAX_MESSAGE_SIZE,
+                                       size_t send_queue_size  = DEFAULT_SEND_QUEUE_SIZE);
 };
 
 } // namespace websockets
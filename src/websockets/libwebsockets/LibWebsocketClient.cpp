@@ -18,6 +18,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 
 #include "LibWebsocketClient.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <iostream>
@@ -30,8 +31,16 @@ namespace websockets
 /** @brief Thread local client instance used when callbacks doesn't provide user data */
 thread_local LibWebsocketClient* client;
 
+#ifdef OCPP_WITH_PERMESSAGE_DEFLATE
+/** @brief Indicate if the permessage-deflate extension is supported */
+static constexpr bool PERMESSAGE_DEFLATE_SUPPORTED = true;
+#else
+/** @brief Indicate if the permessage-deflate extension is supported */
+static constexpr bool PERMESSAGE_DEFLATE_SUPPORTED = false;
+#endif // OCPP_WITH_PERMESSAGE_DEFLATE
+
 /** @brief Constructor */
-LibWebsocketClient::LibWebsocketClient()
+LibWebsocketClient::LibWebsocketClient(size_t max_message_size, size_t send_queue_size)
     : IWebsocketClient(),
       m_listener(nullptr),
       m_thread(nullptr),
@@ -48,7 +57,12 @@ LibWebsocketClient::LibWebsocketClient()
       m_wsi(nullptr),
       m_retry_policy(),
       m_retry_count(0),
-      m_send_msgs()
+      m_deflate_offer(),
+      m_extensions(),
+      m_max_message_size(max_message_size),
+      m_rx_buffer(),
+      m_send_msgs(send_queue_size),
+      m_send_overflow(false)
 {
 }
 /** @brief Destructor */
@@ -69,8 +83,8 @@ bool LibWebsocketClient::connect(const std::string&        url,
 {
     bool ret = false;
 
-    // Check if thread is alive and if a listener has been registered
-    if (!m_thread && m_listener)
+    // Check if thread is alive, if a listener has been registered and if the requested extensions are supported
+    if (!m_thread && m_listener && (PERMESSAGE_DEFLATE_SUPPORTED || !credentials.permessage_deflate))
     {
         // Check URL
         m_url = url;
@@ -100,6 +114,20 @@ bool LibWebsocketClient::connect(const std::string&        url,
             {
                 info.ecdh_curve = m_credentials.ecdh_curve.c_str();
             }
+#ifdef OCPP_WITH_PERMESSAGE_DEFLATE
+            if (m_credentials.permessage_deflate)
+            {
+                // Offer the permessage-deflate extension
+                m_deflate_offer = "permessage-deflate; client_max_window_bits";
+                if ((m_credentials.compression_window_bits >= 9u) && (m_credentials.compression_window_bits <= 15u))
+                {
+                    m_deflate_offer += "=" + std::to_string(m_credentials.compression_window_bits);
+                }
+                m_extensions[0] = {"permessage-deflate", lws_extension_callback_pm_deflate, m_deflate_offer.c_str()};
+                m_extensions[1] = {nullptr, nullptr, nullptr};
+                info.extensions = &m_extensions[0];
+            }
+#endif // OCPP_WITH_PERMESSAGE_DEFLATE
 
             // Create context
             m_context = lws_create_context(&info);
@@ -136,11 +164,7 @@ bool LibWebsocketClient::disconnect()
     {
         // Stop thread
         m_end = true;
-        SendMsg* msg;
-        while (m_send_msgs.pop(msg, 0))
-        {
-            delete msg;
-        }
+        m_send_msgs.clear();
         lws_cancel_service(m_context);
         if (std::this_thread::get_id() != m_thread->get_id())
         {
@@ -165,8 +189,8 @@ bool LibWebsocketClient::isConnected()
     return m_connected;
 }
 
-/** @copydoc bool IWebsocketClient::send(const void*, size_t) */
-bool LibWebsocketClient::send(const void* data, size_t size)
+/** @copydoc bool IWebsocketClient::send(const void*, size_t, SendPriority) */
+bool LibWebsocketClient::send(const void* data, size_t size, SendPriority priority)
 {
     bool ret = false;
 
@@ -175,15 +199,52 @@ bool LibWebsocketClient::send(const void* data, size_t size)
     {
         // Prepare data to send
         SendMsg* msg = new SendMsg(data, size);
-        ret          = m_send_msgs.push(msg);
+        ret          = queueMessage(msg, priority);
+    }
+
+    return ret;
+}
 
-        // Schedule a send
-        lws_callback_on_writable(m_wsi);
+/** @copydoc size_t IWebsocketClient::sendHeadroom() const */
+size_t LibWebsocketClient::sendHeadroom() const
+{
+    return LWS_PRE;
+}
+
+/** @copydoc bool IWebsocketClient::send(std::string&&, SendPriority) */
+bool LibWebsocketClient::send(std::string&& buffer, SendPriority priority)
+{
+    bool ret = false;
+
+    // Check if connected
+    if (m_connected && (buffer.size() >= LWS_PRE))
+    {
+        // Prepare data to send
+        SendMsg* msg = new SendMsg(std::move(buffer));
+        ret          = queueMessage(msg, priority);
     }
 
     return ret;
 }
 
+/** @copydoc size_t IWebsocketClient::sendQueueDepth() const */
+size_t LibWebsocketClient::sendQueueDepth() const
+{
+    return m_send_msgs.count();
+}
+
+/** @copydoc size_t IWebsocketClient::sendQueueBytes() const */
+size_t LibWebsocketClient::sendQueueBytes() const
+{
+    return m_send_msgs.bytes();
+}
+
+/** @copydoc size_t IWebsocketClient::sendQueueHighWaterMark(SendPriority) const */
+size_t LibWebsocketClient::sendQueueHighWaterMark(SendPriority priority) const
+{
+    return m_send_msgs.highWaterMark(priority);
+}
+
 /** @copydoc void IWebsocketClient::registerListener(IListener&) */
 void LibWebsocketClient::registerListener(IListener& listener)
 {
@@ -212,6 +273,101 @@ void LibWebsocketClient::process()
     lws_context_destroy(m_context);
 }
 
+/** @brief Queue a message to send and wake up the internal thread */
+bool LibWebsocketClient::queueMessage(SendMsg* msg, SendPriority priority)
+{
+    // Queue message, the queue is full when the messages are produced faster than they can be sent
+    bool ret = m_send_msgs.push(msg, priority);
+    if (!ret)
+    {
+        delete msg;
+
+        // A response cannot be dropped, the connection is closed instead
+        if (priority == SendPriority::High)
+        {
+            m_send_overflow = true;
+        }
+    }
+
+    // Wake up the internal thread so that it asks for a writeable callback
+    lws_cancel_service(m_context);
+
+    return ret;
+}
+
+/** @brief Send the next queued message, libwebsockets allows only one write per writeable callback */
+void LibWebsocketClient::sendQueuedMessage(struct lws* wsi)
+{
+    bool     error = false;
+    SendMsg* msg   = nullptr;
+    if (m_send_msgs.pop(msg))
+    {
+        if (lws_write(wsi, msg->payload, msg->size, LWS_WRITE_TEXT) < static_cast<int>(msg->size))
+        {
+            error = true;
+        }
+
+        // Free message memory
+        delete msg;
+    }
+    if (error)
+    {
+        // Error
+        disconnect();
+        m_listener->wsClientError();
+    }
+    else if (!m_send_msgs.empty())
+    {
+        // Send the next message on the next writeable callback
+        lws_callback_on_writable(wsi);
+    }
+}
+
+/** @brief Reassemble the received fragments and notify the complete messages */
+bool LibWebsocketClient::receiveFragment(struct lws* wsi, const void* data, size_t size)
+{
+    bool ret = false;
+
+    bool first = (lws_is_first_fragment(wsi) != 0);
+    bool final = (lws_is_final_fragment(wsi) != 0);
+    if (first && final)
+    {
+        // Complete message, no need to copy it
+        if (size <= m_max_message_size)
+        {
+            m_listener->wsClientDataReceived(data, size);
+            ret = true;
+        }
+    }
+    else
+    {
+        // Start of a new message
+        if (first)
+        {
+            m_rx_buffer.clear();
+            m_rx_buffer.reserve(std::min(size + lws_remaining_packet_payload(wsi), m_max_message_size));
+        }
+
+        // Append fragment
+        if ((m_rx_buffer.size() + size) <= m_max_message_size)
+        {
+            m_rx_buffer.append(reinterpret_cast<const char*>(data), size);
+            if (final)
+            {
+                m_listener->wsClientDataReceived(m_rx_buffer.c_str(), m_rx_buffer.size());
+                m_rx_buffer.clear();
+            }
+            ret = true;
+        }
+        else
+        {
+            m_rx_buffer.clear();
+        }
+    }
+
+    return ret;
+}
+
 /** @brief libwebsockets connection callback */
 void LibWebsocketClient::connectCallback(struct lws_sorted_usec_list* sul)
 {
@@ -318,32 +474,49 @@ int LibWebsocketClient::eventCallback(struct lws* wsi, enum lws_callback_reasons
         }
 
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
+            client->m_send_overflow = false;
+#ifdef OCPP_WITH_PERMESSAGE_DEFLATE
+            // Configure compression, the window size has already been negotiated through the extension offer
+            if (client->m_credentials.permessage_deflate)
+            {
+                unsigned int level = std::min(std::max(client->m_credentials.compression_level, 1u), 9u);
+                lws_set_extension_option(wsi, "permessage-deflate", "compression_level", std::to_string(level).c_str());
+            }
+#endif // OCPP_WITH_PERMESSAGE_DEFLATE
             client->m_connected = true;
             client->m_listener->wsClientConnected();
             break;
 
         case LWS_CALLBACK_CLIENT_RECEIVE:
-            client->m_listener->wsClientDataReceived(in, len);
+            if (!client->receiveFragment(wsi, in, len))
+            {
+                // Message too large
+                lws_close_reason(wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, nullptr, 0);
+                return -1;
+            }
             break;
 
-        case LWS_CALLBACK_CLIENT_WRITEABLE:
-        {
-            // Send data if any ready
-            SendMsg* msg = nullptr;
-            if (client->m_send_msgs.pop(msg, 0))
+        case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+            // Messages or a close may have been requested from another thread
+            if (client->m_connected && (!client->m_send_msgs.empty() || client->m_send_overflow))
             {
-                if (lws_write(wsi, msg->payload, msg->size, LWS_WRITE_TEXT) < static_cast<int>(msg->size))
-                {
-                    // Error
-                    client->disconnect();
-                    client->m_listener->wsClientError();
-                }
+                lws_callback_on_writable(client->m_wsi);
+            }
+            break;
 
-                // Free message memory
-                delete msg;
+        case LWS_CALLBACK_CLIENT_WRITEABLE:
+            if (client->m_send_overflow)
+            {
+                // High priority lane is full, the queued messages belong to this connection
+                client->m_send_overflow = false;
+                client->m_send_msgs.clear();
+                lws_close_reason(wsi, LWS_CLOSE_STATUS_POLICY_VIOLATION, nullptr, 0);
+                return -1;
             }
-        }
-        break;
+
+            // Send data if any ready
+            client->sendQueuedMessage(wsi);
+            break;
 
         case LWS_CALLBACK_CLIENT_CLOSED:
             client->m_connected = false;
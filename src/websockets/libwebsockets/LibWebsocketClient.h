@@ -20,10 +20,12 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #define LIBWEBSOCKETCLIENT_H
 
 #include "IWebsocketClient.h"
-#include "Queue.h"
+#include "SendQueue.h"
 #include "Url.h"
 #include "libwebsockets.h"
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
@@ -37,8 +39,12 @@ namespace websockets
 class LibWebsocketClient : public IWebsocketClient
 {
   public:
-    /** @brief Constructor */
-    LibWebsocketClient();
+    /**
+     * @brief Constructor
+     * @param max_message_size Maximum size in bytes of a received message
+     * @param send_queue_size Maximum number of Normal priority messages waiting to be sent
+     */
+    LibWebsocketClient(size_t max_message_size, size_t send_queue_size);
     /** @brief Destructor */
     virtual ~LibWebsocketClient();
 
@@ -57,8 +63,23 @@ class LibWebsocketClient : public IWebsocketClient
     /** @copydoc bool IWebsocketClient::isConnected() */
     bool isConnected() override;
 
-    /** @copydoc bool IWebsocketClient::send(const void*, size_t) */
-    bool send(const void* data, size_t size) override;
+    /** @copydoc bool IWebsocketClient::send(const void*, size_t, SendPriority) */
+    bool send(const void* data, size_t size, SendPriority priority = SendPriority::Normal) override;
+
+    /** @copydoc size_t IWebsocketClient::sendHeadroom() const */
+    size_t sendHeadroom() const override;
+
+    /** @copydoc bool IWebsocketClient::send(std::string&&, SendPriority) */
+    bool send(std::string&& buffer, SendPriority priority = SendPriority::Normal) override;
+
+    /** @copydoc size_t IWebsocketClient::sendQueueDepth() const */
+    size_t sendQueueDepth() const override;
+
+    /** @copydoc size_t IWebsocketClient::sendQueueBytes() const */
+    size_t sendQueueBytes() const override;
+
+    /** @copydoc size_t IWebsocketClient::sendQueueHighWaterMark(SendPriority) const */
+    size_t sendQueueHighWaterMark(SendPriority priority) const override;
 
     /** @copydoc void IWebsocketClient::registerListener(IListener&) */
     void registerListener(IListener& listener) override;
@@ -67,19 +88,20 @@ class LibWebsocketClient : public IWebsocketClient
     /** @brief Message to send */
     struct SendMsg
     {
-        /** @brief Constructor */
-        SendMsg(const void* _data, size_t _size)
+        /** @brief Constructor which copies the data */
+        SendMsg(const void* _data, size_t _size) : data(LWS_PRE + _size, '\0'), payload(nullptr), size(_size)
         {
-            data    = new unsigned char[LWS_PRE + _size];
-            size    = _size;
-            payload = &data[LWS_PRE];
+            payload = reinterpret_cast<unsigned char*>(&data[LWS_PRE]);
             memcpy(payload, _data, size);
         }
-        /** @brief Destructor */
-        virtual ~SendMsg() { delete[] data; }
+        /** @brief Constructor which takes the ownership of a buffer already containing the LWS_PRE headroom */
+        SendMsg(std::string&& _data) : data(std::move(_data)), payload(nullptr), size(data.size() - LWS_PRE)
+        {
+            payload = reinterpret_cast<unsigned char*>(&data[LWS_PRE]);
+        }
 
         /** @brief Data buffer */
-        unsigned char* data;
+        std::string data;
         /** @brief Payload start */
         unsigned char* payload;
         /** @brief Size in bytes */
@@ -117,12 +139,29 @@ class LibWebsocketClient : public IWebsocketClient
     lws_retry_bo_t m_retry_policy;
     /** @brief Consecutive retries */
     uint16_t m_retry_count;
+    /** @brief permessage-deflate extension offer */
+    std::string m_deflate_offer;
+    /** @brief Extensions */
+    std::array<struct lws_extension, 2u> m_extensions;
+
+    /** @brief Maximum size in bytes of a received message */
+    size_t m_max_message_size;
+    /** @brief Reception buffer used to reassemble fragmented messages */
+    std::string m_rx_buffer;
 
     /** @brief Queue of messages to send */
-    ocpp::helpers::Queue<SendMsg*> m_send_msgs;
+    SendQueue<SendMsg> m_send_msgs;
+    /** @brief Indicate that the connection must be closed because the High priority lane is full */
+    std::atomic<bool> m_send_overflow;
 
     /** @brief Internal thread */
     void process();
+    /** @brief Queue a message to send and wake up the internal thread */
+    bool queueMessage(SendMsg* msg, SendPriority priority);
+    /** @brief Send the next queued message, libwebsockets allows only one write per writeable callback */
+    void sendQueuedMessage(struct lws* wsi);
+    /** @brief Reassemble the received fragments and notify the complete messages */
+    bool receiveFragment(struct lws* wsi, const void* data, size_t size);
 
     /** @brief libwebsockets connection callback */
     static void connectCallback(struct lws_sorted_usec_list* sul);
@@ -18,6 +18,7 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 
 #include "LibWebsocketServer.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <functional>
 #include <iostream>
@@ -27,11 +28,19 @@ namespace ocpp
 namespace websockets
 {
 
+#ifdef OCPP_WITH_PERMESSAGE_DEFLATE
+/** @brief Indicate if the permessage-deflate extension is supported */
+static constexpr bool PERMESSAGE_DEFLATE_SUPPORTED = true;
+#else
+/** @brief Indicate if the permessage-deflate extension is supported */
+static constexpr bool PERMESSAGE_DEFLATE_SUPPORTED = false;
+#endif // OCPP_WITH_PERMESSAGE_DEFLATE
+
 /** @brief Thread local server instance used when callbacks doesn't provide user data */
 thread_local LibWebsocketServer* server;
 
 /** @brief Constructor */
-LibWebsocketServer::LibWebsocketServer()
+LibWebsocketServer::LibWebsocketServer(size_t max_message_size, size_t send_queue_size)
     : IWebsocketServer(),
       m_listener(nullptr),
       m_thread(nullptr),
@@ -43,6 +52,9 @@ LibWebsocketServer::LibWebsocketServer()
       m_wsi(nullptr),
       m_retry_policy(),
       m_protocols(),
+      m_extensions(),
+      m_max_message_size(max_message_size),
+      m_send_queue_size(send_queue_size),
       m_clients()
 {
 }
@@ -62,8 +74,8 @@ bool LibWebsocketServer::start(const std::string&        url,
 {
     bool ret = false;
 
-    // Check if thread is alive and if a listener has been registered
-    if (!m_thread && m_listener)
+    // Check if thread is alive, if a listener has been registered and if the requested extensions are supported
+    if (!m_thread && m_listener && (PERMESSAGE_DEFLATE_SUPPORTED || !credentials.permessage_deflate))
     {
         // Check URL
         m_url = url;
@@ -121,6 +133,15 @@ bool LibWebsocketServer::start(const std::string&        url,
             {
                 info.ecdh_curve = m_credentials.ecdh_curve.c_str();
             }
+#ifdef OCPP_WITH_PERMESSAGE_DEFLATE
+            if (m_credentials.permessage_deflate)
+            {
+                // Accept the permessage-deflate extension
+                m_extensions[0] = {"permessage-deflate", lws_extension_callback_pm_deflate, "permessage-deflate"};
+                m_extensions[1] = {nullptr, nullptr, nullptr};
+                info.extensions = &m_extensions[0];
+            }
+#endif // OCPP_WITH_PERMESSAGE_DEFLATE
             if (!m_credentials.server_certificate.empty())
             {
                 info.ssl_cert_filepath = m_credentials.server_certificate.c_str();
@@ -340,9 +361,18 @@ int LibWebsocketServer::eventCallback(struct lws* wsi, enum lws_callback_reasons
         case LWS_CALLBACK_ESTABLISHED:
         {
             // Instanciate a new client
-            std::shared_ptr<IClient> client(new Client(wsi));
+            std::shared_ptr<IClient> client(new Client(wsi, server->m_max_message_size, server->m_send_queue_size));
             server->m_clients[wsi] = client;
 
+#ifdef OCPP_WITH_PERMESSAGE_DEFLATE
+            // Configure compression
+            if (server->m_credentials.permessage_deflate)
+            {
+                unsigned int level = std::min(std::max(server->m_credentials.compression_level, 1u), 9u);
+                lws_set_extension_option(wsi, "permessage-deflate", "compression_level", std::to_string(level).c_str());
+            }
+#endif // OCPP_WITH_PERMESSAGE_DEFLATE
+
             // Notify connection
             char uri[lws_hdr_total_length(wsi, WSI_TOKEN_GET_URI) + 1];
             if (lws_hdr_copy(wsi, uri, sizeof(uri), WSI_TOKEN_GET_URI) <= 0)
@@ -376,6 +406,20 @@ int LibWebsocketServer::eventCallback(struct lws* wsi, enum lws_callback_reasons
         }
         break;
 
+        case LWS_CALLBACK_EVENT_WAIT_CANCELLED:
+        {
+            // Messages, disconnections or closes may have been requested from another thread
+            for (auto& iter_client : server->m_clients)
+            {
+                Client* client = dynamic_cast<Client*>(iter_client.second.get());
+                if (!client->m_connected || !client->m_send_msgs.empty() || client->m_send_overflow)
+                {
+                    lws_callback_on_writable(client->m_wsi);
+                }
+            }
+        }
+        break;
+
         case LWS_CALLBACK_SERVER_WRITEABLE:
         {
             // Get corresponding client
@@ -383,26 +427,19 @@ int LibWebsocketServer::eventCallback(struct lws* wsi, enum lws_callback_reasons
             if (iter_client != server->m_clients.end())
             {
                 Client* client = dynamic_cast<Client*>(iter_client->second.get());
-                if (client->m_connected)
+                if (client->m_send_overflow)
+                {
+                    // High priority lane is full, the queued messages belong to this connection
+                    client->m_send_overflow = false;
+                    client->m_connected     = false;
+                    client->m_send_msgs.clear();
+                    lws_close_reason(client->m_wsi, LWS_CLOSE_STATUS_POLICY_VIOLATION, nullptr, 0);
+                    ret = -1;
+                }
+                else if (client->m_connected)
                 {
-
                     // Send data if any ready
-                    SendMsg* msg = nullptr;
-                    if (client->m_send_msgs.pop(msg, 0))
-                    {
-                        if (lws_write(client->m_wsi, msg->payload, msg->size, LWS_WRITE_TEXT) < static_cast<int>(msg->size))
-                        {
-                            // Error
-                            client->disconnect();
-                            if (client->m_listener)
-                            {
-                                client->m_listener->wsClientError();
-                            }
-                        }
-
-                        // Free message memory
-                        delete msg;
-                    }
+                    client->sendQueuedMessage();
                 }
                 else
                 {
@@ -422,10 +459,12 @@ int LibWebsocketServer::eventCallback(struct lws* wsi, enum lws_callback_reasons
             {
                 Client* client = dynamic_cast<Client*>(iter_client->second.get());
 
-                // Notify client
-                if (client->m_listener)
+                // Reassemble the message and notify client
+                if (!client->receiveFragment(in, len))
                 {
-                    client->m_listener->wsClientDataReceived(in, len);
+                    // Message too large
+                    lws_close_reason(wsi, LWS_CLOSE_STATUS_MESSAGE_TOO_LARGE, nullptr, 0);
+                    ret = -1;
                 }
             }
         }
@@ -439,7 +478,16 @@ int LibWebsocketServer::eventCallback(struct lws* wsi, enum lws_callback_reasons
 }
 
 /** @brief Constructor */
-LibWebsocketServer::Client::Client(struct lws* wsi) : m_wsi(wsi), m_connected(true), m_listener(nullptr), m_send_msgs() { }
+LibWebsocketServer::Client::Client(struct lws* wsi, size_t max_message_size, size_t send_queue_size)
+    : m_wsi(wsi),
+      m_connected(true),
+      m_listener(nullptr),
+      m_send_msgs(send_queue_size),
+      m_send_overflow(false),
+      m_max_message_size(max_message_size),
+      m_rx_buffer()
+{
+}
 /** @brief Destructor */
 LibWebsocketServer::Client::~Client()
 {
@@ -463,11 +511,7 @@ bool LibWebsocketServer::Client::disconnect()
     }
 
     // Empty message queue
-    SendMsg* msg = nullptr;
-    while (m_send_msgs.pop(msg, 0))
-    {
-        delete msg;
-    }
+    m_send_msgs.clear();
 
     return ret;
 }
@@ -478,8 +522,8 @@ bool LibWebsocketServer::Client::isConnected()
     return m_connected;
 }
 
-/** @copydoc bool IClient::send(const void*, size_t) */
-bool LibWebsocketServer::Client::send(const void* data, size_t size)
+/** @copydoc bool IClient::send(const void*, size_t, SendPriority) */
+bool LibWebsocketServer::Client::send(const void* data, size_t size, SendPriority priority)
 {
     bool ret = false;
 
@@ -488,20 +532,161 @@ bool LibWebsocketServer::Client::send(const void* data, size_t size)
     {
         // Prepare data to send
         SendMsg* msg = new SendMsg(data, size);
-        ret          = m_send_msgs.push(msg);
+        ret          = queueMessage(msg, priority);
+    }
 
-        // Schedule a send
-        lws_callback_on_writable(m_wsi);
+    return ret;
+}
+
+/** @copydoc size_t IClient::sendHeadroom() const */
+size_t LibWebsocketServer::Client::sendHeadroom() const
+{
+    return LWS_PRE;
+}
+
+/** @copydoc bool IClient::send(std::string&&, SendPriority) */
+bool LibWebsocketServer::Client::send(std::string&& buffer, SendPriority priority)
+{
+    bool ret = false;
+
+    // Check if connected
+    if (m_connected && (buffer.size() >= LWS_PRE))
+    {
+        // Prepare data to send
+        SendMsg* msg = new SendMsg(std::move(buffer));
+        ret          = queueMessage(msg, priority);
     }
 
     return ret;
 }
 
+/** @copydoc size_t IClient::sendQueueDepth() const */
+size_t LibWebsocketServer::Client::sendQueueDepth() const
+{
+    return m_send_msgs.count();
+}
+
+/** @copydoc size_t IClient::sendQueueBytes() const */
+size_t LibWebsocketServer::Client::sendQueueBytes() const
+{
+    return m_send_msgs.bytes();
+}
+
+/** @copydoc size_t IClient::sendQueueHighWaterMark(SendPriority) const */
+size_t LibWebsocketServer::Client::sendQueueHighWaterMark(SendPriority priority) const
+{
+    return m_send_msgs.highWaterMark(priority);
+}
+
 /** @copydoc bool IClient::registerListener(IListener&) */
 void LibWebsocketServer::Client::registerListener(IClient::IListener& listener)
 {
     m_listener = &listener;
 }
 
+/** @brief Queue a message to send and wake up the server thread */
+bool LibWebsocketServer::Client::queueMessage(SendMsg* msg, SendPriority priority)
+{
+    // Queue message, the queue is full when the messages are produced faster than they can be sent
+    bool ret = m_send_msgs.push(msg, priority);
+    if (!ret)
+    {
+        delete msg;
+
+        // A response cannot be dropped, the connection is closed instead
+        if (priority == SendPriority::High)
+        {
+            m_send_overflow = true;
+        }
+    }
+
+    // Wake up the server thread so that it asks for a writeable callback
+    lws_cancel_service(lws_get_context(m_wsi));
+
+    return ret;
+}
+
+/** @brief Reassemble the received fragments and notify the complete messages */
+bool LibWebsocketServer::Client::receiveFragment(const void* data, size_t size)
+{
+    bool ret = false;
+
+    bool first = (lws_is_first_fragment(m_wsi) != 0);
+    bool final = (lws_is_final_fragment(m_wsi) != 0);
+    if (first && final)
+    {
+        // Complete message, no need to copy it
+        if (size <= m_max_message_size)
+        {
+            if (m_listener)
+            {
+                m_listener->wsClientDataReceived(data, size);
+            }
+            ret = true;
+        }
+    }
+    else
+    {
+        // Start of a new message
+        if (first)
+        {
+            m_rx_buffer.clear();
+            m_rx_buffer.reserve(std::min(size + lws_remaining_packet_payload(m_wsi), m_max_message_size));
+        }
+
+        // Append fragment
+        if ((m_rx_buffer.size() + size) <= m_max_message_size)
+        {
+            m_rx_buffer.append(reinterpret_cast<const char*>(data), size);
+            if (final)
+            {
+                if (m_listener)
+                {
+                    m_listener->wsClientDataReceived(m_rx_buffer.c_str(), m_rx_buffer.size());
+                }
+                m_rx_buffer.clear();
+            }
+            ret = true;
+        }
+        else
+        {
+            m_rx_buffer.clear();
+        }
+    }
+
+    return ret;
+}
+
+/** @brief Send the next queued message, libwebsockets allows only one write per writeable callback */
+void LibWebsocketServer::Client::sendQueuedMessage()
+{
+    bool     error = false;
+    SendMsg* msg   = nullptr;
+    if (m_send_msgs.pop(msg))
+    {
+        if (lws_write(m_wsi, msg->payload, msg->size, LWS_WRITE_TEXT) < static_cast<int>(msg->size))
+        {
+            error = true;
+        }
+
+        // Free message memory
+        delete msg;
+    }
+    if (error)
+    {
+        // Error
+        disconnect();
+        if (m_listener)
+        {
+            m_listener->wsClientError();
+        }
+    }
+    else if (!m_send_msgs.empty())
+    {
+        // Send the next message on the next writeable callback
+        lws_callback_on_writable(m_wsi);
+    }
+}
+
 } // namespace websockets
 } // namespace ocpp
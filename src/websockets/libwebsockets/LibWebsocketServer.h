@@ -20,11 +20,12 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #define LIBWEBSOCKETSERVER_H
 
 #include "IWebsocketServer.h"
-#include "Queue.h"
+#include "SendQueue.h"
 #include "Url.h"
 #include "libwebsockets.h"
 
 #include <array>
+#include <atomic>
 #include <condition_variable>
 #include <map>
 #include <mutex>
@@ -39,8 +40,12 @@ namespace websockets
 class LibWebsocketServer : public IWebsocketServer
 {
   public:
-    /** @brief Constructor */
-    LibWebsocketServer();
+    /**
+     * @brief Constructor
+     * @param max_message_size Maximum size in bytes of a received message
+     * @param send_queue_size Maximum number of Normal priority messages waiting to be sent for each client
+     */
+    LibWebsocketServer(size_t max_message_size, size_t send_queue_size);
     /** @brief Destructor */
     virtual ~LibWebsocketServer();
 
@@ -61,19 +66,20 @@ class LibWebsocketServer : public IWebsocketServer
     /** @brief Message to send */
     struct SendMsg
     {
-        /** @brief Constructor */
-        SendMsg(const void* _data, size_t _size)
+        /** @brief Constructor which copies the data */
+        SendMsg(const void* _data, size_t _size) : data(LWS_PRE + _size, '\0'), payload(nullptr), size(_size)
         {
-            data    = new unsigned char[LWS_PRE + _size];
-            size    = _size;
-            payload = &data[LWS_PRE];
+            payload = reinterpret_cast<unsigned char*>(&data[LWS_PRE]);
             memcpy(payload, _data, size);
         }
-        /** @brief Destructor */
-        virtual ~SendMsg() { delete[] data; }
+        /** @brief Constructor which takes the ownership of a buffer already containing the LWS_PRE headroom */
+        SendMsg(std::string&& _data) : data(std::move(_data)), payload(nullptr), size(data.size() - LWS_PRE)
+        {
+            payload = reinterpret_cast<unsigned char*>(&data[LWS_PRE]);
+        }
 
         /** @brief Data buffer */
-        unsigned char* data;
+        std::string data;
         /** @brief Payload start */
         unsigned char* payload;
         /** @brief Size in bytes */
@@ -89,8 +95,10 @@ class LibWebsocketServer : public IWebsocketServer
         /**
          * @brief Constructor
          * @param wsi Client socket
+         * @param max_message_size Maximum size in bytes of a received message
+         * @param send_queue_size Maximum number of Normal priority messages waiting to be sent
         */
-        Client(struct lws* wsi);
+        Client(struct lws* wsi, size_t max_message_size, size_t send_queue_size);
         /** @brief Destructor */
         virtual ~Client();
 
@@ -100,8 +108,23 @@ class LibWebsocketServer : public IWebsocketServer
         /** @copydoc bool IClient::disconnect() */
         bool isConnected() override;
 
-        /** @copydoc bool IClient::send(const void*, size_t) */
-        bool send(const void* data, size_t size) override;
+        /** @copydoc bool IClient::send(const void*, size_t, SendPriority) */
+        bool send(const void* data, size_t size, SendPriority priority = SendPriority::Normal) override;
+
+        /** @copydoc size_t IClient::sendHeadroom() const */
+        size_t sendHeadroom() const override;
+
+        /** @copydoc bool IClient::send(std::string&&, SendPriority) */
+        bool send(std::string&& buffer, SendPriority priority = SendPriority::Normal) override;
+
+        /** @copydoc size_t IClient::sendQueueDepth() const */
+        size_t sendQueueDepth() const override;
+
+        /** @copydoc size_t IClient::sendQueueBytes() const */
+        size_t sendQueueBytes() const override;
+
+        /** @copydoc size_t IClient::sendQueueHighWaterMark(SendPriority) const */
+        size_t sendQueueHighWaterMark(SendPriority priority) const override;
 
         /** @copydoc bool IClient::registerListener(IListener&) */
         void registerListener(IClient::IListener& listener) override;
@@ -114,7 +137,20 @@ class LibWebsocketServer : public IWebsocketServer
         /** @brief Listener */
         IClient::IListener* m_listener;
         /** @brief Queue of messages to send */
-        ocpp::helpers::Queue<SendMsg*> m_send_msgs;
+        SendQueue<SendMsg> m_send_msgs;
+        /** @brief Indicate that the connection must be closed because the High priority lane is full */
+        std::atomic<bool> m_send_overflow;
+        /** @brief Maximum size in bytes of a received message */
+        size_t m_max_message_size;
+        /** @brief Reception buffer used to reassemble fragmented messages */
+        std::string m_rx_buffer;
+
+        /** @brief Queue a message to send and wake up the server thread */
+        bool queueMessage(SendMsg* msg, SendPriority priority);
+        /** @brief Send the next queued message, libwebsockets allows only one write per writeable callback */
+        void sendQueuedMessage();
+        /** @brief Reassemble the received fragments and notify the complete messages */
+        bool receiveFragment(const void* data, size_t size);
     };
 
     /** @brief Listener */
@@ -138,6 +174,12 @@ class LibWebsocketServer : public IWebsocketServer
     lws_retry_bo_t m_retry_policy;
     /** @brief Protocols */
     std::array<struct lws_protocols, 2u> m_protocols;
+    /** @brief Extensions */
+    std::array<struct lws_extension, 2u> m_extensions;
+    /** @brief Maximum size in bytes of a received message */
+    size_t m_max_message_size;
+    /** @brief Maximum number of Normal priority messages waiting to be sent for each client */
+    size_t m_send_queue_size;
 
     /** @brief Connected clients */
     std::map<struct lws*, std::shared_ptr<IClient>> m_clients;
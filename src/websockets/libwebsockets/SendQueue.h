@@ -0,0 +1,198 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SENDQUEUE_H
+#define SENDQUEUE_H
+
+#include "SendPriority.h"
+
+#include <array>
+#include <deque>
+#include <mutex>
+
+namespace ocpp
+{
+namespace websockets
+{
+
+/** @brief Queue of messages to send with one lane per priority
+ *
+ *  The Normal lane is bounded to apply back-pressure on the requests. The High lane carries the responses
+ *  the peer is waiting for and has its own bound : a response cannot be dropped without leaving the peer
+ *  waiting until its timeout, so the connection has to be closed when the High lane is full.
+ */
+template <typename MsgType>
+class SendQueue
+{
+  public:
+    /** @brief Default maximum number of messages in the High lane */
+    static constexpr size_t DEFAULT_HIGH_LANE_SIZE = 128u;
+
+    /**
+     * @brief Constructor
+     * @param lane_size Maximum number of messages in the Normal lane
+     * @param high_lane_size Maximum number of messages in the High lane
+     */
+    SendQueue(size_t lane_size, size_t high_lane_size = DEFAULT_HIGH_LANE_SIZE)
+        : m_mutex(), m_lane_sizes{high_lane_size, lane_size}, m_lanes(), m_bytes(0), m_high_water_marks()
+    {
+    }
+    /** @brief Destructor */
+    virtual ~SendQueue() { clear(); }
+
+    /**
+     * @brief Add a message to the lane of its priority
+     * @param msg Message to add, its ownership is transfered to the queue only on success
+     * @param priority Priority of the message
+     * @return true if the message has been added, false if the lane is full
+     */
+    bool push(MsgType* msg, SendPriority priority)
+    {
+        bool ret = false;
+
+        // Lock queue
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Check lane capacity
+        size_t                index = static_cast<size_t>(priority);
+        std::deque<MsgType*>& lane  = m_lanes[index];
+        if (lane.size() < m_lane_sizes[index])
+        {
+            // Add message
+            lane.push_back(msg);
+            m_bytes += msg->size;
+            if (lane.size() > m_high_water_marks[index])
+            {
+                m_high_water_marks[index] = lane.size();
+            }
+            ret = true;
+        }
+
+        return ret;
+    }
+
+    /**
+     * @brief Get the next message to send, highest priority first
+     * @param msg Next message, its ownership is transfered to the caller
+     * @return true if a message has been retrieved, false if the queue is empty
+     */
+    bool pop(MsgType*& msg)
+    {
+        bool ret = false;
+
+        // Lock queue
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Look for the first non empty lane
+        for (std::deque<MsgType*>& lane : m_lanes)
+        {
+            if (!lane.empty())
+            {
+                msg = lane.front();
+                lane.pop_front();
+                m_bytes -= msg->size;
+                ret = true;
+                break;
+            }
+        }
+
+        return ret;
+    }
+
+    /** @brief Remove and free all the queued messages */
+    void clear()
+    {
+        // Lock queue
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Free messages
+        for (std::deque<MsgType*>& lane : m_lanes)
+        {
+            for (MsgType* msg : lane)
+            {
+                delete msg;
+            }
+            lane.clear();
+        }
+        m_bytes = 0;
+    }
+
+    /**
+     * @brief Indicate if the queue is empty
+     * @return true if the queue is empty, false otherwise
+     */
+    bool empty() const { return (count() == 0); }
+
+    /**
+     * @brief Get the number of queued messages
+     * @return Number of messages in all the lanes
+     */
+    size_t count() const
+    {
+        // Lock queue
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Sum the lanes
+        size_t ret = 0;
+        for (const std::deque<MsgType*>& lane : m_lanes)
+        {
+            ret += lane.size();
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Get the number of queued payload bytes
+     * @return Number of payload bytes in all the lanes
+     */
+    size_t bytes() const
+    {
+        // Lock queue
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_bytes;
+    }
+
+    /**
+     * @brief Get the highest number of messages which have been queued at the same time in a lane
+     * @param priority Priority of the lane
+     * @return High-water mark of the lane
+     */
+    size_t highWaterMark(SendPriority priority) const
+    {
+        // Lock queue
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_high_water_marks[static_cast<size_t>(priority)];
+    }
+
+  private:
+    /** @brief Mutex to protect the lanes */
+    mutable std::mutex m_mutex;
+    /** @brief Maximum number of messages in the lanes */
+    const std::array<size_t, SEND_PRIORITY_COUNT> m_lane_sizes;
+    /** @brief Lanes, ordered by priority */
+    std::array<std::deque<MsgType*>, SEND_PRIORITY_COUNT> m_lanes;
+    /** @brief Number of queued payload bytes */
+    size_t m_bytes;
+    /** @brief High-water marks of the lanes */
+    std::array<size_t, SEND_PRIORITY_COUNT> m_high_water_marks;
+};
+
+} // namespace websockets
+} // namespace ocpp
+
+#endif // SENDQUEUE_H
@@ -39,6 +39,7 @@ WebsocketClientStub::WebsocketClientStub()
       m_send_called(false),
       m_sent_data(nullptr),
       m_sent_size(0),
+      m_sent_priority(SendPriority::Normal),
       m_listener(nullptr),
       m_next_call_will_fail(false)
 {
@@ -86,8 +87,8 @@ bool WebsocketClientStub::isConnected()
     return m_is_connected;
 }
 
-/** @copydoc bool IWebsocketClient::send(const void*, size_t) */
-bool WebsocketClientStub::send(const void* data, size_t size)
+/** @copydoc bool IWebsocketClient::send(const void*, size_t, SendPriority) */
+bool WebsocketClientStub::send(const void* data, size_t size, SendPriority priority)
 {
     m_send_called = true;
     if (m_sent_data)
@@ -101,11 +102,27 @@ bool WebsocketClientStub::send(const void* data, size_t size)
         memcpy(m_sent_data, data, size);
         m_sent_data[size] = 0;
     }
-    m_sent_size = size;
+    m_sent_size     = size;
+    m_sent_priority = priority;
 
     return returnValue();
 }
 
+/** @copydoc bool IWebsocketClient::send(std::string&&, SendPriority) */
+bool WebsocketClientStub::send(std::string&& buffer, SendPriority priority)
+{
+    bool ret = false;
+    if (buffer.size() >= SEND_HEADROOM)
+    {
+        ret = send(&buffer[SEND_HEADROOM], buffer.size() - SEND_HEADROOM, priority);
+    }
+    else
+    {
+        m_send_called = true;
+    }
+    return ret;
+}
+
 /** @copydoc void IWebsocketClient::registerListener(IListener&) */
 void WebsocketClientStub::registerListener(IListener& listener)
 {
@@ -129,6 +146,7 @@ void WebsocketClientStub::reset()
         m_sent_data = nullptr;
     }
     m_sent_size           = 0;
+    m_sent_priority       = SendPriority::Normal;
     m_listener            = nullptr;
     m_next_call_will_fail = false;
 }
@@ -55,14 +55,36 @@ class WebsocketClientStub : public IWebsocketClient
     /** @copydoc bool IWebsocketClient::isConnected() */
     bool isConnected() override;
 
-    /** @copydoc bool IWebsocketClient::send(const void*, size_t) */
-    bool send(const void* data, size_t size) override;
+    /** @copydoc bool IWebsocketClient::send(const void*, size_t, SendPriority) */
+    bool send(const void* data, size_t size, SendPriority priority = SendPriority::Normal) override;
+
+    /** @copydoc size_t IWebsocketClient::sendHeadroom() const */
+    size_t sendHeadroom() const override { return SEND_HEADROOM; }
+
+    /** @copydoc bool IWebsocketClient::send(std::string&&, SendPriority) */
+    bool send(std::string&& buffer, SendPriority priority = SendPriority::Normal) override;
+
+    /** @copydoc size_t IWebsocketClient::sendQueueDepth() const */
+    size_t sendQueueDepth() const override { return 0; }
+
+    /** @copydoc size_t IWebsocketClient::sendQueueBytes() const */
+    size_t sendQueueBytes() const override { return 0; }
+
+    /** @copydoc size_t IWebsocketClient::sendQueueHighWaterMark(SendPriority) const */
+    size_t sendQueueHighWaterMark(SendPriority priority) const override
+    {
+        (void)priority;
+        return 0;
+    }
 
     /** @copydoc void IWebsocketClient::registerListener(IListener&) */
     void registerListener(IListener& listener) override;
 
     /// Stub interface
 
+    /** @brief Headroom reserved in the buffers given to send(std::string&&, SendPriority) */
+    static constexpr size_t SEND_HEADROOM = 16u;
+
     /** @brief Reset stub's data */
     void reset();
 
@@ -100,6 +122,7 @@ class WebsocketClientStub : public IWebsocketClient
     bool               sendCalled() const { return m_send_called; }
     const uint8_t*     sentData() const { return m_sent_data; }
     size_t             sentSize() const { return m_sent_size; }
+    SendPriority       sentPriority() const { return m_sent_priority; }
 
   private:
     /** @brief Indicate if the connect() function has been called */
@@ -126,6 +149,8 @@ class WebsocketClientStub : public IWebsocketClient
     uint8_t* m_sent_data;
     /** @brief Sent data size */
     size_t m_sent_size;
+    /** @brief Sent data priority */
+    SendPriority m_sent_priority;
     /** @brief Listener */
     IListener* m_listener;
     /** @brief Indicate that the next call will fail */
@@ -0,0 +1,230 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "FastValidators.h"
+#include "JsonValidator.h"
+#include "MessagesValidator.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+using namespace ocpp::json;
+using namespace ocpp::messages;
+
+/** @brief Parse a JSON document */
+static rapidjson::Document parse(const char* json)
+{
+    rapidjson::Document document;
+    document.Parse(json);
+    return document;
+}
+
+/** @brief Check that the fast validator of a schema gives the same results as the generic validator */
+static void checkSameResults(const std::string& schema_name, const std::vector<std::pair<const char*, bool>>& payloads)
+{
+    FastValidator fast = getFastValidator(schema_name);
+    REQUIRE_NE(fast, nullptr);
+
+    std::filesystem::path path(SCHEMAS_PATH);
+    path.append(schema_name + ".json");
+    JsonValidator generic;
+    REQUIRE(generic.init(path));
+
+    for (const auto& payload : payloads)
+    {
+        INFO(schema_name << " : " << payload.first);
+        rapidjson::Document document = parse(payload.first);
+        REQUIRE_FALSE(document.HasParseError());
+
+        const char* keyword = "";
+        CHECK_EQ(fast(document, keyword), payload.second);
+        CHECK_EQ(generic.isValid(document), payload.second);
+    }
+}
+
+TEST_SUITE("Fast validators test suite")
+{
+    TEST_CASE("Availability")
+    {
+        CHECK_NE(getFastValidator("Heartbeat"), nullptr);
+        CHECK_NE(getFastValidator("MeterValuesResponse"), nullptr);
+        CHECK_EQ(getFastValidator("BootNotification"), nullptr);
+    }
+
+    TEST_CASE("Heartbeat")
+    {
+        checkSameResults("Heartbeat", {{"{}", true}, {"{\"a\": 1}", false}, {"[]", false}});
+        checkSameResults("HeartbeatResponse",
+                         {{"{\"currentTime\": \"2026-01-01T00:00:00Z\"}", true},
+                          {"{}", false},
+                          {"{\"currentTime\": 12}", false},
+                          {"{\"currentTime\": \"2026-01-01T00:00:00Z\", \"a\": 1}", false}});
+    }
+
+    TEST_CASE("Authorize")
+    {
+        checkSameResults("Authorize",
+                         {{"{\"idTag\": \"AABBCCDD\"}", true},
+                          {"{\"idTag\": \"01234567890123456789\"}", true},
+                          {"{\"idTag\": \"012345678901234567890\"}", false},
+                          {"{\"idTag\": \"\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\xc3\xa9\"}", true},
+                          {"{\"idTag\": 1}", false},
+                          {"{}", false}});
+        checkSameResults("AuthorizeResponse",
+                         {{"{\"idTagInfo\": {\"status\": \"Accepted\"}}", true},
+                          {"{\"idTagInfo\": {\"status\": \"Blocked\", \"expiryDate\": \"2026-01-01T00:00:00Z\", \"parentIdTag\": \"P\"}}",
+                           true},
+                          {"{\"idTagInfo\": {\"status\": \"Unknown\"}}", false},
+                          {"{\"idTagInfo\": {\"status\": \"Accepted\", \"a\": 1}}", false},
+                          {"{\"idTagInfo\": {\"parentIdTag\": \"P\"}}", false},
+                          {"{\"idTagInfo\": \"Accepted\"}", false},
+                          {"{}", false}});
+    }
+
+    TEST_CASE("StatusNotification")
+    {
+        checkSameResults("StatusNotification",
+                         {{"{\"connectorId\": 1, \"errorCode\": \"NoError\", \"status\": \"Available\"}", true},
+                          {"{\"connectorId\": 0, \"errorCode\": \"WeakSignal\", \"status\": \"Faulted\", \"info\": \"i\", "
+                           "\"timestamp\": \"2026-01-01T00:00:00Z\", \"vendorId\": \"v\", \"vendorErrorCode\": \"e\"}",
+                           true},
+                          {"{\"connectorId\": 1.5, \"errorCode\": \"NoError\", \"status\": \"Available\"}", false},
+                          {"{\"connectorId\": 1, \"errorCode\": \"Error\", \"status\": \"Available\"}", false},
+                          {"{\"connectorId\": 1, \"errorCode\": \"NoError\", \"status\": \"available\"}", false},
+                          {"{\"connectorId\": 1, \"errorCode\": \"NoError\"}", false},
+                          {"{\"connectorId\": 1, \"errorCode\": \"NoError\", \"status\": \"Available\", \"info\": "
+                           "\"012345678901234567890123456789012345678901234567890\"}",
+                           false}});
+        checkSameResults("StatusNotificationResponse", {{"{}", true}, {"{\"status\": \"Accepted\"}", false}});
+    }
+
+    TEST_CASE("MeterValues")
+    {
+        checkSameResults(
+            "MeterValues",
+            {{"{\"connectorId\": 1, \"meterValue\": []}", true},
+             {"{\"connectorId\": 1, \"transactionId\": 12, \"meterValue\": [{\"timestamp\": \"2026-01-01T00:00:00Z\", \"sampledValue\": "
+              "[{\"value\": \"12.5\", \"context\": \"Sample.Periodic\", \"format\": \"Raw\", \"measurand\": \"Voltage\", \"phase\": "
+              "\"L1-N\", \"location\": \"Outlet\", \"unit\": \"V\"}, {\"value\": \"1000\"}]}]}",
+              true},
+             {"{\"connectorId\": 1, \"meterValue\": [{\"timestamp\": \"2026-01-01T00:00:00Z\", \"sampledValue\": [{\"value\": 12}]}]}",
+              false},
+             {"{\"connectorId\": 1, \"meterValue\": [{\"timestamp\": \"2026-01-01T00:00:00Z\", \"sampledValue\": [{\"value\": \"1\", "
+              "\"unit\": \"mA\"}]}]}",
+              false},
+             {"{\"connectorId\": 1, \"meterValue\": [{\"sampledValue\": []}]}", false},
+             {"{\"connectorId\": 1, \"meterValue\": {}}", false},
+             {"{\"meterValue\": []}", false}});
+        checkSameResults("MeterValuesResponse", {{"{}", true}, {"[]", false}});
+    }
+}
+
+TEST_SUITE("MessagesValidator class test suite")
+{
+    TEST_CASE("Policies")
+    {
+        MessagesValidator validator(SCHEMAS_PATH);
+        CHECK_EQ(validator.getPolicy("Authorize"), ValidationPolicy::Off);
+
+        CHECK(validator.configure("sampled, Authorize=full,MeterValues = off"));
+        CHECK_EQ(validator.getPolicy("Authorize"), ValidationPolicy::Full);
+        CHECK_EQ(validator.getPolicy("MeterValues"), ValidationPolicy::Off);
+        CHECK_EQ(validator.getPolicy("Heartbeat"), ValidationPolicy::Sampled);
+
+        CHECK_FALSE(validator.configure("always"));
+        CHECK_FALSE(validator.configure("off,=full"));
+    }
+
+    TEST_CASE("Validation")
+    {
+        MessagesValidator validator(SCHEMAS_PATH, 4u);
+        CHECK(validator.configure("off,Authorize=full,BootNotification=full,Heartbeat=sampled"));
+
+        std::string         error;
+        rapidjson::Document invalid = parse("{\"unknown\": 1}");
+
+        // Off
+        CHECK(validator.isValidRequest("StatusNotification", invalid, error));
+
+        // Full with fast validator
+        CHECK_FALSE(validator.isValidRequest("Authorize", invalid, error));
+        CHECK_FALSE(error.empty());
+        CHECK(validator.isValidResponse("Authorize", parse("{\"idTagInfo\": {\"status\": \"Accepted\"}}"), error));
+
+        // Full with generic validator
+        error.clear();
+        CHECK_FALSE(validator.isValidResponse("BootNotification", invalid, error));
+        CHECK_FALSE(error.empty());
+
+        // Sampled : 1 message out of 4 is checked
+        unsigned int failures = 0;
+        for (unsigned int i = 0; i < 8u; i++)
+        {
+            if (!validator.isValidResponse("Heartbeat", invalid, error))
+            {
+                failures++;
+            }
+        }
+        CHECK_EQ(failures, 2u);
+    }
+}
+
+TEST_SUITE("Validators benchmarks")
+{
+    TEST_CASE("MeterValues")
+    {
+        static constexpr unsigned int ITERATIONS = 20000u;
+
+        rapidjson::Document payload = parse(
+            "{\"connectorId\": 1, \"transactionId\": 12, \"meterValue\": [{\"timestamp\": \"2026-01-01T00:00:00Z\", \"sampledValue\": "
+            "[{\"value\": \"12.5\", \"context\": \"Sample.Periodic\", \"measurand\": \"Voltage\", \"phase\": \"L1-N\", "
+            "\"unit\": \"V\"}, {\"value\": \"32.0\", \"context\": \"Sample.Periodic\", \"measurand\": \"Current.Import\", "
+            "\"phase\": \"L1\", \"unit\": \"A\"}, {\"value\": \"1000\", \"context\": \"Sample.Periodic\", \"measurand\": "
+            "\"Energy.Active.Import.Register\", \"unit\": \"Wh\"}]}]}");
+
+        std::filesystem::path path(SCHEMAS_PATH);
+        path.append("MeterValues.json");
+        JsonValidator generic;
+        REQUIRE(generic.init(path));
+        FastValidator fast = getFastValidator("MeterValues");
+        REQUIRE_NE(fast, nullptr);
+
+        bool valid = true;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < ITERATIONS; i++)
+        {
+            valid = generic.isValid(payload) && valid;
+        }
+        auto generic_duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const char* keyword = "";
+        start               = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < ITERATIONS; i++)
+        {
+            valid = fast(payload, keyword) && valid;
+        }
+        auto fast_duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        CHECK(valid);
+        MESSAGE("Generic validator : " << static_cast<unsigned int>(ITERATIONS / generic_duration) << " payloads/s");
+        MESSAGE("Fast validator : " << static_cast<unsigned int>(ITERATIONS / fast_duration) << " payloads/s");
+    }
+}
@@ -0,0 +1,226 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "IRpc.h"
+#include "JsonValidator.h"
+#include "SendLocalListStreamDecoder.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace ocpp::json;
+using namespace ocpp::messages;
+using namespace ocpp::rpc;
+using namespace ocpp::types;
+
+/** @brief Build a SendLocalList RPC frame */
+static std::string buildFrame(const std::string& payload)
+{
+    return "[2,\"1234\",\"SendLocalList\"," + payload + "]";
+}
+
+/** @brief Build a SendLocalList payload with a given number of entries */
+static std::string buildPayload(size_t entries_count)
+{
+    std::string payload = "{\"listVersion\":3,\"updateType\":\"Full\",\"localAuthorizationList\":[";
+    for (size_t i = 0; i < entries_count; i++)
+    {
+        if (i != 0)
+        {
+            payload += ",";
+        }
+        payload += "{\"idTag\":\"TAG" + std::to_string(i) + "\",\"idTagInfo\":{\"status\":\"Accepted\"}}";
+    }
+    payload += "]}";
+    return payload;
+}
+
+/** @brief Get the compiled schema of the SendLocalList requests */
+static const rapidjson::SchemaDocument& schema()
+{
+    static JsonValidator validator;
+    if (!validator.schema())
+    {
+        std::filesystem::path path(SCHEMAS_PATH);
+        path.append("SendLocalList.json");
+        REQUIRE(validator.init(path));
+    }
+    return *validator.schema();
+}
+
+/** @brief Decode a payload header */
+static bool decodeHeader(const std::string& payload, SendLocalListReq& request, size_t& entries_count, const char*& error_code)
+{
+    std::string                frame = buildFrame(payload);
+    SendLocalListStreamDecoder decoder(schema(), frame.c_str(), frame.size());
+    std::string                error_message;
+    error_code = nullptr;
+    return decoder.decodeHeader(request, entries_count, error_code, error_message);
+}
+
+TEST_SUITE("SendLocalList stream decoder test suite")
+{
+    TEST_CASE("Header")
+    {
+        SendLocalListReq request;
+        size_t           entries_count = 0;
+        const char*      error_code    = nullptr;
+
+        CHECK(decodeHeader(buildPayload(5u), request, entries_count, error_code));
+        CHECK_EQ(request.listVersion, 3);
+        CHECK_EQ(request.updateType, UpdateType::Full);
+        CHECK(request.localAuthorizationList.empty());
+        CHECK_EQ(entries_count, 5u);
+
+        CHECK(decodeHeader("{\"updateType\":\"Differential\",\"listVersion\":-12}", request, entries_count, error_code));
+        CHECK_EQ(request.listVersion, -12);
+        CHECK_EQ(request.updateType, UpdateType::Differential);
+        CHECK_EQ(entries_count, 0u);
+    }
+
+    TEST_CASE("Entries")
+    {
+        std::string payload = "{\"listVersion\":1,\"localAuthorizationList\":["
+                              "{\"idTagInfo\":{\"status\":\"Blocked\",\"parentIdTag\":\"PARENT\","
+                              "\"expiryDate\":\"2023-10-14T12:15:00.000Z\"},\"idTag\":\"TAG1\"},"
+                              "{\"idTag\":\"TAG2\"}],\"updateType\":\"Differential\"}";
+        std::string frame   = buildFrame(payload);
+
+        SendLocalListStreamDecoder decoder(schema(), frame.c_str(), frame.size());
+        SendLocalListReq           request;
+        size_t                     entries_count = 0;
+        const char*                error_code    = nullptr;
+        std::string                error_message;
+        REQUIRE(decoder.decodeHeader(request, entries_count, error_code, error_message));
+        CHECK_EQ(entries_count, 2u);
+
+        std::vector<AuthorizationData> entries;
+        CHECK(decoder.decodeEntries(10u,
+                                    [&entries](const std::vector<AuthorizationData>& chunk)
+                                    {
+                                        entries.insert(entries.end(), chunk.begin(), chunk.end());
+                                        return true;
+                                    }));
+        REQUIRE_EQ(entries.size(), 2u);
+        CHECK_EQ(entries[0].idTag.str(), "TAG1");
+        REQUIRE(entries[0].idTagInfo.isSet());
+        CHECK_EQ(entries[0].idTagInfo.value().status, AuthorizationStatus::Blocked);
+        CHECK_EQ(entries[0].idTagInfo.value().parentIdTag.value().str(), "PARENT");
+        CHECK(entries[0].idTagInfo.value().expiryDate.isSet());
+        CHECK_EQ(entries[1].idTag.str(), "TAG2");
+        CHECK_FALSE(entries[1].idTagInfo.isSet());
+    }
+
+    TEST_CASE("Chunks")
+    {
+        std::string                frame = buildFrame(buildPayload(10u));
+        SendLocalListStreamDecoder decoder(schema(), frame.c_str(), frame.size());
+
+        std::vector<size_t> chunks;
+        std::string         last_tag;
+        CHECK(decoder.decodeEntries(4u,
+                                    [&chunks, &last_tag](const std::vector<AuthorizationData>& chunk)
+                                    {
+                                        chunks.push_back(chunk.size());
+                                        last_tag = chunk.back().idTag.str();
+                                        return true;
+                                    }));
+        CHECK_EQ(chunks, std::vector<size_t>({4u, 4u, 2u}));
+        CHECK_EQ(last_tag, "TAG9");
+
+        // Stop the decoding
+        chunks.clear();
+        CHECK_FALSE(decoder.decodeEntries(4u,
+                                          [&chunks](const std::vector<AuthorizationData>& chunk)
+                                          {
+                                              chunks.push_back(chunk.size());
+                                              return false;
+                                          }));
+        CHECK_EQ(chunks.size(), 1u);
+    }
+
+    TEST_CASE("Invalid payloads")
+    {
+        // Same results as the schema validator
+        std::filesystem::path path(SCHEMAS_PATH);
+        path.append("SendLocalList.json");
+        JsonValidator validator;
+        REQUIRE(validator.init(path));
+
+        std::vector<std::pair<const char*, const char*>> payloads = {
+            {"{\"listVersion\":1}", IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1,\"updateType\":\"Partial\"}", IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":\"1\",\"updateType\":\"Full\"}", IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1.5,\"updateType\":\"Full\"}", IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1,\"updateType\":\"Full\",\"unknown\":0}", IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1,\"updateType\":\"Full\",\"localAuthorizationList\":[{}]}", IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1,\"updateType\":\"Full\",\"localAuthorizationList\":[{\"idTag\":\"012345678901234567890\"}]}",
+             IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1,\"updateType\":\"Full\",\"localAuthorizationList\":[{\"idTag\":\"TAG\",\"idTagInfo\":{}}]}",
+             IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1,\"updateType\":\"Full\","
+             "\"localAuthorizationList\":[{\"idTag\":\"TAG\",\"idTagInfo\":{\"status\":\"Ok\"}}]}",
+             IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION},
+            {"{\"listVersion\":1,\"updateType\":\"Full\",\"localAuthorizationList\":{}}", IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION}};
+        for (const auto& payload : payloads)
+        {
+            INFO(payload.first);
+            rapidjson::Document document;
+            document.Parse(payload.first);
+            REQUIRE_FALSE(document.HasParseError());
+            CHECK_FALSE(validator.isValid(document));
+
+            SendLocalListReq request;
+            size_t           entries_count = 0;
+            const char*      error_code    = nullptr;
+            CHECK_FALSE(decodeHeader(payload.first, request, entries_count, error_code));
+            CHECK_EQ(std::strcmp(error_code, payload.second), 0);
+        }
+
+        // Valid for the schema but cannot be decoded
+        SendLocalListReq request;
+        size_t           entries_count = 0;
+        const char*      error_code    = nullptr;
+        CHECK_FALSE(decodeHeader("{\"listVersion\":1,\"updateType\":\"Full\","
+                                 "\"localAuthorizationList\":[{\"idTag\":\"TAG\",\"idTagInfo\":{\"status\":\"Accepted\","
+                                 "\"expiryDate\":\"not a date\"}}]}",
+                                 request,
+                                 entries_count,
+                                 error_code));
+        CHECK_EQ(std::strcmp(error_code, IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION), 0);
+        CHECK_FALSE(decodeHeader("{\"listVersion\":4294967296,\"updateType\":\"Full\"}", request, entries_count, error_code));
+        CHECK_EQ(std::strcmp(error_code, IRpc::RPC_ERROR_TYPE_CONSTRAINT_VIOLATION), 0);
+
+        // Malformed JSON
+        CHECK_FALSE(decodeHeader("{\"listVersion\":1,\"updateType\":\"Full\"", request, entries_count, error_code));
+        CHECK_EQ(std::strcmp(error_code, IRpc::RPC_ERROR_FORMATION_VIOLATION), 0);
+
+        // Trailing garbage after the frame
+        std::string                frame = buildFrame(buildPayload(2u)) + " garbage";
+        SendLocalListStreamDecoder decoder(schema(), frame.c_str(), frame.size());
+        std::string                error_message;
+        error_code = nullptr;
+        CHECK_FALSE(decoder.decodeHeader(request, entries_count, error_code, error_message));
+        CHECK_EQ(std::strcmp(error_code, IRpc::RPC_ERROR_FORMATION_VIOLATION), 0);
+        CHECK_FALSE(decoder.decodeEntries(4u, [](const std::vector<AuthorizationData>&) { return true; }));
+    }
+}
@@ -17,12 +17,16 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "RpcClient.h"
+#include "RpcServer.h"
 #include "WebsocketClientStub.h"
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <atomic>
 #include <cstring>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 using namespace ocpp::websockets;
 using namespace ocpp::rpc;
@@ -96,6 +100,38 @@ class RpcClientListener : public IRpc::IListener, public RpcClient::IListener
     bool        received_error;
 };
 
+class RpcStreamHandler : public IRpc::IStreamHandler
+{
+  public:
+    RpcStreamHandler() : action(), frame(), response(nullptr) { }
+    virtual ~RpcStreamHandler() { }
+
+    /** @copydoc bool IRpc::IStreamHandler::rpcStreamedCallReceived(const std::string&,
+                                                                    const char*,
+                                                                    size_t,
+                                                                    rapidjson::Document&,
+                                                                    const char*&,
+                                                                    std::string&) */
+    bool rpcStreamedCallReceived(const std::string&   action,
+                                 const char*          frame,
+                                 size_t               size,
+                                 rapidjson::Document& response,
+                                 const char*&         error_code,
+                                 std::string&         error_message) override
+    {
+        (void)error_code;
+        (void)error_message;
+        this->action = action;
+        this->frame.assign(frame, size);
+        response.Parse(this->response);
+        return true;
+    }
+
+    std::string action;
+    std::string frame;
+    const char* response;
+};
+
 static constexpr const char* WS_PROTOCOL = "ocpp1.6";
 static constexpr const char* WS_URL      = "ws://localhost:8080/ocpp/";
 
@@ -157,16 +193,19 @@ TEST_SUITE("Initialization, connection/disconnection")
     }
 }
 
-static constexpr const char* ACTION                        = "Heartbeat";
-static constexpr const char* CALL_PAYLOAD                  = "{\"id\":4}";
-static constexpr const char* CALLRESULT_PAYLOAD            = "{\"name\":\"bob\"}";
-static constexpr const char* CALLERROR_PAYLOAD             = "This is an error!";
-static constexpr const char* EXPECTED_CALL_MESSAGE_0       = "[2, \"0\", \"Heartbeat\", {\"id\":4}]";
-static constexpr const char* EXPECTED_CALL_MESSAGE_1       = "[2, \"1\", \"Heartbeat\", {\"id\":4}]";
-static constexpr const char* EXPECTED_CALL_MESSAGE_2       = "[2, \"2\", \"Heartbeat\", {\"id\":4}]";
-static constexpr const char* EXPECTED_CALLRESULT_MESSAGE_1 = "[3, \"1\", {\"name\":\"bob\"}]";
-static constexpr const char* EXPECTED_CALLRESULT_MESSAGE_2 = "[3, \"2\", {\"name\":\"bob\"}]";
-static constexpr const char* EXPECTED_CALLERROR_MESSAGE_1  = "[4, \"1\", \"NotImplemented\", \"This is an error!\", {}]";
+static constexpr const char* ACTION                               = "Heartbeat";
+static constexpr const char* CALL_PAYLOAD                         = "{\"id\":4}";
+static constexpr const char* CALLRESULT_PAYLOAD                   = "{\"name\":\"bob\"}";
+static constexpr const char* CALLERROR_PAYLOAD                    = "This is an error!";
+static constexpr const char* ESCAPED_CALLERROR_PAYLOAD            = "This is an \"error\"!\n";
+static constexpr const char* EXPECTED_CALL_MESSAGE_0              = "[2,\"0\",\"Heartbeat\",{\"id\":4}]";
+static constexpr const char* EXPECTED_CALL_MESSAGE_1              = "[2,\"1\",\"Heartbeat\",{\"id\":4}]";
+static constexpr const char* EXPECTED_CALL_MESSAGE_2              = "[2,\"2\",\"Heartbeat\",{\"id\":4}]";
+static constexpr const char* EXPECTED_CALLRESULT_MESSAGE_0        = "[3,\"0\",{\"name\":\"bob\"}]";
+static constexpr const char* EXPECTED_CALLRESULT_MESSAGE_1        = "[3,\"1\",{\"name\":\"bob\"}]";
+static constexpr const char* EXPECTED_CALLRESULT_MESSAGE_2        = "[3,\"2\",{\"name\":\"bob\"}]";
+static constexpr const char* EXPECTED_CALLERROR_MESSAGE_1         = "[4,\"1\",\"NotImplemented\",\"This is an error!\",{}]";
+static constexpr const char* EXPECTED_ESCAPED_CALLERROR_MESSAGE_1 = "[4,\"1\",\"NotImplemented\",\"This is an \\\"error\\\"!\\n\",{}]";
 
 TEST_SUITE("CALL messages")
 {
@@ -189,6 +228,7 @@ TEST_SUITE("CALL messages")
         CHECK_FALSE(client.call(ACTION, payload, response, std::chrono::milliseconds(0)));
         CHECK(websocket.sendCalled());
         CHECK_EQ(strcmp(reinterpret_cast<const char*>(websocket.sentData()), EXPECTED_CALL_MESSAGE_0), 0);
+        CHECK_EQ(websocket.sentPriority(), SendPriority::Normal);
 
         CHECK_FALSE(client.call(ACTION, payload, response, std::chrono::milliseconds(0)));
         CHECK_EQ(strcmp(reinterpret_cast<const char*>(websocket.sentData()), EXPECTED_CALL_MESSAGE_1), 0);
@@ -242,6 +282,106 @@ TEST_SUITE("CALL messages")
         response_thread.join();
     }
 
+    TEST_CASE("Pipelined calls")
+    {
+        RpcClientListener   listener;
+        WebsocketClientStub websocket;
+        RpcClient           client(websocket, WS_PROTOCOL);
+        client.registerListener(listener);
+        client.registerClientListener(listener);
+        client.setMaxPendingCalls(2u);
+        websocket.setConnected();
+
+        rapidjson::Document payload;
+        payload.Parse(CALL_PAYLOAD);
+
+        bool result1 = false;
+        bool result2 = false;
+        auto call    = [&client, &payload](bool& result)
+        {
+            rapidjson::Document response;
+            result = client.call(ACTION, payload, response, std::chrono::milliseconds(500));
+        };
+        std::thread call_thread1(call, std::ref(result1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(25u));
+        std::thread call_thread2(call, std::ref(result2));
+        std::this_thread::sleep_for(std::chrono::milliseconds(25u));
+
+        // Window is full
+        rapidjson::Document response;
+        auto                start = std::chrono::steady_clock::now();
+        CHECK_FALSE(client.call(ACTION, payload, response, std::chrono::milliseconds(50)));
+        auto                          end  = std::chrono::steady_clock::now();
+        std::chrono::duration<double> diff = end - start;
+        CHECK_GT(diff, std::chrono::milliseconds(49u));
+
+        // Responses in a different order than the requests
+        websocket.notifyDataReceived(EXPECTED_CALLRESULT_MESSAGE_1, strlen(EXPECTED_CALLRESULT_MESSAGE_1));
+        websocket.notifyDataReceived(EXPECTED_CALLRESULT_MESSAGE_0, strlen(EXPECTED_CALLRESULT_MESSAGE_0));
+        call_thread1.join();
+        call_thread2.join();
+        CHECK(result1);
+        CHECK(result2);
+    }
+
+    TEST_CASE("Asynchronous calls")
+    {
+        RpcClientListener             listener;
+        WebsocketClientStub           websocket;
+        IWebsocketClient::Credentials credentials;
+        RpcClient                     client(websocket, WS_PROTOCOL);
+        client.registerListener(listener);
+        client.registerClientListener(listener);
+        client.start("", credentials);
+        websocket.setConnected();
+
+        rapidjson::Document payload;
+        payload.Parse(CALL_PAYLOAD);
+
+        bool        completed = false;
+        bool        success   = false;
+        std::string response;
+        auto        completion = [&completed, &success, &response](bool result, rapidjson::Document& resp)
+        {
+            rapidjson::StringBuffer                    buffer;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            resp.Accept(writer);
+            response  = buffer.GetString();
+            success   = result;
+            completed = true;
+        };
+
+        // Response received
+        CHECK(client.callAsync(ACTION, payload, completion, std::chrono::milliseconds(500)));
+        CHECK(websocket.sendCalled());
+        rapidjson::Document call_message;
+        call_message.Parse(reinterpret_cast<const char*>(websocket.sentData()));
+        std::string callresult_message = "[3, \"" + std::string(call_message[1].GetString()) + "\", " + CALLRESULT_PAYLOAD + "]";
+        CHECK_FALSE(completed);
+        websocket.notifyDataReceived(callresult_message.c_str(), callresult_message.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+        CHECK(completed);
+        CHECK(success);
+        CHECK_EQ(response, CALLRESULT_PAYLOAD);
+
+        // Response timeout
+        completed = false;
+        auto start = std::chrono::steady_clock::now();
+        CHECK(client.callAsync(ACTION, payload, completion, std::chrono::milliseconds(50)));
+        auto                          end  = std::chrono::steady_clock::now();
+        std::chrono::duration<double> diff = end - start;
+        CHECK_LT(diff, std::chrono::milliseconds(5u));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100u));
+        CHECK(completed);
+        CHECK_FALSE(success);
+
+        // Not started
+        completed = false;
+        client.stop();
+        CHECK_FALSE(client.callAsync(ACTION, payload, completion));
+        CHECK_FALSE(completed);
+    }
+
     TEST_CASE("Reception of call request")
     {
         RpcClientListener             listener;
@@ -259,6 +399,7 @@ TEST_SUITE("CALL messages")
         CHECK_EQ(listener.payload, CALL_PAYLOAD);
         CHECK(websocket.sendCalled());
         CHECK_EQ(strcmp(reinterpret_cast<const char*>(websocket.sentData()), EXPECTED_CALLRESULT_MESSAGE_1), 0);
+        CHECK_EQ(websocket.sentPriority(), SendPriority::High);
     }
 
     TEST_CASE("Error generation on reception of a call request")
@@ -281,5 +422,256 @@ TEST_SUITE("CALL messages")
         CHECK_EQ(listener.payload, CALL_PAYLOAD);
         CHECK(websocket.sendCalled());
         CHECK_EQ(strcmp(reinterpret_cast<const char*>(websocket.sentData()), EXPECTED_CALLERROR_MESSAGE_1), 0);
+        CHECK_EQ(websocket.sentPriority(), SendPriority::High);
+    }
+
+    TEST_CASE("Escaping of the error message on reception of a call request")
+    {
+        RpcClientListener             listener;
+        WebsocketClientStub           websocket;
+        IWebsocketClient::Credentials credentials;
+        RpcClient                     client(websocket, WS_PROTOCOL);
+        client.registerListener(listener);
+        client.registerClientListener(listener);
+        client.start("", credentials);
+
+        listener.response       = CALLRESULT_PAYLOAD;
+        listener.received_error = true;
+        listener.error_code     = IRpc::RPC_ERROR_NOT_IMPLEMENTED;
+        listener.error_message  = ESCAPED_CALLERROR_PAYLOAD;
+        websocket.notifyDataReceived(EXPECTED_CALL_MESSAGE_1, strlen(EXPECTED_CALL_MESSAGE_1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+        CHECK(websocket.sendCalled());
+        CHECK_EQ(strcmp(reinterpret_cast<const char*>(websocket.sentData()), EXPECTED_ESCAPED_CALLERROR_MESSAGE_1), 0);
+
+        rapidjson::Document callerror_message;
+        callerror_message.Parse(reinterpret_cast<const char*>(websocket.sentData()));
+        CHECK_FALSE(callerror_message.HasParseError());
+        CHECK_EQ(std::string(callerror_message[3].GetString()), ESCAPED_CALLERROR_PAYLOAD);
+    }
+
+    TEST_CASE("Reception of a streamed call request")
+    {
+        RpcClientListener             listener;
+        RpcStreamHandler              stream_handler;
+        WebsocketClientStub           websocket;
+        IWebsocketClient::Credentials credentials;
+        RpcClient                     client(websocket, WS_PROTOCOL);
+        client.registerListener(listener);
+        client.registerClientListener(listener);
+        client.registerStreamHandler(ACTION, stream_handler);
+        client.start("", credentials);
+
+        // Streamed action : the whole frame is given to the stream handler
+        stream_handler.response = CALLRESULT_PAYLOAD;
+        websocket.notifyDataReceived(EXPECTED_CALL_MESSAGE_1, strlen(EXPECTED_CALL_MESSAGE_1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+        CHECK(listener.action.empty());
+        CHECK_EQ(stream_handler.action, ACTION);
+        CHECK_EQ(stream_handler.frame, EXPECTED_CALL_MESSAGE_1);
+        CHECK(websocket.sendCalled());
+        CHECK_EQ(strcmp(reinterpret_cast<const char*>(websocket.sentData()), EXPECTED_CALLRESULT_MESSAGE_1), 0);
+
+        // Other actions are still decoded by the RPC
+        const char* other_call_message = "[2,\"2\",\"Authorize\",{\"id\":4}]";
+        listener.response              = CALLRESULT_PAYLOAD;
+        stream_handler.action.clear();
+        websocket.notifyDataReceived(other_call_message, strlen(other_call_message));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+        CHECK(stream_handler.action.empty());
+        CHECK_EQ(listener.action, "Authorize");
+        CHECK_EQ(listener.payload, CALL_PAYLOAD);
+    }
+}
+
+/** @brief Server side websocket connection which stores the sent messages */
+class WebsocketServerClientStub : public IWebsocketServer::IClient
+{
+  public:
+    WebsocketServerClientStub() : listener(nullptr), mutex(), sent_messages() { }
+
+    /** @copydoc bool IClient::disconnect() */
+    bool disconnect() override { return true; }
+
+    /** @copydoc bool IClient::isConnected() */
+    bool isConnected() override { return true; }
+
+    /** @copydoc bool IClient::send(const void*, size_t, SendPriority) */
+    bool send(const void* data, size_t size, SendPriority priority) override
+    {
+        (void)priority;
+        std::lock_guard<std::mutex> lock(mutex);
+        sent_messages.emplace_back(reinterpret_cast<const char*>(data), size);
+        return true;
+    }
+
+    /** @copydoc size_t IClient::sendHeadroom() const */
+    size_t sendHeadroom() const override { return 0; }
+
+    /** @copydoc bool IClient::send(std::string&&, SendPriority) */
+    bool send(std::string&& buffer, SendPriority priority) override { return send(buffer.c_str(), buffer.size(), priority); }
+
+    /** @copydoc size_t IClient::sendQueueDepth() const */
+    size_t sendQueueDepth() const override { return 0; }
+
+    /** @copydoc size_t IClient::sendQueueBytes() const */
+    size_t sendQueueBytes() const override { return 0; }
+
+    /** @copydoc size_t IClient::sendQueueHighWaterMark(SendPriority) const */
+    size_t sendQueueHighWaterMark(SendPriority priority) const override
+    {
+        (void)priority;
+        return 0;
+    }
+
+    /** @copydoc void IClient::registerListener(IClient::IListener&) */
+    void registerListener(IClient::IListener& listener) override { this->listener = &listener; }
+
+    IClient::IListener*      listener;
+    std::mutex               mutex;
+    std::vector<std::string> sent_messages;
+};
+
+/** @brief Server side RPC listener which stores the received CALL payloads */
+class RpcServerClientListener : public IRpc::IListener
+{
+  public:
+    RpcServerClientListener() : payloads() { }
+
+    /** @copydoc void IRpc::IListener::rpcDisconnected() */
+    void rpcDisconnected() override { }
+
+    /** @copydoc void IRpc::IListener::rpcError() */
+    void rpcError() override { }
+
+    /** @copydoc void IRpc::IListener::rpcCallReceived(const std::string&,
+                                                       const rapidjson::Value&,
+                                                       rapidjson::Document&,
+                                                       const char*&,
+                                                       std::string&) */
+    bool rpcCallReceived(
+        const std::string&, const rapidjson::Value& payload, rapidjson::Document& response, const char*&, std::string&) override
+    {
+        payloads.push_back(payload["id"].GetInt());
+        response.Parse(CALLRESULT_PAYLOAD);
+        return true;
+    }
+
+    std::vector<int> payloads;
+};
+
+/** @brief Server side RPC connection which can be stopped from the processing of its own messages */
+class StoppableServerClient : public RpcServer::IClient
+{
+  public:
+    StoppableServerClient(std::shared_ptr<ocpp::websockets::IWebsocketServer::IClient> websocket, std::shared_ptr<RpcPool> pool)
+        : RpcServer::IClient(websocket, pool)
+    {
+    }
+
+    using RpcBase::stop;
+};
+
+/** @brief Server side RPC listener which stops its connection on reception of a CALL */
+class StoppingServerClientListener : public IRpc::IListener
+{
+  public:
+    StoppingServerClientListener(StoppableServerClient& client) : client(client), stopped(false) { }
+
+    /** @copydoc void IRpc::IListener::rpcDisconnected() */
+    void rpcDisconnected() override { }
+
+    /** @copydoc void IRpc::IListener::rpcError() */
+    void rpcError() override { }
+
+    /** @copydoc void IRpc::IListener::rpcCallReceived(const std::string&,
+                                                       const rapidjson::Value&,
+                                                       rapidjson::Document&,
+                                                       const char*&,
+                                                       std::string&) */
+    bool rpcCallReceived(const std::string&, const rapidjson::Value&, rapidjson::Document& response, const char*&, std::string&) override
+    {
+        client.stop();
+        stopped = true;
+        response.Parse(CALLRESULT_PAYLOAD);
+        return true;
+    }
+
+    StoppableServerClient& client;
+    std::atomic<bool>      stopped;
+};
+
+TEST_SUITE("Shared pool")
+{
+    TEST_CASE("Per connection ordering")
+    {
+        static constexpr unsigned int CONNECTIONS = 50u;
+        static constexpr int          MESSAGES    = 20;
+
+        std::shared_ptr<RpcPool>                                pool = std::make_shared<RpcPool>(4u);
+        std::vector<std::shared_ptr<WebsocketServerClientStub>> websockets;
+        std::vector<std::shared_ptr<RpcServer::IClient>>        clients;
+        std::vector<RpcServerClientListener>                    listeners(CONNECTIONS);
+        for (unsigned int i = 0; i < CONNECTIONS; i++)
+        {
+            websockets.push_back(std::make_shared<WebsocketServerClientStub>());
+            clients.push_back(std::make_shared<RpcServer::IClient>(websockets[i], pool));
+            clients[i]->registerListener(listeners[i]);
+        }
+        CHECK_EQ(pool->threadCount(), 4u);
+
+        // Interleave the messages of all the connections
+        for (int id = 0; id < MESSAGES; id++)
+        {
+            for (unsigned int i = 0; i < CONNECTIONS; i++)
+            {
+                std::string call_message = "[2,\"" + std::to_string(id) + "\",\"Heartbeat\",{\"id\":" + std::to_string(id) + "}]";
+                websockets[i]->listener->wsClientDataReceived(call_message.c_str(), call_message.size());
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(250u));
+
+        for (unsigned int i = 0; i < CONNECTIONS; i++)
+        {
+            // Requests are processed in order
+            REQUIRE_EQ(listeners[i].payloads.size(), MESSAGES);
+            for (int id = 0; id < MESSAGES; id++)
+            {
+                CHECK_EQ(listeners[i].payloads[id], id);
+            }
+
+            // Responses are sent in order
+            std::lock_guard<std::mutex> lock(websockets[i]->mutex);
+            REQUIRE_EQ(websockets[i]->sent_messages.size(), MESSAGES);
+            for (int id = 0; id < MESSAGES; id++)
+            {
+                std::string expected = "[3,\"" + std::to_string(id) + "\"," + CALLRESULT_PAYLOAD + "]";
+                CHECK_EQ(websockets[i]->sent_messages[id], expected);
+            }
+        }
+
+        // Connections can be released while the pool is running
+        clients.clear();
+    }
+
+    TEST_CASE("Stop from the processing of a connection")
+    {
+        std::shared_ptr<RpcPool>                   pool      = std::make_shared<RpcPool>(2u);
+        std::shared_ptr<WebsocketServerClientStub> websocket = std::make_shared<WebsocketServerClientStub>();
+        StoppableServerClient                      client(websocket, pool);
+        StoppingServerClientListener               listener(client);
+        client.registerListener(listener);
+
+        // The connection is stopped by the thread which is processing it
+        std::string call_message = "[2,\"0\",\"Heartbeat\",{\"id\":0}]";
+        websocket->listener->wsClientDataReceived(call_message.c_str(), call_message.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100u));
+        CHECK(listener.stopped);
+
+        // The connection is not processed anymore
+        listener.stopped = false;
+        websocket->listener->wsClientDataReceived(call_message.c_str(), call_message.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100u));
+        CHECK_FALSE(listener.stopped);
     }
 }
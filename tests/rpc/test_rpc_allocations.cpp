@@ -0,0 +1,225 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "RpcClient.h"
+#include "WebsocketClientStub.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace ocpp::websockets;
+using namespace ocpp::rpc;
+
+/** @brief Number of dynamic allocations since the start of the process */
+static std::atomic<size_t> s_allocations_count(0);
+
+// Count all the heap allocations (operator new, rapidjson allocators...) by wrapping the glibc allocator
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+
+    void* malloc(size_t size)
+    {
+        s_allocations_count++;
+        return __libc_malloc(size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        s_allocations_count++;
+        return __libc_realloc(ptr, size);
+    }
+}
+
+/** @brief Websocket stub which signals the sent messages to another thread */
+class SignalingWebsocketStub : public WebsocketClientStub
+{
+  public:
+    /** @copydoc bool IWebsocketClient::send(std::string&&, SendPriority) */
+    bool send(std::string&& buffer, SendPriority priority = SendPriority::Normal) override
+    {
+        bool ret = WebsocketClientStub::send(std::move(buffer), priority);
+        sent     = true;
+        return ret;
+    }
+
+    std::atomic<bool> sent{false};
+};
+
+class RpcClientListener : public IRpc::IListener, public RpcClient::IListener
+{
+  public:
+    /** @copydoc void RpcClient::IListener::rpcClientConnected() */
+    void rpcClientConnected() override { }
+
+    /** @copydoc void RpcClient::IListener::rpcClientFailed() */
+    void rpcClientFailed() override { }
+
+    /** @copydoc void IRpc::IListener::rpcDisconnected() */
+    void rpcDisconnected() override { }
+
+    /** @copydoc void IRpc::IListener::rpcError() */
+    void rpcError() override { }
+
+    /** @copydoc void IRpc::IListener::rpcCallReceived(const std::string&,
+                                                       const rapidjson::Value&,
+                                                       rapidjson::Document&,
+                                                       const char*&,
+                                                       std::string&) */
+    bool rpcCallReceived(const std::string&, const rapidjson::Value&, rapidjson::Document& response, const char*&, std::string&)
+        override
+    {
+        // Build a response as the message converters do
+        rapidjson::Document::AllocatorType& allocator = response.GetAllocator();
+        rapidjson::Document                 id_tag_info(rapidjson::kObjectType, &allocator);
+        id_tag_info.AddMember(rapidjson::StringRef("parentIdTag"), rapidjson::Value("PARENT_TAG", allocator), allocator);
+        id_tag_info.AddMember(rapidjson::StringRef("status"), rapidjson::Value("Accepted", allocator), allocator);
+        response.AddMember(rapidjson::StringRef("idTagInfo"), id_tag_info.Move(), allocator);
+        response.AddMember(rapidjson::StringRef("transactionId"), 1234, allocator);
+        calls++;
+        return true;
+    }
+
+    std::atomic<unsigned int> calls{0};
+};
+
+static constexpr const char* WS_PROTOCOL        = "ocpp1.6";
+static constexpr const char* ACTION             = "StartTransaction";
+static constexpr const char* CALL_PAYLOAD       = "{\"connectorId\":1,\"idTag\":\"TAG\",\"meterStart\":0,\"timestamp\":\"2021-01-01T00:00:00Z\"}";
+static constexpr const char* CALLRESULT_PAYLOAD = "{\"idTagInfo\":{\"expiryDate\":\"2021-01-01T00:00:00Z\",\"parentIdTag\":\"PARENT_TAG\","
+                                                  "\"status\":\"Accepted\"},\"transactionId\":1234}";
+static constexpr unsigned int ITERATIONS        = 100u;
+
+TEST_SUITE("Benchmarks")
+{
+    TEST_CASE("Allocations per CALLRESULT - synchronous call")
+    {
+        RpcClientListener      listener;
+        SignalingWebsocketStub websocket;
+        RpcClient              client(websocket, WS_PROTOCOL);
+        client.registerListener(listener);
+        client.registerClientListener(listener);
+        websocket.setConnected();
+
+        rapidjson::Document payload;
+        payload.Parse(CALL_PAYLOAD);
+
+        size_t allocations = 0;
+        for (unsigned int i = 0; i < ITERATIONS; i++)
+        {
+            // Transaction ids start at 0 when the client has not been started
+            std::string         callresult_message = "[3, \"" + std::to_string(i) + "\", " + CALLRESULT_PAYLOAD + "]";
+            std::atomic<size_t> start_count(0);
+            websocket.sent = false;
+            std::thread response_thread(
+                [&websocket, &callresult_message, &start_count]
+                {
+                    // Reply once the call has been sent, it is then pending and the response can be matched
+                    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500u);
+                    while (!websocket.sent && (std::chrono::steady_clock::now() < deadline))
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+                    }
+                    start_count = s_allocations_count.load();
+                    websocket.notifyDataReceived(callresult_message.c_str(), callresult_message.size());
+                });
+            rapidjson::Document response;
+            CHECK(client.call(ACTION, payload, response, std::chrono::milliseconds(500u)));
+            allocations += s_allocations_count - start_count;
+            response_thread.join();
+        }
+
+        MESSAGE("Allocations per CALLRESULT : ", static_cast<double>(allocations) / static_cast<double>(ITERATIONS));
+    }
+
+    TEST_CASE("Allocations per CALLRESULT - asynchronous call")
+    {
+        RpcClientListener             listener;
+        WebsocketClientStub           websocket;
+        IWebsocketClient::Credentials credentials;
+        RpcClient                     client(websocket, WS_PROTOCOL);
+        client.registerListener(listener);
+        client.registerClientListener(listener);
+        client.start("", credentials);
+        websocket.setConnected();
+
+        rapidjson::Document payload;
+        payload.Parse(CALL_PAYLOAD);
+
+        std::atomic<bool> completed(false);
+        auto              completion = [&completed](bool success, rapidjson::Document&)
+        {
+            CHECK(success);
+            completed = true;
+        };
+
+        size_t allocations = 0;
+        for (unsigned int i = 0; i < ITERATIONS; i++)
+        {
+            completed = false;
+            CHECK(client.callAsync(ACTION, payload, completion, std::chrono::milliseconds(500u)));
+
+            // Transaction ids start at a random value when the client has been started
+            rapidjson::Document call_message;
+            call_message.Parse(reinterpret_cast<const char*>(websocket.sentData()));
+            std::string callresult_message = "[3, \"" + std::string(call_message[1].GetString()) + "\", " + CALLRESULT_PAYLOAD + "]";
+
+            size_t start_count = s_allocations_count;
+            websocket.notifyDataReceived(callresult_message.c_str(), callresult_message.size());
+            while (!completed)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+            }
+            allocations += s_allocations_count - start_count;
+        }
+
+        MESSAGE("Allocations per CALLRESULT : ", static_cast<double>(allocations) / static_cast<double>(ITERATIONS));
+    }
+
+    TEST_CASE("Allocations per received CALL")
+    {
+        RpcClientListener             listener;
+        WebsocketClientStub           websocket;
+        IWebsocketClient::Credentials credentials;
+        RpcClient                     client(websocket, WS_PROTOCOL);
+        client.registerListener(listener);
+        client.registerClientListener(listener);
+        client.start("", credentials);
+        websocket.setConnected();
+
+        size_t allocations = 0;
+        for (unsigned int i = 0; i < ITERATIONS; i++)
+        {
+            std::string call_message = "[2, \"" + std::to_string(i) + "\", \"" + ACTION + "\", " + CALL_PAYLOAD + "]";
+
+            size_t start_count = s_allocations_count;
+            websocket.notifyDataReceived(call_message.c_str(), call_message.size());
+            while (listener.calls != (i + 1u))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+            allocations += s_allocations_count - start_count;
+        }
+
+        MESSAGE("Allocations per received CALL : ", static_cast<double>(allocations) / static_cast<double>(ITERATIONS));
+    }
+}
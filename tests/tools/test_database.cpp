@@ -20,7 +20,11 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <thread>
+#include <vector>
 
 using namespace ocpp::database;
 
@@ -31,7 +35,7 @@ TEST_SUITE("Database class test suite")
     TEST_CASE("Setup")
     {
         test_database_path = std::filesystem::temp_directory_path();
-        test_database_path.append("test.db");
+        test_database_path.append("test_database.db");
         std::filesystem::remove(test_database_path);
     }
 
@@ -119,5 +123,342 @@ TEST_SUITE("Database class test suite")
         CHECK_EQ(query.get(), nullptr);
     }
 
-    TEST_CASE("Cleanup") { std::filesystem::remove(test_database_path); }
+    TEST_CASE("Readers see the latest committed data")
+    {
+        Database db;
+        CHECK(db.open(test_database_path));
+
+        auto select_query = db.query("SELECT * FROM TestTable;");
+        auto count_query  = db.query("SELECT count(*) FROM TestTable;");
+        auto insert_query = db.query("INSERT INTO TestTable VALUES(NULL, ?, ?);");
+        REQUIRE_NE(select_query.get(), nullptr);
+        REQUIRE_NE(count_query.get(), nullptr);
+        REQUIRE_NE(insert_query.get(), nullptr);
+
+        // A pending result on the reader connection is released when the query is destroyed
+        CHECK(select_query->exec());
+        CHECK(select_query->hasRows());
+        select_query.reset();
+
+        std::string text = "Pif paf pouf";
+        CHECK(insert_query->bind(0, text));
+        CHECK(insert_query->bind(1, 123.456));
+        CHECK(insert_query->exec());
+
+        // A result is released once all its rows have been read
+        CHECK(count_query->exec());
+        CHECK(count_query->hasRows());
+        CHECK_EQ(count_query->getUInt32(0), 11u);
+        CHECK_FALSE(count_query->next());
+        CHECK_FALSE(count_query->hasRows());
+
+        insert_query->reset();
+        CHECK(insert_query->exec());
+
+        CHECK(count_query->exec());
+        CHECK(count_query->hasRows());
+        CHECK_EQ(count_query->getUInt32(0), 12u);
+        count_query->reset();
+
+        // Delete the last row to keep the expected content of the table
+        auto delete_query = db.query("DELETE FROM TestTable WHERE [IntField]=12;");
+        REQUIRE_NE(delete_query.get(), nullptr);
+        CHECK(delete_query->exec());
+
+        CHECK(db.close());
+    }
+
+    TEST_CASE("Readers of the exited threads are released")
+    {
+        Database db(1u);
+        CHECK(db.open(test_database_path));
+
+        auto count_query = db.query("SELECT count(*) FROM TestTable;");
+        REQUIRE_NE(count_query.get(), nullptr);
+
+        // Each thread uses the only reader connection and releases it when it exits
+        for (unsigned int i = 0; i < 3u; i++)
+        {
+            std::thread thread(
+                [&count_query]
+                {
+                    CHECK(count_query->exec());
+                    CHECK(count_query->hasRows());
+                    CHECK_EQ(count_query->getUInt32(0), 11u);
+                    count_query->reset();
+                });
+            thread.join();
+        }
+
+        // The database can be destroyed before the threads which have used it
+        std::atomic<bool> executed(false);
+        std::atomic<bool> release(false);
+        std::thread       thread;
+        {
+            Database other_db(1u);
+            CHECK(other_db.open(test_database_path));
+            auto other_query = other_db.query("SELECT count(*) FROM TestTable;");
+            REQUIRE_NE(other_query.get(), nullptr);
+            thread = std::thread(
+                [&other_query, &executed, &release]
+                {
+                    CHECK(other_query->exec());
+                    other_query->reset();
+                    executed = true;
+                    while (!release)
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+                    }
+                });
+            while (!executed)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+            }
+        }
+        release = true;
+        thread.join();
+
+        CHECK(db.close());
+    }
+
+    TEST_CASE("Concurrent accesses")
+    {
+        Database db;
+        CHECK(db.open(test_database_path));
+
+        auto count_query  = db.query("SELECT count(*) FROM TestTable;");
+        auto insert_query = db.query("INSERT INTO TestTable VALUES(NULL, ?, ?);");
+        REQUIRE_NE(count_query.get(), nullptr);
+        REQUIRE_NE(insert_query.get(), nullptr);
+
+        static constexpr unsigned int INSERT_COUNT = 200u;
+        static constexpr unsigned int READER_COUNT = 4u;
+
+        // Same query objects shared between a writer and several readers
+        std::atomic<bool>         end(false);
+        std::atomic<unsigned int> read_errors(0);
+        std::atomic<unsigned int> reads(0);
+        std::vector<std::thread>  readers;
+        for (unsigned int i = 0; i < READER_COUNT; i++)
+        {
+            readers.emplace_back(
+                [&]
+                {
+                    unsigned int last_count = 0;
+                    while (!end)
+                    {
+                        count_query->reset();
+                        if (count_query->exec() && count_query->hasRows())
+                        {
+                            unsigned int count = count_query->getUInt32(0);
+                            if (count < last_count)
+                            {
+                                read_errors++;
+                            }
+                            last_count = count;
+                            reads++;
+                        }
+                        else
+                        {
+                            read_errors++;
+                        }
+                    }
+                });
+        }
+
+        std::string  text          = "Concurrent";
+        unsigned int insert_errors = 0;
+        for (unsigned int i = 0; i < INSERT_COUNT; i++)
+        {
+            insert_query->reset();
+            insert_query->bind(0, text);
+            insert_query->bind(1, static_cast<double>(i));
+            if (!insert_query->exec())
+            {
+                insert_errors++;
+            }
+        }
+        end = true;
+        for (auto& reader : readers)
+        {
+            reader.join();
+        }
+
+        CHECK_EQ(insert_errors, 0u);
+        CHECK_EQ(read_errors.load(), 0u);
+        CHECK_GT(reads.load(), 0u);
+
+        count_query->reset();
+        CHECK(count_query->exec());
+        CHECK_EQ(count_query->getUInt32(0), 11u + INSERT_COUNT);
+
+        CHECK(db.close());
+    }
+
+    TEST_CASE("Transactions")
+    {
+        Database db;
+        CHECK(db.open(test_database_path));
+
+        auto count_query  = db.query("SELECT count(*) FROM TestTable;");
+        auto insert_query = db.query("INSERT INTO TestTable VALUES(NULL, ?, ?);");
+        REQUIRE_NE(count_query.get(), nullptr);
+        REQUIRE_NE(insert_query.get(), nullptr);
+
+        count_query->exec();
+        unsigned int initial_count = count_query->getUInt32(0);
+        std::string  text          = "Transaction";
+
+        // Rollback on destruction, pending changes visible inside the transaction
+        {
+            Database::Transaction transaction(db);
+            CHECK(transaction.isActive());
+            CHECK(insert_query->bind(0, text));
+            CHECK(insert_query->bind(1, 1.));
+            CHECK(insert_query->exec());
+
+            count_query->reset();
+            CHECK(count_query->exec());
+            CHECK_EQ(count_query->getUInt32(0), initial_count + 1u);
+        }
+        count_query->reset();
+        CHECK(count_query->exec());
+        CHECK_EQ(count_query->getUInt32(0), initial_count);
+
+        // Commit
+        {
+            Database::Transaction transaction(db);
+            insert_query->reset();
+            CHECK(insert_query->exec());
+            CHECK(transaction.commit());
+            CHECK_FALSE(transaction.isActive());
+            CHECK_FALSE(transaction.commit());
+        }
+        count_query->reset();
+        CHECK(count_query->exec());
+        CHECK_EQ(count_query->getUInt32(0), initial_count + 1u);
+
+        // Nested transaction rolled back
+        {
+            Database::Transaction transaction(db);
+            {
+                Database::Transaction nested(db);
+                insert_query->reset();
+                CHECK(insert_query->exec());
+                CHECK(nested.rollback());
+            }
+            CHECK_FALSE(transaction.commit());
+        }
+        count_query->reset();
+        CHECK(count_query->exec());
+        CHECK_EQ(count_query->getUInt32(0), initial_count + 1u);
+
+        // Batch
+        std::vector<double> values = {1., 2., 3., 4., 5.};
+        CHECK(db.execBatch(*insert_query,
+                           values.size(),
+                           [&](Database::Query& query, size_t index)
+                           {
+                               query.bind(0, text);
+                               query.bind(1, values[index]);
+                           }));
+        count_query->reset();
+        CHECK(count_query->exec());
+        CHECK_EQ(count_query->getUInt32(0), initial_count + 1u + values.size());
+
+        // Failing batch writes nothing
+        auto unique_query = db.query("INSERT INTO TestTable VALUES(?, ?, ?);");
+        REQUIRE_NE(unique_query.get(), nullptr);
+        CHECK_FALSE(db.execBatch(*unique_query,
+                                 2u,
+                                 [&](Database::Query& query, size_t)
+                                 {
+                                     query.bind(0, 1000000);
+                                     query.bind(1, text);
+                                     query.bind(2, 0.);
+                                 }));
+        count_query->reset();
+        CHECK(count_query->exec());
+        CHECK_EQ(count_query->getUInt32(0), initial_count + 1u + values.size());
+
+        CHECK(db.close());
+    }
+
+    TEST_CASE("Durability profiles")
+    {
+        CHECK_EQ(Database::durabilityFromString("safe"), Database::Durability::Safe);
+        CHECK_EQ(Database::durabilityFromString("balanced"), Database::Durability::Balanced);
+        CHECK_EQ(Database::durabilityFromString("fast"), Database::Durability::Fast);
+        CHECK_EQ(Database::durabilityFromString("unknown"), Database::Durability::Safe);
+
+        const std::vector<std::pair<Database::Durability, int>> profiles = {
+            {Database::Durability::Safe, 2}, {Database::Durability::Balanced, 1}, {Database::Durability::Fast, 0}};
+        for (const auto& profile : profiles)
+        {
+            Database db;
+            CHECK(db.open(test_database_path, profile.first));
+
+            auto query = db.query("PRAGMA journal_mode;");
+            REQUIRE_NE(query.get(), nullptr);
+            CHECK(query->exec());
+            CHECK_EQ(query->getString(0), "wal");
+
+            query = db.query("PRAGMA synchronous;");
+            REQUIRE_NE(query.get(), nullptr);
+            CHECK(query->exec());
+            CHECK_EQ(query->getInt32(0), profile.second);
+
+            CHECK(db.close());
+        }
+    }
+
+    TEST_CASE("Cleanup")
+    {
+        std::filesystem::remove(test_database_path);
+        std::filesystem::remove(test_database_path.string() + "-wal");
+        std::filesystem::remove(test_database_path.string() + "-shm");
+    }
+}
+
+TEST_SUITE("Database class benchmarks")
+{
+    TEST_CASE("Inserts per durability profile")
+    {
+        static constexpr unsigned int INSERT_COUNT = 2000u;
+
+        const std::vector<std::pair<Database::Durability, const char*>> profiles = {
+            {Database::Durability::Safe, "safe"}, {Database::Durability::Balanced, "balanced"}, {Database::Durability::Fast, "fast"}};
+        for (const auto& profile : profiles)
+        {
+            std::filesystem::path path = std::filesystem::temp_directory_path();
+            path.append("test_benchmark.db");
+            std::filesystem::remove(path);
+
+            Database db;
+            CHECK(db.open(path, profile.first));
+            auto query = db.query("CREATE TABLE BenchTable ([id] INTEGER, [text] VARCHAR(64), PRIMARY KEY([id] AUTOINCREMENT));");
+            CHECK_NE(query.get(), nullptr);
+            CHECK(query->exec());
+
+            // One transaction per insert, as for the log and FIFO entries
+            std::string text   = "A typical log line with a few words in it";
+            auto        insert = db.query("INSERT INTO BenchTable VALUES (NULL, ?);");
+            CHECK_NE(insert.get(), nullptr);
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned int i = 0; i < INSERT_COUNT; i++)
+            {
+                insert->reset();
+                insert->bind(0, text);
+                CHECK(insert->exec());
+            }
+            auto   duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double rate     = INSERT_COUNT / duration;
+            MESSAGE(profile.second << " : " << static_cast<unsigned int>(rate) << " inserts/s");
+
+            CHECK(db.close());
+            std::filesystem::remove(path);
+            std::filesystem::remove(path.string() + "-wal");
+            std::filesystem::remove(path.string() + "-shm");
+        }
+    }
 }
@@ -0,0 +1,110 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "JsonArena.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <string>
+#include <thread>
+
+using namespace ocpp::json;
+
+/** @brief Fill a document with a given number of members */
+static void fill(rapidjson::Document& document, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        std::string      name = "member" + std::to_string(i);
+        rapidjson::Value key(name.c_str(), document.GetAllocator());
+        rapidjson::Value value("value", document.GetAllocator());
+        document.AddMember(key, value, document.GetAllocator());
+    }
+}
+
+TEST_SUITE("JsonArena class test suite")
+{
+    TEST_CASE("Reuse of the first chunk")
+    {
+        const void* first_chunk = nullptr;
+        for (unsigned int i = 0; i < 10u; i++)
+        {
+            JsonArena           arena;
+            rapidjson::Document document(rapidjson::kObjectType, &arena.allocator());
+            fill(document, 10u);
+            CHECK_EQ(document.MemberCount(), 10u);
+            CHECK_LE(arena.allocator().Capacity(), JsonArena::BUFFER_SIZE);
+
+            // The same memory is used by all the exchanges
+            if (!first_chunk)
+            {
+                first_chunk = document["member0"].GetString();
+            }
+            CHECK_EQ(first_chunk, document["member0"].GetString());
+        }
+    }
+
+    TEST_CASE("Growth and release")
+    {
+        {
+            JsonArena           arena;
+            rapidjson::Document document(rapidjson::kObjectType, &arena.allocator());
+            fill(document, 1000u);
+            CHECK_EQ(document.MemberCount(), 1000u);
+            CHECK_GT(arena.allocator().Capacity(), JsonArena::BUFFER_SIZE);
+        }
+
+        // Only the first chunk is kept
+        JsonArena arena;
+        CHECK_LE(arena.allocator().Capacity(), JsonArena::BUFFER_SIZE);
+        CHECK_EQ(arena.allocator().Size(), 0u);
+    }
+
+    TEST_CASE("Nested scopes")
+    {
+        JsonArena           outer;
+        rapidjson::Document outer_document(rapidjson::kObjectType, &outer.allocator());
+        fill(outer_document, 5u);
+        size_t outer_size = outer.allocator().Size();
+        {
+            JsonArena           inner;
+            rapidjson::Document inner_document(rapidjson::kObjectType, &inner.allocator());
+            fill(inner_document, 5u);
+            CHECK_EQ(&inner.allocator(), &outer.allocator());
+        }
+
+        // The outer document is still valid
+        CHECK_GT(outer.allocator().Size(), outer_size);
+        CHECK_EQ(outer_document.MemberCount(), 5u);
+        CHECK_EQ(std::string(outer_document["member4"].GetString()), "value");
+    }
+
+    TEST_CASE("One pool per thread")
+    {
+        JsonArena             arena;
+        JsonArena::Allocator* other_allocator = nullptr;
+        std::thread           other_thread(
+            [&other_allocator]
+            {
+                JsonArena other_arena;
+                other_allocator = &other_arena.allocator();
+            });
+        other_thread.join();
+        CHECK_NE(other_allocator, &arena.allocator());
+    }
+}
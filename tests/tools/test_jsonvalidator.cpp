@@ -0,0 +1,127 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "JsonValidator.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace ocpp::json;
+
+std::filesystem::path test_schema_path;
+
+/** @brief Parse a JSON document */
+static rapidjson::Document parse(const char* json)
+{
+    rapidjson::Document document;
+    document.Parse(json);
+    return document;
+}
+
+TEST_SUITE("JsonValidator class test suite")
+{
+    TEST_CASE("Setup")
+    {
+        test_schema_path = std::filesystem::temp_directory_path();
+        test_schema_path.append("test_schema.json");
+
+        std::ofstream file(test_schema_path);
+        file << "{"
+                "\"$schema\": \"http://json-schema.org/draft-04/schema#\","
+                "\"type\": \"object\","
+                "\"properties\": {"
+                "  \"idTag\": {\"type\": \"string\", \"maxLength\": 20},"
+                "  \"connectorId\": {\"type\": \"integer\"}"
+                "},"
+                "\"additionalProperties\": false,"
+                "\"required\": [\"idTag\"]"
+                "}";
+    }
+
+    TEST_CASE("Validation")
+    {
+        JsonValidator validator;
+        CHECK_FALSE(validator.init("/does/not/exist.json"));
+        CHECK_FALSE(validator.isValid(parse("{}")));
+        CHECK(validator.init(test_schema_path));
+
+        CHECK(validator.isValid(parse("{\"idTag\": \"ABCD\", \"connectorId\": 1}")));
+        CHECK(validator.lastError().empty());
+        CHECK_FALSE(validator.isValid(parse("{\"connectorId\": 1}")));
+        CHECK_EQ(validator.lastError(), "Error on keyword : required");
+        CHECK_FALSE(validator.isValid(parse("{\"idTag\": \"ABCDEFGHIJKLMNOPQRSTUVWXYZ\"}")));
+        CHECK_EQ(validator.lastError(), "Error on keyword : maxLength");
+        CHECK(validator.isValid(parse("{\"idTag\": \"ABCD\"}")));
+    }
+
+    TEST_CASE("Compiled schemas cache")
+    {
+        // Schema is compiled once per process
+        JsonValidator validator1;
+        CHECK(validator1.init(test_schema_path));
+        std::filesystem::remove(test_schema_path);
+
+        JsonValidator validator2;
+        CHECK(validator2.init(test_schema_path));
+        CHECK(validator2.isValid(parse("{\"idTag\": \"ABCD\"}")));
+        CHECK_FALSE(validator2.isValid(parse("{\"idTag\": 12}")));
+    }
+
+    TEST_CASE("Concurrent validations")
+    {
+        JsonValidator validator;
+        CHECK(validator.init(test_schema_path));
+
+        static constexpr unsigned int THREAD_COUNT     = 4u;
+        static constexpr unsigned int VALIDATION_COUNT = 5000u;
+
+        rapidjson::Document       valid   = parse("{\"idTag\": \"ABCD\", \"connectorId\": 1}");
+        rapidjson::Document       invalid = parse("{\"idTag\": \"ABCD\", \"connectorId\": \"1\"}");
+        std::atomic<unsigned int> errors(0);
+        std::vector<std::thread>  threads;
+        for (unsigned int i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back(
+                [&]
+                {
+                    for (unsigned int j = 0; j < VALIDATION_COUNT; j++)
+                    {
+                        bool expected = ((j % 2u) == 0);
+                        if (validator.isValid(expected ? valid : invalid) != expected)
+                        {
+                            errors++;
+                        }
+                        if (expected != validator.lastError().empty())
+                        {
+                            errors++;
+                        }
+                    }
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        CHECK_EQ(errors.load(), 0u);
+    }
+}
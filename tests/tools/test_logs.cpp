@@ -26,8 +26,11 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <chrono>
 #include <filesystem>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace ocpp::database;
 using namespace ocpp::log;
@@ -39,7 +42,7 @@ TEST_SUITE("Database class test suite")
     TEST_CASE("Setup")
     {
         test_database_path = std::filesystem::temp_directory_path();
-        test_database_path.append("test.db");
+        test_database_path.append("test_logs.db");
         std::filesystem::remove(test_database_path);
     }
 
@@ -56,6 +59,9 @@ TEST_SUITE("Database class test suite")
                         "file.cpp:" + std::to_string(i),
                         "My log! " + std::to_string(i));
         }
+        log_db1.flush();
+        CHECK_EQ(log_db1.writtenCount(), 20u);
+        CHECK_EQ(log_db1.droppedCount(), 0u);
 
         auto query = db.query("SELECT * FROM logs_1;");
         CHECK_NE(query.get(), nullptr);
@@ -90,6 +96,7 @@ TEST_SUITE("Database class test suite")
         LOG_INFO << "This one either!";
         LOG_WARNING << "And also this one!";
         LOG_ERROR << "This is the last one saved!";
+        Logger::flushLoggers();
 
         auto query = db.query("SELECT * FROM " DEFAULT_LOG_NAME " ORDER BY id ASC;");
         CHECK_NE(query.get(), nullptr);
@@ -115,6 +122,9 @@ TEST_SUITE("Database class test suite")
         CHECK_EQ(query->getUInt32(2), 4);
         CHECK_EQ(query->getString(4), "This is the last one saved!");
         CHECK_FALSE(query->next());
+
+        // The logger must not outlive its database
+        Logger::unregisterDefaultLogger();
     }
 
     TEST_CASE("Custom logger")
@@ -131,6 +141,7 @@ TEST_SUITE("Database class test suite")
         LOG_INFO2("MyLogs") << "This one either!";
         LOG_DEBUG2("MyLogs") << "And also this one!";
         LOG_COM2("MyLogs") << "This is the last one saved!";
+        Logger::flushLoggers();
 
         auto query = db.query("SELECT * FROM MyLogs ORDER BY id ASC;");
         CHECK_NE(query.get(), nullptr);
@@ -156,7 +167,156 @@ TEST_SUITE("Database class test suite")
         CHECK_EQ(query->getUInt32(2), 1);
         CHECK_EQ(query->getString(4), "This is the last one saved!");
         CHECK_FALSE(query->next());
+        query.reset();
+
+        // The logger must not outlive its database, its pending logs are written when it is unregistered
+        LOG_INFO2("MyLogs") << "Written before unregistration";
+        Logger::unregisterLogger("MyLogs");
+        LOG_INFO2("MyLogs") << "This log won't be saved!";
+
+        query = db.query("SELECT count(*) FROM MyLogs;");
+        CHECK_NE(query.get(), nullptr);
+        CHECK(query->exec());
+        CHECK_EQ(query->getUInt32(0), 6u);
+    }
+
+    TEST_CASE("Unregistration while logging")
+    {
+        Database db;
+        CHECK(db.open(test_database_path));
+
+        Logger::registerLogger(db, "HeldLogs", 20u);
+
+        // The log being generated is the last user of the logger, it writes the pending logs when it ends
+        auto unregister = []
+        {
+            Logger::unregisterLogger("HeldLogs");
+            return "unregistered";
+        };
+        LOG_INFO2("HeldLogs") << "Logger " << unregister();
+        LOG_INFO2("HeldLogs") << "This log won't be saved!";
+
+        auto query = db.query("SELECT * FROM HeldLogs;");
+        CHECK_NE(query.get(), nullptr);
+        CHECK(query->exec());
+        CHECK(query->hasRows());
+        CHECK_EQ(query->getString(4), "Logger unregistered");
+        CHECK_FALSE(query->next());
+    }
+
+    TEST_CASE("Asynchronous writer")
+    {
+        Database db;
+        CHECK(db.open(test_database_path));
+
+        static constexpr unsigned int THREAD_COUNT    = 4u;
+        static constexpr unsigned int LOGS_PER_THREAD = 5000u;
+
+        LogDatabase              log_db(db, "logs_async", THREAD_COUNT * LOGS_PER_THREAD);
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back(
+                [&log_db, i]
+                {
+                    for (unsigned int j = 0; j < LOGS_PER_THREAD; j++)
+                    {
+                        log_db.log(0, j % 5u, "thread" + std::to_string(i), "Async log " + std::to_string(j));
+                    }
+                });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        log_db.flush();
+
+        // Every entry is either written or accounted as dropped
+        CHECK_EQ(log_db.writtenCount() + log_db.droppedCount(), THREAD_COUNT * LOGS_PER_THREAD);
+        CHECK_GT(log_db.writtenCount(), 0u);
+
+        auto query = db.query("SELECT count(*) FROM logs_async;");
+        CHECK_NE(query.get(), nullptr);
+        CHECK(query->exec());
+        CHECK_EQ(query->getUInt64(0), log_db.writtenCount());
+        MESSAGE("Written : " << log_db.writtenCount() << " - dropped : " << log_db.droppedCount());
+    }
+
+    TEST_CASE("Cleanup")
+    {
+        std::filesystem::remove(test_database_path);
+        std::filesystem::remove(test_database_path.string() + "-wal");
+        std::filesystem::remove(test_database_path.string() + "-shm");
+    }
+}
+
+TEST_SUITE("Log database benchmarks")
+{
+    /** @brief Insert rows in a log table and return the number of inserts per second */
+    static double insertLogs(Database& db, const std::string& table_name, unsigned int count)
+    {
+        auto query = db.query("INSERT INTO " + table_name + " VALUES (NULL, ?, ?, ?, ?);");
+        REQUIRE_NE(query.get(), nullptr);
+
+        std::string file    = "benchmark.cpp:42";
+        std::string message = "A typical log line with a few words in it";
+        auto        start   = std::chrono::steady_clock::now();
+        CHECK(db.execBatch(*query,
+                           count,
+                           [&](Database::Query& insert_query, size_t index)
+                           {
+                               insert_query.bind(0, static_cast<int64_t>(index));
+                               insert_query.bind(1, 2u);
+                               insert_query.bind(2, file);
+                               insert_query.bind(3, message);
+                           }));
+        auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return (count / duration);
     }
 
-    TEST_CASE("Cleanup") { std::filesystem::remove(test_database_path); }
+    TEST_CASE("Inserts with 100k retained entries")
+    {
+        static constexpr unsigned int RETAINED_ENTRIES = 100000u;
+        static constexpr unsigned int INSERT_COUNT     = 2000u;
+
+        std::filesystem::path path = std::filesystem::temp_directory_path();
+        path.append("test_logs_benchmark.db");
+        std::filesystem::remove(path);
+
+        Database db;
+        CHECK(db.open(path));
+
+        // Rotation using the count of entries
+        auto query = db.query("CREATE TABLE logs_count ([id] INTEGER, [timestamp] BIGINT, [level] INT UNSIGNED, [file] VARCHAR(64), "
+                              "[message] VARCHAR(1024), PRIMARY KEY([id] AUTOINCREMENT));");
+        REQUIRE_NE(query.get(), nullptr);
+        CHECK(query->exec());
+        insertLogs(db, "logs_count", RETAINED_ENTRIES);
+        query = db.query("CREATE TRIGGER delete_oldest_logs_count AFTER INSERT ON logs_count WHEN ((SELECT count() FROM logs_count) > " +
+                         std::to_string(RETAINED_ENTRIES) +
+                         ") BEGIN DELETE FROM logs_count WHERE ROWID IN (SELECT ROWID FROM logs_count LIMIT 1);END;");
+        REQUIRE_NE(query.get(), nullptr);
+        CHECK(query->exec());
+        double count_rate = insertLogs(db, "logs_count", INSERT_COUNT);
+
+        // Rotation of the log database
+        {
+            LogDatabase log_db(db, "logs_ring", RETAINED_ENTRIES);
+            insertLogs(db, "logs_ring", RETAINED_ENTRIES);
+            double ring_rate = insertLogs(db, "logs_ring", INSERT_COUNT);
+
+            query = db.query("SELECT count(*) FROM logs_ring;");
+            REQUIRE_NE(query.get(), nullptr);
+            CHECK(query->exec());
+            CHECK_EQ(query->getUInt32(0), RETAINED_ENTRIES);
+
+            MESSAGE("count() trigger : " << static_cast<unsigned int>(count_rate) << " inserts/s");
+            MESSAGE("id window trigger : " << static_cast<unsigned int>(ring_rate) << " inserts/s");
+        }
+
+        CHECK(db.close());
+        std::filesystem::remove(path);
+        std::filesystem::remove(path.string() + "-wal");
+        std::filesystem::remove(path.string() + "-shm");
+    }
 }
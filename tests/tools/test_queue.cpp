@@ -17,10 +17,12 @@ along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 */
 
 #include "Queue.h"
+#include "RingQueue.h"
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
 #include <thread>
+#include <vector>
 
 using namespace ocpp::helpers;
 
@@ -113,3 +115,126 @@ TEST_SUITE("Queue class test suite - Nominal")
         CHECK_FALSE(queue.pop(val, 0));
     }
 }
+
+TEST_SUITE("RingQueue class test suite - Nominal")
+{
+    TEST_CASE("Standard operations")
+    {
+        MpscRingQueue<size_t, 10> mpsc_queue;
+        SpscRingQueue<size_t, 10> spsc_queue;
+        auto                      test = [](auto& queue)
+        {
+            CHECK_EQ(queue.size(), 10);
+            CHECK_EQ(queue.count(), 0);
+            CHECK(queue.empty());
+            CHECK_FALSE(queue.full());
+
+            for (size_t loop = 0; loop < 3u; loop++)
+            {
+                for (size_t i = 0; i < queue.size(); i++)
+                {
+                    CHECK(queue.push(i));
+                    CHECK_EQ(queue.count(), (i + 1));
+                }
+                CHECK_FALSE(queue.push(55u));
+                CHECK_FALSE(queue.empty());
+                CHECK(queue.full());
+
+                size_t val = 0;
+                for (size_t i = 0; i < queue.size(); i++)
+                {
+                    CHECK(queue.pop(val, 0));
+                    CHECK_EQ(val, i);
+                    CHECK_EQ(queue.count(), (queue.size() - (i + 1)));
+                }
+                CHECK_FALSE(queue.pop(val, 0));
+                CHECK(queue.empty());
+                CHECK_FALSE(queue.full());
+            }
+
+            CHECK(queue.push(45u));
+            CHECK(queue.push(890u));
+            CHECK(queue.push(3456u));
+            CHECK_EQ(queue.count(), 3u);
+            queue.clear();
+            CHECK_EQ(queue.count(), 0u);
+            CHECK(queue.empty());
+        };
+        test(mpsc_queue);
+        test(spsc_queue);
+    }
+
+    TEST_CASE("Timeout management")
+    {
+        MpscRingQueue<int, 16> queue;
+
+        int val = 0;
+        CHECK_FALSE(queue.pop(val, 200u));
+
+        std::thread push_thread(
+            [&queue]
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                queue.push(12345);
+            });
+        push_thread.detach();
+
+        CHECK(queue.pop(val, 2000u));
+        CHECK_EQ(val, 12345);
+
+        CHECK_FALSE(queue.pop(val, 200u));
+
+        std::thread cancel_thread(
+            [&queue]
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                queue.setEnable(false);
+            });
+        cancel_thread.detach();
+        CHECK_FALSE(queue.pop(val));
+
+        queue.setEnable(true);
+        queue.push(12345);
+        CHECK(queue.pop(val));
+        CHECK_EQ(val, 12345);
+    }
+
+    TEST_CASE("Multiple producers")
+    {
+        static constexpr size_t PRODUCERS_COUNT    = 4u;
+        static constexpr size_t ITEMS_PER_PRODUCER = 10000u;
+
+        MpscRingQueue<size_t, 64> queue;
+        std::vector<std::thread>  producers;
+        for (size_t producer = 0; producer < PRODUCERS_COUNT; producer++)
+        {
+            producers.emplace_back(
+                [&queue, producer]
+                {
+                    for (size_t i = 0; i < ITEMS_PER_PRODUCER; i++)
+                    {
+                        while (!queue.push(producer * ITEMS_PER_PRODUCER + i))
+                        {
+                            std::this_thread::yield();
+                        }
+                    }
+                });
+        }
+
+        // Each item must be received once and in order for a given producer
+        std::vector<size_t> next_items(PRODUCERS_COUNT, 0);
+        size_t              val = 0;
+        for (size_t i = 0; i < (PRODUCERS_COUNT * ITEMS_PER_PRODUCER); i++)
+        {
+            REQUIRE(queue.pop(val, 2000u));
+            size_t producer = val / ITEMS_PER_PRODUCER;
+            CHECK_EQ(val % ITEMS_PER_PRODUCER, next_items[producer]);
+            next_items[producer]++;
+        }
+        CHECK_FALSE(queue.pop(val, 0));
+        for (std::thread& producer : producers)
+        {
+            producer.join();
+        }
+    }
+}
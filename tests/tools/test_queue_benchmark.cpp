@@ -0,0 +1,116 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Queue.h"
+#include "RingQueue.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace ocpp::helpers;
+
+/** @brief Number of items exchanged in each benchmark */
+static constexpr size_t ITEMS_COUNT = 200000u;
+/** @brief Capacity of the queues */
+static constexpr size_t QUEUE_SIZE = 1024u;
+
+/** @brief Item carrying its push date to measure the latency */
+typedef int64_t BenchmarkItem;
+
+/** @brief Get the current date in nanoseconds */
+static int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** @brief Run a benchmark with a given number of producers and return a printable result */
+template <typename QueueType>
+static std::string benchmark(QueueType& queue, size_t producers_count)
+{
+    // Start producers
+    size_t                   items_per_producer = ITEMS_COUNT / producers_count;
+    int64_t                  start              = now();
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < producers_count; producer++)
+    {
+        producers.emplace_back(
+            [&queue, items_per_producer]
+            {
+                for (size_t i = 0; i < items_per_producer; i++)
+                {
+                    while (!queue.push(now()))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+    }
+
+    // Consume items
+    BenchmarkItem item          = 0;
+    int64_t       total_latency = 0;
+    size_t        count         = 0;
+    for (; count < (items_per_producer * producers_count); count++)
+    {
+        REQUIRE(queue.pop(item, 2000u));
+        total_latency += (now() - item);
+    }
+    int64_t duration = now() - start;
+    for (std::thread& producer : producers)
+    {
+        producer.join();
+    }
+
+    // Format result
+    std::stringstream result;
+    result << producers_count << " producer(s) : " << (static_cast<double>(count) * 1e9 / static_cast<double>(duration)) / 1e6
+           << " Mitems/s, average latency = " << (total_latency / static_cast<int64_t>(count)) << " ns";
+    return result.str();
+}
+
+TEST_SUITE("Benchmarks")
+{
+    TEST_CASE("Mutex based queue")
+    {
+        for (size_t producers_count : {1u, 2u, 8u})
+        {
+            Queue<BenchmarkItem, QUEUE_SIZE> queue;
+            MESSAGE("Queue : " << benchmark(queue, producers_count));
+        }
+    }
+
+    TEST_CASE("Lock-free MPSC queue")
+    {
+        for (size_t producers_count : {1u, 2u, 8u})
+        {
+            MpscRingQueue<BenchmarkItem, QUEUE_SIZE> queue;
+            MESSAGE("MpscRingQueue : " << benchmark(queue, producers_count));
+        }
+    }
+
+    TEST_CASE("Lock-free SPSC queue")
+    {
+        SpscRingQueue<BenchmarkItem, QUEUE_SIZE> queue;
+        MESSAGE("SpscRingQueue : " << benchmark(queue, 1u));
+    }
+}
@@ -16,12 +16,18 @@ You should have received a copy of the GNU Lesser General Public License
 along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "ClockAlignedTimer.h"
 #include "Timer.h"
 #include "TimerPool.h"
+#include "WorkerThreadPool.h"
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <random>
+#include <vector>
 
 using namespace ocpp::helpers;
 
@@ -184,4 +190,338 @@ TEST_SUITE("Timers class test suite")
         CHECK_EQ(calls2, 2u);
         CHECK_EQ(calls3, 6u);
     }
+
+    TEST_CASE("Standard operations - wakeup order")
+    {
+        TimerPool                           pool;
+        std::vector<std::unique_ptr<Timer>> timers;
+        std::vector<unsigned int>           wakeups;
+        std::mt19937                        random(1234u);
+        for (unsigned int i = 0; i < 50u; i++)
+        {
+            timers.emplace_back(pool.createTimer());
+            timers.back()->setCallback([&wakeups, i] { wakeups.push_back(i); });
+        }
+
+        // Start the timers with shuffled intervals and stop some of them
+        std::vector<unsigned int> intervals;
+        for (unsigned int i = 0; i < timers.size(); i++)
+        {
+            intervals.push_back(100u + 4u * i);
+        }
+        std::shuffle(intervals.begin(), intervals.end(), random);
+        for (unsigned int i = 0; i < timers.size(); i++)
+        {
+            CHECK(timers[i]->start(std::chrono::milliseconds(intervals[i]), true));
+        }
+        for (unsigned int i = 0; i < timers.size(); i += 5u)
+        {
+            CHECK(timers[i]->stop());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500u));
+
+        // Check wakeup order
+        CHECK_EQ(wakeups.size(), 40u);
+        for (unsigned int i = 1u; i < wakeups.size(); i++)
+        {
+            CHECK_LT(intervals[wakeups[i - 1u]], intervals[wakeups[i]]);
+        }
+    }
+}
+
+TEST_SUITE("Timers executors and statistics")
+{
+    TEST_CASE("Callbacks on an executor")
+    {
+        TimerPool              pool;
+        WorkerThreadPool       executor(1u);
+        std::unique_ptr<Timer> slow_timer(pool.createTimer());
+        std::unique_ptr<Timer> fast_timer(pool.createTimer());
+        std::atomic<unsigned>  slow_calls(0);
+        std::atomic<unsigned>  fast_calls(0);
+
+        // The slow callback does not delay the other timers of the pool
+        slow_timer->setCallback(
+            [&slow_calls]
+            {
+                slow_calls++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(250u));
+            });
+        slow_timer->setExecutor(&executor);
+        fast_timer->setCallback([&fast_calls] { fast_calls++; });
+
+        CHECK(slow_timer->start(std::chrono::milliseconds(50u)));
+        CHECK(fast_timer->start(std::chrono::milliseconds(50u)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(525u));
+        CHECK(fast_timer->stop());
+        CHECK(slow_timer->stop());
+
+        // Expiries happening while the slow callback is executing are dropped
+        CHECK_EQ(fast_calls, 10u);
+        CHECK_EQ(slow_calls, 2u);
+
+        TimerPool::Statistics stats = pool.getStatistics();
+        CHECK_EQ(stats.expiries, 12u);
+        CHECK_EQ(stats.dropped, 8u);
+        uint64_t histogram_count = 0;
+        for (uint64_t count : stats.lateness_histogram)
+        {
+            histogram_count += count;
+        }
+        CHECK_EQ(histogram_count, stats.expiries);
+        CHECK_LT(stats.max_lateness, std::chrono::milliseconds(100u));
+
+        pool.resetStatistics();
+        stats = pool.getStatistics();
+        CHECK_EQ(stats.expiries, 0u);
+        CHECK_EQ(stats.dropped, 0u);
+        CHECK_EQ(stats.max_lateness, std::chrono::microseconds(0));
+    }
+
+    TEST_CASE("Single shot callbacks on an executor")
+    {
+        TimerPool              pool;
+        WorkerThreadPool       executor(1u);
+        std::unique_ptr<Timer> timer(pool.createTimer());
+        std::atomic<unsigned>  calls(0);
+        timer->setCallback([&calls] { calls++; });
+        timer->setExecutor(&executor);
+
+        // Single shot expiries are never dropped, even if the previous one has not been processed yet
+        executor.run<void>([] { std::this_thread::sleep_for(std::chrono::milliseconds(200u)); });
+        CHECK(timer->start(std::chrono::milliseconds(20u), true));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+        CHECK(timer->start(std::chrono::milliseconds(20u), true));
+        std::this_thread::sleep_for(std::chrono::milliseconds(300u));
+        CHECK_EQ(calls, 2u);
+        CHECK_EQ(pool.getStatistics().dropped, 0u);
+
+        // Stopping the timer cancels the queued executions
+        executor.run<void>([] { std::this_thread::sleep_for(std::chrono::milliseconds(200u)); });
+        CHECK(timer->start(std::chrono::milliseconds(20u), true));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+        CHECK_FALSE(timer->stop());
+        std::this_thread::sleep_for(std::chrono::milliseconds(300u));
+        CHECK_EQ(calls, 2u);
+    }
+
+    TEST_CASE("Stop waits for the end of the running callback")
+    {
+        TimerPool              pool;
+        WorkerThreadPool       executor(1u);
+        std::unique_ptr<Timer> timer(pool.createTimer());
+        std::atomic<bool>      running(false);
+        std::atomic<bool>      done(false);
+        timer->setCallback(
+            [&running, &done]
+            {
+                running = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(200u));
+                done = true;
+            });
+        timer->setExecutor(&executor);
+
+        CHECK(timer->start(std::chrono::milliseconds(20u), true));
+        while (!running)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5u));
+        }
+        timer->stop();
+        CHECK(done);
+
+        // The timer can be destroyed once stopped
+        timer.reset();
+    }
+
+    TEST_CASE("Stop from an inline callback while the running callback waits for the timers")
+    {
+        TimerPool              pool;
+        WorkerThreadPool       executor(1u);
+        std::unique_ptr<Timer> worker_timer(pool.createTimer());
+        std::unique_ptr<Timer> inline_timer(pool.createTimer());
+        std::unique_ptr<Timer> other_timer(pool.createTimer());
+        std::atomic<bool>      running(false);
+        std::atomic<bool>      inline_running(false);
+        std::atomic<bool>      done(false);
+        worker_timer->setCallback(
+            [&]
+            {
+                running = true;
+                while (!inline_running)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5u));
+                }
+                // Blocks until the end of the inline callback
+                other_timer->restart(std::chrono::milliseconds(1000u));
+                done = true;
+            });
+        worker_timer->setExecutor(&executor);
+        inline_timer->setCallback(
+            [&]
+            {
+                inline_running = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(50u));
+                worker_timer->stop();
+            });
+
+        CHECK(worker_timer->start(std::chrono::milliseconds(20u), true));
+        while (!running)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5u));
+        }
+        CHECK(inline_timer->start(std::chrono::milliseconds(20u), true));
+        for (unsigned int i = 0; (i < 200u) && !done; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5u));
+        }
+        CHECK(done);
+        other_timer->stop();
+    }
+
+    TEST_CASE("Lateness of inline callbacks")
+    {
+        TimerPool              pool;
+        std::unique_ptr<Timer> slow_timer(pool.createTimer());
+        std::unique_ptr<Timer> delayed_timer(pool.createTimer());
+        slow_timer->setCallback([] { std::this_thread::sleep_for(std::chrono::milliseconds(200u)); });
+        delayed_timer->setCallback([] {});
+
+        CHECK(slow_timer->start(std::chrono::milliseconds(50u), true));
+        CHECK(delayed_timer->start(std::chrono::milliseconds(100u), true));
+        std::this_thread::sleep_for(std::chrono::milliseconds(400u));
+
+        // The delayed timer has been late of about 150ms
+        TimerPool::Statistics stats = pool.getStatistics();
+        CHECK_EQ(stats.expiries, 2u);
+        CHECK_GE(stats.max_lateness, std::chrono::milliseconds(100u));
+        CHECK_EQ(stats.lateness_histogram[TimerPool::LATENESS_BUCKET_COUNT - 3u], 1u);
+    }
+}
+
+TEST_SUITE("Clock aligned timers class test suite")
+{
+    TEST_CASE("Next aligned time point")
+    {
+        // Local midnight
+        time_t    now_time = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        struct tm midnight_tm;
+        localtime_r(&now_time, &midnight_tm);
+        midnight_tm.tm_hour  = 0;
+        midnight_tm.tm_min   = 0;
+        midnight_tm.tm_sec   = 0;
+        midnight_tm.tm_isdst = -1;
+        auto midnight        = std::chrono::system_clock::from_time_t(std::mktime(&midnight_tm));
+
+        auto quarter = std::chrono::minutes(15u);
+        CHECK_EQ(ClockAlignedTimer::nextAlignedTimePoint(midnight, quarter), midnight + quarter);
+        CHECK_EQ(ClockAlignedTimer::nextAlignedTimePoint(midnight + std::chrono::minutes(14u), quarter), midnight + quarter);
+        CHECK_EQ(ClockAlignedTimer::nextAlignedTimePoint(midnight + quarter, quarter), midnight + 2 * quarter);
+        CHECK_EQ(ClockAlignedTimer::nextAlignedTimePoint(midnight + std::chrono::milliseconds(900500u), quarter), midnight + 2 * quarter);
+
+        // Alignment restarts at midnight
+        auto seven         = std::chrono::minutes(7u);
+        auto next_midnight = ClockAlignedTimer::nextAlignedTimePoint(midnight + std::chrono::hours(23u) + std::chrono::minutes(59u),
+                                                                     std::chrono::hours(1u));
+        CHECK_EQ(ClockAlignedTimer::nextAlignedTimePoint(next_midnight - std::chrono::minutes(1u), seven), next_midnight);
+    }
+
+    TEST_CASE("Standard operations")
+    {
+        TimerPool                                          pool;
+        ClockAlignedTimer                                  timer(pool);
+        std::vector<std::chrono::system_clock::time_point> wakeups;
+        timer.setCallback([&wakeups] { wakeups.push_back(std::chrono::system_clock::now()); });
+
+        CHECK_FALSE(timer.isStarted());
+        CHECK_FALSE(timer.stop());
+        CHECK_FALSE(timer.start(std::chrono::seconds(0)));
+        CHECK_FALSE(timer.isStarted());
+        CHECK(timer.start(std::chrono::seconds(1u)));
+        CHECK(timer.isStarted());
+        CHECK_EQ(timer.getInterval(), std::chrono::seconds(1u));
+        std::this_thread::sleep_for(std::chrono::milliseconds(2500u));
+        CHECK(timer.stop());
+        CHECK_FALSE(timer.isStarted());
+
+        // Wakeups are aligned on the wall-clock seconds
+        REQUIRE_GE(wakeups.size(), 2u);
+        for (const auto& wakeup : wakeups)
+        {
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(wakeup.time_since_epoch()).count() % 1000;
+            CHECK_LT(ms, 100);
+        }
+    }
+}
+
+TEST_SUITE("Timers class benchmarks")
+{
+    TEST_CASE("Start, restart and stop")
+    {
+        std::mt19937 random(1234u);
+        for (size_t count : {1000u, 10000u, 100000u})
+        {
+            TimerPool                           pool;
+            std::vector<std::unique_ptr<Timer>> timers;
+            for (size_t i = 0; i < count; i++)
+            {
+                timers.emplace_back(pool.createTimer());
+            }
+
+            // Start all the timers far in the future
+            std::uniform_int_distribution<unsigned int> interval(3600u, 7200u);
+            auto                                        start = std::chrono::steady_clock::now();
+            for (auto& timer : timers)
+            {
+                timer->start(std::chrono::seconds(interval(random)));
+            }
+            auto started = std::chrono::steady_clock::now();
+            for (auto& timer : timers)
+            {
+                timer->restart(std::chrono::seconds(interval(random)));
+            }
+            auto restarted = std::chrono::steady_clock::now();
+            std::shuffle(timers.begin(), timers.end(), random);
+            for (auto& timer : timers)
+            {
+                timer->stop();
+            }
+            auto stopped = std::chrono::steady_clock::now();
+
+            auto us = [count](std::chrono::steady_clock::duration duration)
+            { return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) / 1000. / count; };
+            MESSAGE(count << " timers : start = " << us(started - start) << " us/timer, restart = " << us(restarted - started)
+                          << " us/timer, stop = " << us(stopped - restarted) << " us/timer");
+        }
+    }
+
+    TEST_CASE("Expiry")
+    {
+        std::mt19937 random(1234u);
+        for (size_t count : {1000u, 10000u, 100000u})
+        {
+            TimerPool                           pool;
+            std::vector<std::unique_ptr<Timer>> timers;
+            std::atomic<size_t>                 calls(0);
+            for (size_t i = 0; i < count; i++)
+            {
+                timers.emplace_back(pool.createTimer());
+                timers.back()->setCallback([&calls] { calls++; });
+            }
+
+            // Make all the timers elapse in a 200ms window
+            std::uniform_int_distribution<unsigned int> interval(100u, 300u);
+            auto                                        start = std::chrono::steady_clock::now();
+            for (auto& timer : timers)
+            {
+                timer->start(std::chrono::milliseconds(interval(random)), true);
+            }
+            while ((calls != count) && ((std::chrono::steady_clock::now() - start) < std::chrono::seconds(10u)))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1u));
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            CHECK_EQ(calls, count);
+            MESSAGE(count << " timers : all elapsed after " << elapsed.count() << " ms");
+        }
+    }
 }
@@ -16,10 +16,14 @@ You should have received a copy of the GNU Lesser General Public License
 along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include "TimerPool.h"
 #include "WorkerThreadPool.h"
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 
+#include <atomic>
+#include <vector>
+
 using namespace ocpp::helpers;
 
 TEST_SUITE("WorkerThreadPool class test suite")
@@ -40,7 +44,7 @@ TEST_SUITE("WorkerThreadPool class test suite")
             jobs_done++;
         };
 
-        worker_thread_pool.run<void>(job1);
+        Waiter<void> waiter0 = worker_thread_pool.run<void>(job1);
         Waiter<void> waiter1 = worker_thread_pool.run<void>(job1);
 
         auto job2 = [&jobs_done]
@@ -60,6 +64,7 @@ TEST_SUITE("WorkerThreadPool class test suite")
         end_job_1 = true;
         end_job1_var.notify_all();
 
+        CHECK(waiter0.wait());
         CHECK(waiter1.wait());
         CHECK_EQ(jobs_done, 7u);
     }
@@ -155,4 +160,178 @@ TEST_SUITE("WorkerThreadPool class test suite")
         CHECK_EQ(waiter7.value(), "Pouf");
         CHECK_FALSE(waiter8.success());
     }
+
+    TEST_CASE("Futures")
+    {
+        WorkerThreadPool worker_thread_pool(2);
+        CHECK_EQ(worker_thread_pool.threadCount(), 2u);
+
+        std::mutex              start_mutex;
+        std::condition_variable start_var;
+        bool                    started = false;
+        auto                    job     = [&start_mutex, &start_var, &started]
+        {
+            std::unique_lock<std::mutex> lock(start_mutex);
+            start_var.wait_for(lock, std::chrono::milliseconds(1000u), [&started] { return started; });
+            return 42;
+        };
+
+        Future<int> future = worker_thread_pool.run<int>(job);
+        Future<int> copy   = future;
+        CHECK_FALSE(future.ready());
+        CHECK_FALSE(copy.wait(std::chrono::milliseconds(20u)));
+        {
+            std::lock_guard<std::mutex> lock(start_mutex);
+            started = true;
+        }
+        start_var.notify_all();
+        CHECK(future.wait());
+        CHECK(copy.ready());
+        CHECK(copy.success());
+        CHECK_EQ(copy.value(), 42);
+        CHECK_EQ(future.value(), 42);
+
+        // Recycled jobs are reset
+        Future<int> other = worker_thread_pool.run<int>([] { return 7; });
+        CHECK(other.wait());
+        CHECK_EQ(other.value(), 7);
+        CHECK_EQ(future.value(), 42);
+    }
+
+    TEST_CASE("Jobs submitted from worker threads")
+    {
+        WorkerThreadPool             worker_thread_pool(4);
+        std::atomic<unsigned>        jobs_done(0);
+        std::thread::id              root_id;
+        std::vector<std::thread::id> thread_ids(64u);
+
+        // A job submits sub-jobs to its own queue and waits for them without executing them,
+        // the sub-jobs can only be executed by the other threads by stealing them
+        Future<void> root = worker_thread_pool.run<void>(
+            [&worker_thread_pool, &jobs_done, &root_id, &thread_ids]
+            {
+                root_id = std::this_thread::get_id();
+                std::vector<Future<void>> futures;
+                for (size_t i = 0; i < thread_ids.size(); i++)
+                {
+                    futures.push_back(worker_thread_pool.run<void>(
+                        [&jobs_done, &thread_ids, i]
+                        {
+                            thread_ids[i] = std::this_thread::get_id();
+                            jobs_done++;
+                        }));
+                }
+                for (auto& future : futures)
+                {
+                    future.wait();
+                }
+            });
+        CHECK(root.wait());
+        CHECK_EQ(jobs_done, thread_ids.size());
+        for (const auto& id : thread_ids)
+        {
+            CHECK_NE(id, std::thread::id());
+            CHECK_NE(id, root_id);
+        }
+    }
+
+    TEST_CASE("Delayed jobs")
+    {
+        TimerPool        timer_pool;
+        WorkerThreadPool worker_thread_pool(1, &timer_pool);
+
+        std::mutex               order_mutex;
+        std::vector<std::string> order;
+        auto                     job = [&order_mutex, &order](const char* name)
+        {
+            return [&order_mutex, &order, name]
+            {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(name);
+            };
+        };
+
+        // The only worker thread is not blocked by the delayed jobs
+        auto start = std::chrono::steady_clock::now();
+        worker_thread_pool.runAfter(std::chrono::milliseconds(150u), job("150ms"));
+        CancellationToken token = worker_thread_pool.runAfter(std::chrono::milliseconds(100u), job("cancelled"));
+        worker_thread_pool.runAt(std::chrono::system_clock::now() + std::chrono::milliseconds(50u), job("50ms"));
+        worker_thread_pool.runAfter(std::chrono::milliseconds(100u), job("100ms"));
+        Future<void> immediate = worker_thread_pool.run<void>(job("now"));
+        CHECK(immediate.wait());
+        CHECK_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50u));
+
+        CHECK_FALSE(token.isCancelled());
+        token.cancel();
+        CHECK(token.isCancelled());
+        CancellationToken empty;
+        empty.cancel();
+        CHECK_FALSE(empty.isCancelled());
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(250u));
+        std::lock_guard<std::mutex> lock(order_mutex);
+        CHECK_EQ(order, std::vector<std::string>({"now", "50ms", "100ms", "150ms"}));
+    }
+
+    TEST_CASE("Delayed jobs without timer pool")
+    {
+        WorkerThreadPool  worker_thread_pool(1);
+        std::atomic<bool> done(false);
+        worker_thread_pool.runAfter(std::chrono::milliseconds(20u), [&done] { done = true; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100u));
+        CHECK(done);
+
+        // Pending delayed jobs are dropped on destruction
+        worker_thread_pool.runAfter(std::chrono::hours(24u), [] {});
+    }
+}
+
+TEST_SUITE("WorkerThreadPool class benchmarks")
+{
+    TEST_CASE("Throughput")
+    {
+        static constexpr size_t JOBS_COUNT = 200000u;
+
+        for (size_t thread_count : {1u, 2u, 4u})
+        {
+            WorkerThreadPool    worker_thread_pool(thread_count);
+            std::atomic<size_t> jobs_done(0);
+
+            // Jobs submitted from outside the pool
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < (JOBS_COUNT - 1u); i++)
+            {
+                worker_thread_pool.run<void>([&jobs_done] { jobs_done++; });
+            }
+            Future<void> last = worker_thread_pool.run<void>([&jobs_done] { jobs_done++; });
+            CHECK(last.wait());
+            while (jobs_done != JOBS_COUNT)
+            {
+                std::this_thread::yield();
+            }
+            auto external = std::chrono::steady_clock::now() - start;
+
+            // Jobs submitted from a worker thread
+            jobs_done = 0;
+            start     = std::chrono::steady_clock::now();
+            worker_thread_pool.run<void>(
+                [&worker_thread_pool, &jobs_done]
+                {
+                    for (size_t i = 0; i < JOBS_COUNT; i++)
+                    {
+                        worker_thread_pool.run<void>([&jobs_done] { jobs_done++; });
+                    }
+                });
+            while (jobs_done != JOBS_COUNT)
+            {
+                std::this_thread::yield();
+            }
+            auto internal = std::chrono::steady_clock::now() - start;
+
+            auto rate = [](std::chrono::steady_clock::duration duration)
+            { return static_cast<double>(JOBS_COUNT) / std::chrono::duration_cast<std::chrono::duration<double>>(duration).count() / 1e6; };
+            MESSAGE(thread_count << " thread(s) : external submissions = " << rate(external)
+                                 << " Mjobs/s, submissions from a worker thread = " << rate(internal) << " Mjobs/s");
+        }
+    }
 }
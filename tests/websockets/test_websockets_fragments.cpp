@@ -0,0 +1,255 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "WebsocketFactory.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace ocpp::websockets;
+
+/** @brief Maximum size of the messages in the tests */
+static constexpr size_t MAX_MESSAGE_SIZE = 1024u * 1024u;
+/** @brief URL of the test server */
+static const char* SERVER_URL = "ws://127.0.0.1:18089/test";
+/** @brief Protocol of the test server */
+static const char* PROTOCOL = "test";
+
+/** @brief Server listener which echoes the received messages */
+class EchoServerListener : public IWebsocketServer::IListener, public IWebsocketServer::IClient::IListener
+{
+  public:
+    bool wsCheckCredentials(const char*, const std::string&, const std::string&) override { return true; }
+    void wsClientConnected(const char*, std::shared_ptr<IWebsocketServer::IClient> client) override
+    {
+        m_client = client;
+        m_client->registerListener(*this);
+    }
+    void wsServerError() override { }
+    void wsClientDisconnected() override { }
+    void wsClientError() override { }
+    void wsClientDataReceived(const void* data, size_t size) override { m_client->send(data, size); }
+
+    std::shared_ptr<IWebsocketServer::IClient> client() const { return m_client; }
+
+  private:
+    std::shared_ptr<IWebsocketServer::IClient> m_client;
+};
+
+/** @brief Client listener which stores the received messages */
+class ClientListener : public IWebsocketClient::IListener
+{
+  public:
+    void wsClientConnected() override { notify(); }
+    void wsClientFailed() override { }
+    void wsClientDisconnected() override
+    {
+        disconnected = true;
+        notify();
+    }
+    void wsClientError() override { }
+    void wsClientDataReceived(const void* data, size_t size) override
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        messages.emplace_back(reinterpret_cast<const char*>(data), size);
+        cond_var.notify_all();
+    }
+
+    template <typename PredicateType>
+    bool waitFor(PredicateType predicate)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cond_var.wait_for(lock, std::chrono::seconds(5), predicate);
+    }
+
+    std::mutex               mutex;
+    std::condition_variable  cond_var;
+    std::vector<std::string> messages;
+    bool                     disconnected = false;
+
+  private:
+    void notify()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cond_var.notify_all();
+    }
+};
+
+TEST_SUITE("Fragmented messages")
+{
+    TEST_CASE("Reassembly and maximum message size")
+    {
+        EchoServerListener                server_listener;
+        std::unique_ptr<IWebsocketServer> server(WebsocketFactory::newServer(MAX_MESSAGE_SIZE));
+        IWebsocketServer::Credentials     server_credentials = {};
+        server->registerListener(server_listener);
+        REQUIRE(server->start(SERVER_URL, PROTOCOL, server_credentials));
+
+        ClientListener                    client_listener;
+        std::unique_ptr<IWebsocketClient> client(WebsocketFactory::newClient(MAX_MESSAGE_SIZE));
+        IWebsocketClient::Credentials     client_credentials = {};
+        client->registerListener(client_listener);
+        REQUIRE(client->connect(SERVER_URL, PROTOCOL, client_credentials, std::chrono::seconds(2), std::chrono::seconds(0)));
+        REQUIRE(client_listener.waitFor([&client] { return client->isConnected(); }));
+
+        // Messages larger than the reception chunks are delivered in one piece
+        std::string message_1(300u * 1024u, 'a');
+        std::string message_2(MAX_MESSAGE_SIZE, 'b');
+        std::string message_3("{}");
+        CHECK(client->send(message_1.c_str(), message_1.size()));
+        CHECK(client->send(message_2.c_str(), message_2.size()));
+        CHECK(client->send(message_3.c_str(), message_3.size()));
+        REQUIRE(client_listener.waitFor([&client_listener] { return (client_listener.messages.size() == 3u); }));
+        CHECK_EQ(client_listener.messages[0], message_1);
+        CHECK_EQ(client_listener.messages[1], message_2);
+        CHECK_EQ(client_listener.messages[2], message_3);
+        CHECK_EQ(client->sendQueueDepth(), 0);
+        CHECK_EQ(client->sendQueueBytes(), 0);
+
+        // Messages larger than the maximum size close the connection
+        std::string message_4(MAX_MESSAGE_SIZE + 1u, 'c');
+        CHECK(client->send(message_4.c_str(), message_4.size()));
+        CHECK(client_listener.waitFor([&client_listener] { return client_listener.disconnected; }));
+        CHECK_EQ(client_listener.messages.size(), 3u);
+
+        client->disconnect();
+        server->stop();
+    }
+}
+
+TEST_SUITE("Send queues")
+{
+    TEST_CASE("High priority lane overflow")
+    {
+        EchoServerListener                server_listener;
+        std::unique_ptr<IWebsocketServer> server(WebsocketFactory::newServer(MAX_MESSAGE_SIZE));
+        IWebsocketServer::Credentials     server_credentials = {};
+        server->registerListener(server_listener);
+        REQUIRE(server->start(SERVER_URL, PROTOCOL, server_credentials));
+
+        ClientListener                    client_listener;
+        std::unique_ptr<IWebsocketClient> client(WebsocketFactory::newClient(MAX_MESSAGE_SIZE));
+        IWebsocketClient::Credentials     client_credentials = {};
+        client->registerListener(client_listener);
+        REQUIRE(client->connect(SERVER_URL, PROTOCOL, client_credentials, std::chrono::seconds(2), std::chrono::seconds(0)));
+        REQUIRE(client_listener.waitFor([&client] { return client->isConnected(); }));
+
+        // Responses produced faster than they can be sent close the connection from the server thread
+        std::shared_ptr<IWebsocketServer::IClient> server_client = server_listener.client();
+        REQUIRE(server_client);
+        std::string message(256u * 1024u, 'r');
+        bool        overflow = false;
+        for (unsigned int i = 0; (i < 1000u) && !overflow; i++)
+        {
+            overflow = !server_client->send(message.c_str(), message.size(), SendPriority::High);
+        }
+        CHECK(overflow);
+        CHECK(client_listener.waitFor([&client_listener] { return client_listener.disconnected; }));
+        CHECK_FALSE(server_client->isConnected());
+
+        client->disconnect();
+        server->stop();
+    }
+}
+
+TEST_SUITE("Compression")
+{
+#ifdef OCPP_WITH_PERMESSAGE_DEFLATE
+    TEST_CASE("permessage-deflate extension")
+    {
+        EchoServerListener                server_listener;
+        std::unique_ptr<IWebsocketServer> server(WebsocketFactory::newServer(MAX_MESSAGE_SIZE));
+        IWebsocketServer::Credentials     server_credentials = {};
+        server_credentials.permessage_deflate                = true;
+        server_credentials.compression_level                 = 6u;
+        server->registerListener(server_listener);
+        REQUIRE(server->start(SERVER_URL, PROTOCOL, server_credentials));
+
+        ClientListener                    client_listener;
+        std::unique_ptr<IWebsocketClient> client(WebsocketFactory::newClient(MAX_MESSAGE_SIZE));
+        IWebsocketClient::Credentials     client_credentials = {};
+        client_credentials.permessage_deflate                = true;
+        client_credentials.compression_level                 = 9u;
+        client_credentials.compression_window_bits           = 12u;
+        client->registerListener(client_listener);
+        REQUIRE(client->connect(SERVER_URL, PROTOCOL, client_credentials, std::chrono::seconds(2), std::chrono::seconds(0)));
+        REQUIRE(client_listener.waitFor([&client] { return client->isConnected(); }));
+
+        // Verbose JSON messages are compressed
+        std::string message;
+        for (unsigned int i = 0; i < 100u; i++)
+        {
+            message += R"([2,"123","MeterValues",{"connectorId":1,"meterValue":[{"timestamp":"2026-10-16T12:00:00Z","sampledValue":[]}]}])";
+        }
+        CHECK(client->send(message.c_str(), message.size()));
+        CHECK(client->send(message.c_str(), message.size()));
+        REQUIRE(client_listener.waitFor([&client_listener] { return (client_listener.messages.size() == 2u); }));
+        CHECK_EQ(client_listener.messages[0], message);
+        CHECK_EQ(client_listener.messages[1], message);
+
+        client->disconnect();
+        server->stop();
+    }
+
+    TEST_CASE("Without compression")
+    {
+        EchoServerListener                server_listener;
+        std::unique_ptr<IWebsocketServer> server(WebsocketFactory::newServer(MAX_MESSAGE_SIZE));
+        IWebsocketServer::Credentials     server_credentials = {};
+        server->registerListener(server_listener);
+        REQUIRE(server->start(SERVER_URL, PROTOCOL, server_credentials));
+
+        ClientListener                    client_listener;
+        std::unique_ptr<IWebsocketClient> client(WebsocketFactory::newClient(MAX_MESSAGE_SIZE));
+        IWebsocketClient::Credentials     client_credentials = {};
+        client_credentials.permessage_deflate                = true;
+        client->registerListener(client_listener);
+        REQUIRE(client->connect(SERVER_URL, PROTOCOL, client_credentials, std::chrono::seconds(2), std::chrono::seconds(0)));
+        REQUIRE(client_listener.waitFor([&client] { return client->isConnected(); }));
+
+        // The server doesn't accept the extension
+        std::string message(1000u, 'a');
+        CHECK(client->send(message.c_str(), message.size()));
+        REQUIRE(client_listener.waitFor([&client_listener] { return (client_listener.messages.size() == 1u); }));
+        CHECK_EQ(client_listener.messages[0], message);
+
+        client->disconnect();
+        server->stop();
+    }
+#else  // OCPP_WITH_PERMESSAGE_DEFLATE
+    TEST_CASE("permessage-deflate not supported")
+    {
+        std::unique_ptr<IWebsocketServer> server(WebsocketFactory::newServer(MAX_MESSAGE_SIZE));
+        IWebsocketServer::Credentials     server_credentials = {};
+        server_credentials.permessage_deflate                = true;
+        CHECK_FALSE(server->start(SERVER_URL, PROTOCOL, server_credentials));
+
+        std::unique_ptr<IWebsocketClient> client(WebsocketFactory::newClient(MAX_MESSAGE_SIZE));
+        IWebsocketClient::Credentials     client_credentials = {};
+        client_credentials.permessage_deflate                = true;
+        CHECK_FALSE(client->connect(SERVER_URL, PROTOCOL, client_credentials, std::chrono::seconds(2), std::chrono::seconds(0)));
+        CHECK_FALSE(client->isConnected());
+    }
+#endif // OCPP_WITH_PERMESSAGE_DEFLATE
+}
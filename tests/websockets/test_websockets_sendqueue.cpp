@@ -0,0 +1,106 @@
+/*
+Copyright (c) 2020 Cedric Jimenez
+This file is part of OpenOCPP.
+
+OpenOCPP is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+OpenOCPP is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with OpenOCPP. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SendQueue.h"
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include <string>
+
+using namespace ocpp::websockets;
+
+/** @brief Message stored in the send queue */
+struct Msg
+{
+    Msg(const std::string& _data) : data(_data), size(_data.size()) { }
+    std::string data;
+    size_t      size;
+};
+
+TEST_SUITE("Send queue")
+{
+    TEST_CASE("Priority lanes")
+    {
+        SendQueue<Msg> queue(10u);
+        CHECK(queue.empty());
+
+        CHECK(queue.push(new Msg("bulk1"), SendPriority::Normal));
+        CHECK(queue.push(new Msg("bulk2"), SendPriority::Normal));
+        CHECK(queue.push(new Msg("response"), SendPriority::High));
+        CHECK_FALSE(queue.empty());
+        CHECK_EQ(queue.count(), 3u);
+        CHECK_EQ(queue.bytes(), 18u);
+
+        // High priority messages are sent first, then messages are sent in order
+        Msg* msg = nullptr;
+        REQUIRE(queue.pop(msg));
+        CHECK_EQ(msg->data, "response");
+        delete msg;
+        REQUIRE(queue.pop(msg));
+        CHECK_EQ(msg->data, "bulk1");
+        delete msg;
+        REQUIRE(queue.pop(msg));
+        CHECK_EQ(msg->data, "bulk2");
+        delete msg;
+        CHECK_FALSE(queue.pop(msg));
+        CHECK(queue.empty());
+        CHECK_EQ(queue.bytes(), 0u);
+    }
+
+    TEST_CASE("Back-pressure and high-water marks")
+    {
+        SendQueue<Msg> queue(2u, 3u);
+
+        // Each lane has its own bound
+        Msg* msg = new Msg("bulk3");
+        CHECK(queue.push(new Msg("bulk1"), SendPriority::Normal));
+        CHECK(queue.push(new Msg("bulk2"), SendPriority::Normal));
+        CHECK_FALSE(queue.push(msg, SendPriority::Normal));
+        delete msg;
+        CHECK(queue.push(new Msg("response1"), SendPriority::High));
+        CHECK(queue.push(new Msg("response2"), SendPriority::High));
+        CHECK(queue.push(new Msg("response3"), SendPriority::High));
+        msg = new Msg("response4");
+        CHECK_FALSE(queue.push(msg, SendPriority::High));
+        delete msg;
+        CHECK_EQ(queue.count(), 5u);
+        CHECK_EQ(queue.highWaterMark(SendPriority::Normal), 2u);
+        CHECK_EQ(queue.highWaterMark(SendPriority::High), 3u);
+
+        // High-water marks are kept when the queue is emptied
+        queue.clear();
+        CHECK(queue.empty());
+        CHECK_EQ(queue.bytes(), 0u);
+        CHECK_EQ(queue.highWaterMark(SendPriority::Normal), 2u);
+        CHECK_EQ(queue.highWaterMark(SendPriority::High), 3u);
+        CHECK(queue.push(new Msg("bulk4"), SendPriority::Normal));
+        CHECK(queue.push(new Msg("response5"), SendPriority::High));
+    }
+
+    TEST_CASE("Default High lane bound")
+    {
+        SendQueue<Msg> queue(1u);
+        for (size_t i = 0; i < SendQueue<Msg>::DEFAULT_HIGH_LANE_SIZE; i++)
+        {
+            CHECK(queue.push(new Msg("response"), SendPriority::High));
+        }
+        Msg* msg = new Msg("response");
+        CHECK_FALSE(queue.push(msg, SendPriority::High));
+        delete msg;
+    }
+}